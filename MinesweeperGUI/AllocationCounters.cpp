@@ -0,0 +1,95 @@
+#include "AllocationCounters.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// Define the counters, the totals are shared by every thread and the thread count is only written by its thread
+static std::atomic<uint64_t> totalAllocations{ 0 };
+static std::atomic<uint64_t> totalFrees{ 0 };
+static std::atomic<uint64_t> totalBytes{ 0 };
+static thread_local uint64_t threadAllocations = 0;
+
+AllocationCounters::Counts AllocationCounters::GetTotal() {
+	Counts counts;
+	counts.allocations = totalAllocations.load(std::memory_order_relaxed);
+	counts.frees = totalFrees.load(std::memory_order_relaxed);
+	counts.bytesAllocated = totalBytes.load(std::memory_order_relaxed);
+	return counts;
+}
+
+uint64_t AllocationCounters::GetThreadAllocations() {
+	return threadAllocations;
+}
+
+// Counts an allocation, then allocates the memory (aligned if alignment is above what malloc gives)
+static void* CountedAllocate(size_t size, size_t alignment) {
+
+	totalAllocations.fetch_add(1, std::memory_order_relaxed);
+	totalBytes.fetch_add(size, std::memory_order_relaxed);
+	threadAllocations++;
+
+	if (size == 0) {
+		size = 1;
+	}
+	if (alignment <= alignof(std::max_align_t)) {
+		return malloc(size);
+	}
+#ifdef _WIN32
+	return _aligned_malloc(size, alignment);
+#else
+	void* memory = nullptr;
+	return posix_memalign(&memory, alignment, size) == 0 ? memory : nullptr;
+#endif
+}
+
+static void CountedFree(void* memory, size_t alignment) {
+
+	if (memory == nullptr) {
+		return;
+	}
+	totalFrees.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+	if (alignment > alignof(std::max_align_t)) {
+		_aligned_free(memory);
+		return;
+	}
+#else
+	(void)alignment;
+#endif
+	free(memory);
+}
+
+static void* AllocateOrThrow(size_t size, size_t alignment) {
+	void* memory = CountedAllocate(size, alignment);
+	if (memory == nullptr) {
+		throw std::bad_alloc();
+	}
+	return memory;
+}
+
+// Define the replaced global operators (every form, so memory is always freed the way it was allocated)
+void* operator new(size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size, 0); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, static_cast<size_t>(alignment)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, static_cast<size_t>(alignment)); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return CountedAllocate(size, static_cast<size_t>(alignment)); }
+
+void operator delete(void* memory) noexcept { CountedFree(memory, 0); }
+void operator delete[](void* memory) noexcept { CountedFree(memory, 0); }
+void operator delete(void* memory, size_t) noexcept { CountedFree(memory, 0); }
+void operator delete[](void* memory, size_t) noexcept { CountedFree(memory, 0); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { CountedFree(memory, 0); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { CountedFree(memory, 0); }
+void operator delete(void* memory, std::align_val_t alignment) noexcept { CountedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment) noexcept { CountedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete(void* memory, size_t, std::align_val_t alignment) noexcept { CountedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, size_t, std::align_val_t alignment) noexcept { CountedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete(void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(memory, static_cast<size_t>(alignment)); }
+void operator delete[](void* memory, std::align_val_t alignment, const std::nothrow_t&) noexcept { CountedFree(memory, static_cast<size_t>(alignment)); }
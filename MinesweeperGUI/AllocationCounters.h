@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdint>
+
+// Counts the heap allocations made by the program, in total and on each thread. The global operator new and delete
+// are replaced in AllocationCounters.cpp, so the counts are only kept in programs that link it.
+// Used by the benchmarks to check that gameplay doesn't allocate, and by the engine thread to report the
+// allocations made by each move
+class AllocationCounters
+{
+public:
+
+	// Define the counts since the program started
+	struct Counts {
+		uint64_t allocations;
+		uint64_t frees;
+		uint64_t bytesAllocated;
+	};
+
+	// Returns the counts of every thread (each count is exact, but the three are not read at the same instant)
+	static Counts GetTotal();
+
+	// Returns the # of allocations made by the calling thread
+	static uint64_t GetThreadAllocations();
+};
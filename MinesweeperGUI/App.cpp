@@ -1,13 +1,27 @@
 #include "App.h"
 #include "MainFrame.h"
 #include <wx/wx.h>
+#include <wx/filename.h>
+#include <wx/stdpaths.h>
 
 wxIMPLEMENT_APP(App);
 
 bool App::OnInit() {
-	MainFrame* mainFrame = new MainFrame("Minesweeper");
+
+	// The statistics are kept in the user's data folder, the games are played without saving them if it can't be written
+	wxString statsFolder = wxStandardPaths::Get().GetUserDataDir();
+	wxFileName::Mkdir(statsFolder, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+	stats.Open(wxFileName(statsFolder, "games.log").GetFullPath().ToStdString(), wxFileName(statsFolder, "summary.bin").GetFullPath().ToStdString());
+
+	MainFrame* mainFrame = new MainFrame("Minesweeper", stats);
 	mainFrame->SetClientSize(500, 500); 
 	mainFrame->Center();
 	mainFrame->Show();
 	return true;
 }
+
+// Writes the games not yet saved (every window is closed by now)
+int App::OnExit() {
+	stats.Close();
+	return wxApp::OnExit();
+}
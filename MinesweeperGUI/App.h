@@ -1,8 +1,15 @@
 #pragma once
 #include <wx/wx.h>
+#include "StatsStore.h"
 
 class App : public wxApp
 {
 public:
 	bool OnInit();
+	int OnExit();
+
+private:
+
+	// Define the statistics of every game played, kept by the app so the windows opened from the home button share them
+	StatsStore stats;
 };
\ No newline at end of file
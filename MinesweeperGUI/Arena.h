@@ -0,0 +1,118 @@
+#pragma once
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Hands out memory from a single block owned by the arena, by moving a position through the block.
+// Allocations are never freed one at a time: Reset rewinds the arena (keeping its block if it is big enough)
+// and the block is freed with the arena. An allocation that doesn't fit in the block gets a block of its own,
+// which is freed by the next Reset. Alignments are at most alignof(std::max_align_t)
+class Arena
+{
+public:
+
+	Arena() {}
+	~Arena() { Free(); }
+	Arena(const Arena&) = delete;
+	Arena& operator=(const Arena&) = delete;
+
+	// Rewinds the arena, its block holds at least capacity bytes afterwards.
+	// Everything allocated from the arena must no longer be in use
+	void Reset(size_t capacity) {
+		FreeOverflow();
+		used = 0;
+		if (capacity > blockSize) {
+
+			// The arena is left empty if the new block can't be allocated
+			::operator delete(block);
+			block = nullptr;
+			blockSize = 0;
+			block = static_cast<char*>(::operator new(capacity));
+			blockSize = capacity;
+		}
+	}
+
+	void* Allocate(size_t bytes, size_t alignment) {
+		size_t start = (used + alignment - 1) & ~(alignment - 1);
+		if (start + bytes <= blockSize) {
+			used = start + bytes;
+			return block + start;
+		}
+		return AllocateOverflow(bytes);
+	}
+
+	void Free() {
+		FreeOverflow();
+		::operator delete(block);
+		block = nullptr;
+		blockSize = 0;
+		used = 0;
+	}
+
+	// Define methods that report the memory of the arena
+	size_t GetCapacity() const { return blockSize; }
+	size_t GetUsed() const { return used; }
+	int GetOverflowCount() const { return overflowCount; }
+
+private:
+
+	// Define the header at the start of an overflow block, the blocks are linked through it
+	struct alignas(std::max_align_t) Overflow {
+		Overflow* next;
+	};
+
+	void* AllocateOverflow(size_t bytes) {
+		Overflow* overflowBlock = static_cast<Overflow*>(::operator new(sizeof(Overflow) + bytes));
+		overflowBlock->next = overflow;
+		overflow = overflowBlock;
+		overflowCount++;
+		return overflowBlock + 1;
+	}
+
+	void FreeOverflow() {
+		while (overflow != nullptr) {
+			Overflow* next = overflow->next;
+			::operator delete(overflow);
+			overflow = next;
+		}
+		overflowCount = 0;
+	}
+
+	char* block = nullptr;
+	size_t blockSize = 0;
+	size_t used = 0;
+	Overflow* overflow = nullptr;
+	int overflowCount = 0;
+};
+
+// Allocator that gets the memory of a container from an arena (freeing does nothing, the arena is rewound instead)
+template <class T>
+class ArenaAllocator
+{
+public:
+
+	typedef T value_type;
+
+	explicit ArenaAllocator(Arena* arena) : arena(arena) {}
+	template <class U>
+	ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+	T* allocate(size_t count) { return static_cast<T*>(arena->Allocate(count * sizeof(T), alignof(T))); }
+	void deallocate(T*, size_t) {}
+
+	template <class U>
+	bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+	template <class U>
+	bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+	Arena* arena;
+};
+
+template <class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// Gives the memory of a vector back to its arena (the vector is empty afterwards), before the arena is rewound
+template <class T>
+void ReleaseArenaVector(ArenaVector<T>& buffer) {
+	ArenaVector<T>(buffer.get_allocator()).swap(buffer);
+}
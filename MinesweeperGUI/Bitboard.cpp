@@ -0,0 +1,466 @@
+#include "Bitboard.h"
+#include <algorithm>
+#include <bitset>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// The AVX2 kernels are compiled with a target attribute and picked at run time,
+// so the same build runs on CPUs without AVX2 (other compilers only build the portable kernels)
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BITBOARD_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+static bool UseAvx2Kernels = Bitboard::HasAvx2();
+
+// Creates an empty board, Resize must be called before it is used
+Bitboard::Bitboard() {
+	Resize(0, 0);
+}
+
+// Creates a board with all cells cleared
+Bitboard::Bitboard(int width, int height) {
+	Resize(width, height);
+}
+
+// Allocates the rows (and their padding) for the given size, all cells are cleared
+void Bitboard::Resize(int width, int height) {
+
+	this->width = width;
+	this->height = height;
+	wordsPerRow = (width + 63) / 64;
+	paddedWordsPerRow = (wordsPerRow + 3) & ~3;
+	stride = paddedWordsPerRow + 2;
+	lastWordMask = (width % 64 == 0) ? ~uint64_t(0) : (uint64_t(1) << (width % 64)) - 1;
+
+	words.assign(static_cast<size_t>(stride) * (height + 2), 0);
+}
+
+void Bitboard::Clear() {
+	std::fill(words.begin(), words.end(), 0);
+}
+
+// Clears the rows [firstRow, lastRow] (with their padding)
+void Bitboard::ClearRows(int firstRow, int lastRow) {
+	if (firstRow <= lastRow) {
+		std::fill(Row(firstRow), Row(lastRow) + paddedWordsPerRow, 0);
+	}
+}
+
+// Sets the words past the width of a row back to zero (the AVX2 kernels write whole groups of 4 words)
+void Bitboard::ClearRowPadding(int y) {
+	uint64_t* row = Row(y);
+	if (wordsPerRow > 0) {
+		row[wordsPerRow - 1] &= lastWordMask;
+	}
+	std::fill(row + wordsPerRow, row + paddedWordsPerRow, 0);
+}
+
+static int PopCount(uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	return static_cast<int>(std::bitset<64>(word).count());
+#endif
+}
+
+int Bitboard::CountTrailingZeros(uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanForward64(&index, word);
+	return static_cast<int>(index);
+#else
+	int count = 0;
+	while ((word & 1) == 0) {
+		word >>= 1;
+		count++;
+	}
+	return count;
+#endif
+}
+
+// Counts the set cells (the padding is always zero, so every word can be counted)
+size_t Bitboard::Count() const {
+	size_t count = 0;
+	for (uint64_t word : words) {
+		count += PopCount(word);
+	}
+	return count;
+}
+
+bool Bitboard::IsEmpty() const {
+	for (uint64_t word : words) {
+		if (word != 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool Bitboard::operator==(const Bitboard& other) const {
+	return width == other.width && height == other.height && words == other.words;
+}
+
+void Bitboard::And(const Bitboard& other) {
+	for (size_t i = 0; i < words.size(); i++) {
+		words[i] &= other.words[i];
+	}
+}
+
+void Bitboard::Or(const Bitboard& other) {
+	for (size_t i = 0; i < words.size(); i++) {
+		words[i] |= other.words[i];
+	}
+}
+
+void Bitboard::AndNot(const Bitboard& other) {
+	for (size_t i = 0; i < words.size(); i++) {
+		words[i] &= ~other.words[i];
+	}
+}
+
+void Bitboard::Invert() {
+	for (int y = 0; y < height; y++) {
+		uint64_t* row = Row(y);
+		for (int i = 0; i < wordsPerRow; i++) {
+			row[i] = ~row[i];
+		}
+		ClearRowPadding(y);
+	}
+}
+
+bool Bitboard::HasAvx2() {
+#if defined(BITBOARD_AVX2_KERNELS)
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2");
+#else
+	return false;
+#endif
+}
+
+// Allows the portable kernels to be used (and compared) on a CPU with AVX2
+void Bitboard::SetUseAvx2(bool IsEnabled) {
+	UseAvx2Kernels = IsEnabled && HasAvx2();
+}
+
+bool Bitboard::IsUsingAvx2() {
+	return UseAvx2Kernels;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Portable kernels (one 64 bit word = 64 cells at a time)
+// ---------------------------------------------------------------------------------------------
+
+// Returns a word where bit x is the cell at x - 1 (reads the previous word, which is zero padding for the first word)
+static inline uint64_t LeftNeighbors(const uint64_t* row, int i) {
+	return (row[i] << 1) | (row[i - 1] >> 63);
+}
+
+// Returns a word where bit x is the cell at x + 1
+static inline uint64_t RightNeighbors(const uint64_t* row, int i) {
+	return (row[i] >> 1) | (row[i + 1] << 63);
+}
+
+// Returns a word where bit x is set if the cell at x - 1, x or x + 1 is set
+static inline uint64_t SpreadRow(const uint64_t* row, int i) {
+	return row[i] | LeftNeighbors(row, i) | RightNeighbors(row, i);
+}
+
+static inline uint64_t Majority(uint64_t a, uint64_t b, uint64_t c) {
+	return (a & b) | (c & (a ^ b));
+}
+
+static void DilateRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* result, int words) {
+	for (int i = 0; i < words; i++) {
+		result[i] = SpreadRow(above, i) | SpreadRow(row, i) | SpreadRow(below, i);
+	}
+}
+
+// Adds the 8 neighbor bits of every cell of a row with full adders, one bit plane of the sum at a time
+static void CountRow(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* planes[4], int words) {
+	for (int i = 0; i < words; i++) {
+
+		// Sum the 3 cells above and the 3 cells below (0 - 3 each, 2 bits)
+		uint64_t aboveLeft = LeftNeighbors(above, i), aboveRight = RightNeighbors(above, i);
+		uint64_t belowLeft = LeftNeighbors(below, i), belowRight = RightNeighbors(below, i);
+		uint64_t above0 = aboveLeft ^ above[i] ^ aboveRight;
+		uint64_t above1 = Majority(aboveLeft, above[i], aboveRight);
+		uint64_t below0 = belowLeft ^ below[i] ^ belowRight;
+		uint64_t below1 = Majority(belowLeft, below[i], belowRight);
+
+		// Sum the cells to the left and right (0 - 2)
+		uint64_t left = LeftNeighbors(row, i), right = RightNeighbors(row, i);
+		uint64_t side0 = left ^ right;
+		uint64_t side1 = left & right;
+
+		// Add above and below (0 - 6, 3 bits)
+		uint64_t carry = above0 & below0;
+		uint64_t sum0 = above0 ^ below0;
+		uint64_t sum1 = above1 ^ below1 ^ carry;
+		uint64_t sum2 = Majority(above1, below1, carry);
+
+		// Add the sides (0 - 8, 4 bits)
+		carry = sum0 & side0;
+		planes[0][i] = sum0 ^ side0;
+		planes[1][i] = sum1 ^ side1 ^ carry;
+		carry = Majority(sum1, side1, carry);
+		planes[2][i] = sum2 ^ carry;
+		planes[3][i] = sum2 & carry;
+	}
+}
+
+// Adds the passable cells next to the rows above and below to a row, returns true if it changed
+static bool GrowRow(const uint64_t* above, uint64_t* row, const uint64_t* below, const uint64_t* passable, int words) {
+	uint64_t difference = 0;
+	for (int i = 0; i < words; i++) {
+		uint64_t grown = row[i] | ((SpreadRow(above, i) | SpreadRow(below, i)) & passable[i]);
+		difference |= grown ^ row[i];
+		row[i] = grown;
+	}
+	return difference != 0;
+}
+
+// ---------------------------------------------------------------------------------------------
+// AVX2 kernels (4 words = 256 cells at a time, the rows are padded to a multiple of 4 words)
+// ---------------------------------------------------------------------------------------------
+
+#if defined(BITBOARD_AVX2_KERNELS)
+
+#define BITBOARD_AVX2 __attribute__((target("avx2")))
+
+BITBOARD_AVX2 static inline __m256i Load(const uint64_t* words) {
+	return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words));
+}
+
+BITBOARD_AVX2 static inline void Store(uint64_t* words, __m256i value) {
+	_mm256_storeu_si256(reinterpret_cast<__m256i*>(words), value);
+}
+
+// The neighbor words are read with unaligned loads 1 word before and after, instead of shuffling lanes
+BITBOARD_AVX2 static inline __m256i LeftNeighborsAvx2(const uint64_t* row, int i) {
+	return _mm256_or_si256(_mm256_slli_epi64(Load(row + i), 1), _mm256_srli_epi64(Load(row + i - 1), 63));
+}
+
+BITBOARD_AVX2 static inline __m256i RightNeighborsAvx2(const uint64_t* row, int i) {
+	return _mm256_or_si256(_mm256_srli_epi64(Load(row + i), 1), _mm256_slli_epi64(Load(row + i + 1), 63));
+}
+
+BITBOARD_AVX2 static inline __m256i SpreadRowAvx2(const uint64_t* row, int i) {
+	return _mm256_or_si256(Load(row + i), _mm256_or_si256(LeftNeighborsAvx2(row, i), RightNeighborsAvx2(row, i)));
+}
+
+BITBOARD_AVX2 static inline __m256i MajorityAvx2(__m256i a, __m256i b, __m256i c) {
+	return _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(c, _mm256_xor_si256(a, b)));
+}
+
+BITBOARD_AVX2 static inline __m256i Xor3(__m256i a, __m256i b, __m256i c) {
+	return _mm256_xor_si256(_mm256_xor_si256(a, b), c);
+}
+
+BITBOARD_AVX2 static void DilateRowAvx2(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* result, int words) {
+	for (int i = 0; i < words; i += 4) {
+		Store(result + i, _mm256_or_si256(SpreadRowAvx2(above, i), _mm256_or_si256(SpreadRowAvx2(row, i), SpreadRowAvx2(below, i))));
+	}
+}
+
+// Same adders as CountRow
+BITBOARD_AVX2 static void CountRowAvx2(const uint64_t* above, const uint64_t* row, const uint64_t* below, uint64_t* planes[4], int words) {
+	for (int i = 0; i < words; i += 4) {
+
+		// Sum the 3 cells above and the 3 cells below
+		__m256i aboveLeft = LeftNeighborsAvx2(above, i), aboveCenter = Load(above + i), aboveRight = RightNeighborsAvx2(above, i);
+		__m256i belowLeft = LeftNeighborsAvx2(below, i), belowCenter = Load(below + i), belowRight = RightNeighborsAvx2(below, i);
+		__m256i above0 = Xor3(aboveLeft, aboveCenter, aboveRight);
+		__m256i above1 = MajorityAvx2(aboveLeft, aboveCenter, aboveRight);
+		__m256i below0 = Xor3(belowLeft, belowCenter, belowRight);
+		__m256i below1 = MajorityAvx2(belowLeft, belowCenter, belowRight);
+
+		// Sum the cells to the left and right
+		__m256i left = LeftNeighborsAvx2(row, i), right = RightNeighborsAvx2(row, i);
+		__m256i side0 = _mm256_xor_si256(left, right);
+		__m256i side1 = _mm256_and_si256(left, right);
+
+		// Add above and below
+		__m256i carry = _mm256_and_si256(above0, below0);
+		__m256i sum0 = _mm256_xor_si256(above0, below0);
+		__m256i sum1 = Xor3(above1, below1, carry);
+		__m256i sum2 = MajorityAvx2(above1, below1, carry);
+
+		// Add the sides
+		carry = _mm256_and_si256(sum0, side0);
+		Store(planes[0] + i, _mm256_xor_si256(sum0, side0));
+		Store(planes[1] + i, Xor3(sum1, side1, carry));
+		carry = MajorityAvx2(sum1, side1, carry);
+		Store(planes[2] + i, _mm256_xor_si256(sum2, carry));
+		Store(planes[3] + i, _mm256_and_si256(sum2, carry));
+	}
+}
+
+BITBOARD_AVX2 static bool GrowRowAvx2(const uint64_t* above, uint64_t* row, const uint64_t* below, const uint64_t* passable, int words) {
+	__m256i difference = _mm256_setzero_si256();
+	for (int i = 0; i < words; i += 4) {
+		__m256i current = Load(row + i);
+		__m256i grown = _mm256_or_si256(current, _mm256_and_si256(_mm256_or_si256(SpreadRowAvx2(above, i), SpreadRowAvx2(below, i)), Load(passable + i)));
+		difference = _mm256_or_si256(difference, _mm256_xor_si256(grown, current));
+		Store(row + i, grown);
+	}
+	return !_mm256_testz_si256(difference, difference);
+}
+
+#endif
+
+// ---------------------------------------------------------------------------------------------
+// Whole board operations
+// ---------------------------------------------------------------------------------------------
+
+void Bitboard::Dilate(const Bitboard& source, Bitboard& result) {
+
+	if (result.width != source.width || result.height != source.height) {
+		result.Resize(source.width, source.height);
+	}
+
+	for (int y = 0; y < source.height; y++) {
+#if defined(BITBOARD_AVX2_KERNELS)
+		if (UseAvx2Kernels) {
+			DilateRowAvx2(source.Row(y - 1), source.Row(y), source.Row(y + 1), result.Row(y), source.paddedWordsPerRow);
+			result.ClearRowPadding(y);
+			continue;
+		}
+#endif
+		DilateRow(source.Row(y - 1), source.Row(y), source.Row(y + 1), result.Row(y), source.wordsPerRow);
+		result.ClearRowPadding(y);
+	}
+}
+
+void Bitboard::CountNeighbors(const Bitboard& bombs, Bitboard planes[4]) {
+
+	for (int plane = 0; plane < 4; plane++) {
+		if (planes[plane].width != bombs.width || planes[plane].height != bombs.height) {
+			planes[plane].Resize(bombs.width, bombs.height);
+		}
+	}
+
+	for (int y = 0; y < bombs.height; y++) {
+		uint64_t* rows[4] = { planes[0].Row(y), planes[1].Row(y), planes[2].Row(y), planes[3].Row(y) };
+#if defined(BITBOARD_AVX2_KERNELS)
+		if (UseAvx2Kernels) {
+			CountRowAvx2(bombs.Row(y - 1), bombs.Row(y), bombs.Row(y + 1), rows, bombs.paddedWordsPerRow);
+		}
+		else
+#endif
+		{
+			CountRow(bombs.Row(y - 1), bombs.Row(y), bombs.Row(y + 1), rows, bombs.wordsPerRow);
+		}
+		for (int plane = 0; plane < 4; plane++) {
+			planes[plane].ClearRowPadding(y);
+		}
+	}
+}
+
+// Spreads the set cells of a row along the runs of passable cells, in both directions (carrying between words),
+// with a shift-and-mask fill that doubles the distance each step. Returns true if the row changed
+static bool FillRowRuns(uint64_t* row, const uint64_t* passable, int words) {
+
+	uint64_t difference = 0;
+
+	// Spread toward higher x
+	uint64_t carry = 0;
+	for (int i = 0; i < words; i++) {
+		uint64_t fill = row[i] | (carry & passable[i]);
+		uint64_t open = passable[i];
+		fill |= open & (fill << 1); open &= open << 1;
+		fill |= open & (fill << 2); open &= open << 2;
+		fill |= open & (fill << 4); open &= open << 4;
+		fill |= open & (fill << 8); open &= open << 8;
+		fill |= open & (fill << 16); open &= open << 16;
+		fill |= open & (fill << 32);
+		difference |= fill ^ row[i];
+		row[i] = fill;
+		carry = fill >> 63;
+	}
+
+	// Spread toward lower x
+	carry = 0;
+	for (int i = words - 1; i >= 0; i--) {
+		uint64_t fill = row[i] | ((carry << 63) & passable[i]);
+		uint64_t open = passable[i];
+		fill |= open & (fill >> 1); open &= open >> 1;
+		fill |= open & (fill >> 2); open &= open >> 2;
+		fill |= open & (fill >> 4); open &= open >> 4;
+		fill |= open & (fill >> 8); open &= open >> 8;
+		fill |= open & (fill >> 16); open &= open >> 16;
+		fill |= open & (fill >> 32);
+		difference |= fill ^ row[i];
+		row[i] = fill;
+		carry = fill & 1;
+	}
+
+	return difference != 0;
+}
+
+// Grows the seeds with dilate-and-mask steps until nothing changes
+void Bitboard::FloodFill(const Bitboard& seeds, const Bitboard& passable, Bitboard& result) {
+
+	result = seeds;
+	result.And(passable);
+
+	// Find the rows that contain seeds
+	int firstRow = result.height;
+	int lastRow = -1;
+	for (int y = 0; y < result.height; y++) {
+		const uint64_t* row = result.Row(y);
+		if (std::any_of(row, row + result.wordsPerRow, [](uint64_t word) { return word != 0; })) {
+			firstRow = std::min(firstRow, y);
+			lastRow = y;
+		}
+	}
+
+	if (lastRow >= 0) {
+		GrowRegion(passable, result, firstRow, lastRow);
+	}
+}
+
+// Grows the region with dilate-and-mask steps until nothing changes. The rows are updated in place,
+// sweeping down and then up the board, so a region spreads across many rows in a single sweep.
+// Only the rows the region has reached (and one more on each side) are swept
+void Bitboard::GrowRegion(const Bitboard& passable, Bitboard& result, int& firstRow, int& lastRow) {
+
+	bool IsChanged = true;
+	while (IsChanged) {
+		IsChanged = false;
+		for (int sweep = 0; sweep < 2; sweep++) {
+			int step = (sweep == 0) ? 1 : -1;
+			int y = (sweep == 0) ? std::max(firstRow - 1, 0) : std::min(lastRow + 1, result.height - 1);
+			for (; y >= std::max(firstRow - 1, 0) && y <= std::min(lastRow + 1, result.height - 1); y += step) {
+				uint64_t* row = result.Row(y);
+				bool IsRowChanged;
+#if defined(BITBOARD_AVX2_KERNELS)
+				if (UseAvx2Kernels) {
+					IsRowChanged = GrowRowAvx2(result.Row(y - 1), row, result.Row(y + 1), passable.Row(y), result.paddedWordsPerRow);
+				}
+				else
+#endif
+				{
+					IsRowChanged = GrowRow(result.Row(y - 1), row, result.Row(y + 1), passable.Row(y), result.wordsPerRow);
+				}
+				IsRowChanged |= FillRowRuns(row, passable.Row(y), result.wordsPerRow);
+
+				// A row that changed is part of the region now
+				if (IsRowChanged) {
+					IsChanged = true;
+					firstRow = std::min(firstRow, y);
+					lastRow = std::max(lastRow, y);
+				}
+			}
+		}
+	}
+}
+
+void Bitboard::Frontier(const Bitboard& covered, const Bitboard& revealed, Bitboard& result) {
+	Dilate(revealed, result);
+	result.And(covered);
+}
@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stores one bit per cell, each row packed into 64 bit words (bit x of row y is the cell xPos = x, yPos = y,
+// the same cell as index x + y * nCols in GameBoard). Used to work on 64 - 256 cells per instruction
+// on very large boards: bomb counting, flood fill and frontier extraction.
+//
+// Every row has a zero word before it and is padded to a multiple of 4 words (plus a zero word after it),
+// and there is a zero row above and below the grid, so the kernels can read the neighbors of any word
+// (and load 4 words at a time with AVX2) without bounds checks. Bits past the width are always zero.
+class Bitboard
+{
+public:
+
+	Bitboard();
+	Bitboard(int width, int height);
+
+	// Define methods used to set up the board
+	void Resize(int width, int height);
+	void Clear();
+	void ClearRows(int firstRow, int lastRow);
+
+	// Define methods that give access to single cells and rows
+	int GetWidth() const { return width; }
+	int GetHeight() const { return height; }
+	int GetWordsPerRow() const { return wordsPerRow; }
+	bool Get(int x, int y) const { return (Row(y)[x >> 6] >> (x & 63)) & 1; }
+	void Set(int x, int y) { Row(y)[x >> 6] |= uint64_t(1) << (x & 63); }
+	void Reset(int x, int y) { Row(y)[x >> 6] &= ~(uint64_t(1) << (x & 63)); }
+
+	// Rows -1 and height are zero rows that can be read but must not be written
+	uint64_t* Row(int y) { return &words[(y + 1) * stride + 1]; }
+	const uint64_t* Row(int y) const { return &words[(y + 1) * stride + 1]; }
+
+	// Define methods that combine whole boards of the same size
+	size_t Count() const;
+	bool IsEmpty() const;
+	bool operator==(const Bitboard& other) const;
+	bool operator!=(const Bitboard& other) const { return !(*this == other); }
+	void And(const Bitboard& other);
+	void Or(const Bitboard& other);
+	void AndNot(const Bitboard& other);
+	void Invert();
+
+	// Calls function(x, y) for every set cell, in row order
+	template <class Function>
+	void ForEachSet(Function function) const {
+		for (int y = 0; y < height; y++) {
+			const uint64_t* row = Row(y);
+			for (int i = 0; i < wordsPerRow; i++) {
+				for (uint64_t word = row[i]; word != 0; word &= word - 1) {
+					function(i * 64 + CountTrailingZeros(word), y);
+				}
+			}
+		}
+	}
+
+	// Calls function(x, y) for every cell of rows [firstRow, lastRow] that is set or has a set neighbor (8 neighbors),
+	// in row order
+	template <class Function>
+	void ForEachNear(int firstRow, int lastRow, Function function) const {
+		for (int y = firstRow; y <= lastRow; y++) {
+			const uint64_t* rows[3] = { Row(y - 1), Row(y), Row(y + 1) };
+			for (int i = 0; i < wordsPerRow; i++) {
+				uint64_t cells = 0;
+				for (const uint64_t* row : rows) {
+					cells |= row[i] | (row[i] << 1) | (row[i - 1] >> 63) | (row[i] >> 1) | (row[i + 1] << 63);
+				}
+				if (i == wordsPerRow - 1) {
+					cells &= lastWordMask;
+				}
+				for (; cells != 0; cells &= cells - 1) {
+					function(i * 64 + CountTrailingZeros(cells), y);
+				}
+			}
+		}
+	}
+
+	// Sets every cell that is set in source or has a set neighbor (8 neighbors)
+	static void Dilate(const Bitboard& source, Bitboard& result);
+
+	// Counts the set neighbors of every cell with bit-sliced adders: count = planes[0] + 2 planes[1] + 4 planes[2] + 8 planes[3]
+	static void CountNeighbors(const Bitboard& bombs, Bitboard planes[4]);
+
+	// Sets every cell of passable that is connected (8 neighbors) to a cell of seeds through passable cells
+	static void FloodFill(const Bitboard& seeds, const Bitboard& passable, Bitboard& result);
+
+	// Grows the cells set in result (on the rows [firstRow, lastRow], the other rows are clear) through the passable
+	// cells, the same as FloodFill without a pass over the whole board. firstRow and lastRow are given the rows reached
+	static void GrowRegion(const Bitboard& passable, Bitboard& result, int& firstRow, int& lastRow);
+
+	// Sets the covered cells that have a revealed neighbor
+	static void Frontier(const Bitboard& covered, const Bitboard& revealed, Bitboard& result);
+
+	// Define methods that select the AVX2 kernels (used by default when the CPU supports them)
+	static bool HasAvx2();
+	static void SetUseAvx2(bool IsEnabled);
+	static bool IsUsingAvx2();
+
+	static int CountTrailingZeros(uint64_t word);
+
+private:
+
+	void ClearRowPadding(int y);
+
+	int width = 0;
+	int height = 0;
+	int wordsPerRow = 0;
+	int paddedWordsPerRow = 0;
+	int stride = 0;
+	uint64_t lastWordMask = 0;
+	std::vector<uint64_t> words;
+};
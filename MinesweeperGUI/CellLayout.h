@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Define how the cells of a grid are laid out in memory. Each layout is a policy with the same methods, so the
+// algorithms over a grid can be templates on the layout (as they are on the board shapes of Topology.h):
+//   GetIndex gives the place of a cell in the storage, GetStorageSize the # of places (a tiled grid pads its last
+//   blocks), GetNeighbor the place of the cell dx, dy away from a cell (dx and dy from -1 to 1, the cell must be on
+//   the grid)
+// RowMajorLayout is the layout of GameBoard and the UI (index x + y * nCols). On a wide board the cells above and
+// below a cell are a whole row away in memory, so a flood fill or a view of the board reads new cache lines with
+// every row. TiledLayout stores square blocks of cells one after the other (the blocks row by row), the cells of a
+// block in Z (Morton) order, so most of the cells around a cell are in the same block, a few cache lines away. It
+// only pays off when reading views of the board: the flood fill and the solver pass of Tools/CellLayoutBenchmark.cpp
+// are slower on it than row major (the flood fill's stack already keeps it local, the solver copies blocks to rows)
+class RowMajorLayout
+{
+public:
+
+	RowMajorLayout(int nCols, int nRows) : nCols(nCols), nRows(nRows) {}
+
+	size_t GetStorageSize() const { return static_cast<size_t>(nCols) * nRows; }
+	size_t GetIndex(int xPos, int yPos) const { return xPos + static_cast<size_t>(yPos) * nCols; }
+	size_t GetNeighbor(size_t index, int, int, int dx, int dy) const { return index + dx + static_cast<ptrdiff_t>(dy) * nCols; }
+	int GetCols() const { return nCols; }
+	int GetRows() const { return nRows; }
+
+private:
+
+	int nCols;
+	int nRows;
+};
+
+// Define a tiled layout with blocks of 2^BlockShift x 2^BlockShift cells (3 for 8 x 8, 4 for 16 x 16). In the
+// Morton code of a cell inside its block the bits of x are the even bits and the bits of y the odd bits
+template <int BlockShift>
+class TiledLayout
+{
+public:
+
+	static const int BlockSide = 1 << BlockShift;
+	static const int BlockCells = BlockSide * BlockSide;
+
+	TiledLayout(int nCols, int nRows)
+		: nCols(nCols), nRows(nRows), blockCols((nCols + BlockSide - 1) >> BlockShift), blockRows((nRows + BlockSide - 1) >> BlockShift) {}
+
+	size_t GetStorageSize() const { return static_cast<size_t>(GetBlockCount()) * BlockCells; }
+	int GetBlockCount() const { return blockCols * blockRows; }
+	int GetBlockCols() const { return blockCols; }
+	int GetBlockRows() const { return blockRows; }
+	int GetCols() const { return nCols; }
+	int GetRows() const { return nRows; }
+
+	size_t GetIndex(int xPos, int yPos) const {
+		size_t block = (xPos >> BlockShift) + static_cast<size_t>(yPos >> BlockShift) * blockCols;
+		return (block << (2 * BlockShift)) | Interleave(xPos & blockMask, yPos & blockMask);
+	}
+
+	// A neighbor in the same block is stepped to from the Morton code, a neighbor in another block found from its position
+	size_t GetNeighbor(size_t index, int xPos, int yPos, int dx, int dy) const {
+		unsigned insideX = static_cast<unsigned>((xPos & blockMask) + dx);
+		unsigned insideY = static_cast<unsigned>((yPos & blockMask) + dy);
+		if ((insideX | insideY) < static_cast<unsigned>(BlockSide)) {
+			return StepInBlock(index, dx, dy);
+		}
+		return GetIndex(xPos + dx, yPos + dy);
+	}
+
+	// Returns the cell dx, dy away in the same block without a branch: the x bits and the y bits of the code are
+	// stepped on their own, the bits of the other coordinate set to 1 so the carries go through them
+	// (-1 is all of the coordinate's bits set)
+	static size_t StepInBlock(size_t index, int dx, int dy) {
+		static const size_t stepX[3] = { xBits, 0, 1 };
+		static const size_t stepY[3] = { yBits, 0, 2 };
+		size_t code = index & (BlockCells - 1);
+		size_t x = ((code | yBits) + stepX[dx + 1]) & xBits;
+		size_t y = ((code | xBits) + stepY[dy + 1]) & yBits;
+		return (index & ~static_cast<size_t>(BlockCells - 1)) | x | y;
+	}
+
+	// Copies a block (its cells in Morton order) into BlockSide rows of BlockSide cells, rowStride cells apart,
+	// so kernels written for row major cells (that the compiler vectorizes) run on it, and copies the rows back
+	template <class T>
+	static void CopyBlockToRows(const T* cells, size_t block, T* rows, size_t rowStride) {
+		const T* blockCells = cells + block * BlockCells;
+		for (int j = 0; j < BlockSide; j++) {
+			for (int i = 0; i < BlockSide; i++) {
+				rows[j * rowStride + i] = blockCells[Interleave(i, j)];
+			}
+		}
+	}
+
+	template <class T>
+	static void CopyRowsToBlock(const T* rows, size_t rowStride, T* cells, size_t block) {
+		T* blockCells = cells + block * BlockCells;
+		for (int j = 0; j < BlockSide; j++) {
+			for (int i = 0; i < BlockSide; i++) {
+				blockCells[Interleave(i, j)] = rows[j * rowStride + i];
+			}
+		}
+	}
+
+	// Returns the Morton code of a position inside a block
+	static size_t Interleave(int x, int y) {
+		return Dilate(static_cast<size_t>(x)) | (Dilate(static_cast<size_t>(y)) << 1);
+	}
+
+private:
+
+	static_assert(BlockShift >= 1 && BlockShift <= 8, "the Morton code of a block is at most 16 bits");
+
+	static const int blockMask = BlockSide - 1;
+	static const size_t xBits = 0x5555 & (BlockCells - 1);
+	static const size_t yBits = 0xAAAA & (BlockCells - 1);
+
+	// Spreads the bits of a coordinate (below 256) to the even bits
+	static size_t Dilate(size_t value) {
+		value = (value | (value << 4)) & 0x0F0F;
+		value = (value | (value << 2)) & 0x3333;
+		return (value | (value << 1)) & 0x5555;
+	}
+
+	int nCols;
+	int nRows;
+	int blockCols;
+	int blockRows;
+};
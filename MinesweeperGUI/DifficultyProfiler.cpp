@@ -0,0 +1,314 @@
+#include "DifficultyProfiler.h"
+#include <algorithm>
+#include <chrono>
+
+// Define the most threads a pool starts on its own
+static const int maxPoolThreads = 4;
+
+// Replays a board with the solver, the board's first reveal is done
+class ReplaySolver
+{
+public:
+
+	ReplaySolver(GameBoard& board, BoardProfile& profile) : board(board), profile(profile) {
+		IsQueued.assign(board.GetCellCount(), 0);
+	}
+
+	template <class Topology>
+	void Solve(Topology policy);
+
+private:
+
+	template <class Topology> void QueueChangedNumbers(Topology policy);
+	template <class Topology> void FindSubsetMoves(Topology policy);
+	template <class Topology> int GetUnknowns(int index, int* unknowns, Topology policy) const;
+	bool Guess();
+	void AddMoves(const int* cells, int count, bool IsMine);
+
+	GameBoard& board;
+	BoardProfile& profile;
+
+	// Define the moves proven in a round, and the numbers near the cells changed since the pairs were last checked
+	std::vector<uint32_t> safeCells;
+	std::vector<uint32_t> mineCells;
+	std::vector<uint32_t> queue;
+	std::vector<uint8_t> IsQueued;
+	int guessCursor = 0;
+};
+
+// Each round makes the moves of single numbers (the frontier index finds them), the moves of pairs of numbers are
+// only looked for when there are none, and a guess when there are none of either
+template <class Topology>
+void ReplaySolver::Solve(Topology policy) {
+
+	const uint8_t* visible = board.GetVisibleState();
+	int chain = 0;
+	QueueChangedNumbers(policy);
+	while (board.GetStatus() == GameBoard::Status::Playing) {
+
+		board.GetFrontier().FindSafeCells(safeCells);
+		board.GetFrontier().FindCertainMines(mineCells);
+		if (safeCells.empty() && mineCells.empty()) {
+			FindSubsetMoves(policy);
+		}
+		if (safeCells.empty() && mineCells.empty()) {
+			if (!Guess()) {
+				return;
+			}
+			QueueChangedNumbers(policy);
+			chain = 0;
+			continue;
+		}
+		chain++;
+		profile.longestChain = std::max(profile.longestChain, chain);
+
+		// A cell can be found twice by the pairs, or revealed by an opening of the same round
+		for (uint32_t index : mineCells) {
+			if (visible[index] == GameBoard::Covered) {
+				board.ToggleFlag(index % board.GetCols(), index / board.GetCols());
+				QueueChangedNumbers(policy);
+			}
+		}
+		for (uint32_t index : safeCells) {
+			if (visible[index] == GameBoard::Covered) {
+				board.Reveal(index % board.GetCols(), index / board.GetCols());
+				QueueChangedNumbers(policy);
+			}
+		}
+	}
+}
+
+// Queues the numbers next to the cells changed by the last move (their covered cells or mines left changed)
+template <class Topology>
+void ReplaySolver::QueueChangedNumbers(Topology) {
+
+	const uint8_t* visible = board.GetVisibleState();
+	auto queueNumber = [&](int index) {
+		if (visible[index] > 0 && visible[index] < GameBoard::Covered && !IsQueued[index]) {
+			IsQueued[index] = 1;
+			queue.push_back(index);
+		}
+	};
+	for (const GameBoard::CellChange& change : board.GetChanges()) {
+		queueNumber(change.index);
+		Topology::ForEachNeighbor(change.index % board.GetCols(), change.index / board.GetCols(), board.GetCols(), board.GetRows(), queueNumber);
+	}
+}
+
+// Checks each queued number against the numbers that share a covered cell with it: if the covered cells of one are
+// all around the other, the other's cells outside of them hold the difference of their mines left (none, or all)
+template <class Topology>
+void ReplaySolver::FindSubsetMoves(Topology policy) {
+
+	const FrontierIndex& frontier = board.GetFrontier();
+	const uint8_t* visible = board.GetVisibleState();
+	int unknowns[Topology::MaxNeighbors];
+	int otherUnknowns[Topology::MaxNeighbors];
+	int neighbors[Topology::MaxNeighbors];
+	int difference[Topology::MaxNeighbors];
+	int checked[Topology::MaxNeighbors * Topology::MaxNeighbors];
+
+	while (!queue.empty()) {
+		int number = queue.back();
+		queue.pop_back();
+		IsQueued[number] = 0;
+		int unknownCount = GetUnknowns(number, unknowns, policy);
+		if (unknownCount == 0) {
+			continue;
+		}
+
+		int checkedCount = 0;
+		for (int i = 0; i < unknownCount; i++) {
+			int neighborCount = Topology::GetNeighbors(unknowns[i] % board.GetCols(), unknowns[i] / board.GetCols(), board.GetCols(), board.GetRows(), neighbors);
+			for (int j = 0; j < neighborCount; j++) {
+				int other = neighbors[j];
+				if (other == number || visible[other] == 0 || visible[other] >= GameBoard::Covered ||
+					std::find(checked, checked + checkedCount, other) != checked + checkedCount) {
+					continue;
+				}
+				checked[checkedCount++] = other;
+				int otherCount = GetUnknowns(other, otherUnknowns, policy);
+
+				// The cells are listed in the order of their indices, so one list holds the other if they share as
+				// many cells as the shorter one has
+				const int* inner = unknownCount <= otherCount ? unknowns : otherUnknowns;
+				const int* outer = unknownCount <= otherCount ? otherUnknowns : unknowns;
+				int innerCount = std::min(unknownCount, otherCount);
+				int outerCount = std::max(unknownCount, otherCount);
+				int differenceCount = 0;
+				int shared = 0;
+				for (int k = 0; k < outerCount; k++) {
+					if (shared < innerCount && inner[shared] == outer[k]) {
+						shared++;
+					}
+					else {
+						difference[differenceCount++] = outer[k];
+					}
+				}
+				if (shared != innerCount || differenceCount == 0) {
+					continue;
+				}
+
+				int innerMines = frontier.GetRemainingMines(inner == unknowns ? number : other);
+				int outerMines = frontier.GetRemainingMines(inner == unknowns ? other : number);
+				if (outerMines == innerMines) {
+					AddMoves(difference, differenceCount, false);
+				}
+				else if (outerMines - innerMines == differenceCount) {
+					AddMoves(difference, differenceCount, true);
+				}
+			}
+		}
+	}
+}
+
+// Lists the covered unflagged cells around a cell in the order of their indices, returns their #
+template <class Topology>
+int ReplaySolver::GetUnknowns(int index, int* unknowns, Topology) const {
+
+	const uint8_t* visible = board.GetVisibleState();
+	int count = 0;
+	Topology::ForEachNeighbor(index % board.GetCols(), index / board.GetCols(), board.GetCols(), board.GetRows(), [&](int neighbor) {
+		if (visible[neighbor] == GameBoard::Covered) {
+			unknowns[count++] = neighbor;
+		}
+	});
+	std::sort(unknowns, unknowns + count);
+	return count;
+}
+
+// Reveals the safe cell a player is most likely to guess: one next to the revealed cells (the lowest index, so the
+// profile of a board is always the same), or any covered safe cell if every cell there is a mine. Returns false if
+// no covered cell is safe (a wrong flag, the solver is broken)
+bool ReplaySolver::Guess() {
+
+	profile.forcedGuesses++;
+	int guess = -1;
+	for (uint32_t index : board.GetFrontier().GetFrontierCells()) {
+		if (!board.IsBomb(index % board.GetCols(), index / board.GetCols()) && (guess < 0 || static_cast<int>(index) < guess)) {
+			guess = index;
+		}
+	}
+
+	// The cells before the cursor are all revealed or mines, and stay so
+	const uint8_t* visible = board.GetVisibleState();
+	for (; guess < 0 && guessCursor < board.GetCellCount(); guessCursor++) {
+		if (visible[guessCursor] == GameBoard::Covered && !board.IsBomb(guessCursor % board.GetCols(), guessCursor / board.GetCols())) {
+			guess = guessCursor;
+		}
+	}
+	if (guess < 0) {
+		return false;
+	}
+	board.Reveal(guess % board.GetCols(), guess / board.GetCols());
+	return true;
+}
+
+void ReplaySolver::AddMoves(const int* cells, int count, bool IsMine) {
+	std::vector<uint32_t>& moves = IsMine ? mineCells : safeCells;
+	moves.insert(moves.end(), cells, cells + count);
+}
+
+DifficultyProfiler::DifficultyProfiler(int threadCount) {
+
+	if (threadCount <= 0) {
+		threadCount = std::min(maxPoolThreads, std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 2));
+	}
+	for (int i = 0; i < threadCount; i++) {
+		threads.emplace_back([this]() { Run(); });
+	}
+}
+
+DifficultyProfiler::~DifficultyProfiler() {
+	Stop();
+}
+
+void DifficultyProfiler::Submit(const BoardSetup& setup, std::function<void(const BoardProfile&)> done) {
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		tasks.push_back([setup, done]() { done(Profile(setup)); });
+	}
+	taskReady.notify_one();
+}
+
+void DifficultyProfiler::ProfileSeeds(const BoardSetup& setup, int count, std::vector<BoardProfile>& profiles) {
+
+	profiles.assign(count, BoardProfile());
+	std::mutex doneMutex;
+	std::condition_variable allDone;
+	int remaining = count;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		for (int i = 0; i < count; i++) {
+			tasks.push_back([&, i]() {
+				BoardSetup seedSetup = setup;
+				seedSetup.seed = setup.seed + i;
+				profiles[i] = Profile(seedSetup);
+				std::lock_guard<std::mutex> doneLock(doneMutex);
+				if (--remaining == 0) {
+					allDone.notify_one();
+				}
+			});
+		}
+	}
+	taskReady.notify_all();
+
+	std::unique_lock<std::mutex> lock(doneMutex);
+	allDone.wait(lock, [&]() { return remaining == 0; });
+}
+
+void DifficultyProfiler::Stop() {
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		IsStopping = true;
+		tasks.clear();
+	}
+	taskReady.notify_all();
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	threads.clear();
+}
+
+// Places the bombs of the board again and replays it (on one thread, the pool already uses the others)
+BoardProfile DifficultyProfiler::Profile(const BoardSetup& setup) {
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	BoardProfile profile;
+	GameBoard board(setup.nCols, setup.nRows, setup.numberOfBombs);
+	board.SetGenerationThreads(1);
+	board.SetTopology(setup.topology);
+	board.SetFrontierTracking(true);
+	board.NewGame(setup.seed);
+	board.Reveal(setup.firstX, setup.firstY);
+	if (board.GetStatus() == GameBoard::Status::NotStarted) {
+		return profile;
+	}
+
+	profile.bbbv = board.Count3BV(&profile.openings);
+	ReplaySolver solver(board, profile);
+
+	// The board's own topology, the one of the setup is fitted to the board (a small toroidal board is standard)
+	WithTopology(board.GetTopology(), [&](auto policy) { solver.Solve(policy); });
+	profile.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	profile.IsProfiled = board.GetStatus() == GameBoard::Status::Won;
+	return profile;
+}
+
+void DifficultyProfiler::Run() {
+
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			taskReady.wait(lock, [this]() { return IsStopping || !tasks.empty(); });
+			if (IsStopping) {
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "GameBoard.h"
+
+// Measures how hard a generated board is by replaying it with a logic solver from the first reveal: the solver makes
+// every move the numbers prove (a number whose mines are all flagged, or with as many mines left as covered cells,
+// and pairs of numbers where the covered cells of one are all around the other), and when none is proven it has to
+// guess (it reveals a safe cell, as a lucky player would). The boards are placed again from their seed on a board of
+// the profiler's own, so the game being played is never touched. Boards are profiled on a small pool of threads:
+// one at a time as games start, or many seeds at once to pick boards when they are generated
+
+// Define what places the bombs of a board: its size and shape, its seed and the first cell revealed
+struct BoardSetup {
+	int nCols = 0;
+	int nRows = 0;
+	int numberOfBombs = 0;
+	TopologyType topology = TopologyType::Standard;
+	uint64_t seed = 0;
+	int firstX = 0;
+	int firstY = 0;
+};
+
+// Define the difficulty of a board: its 3BV (GameBoard::Count3BV) and openings, the guesses the solver was forced to
+// make after the first reveal, and the most rounds of proven moves it made in a row (a round makes every move the
+// board proves when it starts, so each round needs the cells the one before revealed). IsProfiled is false if the
+// replay didn't clear the board (the first reveal didn't start a game)
+struct BoardProfile {
+	int bbbv = 0;
+	int openings = 0;
+	int forcedGuesses = 0;
+	int longestChain = 0;
+	double milliseconds = 0;
+	bool IsProfiled = false;
+};
+
+class DifficultyProfiler
+{
+public:
+
+	// Define the most cells of a board profiled while it is played (a board of that size is profiled in about
+	// 150 ms, before a player makes a second move, the replay takes about 0.5 us per cell)
+	static const int MaxProfiledCells = 1 << 18;
+
+	// Starts the threads of the pool (0 uses up to 4, leaving a core to the UI and one to the engine)
+	explicit DifficultyProfiler(int threadCount = 0);
+	~DifficultyProfiler();
+
+	// Profiles a board on the pool, done(profile) is called on a thread of the pool
+	void Submit(const BoardSetup& setup, std::function<void(const BoardProfile&)> done);
+
+	// Profiles the boards of count seeds from setup.seed on, on every thread of the pool, and waits for them.
+	// profiles[i] is the profile of seed setup.seed + i
+	void ProfileSeeds(const BoardSetup& setup, int count, std::vector<BoardProfile>& profiles);
+
+	// Drops the boards waiting to be profiled and waits for the ones being profiled
+	void Stop();
+
+	// Profiles a board on the calling thread
+	static BoardProfile Profile(const BoardSetup& setup);
+
+	int GetThreadCount() const { return static_cast<int>(threads.size()); }
+
+private:
+
+	void Run();
+
+	// Define the threads of the pool, the profiles waiting for one and what they sleep on
+	std::vector<std::thread> threads;
+	std::mutex queueMutex;
+	std::condition_variable taskReady;
+	std::deque<std::function<void()>> tasks;
+	bool IsStopping = false;
+};
@@ -0,0 +1,211 @@
+#include "EngineThread.h"
+#include "AllocationCounters.h"
+#include <algorithm>
+#include <chrono>
+
+EngineThread::EngineThread(size_t queueCapacity) : commands(queueCapacity), results(ResultQueueCapacity) {
+}
+
+EngineThread::~EngineThread() {
+	Stop();
+}
+
+void EngineThread::Start(GameBoard& board, std::function<void()> notify) {
+
+	Stop();
+	this->board = &board;
+	this->notify = notify;
+	IsStopping = false;
+	IsNotifyPending = false;
+	IsSleeping = false;
+	thread = std::thread([this]() { Run(); });
+}
+
+// Stops the thread once the command it is applying is done (the placement of the bombs of a large board is cancelled).
+// Commands and results still in the queues are dropped
+void EngineThread::Stop() {
+
+	if (!thread.joinable()) {
+		return;
+	}
+	IsStopping = true;
+	board->CancelGeneration();
+	IsSleeping.store(false);
+	IsSleeping.notify_one();
+	thread.join();
+
+	Command command;
+	while (commands.TryPop(command)) {
+	}
+	DrainResults([](const Result&) {});
+}
+
+// Numbers the command and queues it, then wakes the engine thread if it is sleeping (without a lock, the UI thread
+// never waits for the engine). The fences order the push before the look at IsSleeping, and IsSleeping before the
+// engine's last look at the queue, so either the engine sees the command or this thread sees the engine sleeping
+bool EngineThread::Submit(Command command) {
+
+	command.sequence = nextSequence;
+	if (command.submitTime == 0) {
+		command.submitTime = Now();
+	}
+	if (!commands.TryPush(command)) {
+		return false;
+	}
+	nextSequence++;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (IsSleeping.load(std::memory_order_seq_cst) && IsSleeping.exchange(false)) {
+		IsSleeping.notify_one();
+	}
+	return true;
+}
+
+int64_t EngineThread::Now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Applies the commands in order, pushes their results and tells the other thread about them
+void EngineThread::Run() {
+
+	Command command;
+	while (!IsStopping) {
+
+		// With no command the engine sleeps until Submit or Stop clears IsSleeping (it looks at the queue once more
+		// after setting it, a command pushed before that isn't waited for)
+		if (!commands.TryPop(command)) {
+			IsSleeping.store(true, std::memory_order_seq_cst);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (IsStopping || !commands.IsEmpty()) {
+				IsSleeping.store(false, std::memory_order_relaxed);
+				continue;
+			}
+			IsSleeping.wait(true);
+			continue;
+		}
+
+		// The result is written in its slot of the result queue, a full queue waits for the other thread to catch up
+		Result* result = results.GetPushSlot();
+		while (result == nullptr) {
+			if (IsStopping) {
+				return;
+			}
+			std::this_thread::yield();
+			result = results.GetPushSlot();
+		}
+		Apply(command, *result);
+		results.Push();
+		if (!IsNotifyPending.exchange(true)) {
+			notify();
+		}
+	}
+}
+
+// Empties a list of a result slot, a list longer than MaxReservedCells gives its memory back (a large opening doesn't
+// keep it in the slot)
+template <class T>
+static void ClearResultList(std::vector<T>& list) {
+	if (list.capacity() > EngineThread::MaxReservedCells) {
+		std::vector<T>().swap(list);
+	}
+	list.clear();
+}
+
+// The result slot still holds an older result, its lists keep their memory
+void EngineThread::Apply(const Command& command, Result& result) {
+
+	result.command = command;
+	result.IsChanged = false;
+	ClearResultList(result.changes);
+	ClearResultList(result.mines);
+	ClearResultList(result.falseFlags);
+	std::fill(std::begin(result.regionCounts), std::end(result.regionCounts), 0);
+	result.bbbv = 0;
+	result.startTime = Now();
+	result.statusBefore = board->GetStatus();
+	uint64_t allocationsBefore = AllocationCounters::GetThreadAllocations();
+
+	switch (command.type) {
+	case CommandType::Reveal:
+		result.IsChanged = board->Reveal(command.xPos, command.yPos);
+		break;
+	case CommandType::Flag:
+		result.IsChanged = board->ToggleFlag(command.xPos, command.yPos);
+		break;
+	case CommandType::Undo:
+		result.IsChanged = board->Undo();
+		break;
+	case CommandType::Redo:
+		result.IsChanged = board->Redo();
+		break;
+	case CommandType::NewGame:
+		board->NewGame(command.seed);
+		result.IsChanged = true;
+		break;
+	case CommandType::Resize:
+		board->Resize(command.width, command.height, command.numberOfBombs);
+		board->NewGame(command.seed);
+		result.IsChanged = true;
+		break;
+	case CommandType::FindHint:
+		if (board->IsTrackingRegions()) {
+			int index = board->GetRegions().FindNearest(RegionIndex::UnflaggedMines, command.xPos, command.yPos, command.width, command.height);
+			if (index >= 0) {
+				result.mines.push_back(index);
+			}
+			break;
+		}
+		for (int i = 0; i < board->GetCols() && result.mines.empty(); i++) {
+			for (int j = 0; j < board->GetRows(); j++) {
+				if (board->IsUnflaggedBomb(i, j)) {
+					result.mines.push_back(board->GetIndex(i, j));
+					break;
+				}
+			}
+		}
+		break;
+	case CommandType::CountRegion:
+		if (board->IsTrackingRegions()) {
+			for (int layer = 0; layer < RegionIndex::LayerCount; layer++) {
+				result.regionCounts[layer] = board->GetRegions().Count(static_cast<RegionIndex::Layer>(layer), command.xPos, command.yPos, command.width, command.height);
+			}
+		}
+		break;
+	}
+
+	// The lists of the slot get room for a move on a board of this size the first time it is used for one
+	size_t reservedCells = std::min<size_t>(board->GetCellCount(), MaxReservedCells);
+	result.changes.reserve(reservedCells);
+	result.mines.reserve(reservedCells);
+	result.falseFlags.reserve(reservedCells);
+
+	// The changes list belongs to the board's last move, it is only copied for a move that changed the board
+	// (a new game on a layout changes the cells the layout reveals and flags)
+	bool IsMove = command.type != CommandType::FindHint && command.type != CommandType::CountRegion;
+	if (IsMove && result.IsChanged) {
+		result.changes.assign(board->GetChanges().begin(), board->GetChanges().end());
+	}
+	result.status = board->GetStatus();
+	result.flagsPlaced = board->GetFlagsPlaced();
+
+	// A game that ended is scored by its 3BV (for the statistics of the window)
+	bool IsOver = result.status == GameBoard::Status::Won || result.status == GameBoard::Status::Lost;
+	if (IsOver && result.status != result.statusBefore) {
+		result.bbbv = board->Count3BV();
+	}
+
+	// A lost game shows every unflagged mine and every wrong flag
+	if (result.status == GameBoard::Status::Lost && result.statusBefore != GameBoard::Status::Lost) {
+		for (int index = 0; index < board->GetCellCount(); index++) {
+			int x = index % board->GetCols();
+			int y = index / board->GetCols();
+			if (board->IsUnflaggedBomb(x, y)) {
+				result.mines.push_back(index);
+			}
+			else if (board->IsFlagged(x, y) && !board->IsBomb(x, y)) {
+				result.falseFlags.push_back(index);
+			}
+		}
+	}
+	result.allocations = AllocationCounters::GetThreadAllocations() - allocationsBefore;
+	result.endTime = Now();
+}
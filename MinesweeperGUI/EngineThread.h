@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <vector>
+#include "GameBoard.h"
+#include "SpscQueue.h"
+
+// Runs the moves of a GameBoard on a thread of its own, so the game logic never runs on the UI thread.
+// The UI thread pushes commands into a lock-free queue and gets the result of each one (the cells it changed and the
+// state of the game after it) from another lock-free queue. One thread applies the commands one at a time in the
+// order they were sent, and the results come back in that order, so the same commands always give the same results.
+// The results are written and read in place in the slots of their queue, so the lists of a result reuse the memory
+// of the results that were in its slot before.
+// While the thread runs it is the only user of the board, apart from GameBoard's methods that can be called from any
+// thread (GetGenerationProgress and CancelGeneration)
+class EngineThread
+{
+public:
+
+	enum class CommandType : uint8_t {
+		Reveal,     // reveals a cell, or chords it if it is revealed
+		Flag,
+		Undo,
+		Redo,
+		NewGame,
+		Resize,     // sizes the board (clearing a layout) and starts a new game on it
+		FindHint,   // finds an unflagged mine (the closest one to the rectangle of the command if the board tracks regions)
+		CountRegion // counts the cells of each layer of the region index in the rectangle of the command
+	};
+
+	// Define a command and the times used to measure its latency (steady clock, in nanoseconds).
+	// FindHint and CountRegion use the rectangle of cells from xPos, yPos of width x height (the cells in view),
+	// Resize sizes the board to width x height cells with numberOfBombs bombs
+	struct Command {
+		CommandType type = CommandType::Reveal;
+		int xPos = 0;
+		int yPos = 0;
+		int width = 0;
+		int height = 0;
+		int numberOfBombs = 0;
+		uint64_t seed = 0;
+		uint64_t sequence = 0;
+		int64_t submitTime = 0;
+	};
+
+	// Define the # of results that can wait for the other thread, and the longest lists a result keeps the memory of
+	// (the lists of a slot get room for the changes of a move on the board, up to that # of cells, the first time
+	// the slot is used after the board was sized)
+	static const size_t ResultQueueCapacity = 64;
+	static const size_t MaxReservedCells = 1 << 12;
+
+	// Define the result of a command, it is never changed once it has been pushed
+	struct Result {
+		Command command;
+		bool IsChanged = false;
+		GameBoard::Status statusBefore = GameBoard::Status::NotStarted;
+		GameBoard::Status status = GameBoard::Status::NotStarted;
+		int flagsPlaced = 0;
+		std::vector<GameBoard::CellChange> changes;
+
+		// Define the cells shown when the command lost the game (the unflagged mines and the wrong flags),
+		// the mine found by FindHint is in mines
+		std::vector<uint32_t> mines;
+		std::vector<uint32_t> falseFlags;
+
+		// Define the counts of CountRegion, by RegionIndex layer (0 if the board does not track regions)
+		int regionCounts[RegionIndex::LayerCount] = {};
+
+		// Define the 3BV of the board (GameBoard::Count3BV) when the command ended the game, 0 otherwise
+		int bbbv = 0;
+
+		// Define when the engine started and finished the command, and the heap allocations made on the engine
+		// thread during the command, the copy of its lists into the result included (AllocationCounters.h, 0 once
+		// every slot of the result queue has been used for the board's size, unless a list is longer than
+		// MaxReservedCells)
+		int64_t startTime = 0;
+		int64_t endTime = 0;
+		uint64_t allocations = 0;
+	};
+
+	// queueCapacity is the # of commands that can wait for the engine thread
+	explicit EngineThread(size_t queueCapacity = 1024);
+	~EngineThread();
+
+	// Starts the thread on a board set up by the caller, who must not use the board until Stop.
+	// notify is called on the engine thread when results are ready, and is not called again until DrainResults ran
+	void Start(GameBoard& board, std::function<void()> notify);
+	void Stop();
+	bool IsRunning() const { return thread.joinable(); }
+
+	// Define methods called by the thread that sends the commands (they never wait for the engine).
+	// Submit returns false if the queue is full, DrainResults calls function(result) for each result ready
+	bool Submit(Command command);
+	template <class Function>
+	void DrainResults(Function function) {
+		IsNotifyPending = false;
+		while (const Result* result = results.GetFront()) {
+			function(*result);
+			results.Pop();
+		}
+	}
+
+	// Returns the steady clock time in nanoseconds (the clock of the command and result times)
+	static int64_t Now();
+
+private:
+
+	void Run();
+	void Apply(const Command& command, Result& result);
+
+	GameBoard* board = nullptr;
+	std::function<void()> notify;
+	std::thread thread;
+	SpscQueue<Command> commands;
+	SpscQueue<Result> results;
+	uint64_t nextSequence = 0;
+	std::atomic<bool> IsStopping{ false };
+	std::atomic<bool> IsNotifyPending{ false };
+
+	// Define what the engine thread sleeps on when it has no commands: it waits on the flag itself (std::atomic::wait,
+	// C++20), so no lock is taken on either side. It sets IsSleeping before it looks at the queue a last time, and the
+	// submitting thread clears it and wakes the engine when it sees the flag after its push
+	std::atomic<bool> IsSleeping{ false };
+};
@@ -0,0 +1,155 @@
+#include "FrontierIndex.h"
+#include "VisibleCell.h"
+#include <algorithm>
+
+// Allocates the per cell data for the grid size
+void FrontierIndex::Reset(int nCols, int nRows, TopologyType topology) {
+
+	this->nCols = nCols;
+	this->nRows = nRows;
+	this->topology = topology;
+
+	size_t cellCount = static_cast<size_t>(nCols) * nRows;
+	visible.assign(cellCount, VisibleCellValues::Covered);
+	unknownNeighbors.assign(cellCount, 0);
+	flaggedNeighbors.assign(cellCount, 0);
+	revealedNeighbors.assign(cellCount, 0);
+	setOf.assign(cellCount, NoSet);
+	positionInSet.assign(cellCount, 0);
+	IsListed.assign(cellCount, 0);
+
+	// Reserve the worst case for the lists so that keeping them up to date does not allocate
+	for (std::vector<uint32_t>& set : sets) {
+		set.reserve(cellCount);
+	}
+	Clear();
+}
+
+// Covers every cell again (a new game on the same grid): every neighbor of every cell is unknown
+void FrontierIndex::Clear() {
+	WithTopology(topology, [this](auto policy) { Clear(policy); });
+}
+
+template <class Topology>
+void FrontierIndex::Clear(Topology) {
+
+	std::fill(visible.begin(), visible.end(), VisibleCellValues::Covered);
+	std::fill(flaggedNeighbors.begin(), flaggedNeighbors.end(), 0);
+	std::fill(revealedNeighbors.begin(), revealedNeighbors.end(), 0);
+	std::fill(setOf.begin(), setOf.end(), static_cast<uint8_t>(NoSet));
+	for (std::vector<uint32_t>& set : sets) {
+		set.clear();
+	}
+
+	int neighbors[Topology::MaxNeighbors];
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			unknownNeighbors[x + static_cast<size_t>(y) * nCols] = static_cast<uint8_t>(Topology::GetNeighbors(x, y, nCols, nRows, neighbors));
+		}
+	}
+}
+
+// Frees the per cell data (the index is no longer kept up to date)
+void FrontierIndex::Free() {
+
+	*this = FrontierIndex();
+}
+
+void FrontierIndex::Update(int index, uint8_t value) {
+	WithTopology(topology, [&](auto policy) { Update(index, value, policy); });
+}
+
+template <class Topology>
+void FrontierIndex::Update(int index, uint8_t value, Topology) {
+
+	uint8_t previous = visible[index];
+	if (value == previous) {
+		return;
+	}
+	visible[index] = value;
+
+	// The neighbors count the cell as unknown, flagged or revealed
+	uint8_t unknownChange = static_cast<uint8_t>((value == VisibleCellValues::Covered) - (previous == VisibleCellValues::Covered));
+	uint8_t flaggedChange = static_cast<uint8_t>((value == VisibleCellValues::Flagged) - (previous == VisibleCellValues::Flagged));
+	uint8_t revealedChange = static_cast<uint8_t>((value < VisibleCellValues::Covered) - (previous < VisibleCellValues::Covered));
+
+	Topology::ForEachNeighbor(index % nCols, index / nCols, nCols, nRows, [&](int newIndex) {
+		unknownNeighbors[newIndex] += unknownChange;
+		flaggedNeighbors[newIndex] += flaggedChange;
+		revealedNeighbors[newIndex] += revealedChange;
+		Classify(newIndex);
+	});
+	Classify(index);
+}
+
+// Puts a cell in the list it belongs in from its value and counts
+void FrontierIndex::Classify(int index) {
+
+	uint8_t value = visible[index];
+	SetId set = NoSet;
+	if (value == VisibleCellValues::Covered) {
+		if (revealedNeighbors[index] > 0) {
+			set = FrontierSet;
+		}
+	}
+	else if (value < VisibleCellValues::Covered && unknownNeighbors[index] > 0) {
+		int remainingMines = GetRemainingMines(index);
+		if (remainingMines == 0) {
+			set = SatisfiedSet;
+		}
+		else if (remainingMines == unknownNeighbors[index]) {
+			set = SaturatedSet;
+		}
+	}
+
+	if (set != setOf[index]) {
+		Move(index, set);
+	}
+}
+
+// Moves a cell from its list to another one. It is taken out of its list by moving the last cell of the list into its place
+void FrontierIndex::Move(int index, SetId set) {
+
+	if (setOf[index] != NoSet) {
+		std::vector<uint32_t>& from = sets[setOf[index]];
+		uint32_t last = from.back();
+		from[positionInSet[index]] = last;
+		positionInSet[last] = positionInSet[index];
+		from.pop_back();
+	}
+
+	if (set != NoSet) {
+		positionInSet[index] = static_cast<uint32_t>(sets[set].size());
+		sets[set].push_back(index);
+	}
+	setOf[index] = set;
+}
+
+void FrontierIndex::FindSafeCells(std::vector<uint32_t>& cells) const {
+	cells.clear();
+	WithTopology(topology, [&](auto policy) { CollectNeighbors(sets[SatisfiedSet], cells, policy); });
+}
+
+void FrontierIndex::FindCertainMines(std::vector<uint32_t>& cells) const {
+	cells.clear();
+	WithTopology(topology, [&](auto policy) { CollectNeighbors(sets[SaturatedSet], cells, policy); });
+}
+
+// Lists the unknown neighbors of the numbers. Every number in the lists has at least one unknown neighbor,
+// and a cell has 8 neighbors at most, so this visits at most 8 numbers per cell found
+template <class Topology>
+void FrontierIndex::CollectNeighbors(const std::vector<uint32_t>& numbers, std::vector<uint32_t>& cells, Topology) const {
+
+	for (uint32_t number : numbers) {
+		Topology::ForEachNeighbor(static_cast<int>(number) % nCols, static_cast<int>(number) / nCols, nCols, nRows, [&](int newIndex) {
+			if (visible[newIndex] == VisibleCellValues::Covered && !IsListed[newIndex]) {
+				IsListed[newIndex] = 1;
+				cells.push_back(newIndex);
+			}
+		});
+	}
+
+	for (uint32_t cell : cells) {
+		IsListed[cell] = 0;
+	}
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "Topology.h"
+
+// Keeps the boundary between the revealed and covered cells of a board up to date from the cells each move changes,
+// so assistance logic never has to scan the whole board. Only what the player can see is used (a GameBoard visible
+// value per cell), so flags are trusted: a number counts its flagged neighbors as found mines.
+//
+// For every revealed number it keeps the # of covered unflagged neighbors (unknowns) and the # of mines left
+// (its number minus its flagged neighbors). The numbers whose mines are all flagged (their unknowns are safe) and the
+// numbers with as many mines left as unknowns (their unknowns are mines) are kept in lists, as are the covered
+// unflagged cells next to a revealed cell (the frontier). Each changed cell updates itself and its neighbors
+// (8 at most, which cells are neighbors depends on the board's topology)
+class FrontierIndex
+{
+public:
+
+	// Define methods used to set up the index (every cell starts covered)
+	void Reset(int nCols, int nRows, TopologyType topology = TopologyType::Standard);
+	void Clear();
+	void Free();
+
+	// Updates the index for a cell whose visible value changed (a GameBoard visible value)
+	void Update(int index, uint8_t visible);
+
+	// Define methods that give the lists kept up to date (indices in no particular order)
+	const std::vector<uint32_t>& GetFrontierCells() const { return sets[FrontierSet]; }
+	const std::vector<uint32_t>& GetSatisfiedNumbers() const { return sets[SatisfiedSet]; }
+	const std::vector<uint32_t>& GetSaturatedNumbers() const { return sets[SaturatedSet]; }
+
+	// Define methods that give the counts of a revealed cell
+	int GetUnknownCount(int index) const { return unknownNeighbors[index]; }
+	int GetRemainingMines(int index) const { return static_cast<int>(visible[index]) - flaggedNeighbors[index]; }
+
+	// Finds the covered unflagged cells that are trivially safe (next to a number with all of its mines flagged)
+	// or trivially mines (next to a number with as many mines left as unknowns). Each cell is listed once,
+	// the cost is proportional to the # of cells found
+	void FindSafeCells(std::vector<uint32_t>& cells) const;
+	void FindCertainMines(std::vector<uint32_t>& cells) const;
+
+	bool IsAllocated() const { return !visible.empty(); }
+
+private:
+
+	// Define the lists a cell can be in (a cell is in one list at most: covered cells can only be on the frontier,
+	// and a number can't have all of its mines flagged and mines left at the same time)
+	enum SetId : uint8_t {
+		FrontierSet,
+		SatisfiedSet,
+		SaturatedSet,
+		SetCount,
+		NoSet = SetCount
+	};
+
+	template <class Topology> void Clear(Topology policy);
+	template <class Topology> void Update(int index, uint8_t value, Topology policy);
+	template <class Topology> void CollectNeighbors(const std::vector<uint32_t>& numbers, std::vector<uint32_t>& cells, Topology policy) const;
+	void Classify(int index);
+	void Move(int index, SetId set);
+
+	int nCols = 0;
+	int nRows = 0;
+	TopologyType topology = TopologyType::Standard;
+
+	// Define per cell data (indexed by x + y * nCols): the visible value, the # of neighbors that are covered
+	// and unflagged, flagged, and revealed, and the list the cell is in and its position in that list
+	std::vector<uint8_t> visible;
+	std::vector<uint8_t> unknownNeighbors;
+	std::vector<uint8_t> flaggedNeighbors;
+	std::vector<uint8_t> revealedNeighbors;
+	std::vector<uint8_t> setOf;
+	std::vector<uint32_t> positionInSet;
+	std::vector<uint32_t> sets[SetCount];
+
+	// Define the marks used to list each cell found by a query once (cleared after every query)
+	mutable std::vector<uint8_t> IsListed;
+};
@@ -0,0 +1,1124 @@
+#include "GameBoard.h"
+#include <algorithm>
+#include <thread>
+
+// Define the memory used by the undo history in training mode (4 MB of cell ranges, 65536 moves)
+static const size_t journalWords = 1 << 20;
+static const size_t journalMoves = 1 << 16;
+
+// Define the bytes added to the arena for the alignment of its buffers
+static const size_t arenaSlack = 256;
+
+// Define the # of cells in each stripe of rows handed to a generation thread, and the # of buckets
+// used to find the random number below which cells get a bomb
+static const int generationStripeCells = 1 << 16;
+static const int generationBuckets = 1 << 16;
+
+// Define the # of rows worth of cells a flood fill of a large standard board clears one at a time before it checks
+// if the area is dense enough for the bit planes (which sweep whole rows, so they only pay off for areas that cover
+// a quarter of their rows or more), the check is made again each time the area doubles
+static const int floodBudgetRows = 16;
+
+// Creates an empty board, Resize must be called before a game can be played
+GameBoard::GameBoard() {
+}
+
+// Creates a board with the given grid size and # of bombs and starts a new game
+GameBoard::GameBoard(int nCols, int nRows, int numberOfBombs) {
+	Resize(nCols, nRows, numberOfBombs);
+	NewGame(0);
+}
+
+// Allocates all per cell data for the given grid size in one block of the arena (the only place gameplay memory
+// is allocated, apart from the buffers used to place the bombs of large boards on several threads and the bit planes
+// of their flood fill)
+void GameBoard::Resize(int nCols, int nRows, int numberOfBombs) {
+
+	this->nCols = nCols;
+	this->nRows = nRows;
+	this->numberOfBombs = numberOfBombs;
+	IsLayoutFixed = false;
+	topology = FitTopology(chosenTopology, nCols, nRows);
+
+	// The buffers of the last grid size are given back before the arena is rewound. The block holds the worst case
+	// of every buffer, including the training mode history and the assist queue that may be turned on later
+	ReleaseArenaVector(cellFlags);
+	ReleaseArenaVector(bombsSurrounding);
+	ReleaseArenaVector(visible);
+	ReleaseArenaVector(changes);
+	ReleaseArenaVector(possibleCoordinates);
+	ReleaseArenaVector(floodStack);
+	ReleaseArenaVector(journalIndices);
+	ReleaseArenaVector(assistQueue);
+
+	int cellCount = GetCellCount();
+	size_t bytesPerCell = 3 * sizeof(uint8_t) + sizeof(CellChange) + (IsLargeBoard() ? 3 : 4) * sizeof(uint32_t);
+	arena.Reset(cellCount * bytesPerCell + arenaSlack);
+
+	cellFlags.assign(cellCount, 0);
+	bombsSurrounding.assign(cellCount, 0);
+	visible.assign(cellCount, Covered);
+
+	// Reserve the worst case for the buffers used during gameplay
+	changes.clear();
+	changes.reserve(cellCount);
+	possibleCoordinates.clear();
+	possibleCoordinates.reserve(IsLargeBoard() ? 0 : cellCount);
+	floodStack.clear();
+	floodStack.reserve(cellCount);
+	if (IsTrainingMode) {
+		journalIndices.reserve(cellCount);
+	}
+	if (assistModes != 0) {
+		assistQueue.reserve(cellCount);
+	}
+	if (IsFrontierTracked) {
+		frontier.Reset(nCols, nRows, topology);
+	}
+	if (IsRegionTracked) {
+		regions.Reset(nCols, nRows);
+	}
+	openCells.Resize(IsLargeBoard() ? nCols : 0, IsLargeBoard() ? nRows : 0);
+	floodRegion.Resize(IsLargeBoard() ? nCols : 0, IsLargeBoard() ? nRows : 0);
+
+	NewGame(seed);
+}
+
+void GameBoard::SetTopology(TopologyType topology) {
+
+	chosenTopology = topology;
+	this->topology = FitTopology(topology, nCols, nRows);
+	if (IsFrontierTracked) {
+		frontier.Reset(nCols, nRows, this->topology);
+	}
+	if (IsLayoutFixed) {
+		CountAllBombs();
+	}
+	NewGame(seed);
+}
+
+// Sizes the board for a layout, every cell starts without a bomb (the seed is kept, it isn't used by a layout)
+void GameBoard::BeginLayout(int nCols, int nRows) {
+	Resize(nCols, nRows, 0);
+}
+
+// Adds the cells of a row of the layout (LayoutCell bits) to the ones added before
+void GameBoard::AddLayoutRow(int yPos, const uint8_t* cells) {
+
+	uint8_t* flags = &cellFlags[GetIndex(0, yPos)];
+	uint8_t* shown = &visible[GetIndex(0, yPos)];
+	for (int x = 0; x < nCols; x++) {
+		uint8_t cell = cells[x];
+		flags[x] |= (cell & LayoutMine ? BombBit : 0) | (cell & LayoutRevealed ? LayoutRevealedBit : 0) | (cell & LayoutFlagged ? LayoutFlaggedBit : 0);
+
+		// The numbers to check are kept in the visible state until the layout is finished
+		if (cell >> LayoutNumberShift) {
+			shown[x] = static_cast<uint8_t>((cell >> LayoutNumberShift) - 1);
+		}
+	}
+}
+
+// Counts the bombs of the layout and checks its revealed cells, then starts a game on it
+bool GameBoard::FinishLayout(std::string& error) {
+
+	CountAllBombs();
+
+	int bombCount = 0;
+	for (int index = 0; index < GetCellCount() && error.empty(); index++) {
+		uint8_t flags = cellFlags[index];
+		bombCount += flags & BombBit;
+		if (!(flags & LayoutRevealedBit)) {
+			continue;
+		}
+
+		// A revealed cell can't hold a mine or a flag, and must show the # of mines around it
+		int xPos = index % nCols;
+		int yPos = index / nCols;
+		if (flags & (BombBit | LayoutFlaggedBit)) {
+			error = "cell " + std::to_string(xPos) + ", " + std::to_string(yPos) + " is revealed but holds " + (flags & BombBit ? "a mine" : "a flag");
+		}
+		else if (visible[index] != Covered && visible[index] != bombsSurrounding[index]) {
+			error = "cell " + std::to_string(xPos) + ", " + std::to_string(yPos) + " shows " + std::to_string(visible[index]) + " but has "
+				+ std::to_string(bombsSurrounding[index]) + " mines around it";
+		}
+	}
+
+	if (!error.empty()) {
+		numberOfBombs = 0;
+		NewGame(seed);
+		return false;
+	}
+	numberOfBombs = bombCount;
+	IsLayoutFixed = true;
+	NewGame(seed);
+	return true;
+}
+
+// Restart the game with the same grid size and # of bombs,
+// bombs are placed using the seed when the first cell is revealed
+void GameBoard::NewGame(uint64_t seed) {
+
+	this->seed = seed;
+
+	// Set all of the cells to their default state (a layout keeps its bombs and the cells it reveals and flags)
+	if (IsLayoutFixed) {
+		for (uint8_t& flags : cellFlags) {
+			flags &= BombBit | LayoutRevealedBit | LayoutFlaggedBit;
+		}
+	}
+	else {
+		std::fill(cellFlags.begin(), cellFlags.end(), 0);
+		std::fill(bombsSurrounding.begin(), bombsSurrounding.end(), 0);
+	}
+	std::fill(visible.begin(), visible.end(), static_cast<uint8_t>(Covered));
+	changes.clear();
+	journal.Clear();
+	HasOpenCells = false;
+	if (IsFrontierTracked) {
+		frontier.Clear();
+	}
+	if (IsRegionTracked) {
+		regions.Clear();
+	}
+	generationStepsDone = 0;
+	generationStepCount = 0;
+	IsGenerationCancelled = false;
+
+	// Reset variables for game beginning
+	status = Status::NotStarted;
+	numberFlagsPlaced = 0;
+	coveredSafeCells = GetCellCount() - numberOfBombs;
+	HasFlaggedBeforeFirstClick = false;
+
+	if (IsLayoutFixed) {
+		StartLayoutGame();
+	}
+}
+
+// Starts a game on the layout: the bombs are in place, so the game is on before the first reveal. The cells the
+// layout reveals and flags are the changes of the new game
+void GameBoard::StartLayoutGame() {
+
+	status = Status::Playing;
+	if (IsRegionTracked) {
+		regions.Build(visible.data(), [this](int index) { return (cellFlags[index] & BombBit) != 0; });
+	}
+	for (int index = 0; index < GetCellCount(); index++) {
+		if (cellFlags[index] & LayoutFlaggedBit) {
+			FlipFlag(index);
+		}
+		if (cellFlags[index] & LayoutRevealedBit) {
+			ClearCell(index);
+		}
+	}
+	if (coveredSafeCells == 0) {
+		status = Status::Won;
+	}
+}
+
+// Reveals a cell: places the bombs on the first reveal, clears empty areas,
+// chords if the cell is already revealed, and ends the game if a bomb is revealed
+bool GameBoard::Reveal(int xPos, int yPos) {
+
+	if (!IsInGridIndex(xPos, yPos) || status == Status::Won || status == Status::Lost) {
+		return false;
+	}
+
+	// A revealed cell is chorded (same as clicking a numbered cell in the GUI)
+	if (IsCleared(xPos, yPos)) {
+		return Chord(xPos, yPos);
+	}
+
+	changes.clear();
+	Status previousStatus = status;
+
+	// Handles first reveal: the first cell revealed can never be a bomb
+	if (status == Status::NotStarted) {
+
+		// the history starts once the bombs are placed
+		journal.Clear();
+
+		// the bombs are placed first, so a cancelled placement leaves the board as it was
+		if (!WithTopology(topology, [&](auto policy) { return PlaceBombs(xPos, yPos, policy); })) {
+			return false;
+		}
+		if (IsRegionTracked) {
+			regions.Build(visible.data(), [this](int index) { return (cellFlags[index] & BombBit) != 0; });
+		}
+
+		// if flags were placed before the first reveal, the board is reset first
+		if (HasFlaggedBeforeFirstClick) {
+			ClearFlagsBeforeFirstClick();
+		}
+
+		status = Status::Playing;
+		WithTopology(topology, [&](auto policy) { ClearEmpty(xPos, yPos, policy); });
+	}
+	// Cell revealed is a bomb and not flagged, the game is lost
+	else if (IsUnflaggedBomb(xPos, yPos)) {
+		status = Status::Lost;
+	}
+	// Flagged cells cannot be revealed
+	else if (!IsFlagged(xPos, yPos)) {
+		WithTopology(topology, [&](auto policy) { ClearEmpty(xPos, yPos, policy); });
+	}
+
+	// Check for victory (all non-bomb cells are cleared)
+	if (status == Status::Playing && coveredSafeCells == 0) {
+		status = Status::Won;
+	}
+
+	bool IsChanged = !changes.empty() || status != previousStatus;
+	if (IsChanged) {
+		FinishMove(RevealMove, previousStatus);
+	}
+
+	return IsChanged;
+}
+
+// Sets a flag on a covered cell, or removes it if the cell is already flagged
+bool GameBoard::ToggleFlag(int xPos, int yPos) {
+
+	if (!IsInGridIndex(xPos, yPos) || status == Status::Won || status == Status::Lost) {
+		return false;
+	}
+
+	// Ensure that flags can't be placed on a revealed cell
+	if (IsCleared(xPos, yPos)) {
+		return false;
+	}
+
+	changes.clear();
+	FlipFlag(GetIndex(xPos, yPos));
+
+	if (status == Status::NotStarted) {
+		HasFlaggedBeforeFirstClick = true;
+	}
+	else {
+		FinishMove(FlagMove, status);
+	}
+
+	return true;
+}
+
+// Clears the cells around a numbered cell if the number of flags surrounding it equals its number.
+// This doesn't check if the flags were placed correctly,
+// so if a flag is wrong and a bomb is in the surrounding cells, the game is lost
+bool GameBoard::Chord(int xPos, int yPos) {
+
+	if (!IsInGridIndex(xPos, yPos) || status != Status::Playing || !IsCleared(xPos, yPos)) {
+		return false;
+	}
+
+	changes.clear();
+	return WithTopology(topology, [&](auto policy) { return Chord(xPos, yPos, policy); });
+}
+
+template <class Topology>
+bool GameBoard::Chord(int xPos, int yPos, Topology policy) {
+
+	if (CountFlagsSurrounding(xPos, yPos, policy) != CountBombsSurrounding(xPos, yPos)) {
+		return false;
+	}
+	ClearAround(xPos, yPos, policy);
+
+	bool IsChanged = !changes.empty() || status != Status::Playing;
+	if (IsChanged) {
+		FinishMove(RevealMove, Status::Playing);
+	}
+
+	return IsChanged;
+}
+
+// Reveals the unflagged cells around a cell (the chord of a number whose flags are all placed)
+template <class Topology>
+void GameBoard::ClearAround(int xPos, int yPos, Topology policy) {
+
+	// Iterate through the surrounding cells (until the game is lost or won)
+	int neighbors[Topology::MaxNeighbors];
+	int neighborCount = Topology::GetNeighbors(xPos, yPos, nCols, nRows, neighbors);
+	for (int i = 0; i < neighborCount && status == Status::Playing; i++) {
+		int newX = neighbors[i] % nCols;
+		int newY = neighbors[i] / nCols;
+
+		// check if current surrounding cell is a bomb, the game is lost
+		if (IsUnflaggedBomb(newX, newY)) {
+			status = Status::Lost;
+		}
+		// Ensure that flagged cells are not revealed
+		else if (!IsFlagged(newX, newY)) {
+			ClearEmpty(newX, newY, policy);
+
+			// check for victory
+			if (coveredSafeCells == 0) {
+				status = Status::Won;
+			}
+		}
+	}
+}
+
+// Applies the moves the assist modes force after a move that changed the board, and records the move in training
+// mode (the first reveal starts the history, it isn't recorded). The assist's flags and its reveals are recorded as
+// two moves after the move, so its flags are placed again before its reveals (a flag kept on a cell the assist
+// revealed shows the cell's number)
+void GameBoard::FinishMove(MoveType type, Status statusBefore) {
+
+	size_t moveChanges = changes.size();
+	Status statusAfterMove = status;
+	if (assistModes != 0 && status == Status::Playing) {
+		WithTopology(topology, [&](auto policy) { RunAssist(policy); });
+	}
+
+	if (!IsTrainingMode || statusBefore == Status::NotStarted) {
+		return;
+	}
+	RecordMove(type, statusBefore, statusAfterMove, 0, moveChanges);
+	RecordMove(AssistFlagMove, statusAfterMove, statusAfterMove, moveChanges, changes.size());
+	RecordMove(AssistRevealMove, statusAfterMove, status, moveChanges, changes.size());
+}
+
+// Checks the numbers around the cells changed by the move (the changes list is read as it grows, so the cells the
+// assist changes queue the numbers around them too). Each number is queued once until it is checked, so a move
+// costs time in proportion to the cells it changed, not to the size of the board
+template <class Topology>
+void GameBoard::RunAssist(Topology policy) {
+
+	size_t nextChange = 0;
+	assistQueue.clear();
+	while (status == Status::Playing) {
+
+		for (; nextChange < changes.size(); nextChange++) {
+			int index = changes[nextChange].index;
+			QueueForAssist(index);
+			Topology::ForEachNeighbor(index % nCols, index / nCols, nCols, nRows, [this](int neighbor) { QueueForAssist(neighbor); });
+		}
+		if (assistQueue.empty()) {
+			break;
+		}
+		int number = assistQueue.back();
+		assistQueue.pop_back();
+		cellFlags[number] &= ~QueuedBit;
+
+		// Count the flags and the covered unflagged cells around the number, as the player sees them (a flag kept on a
+		// revealed cell isn't a mine)
+		int xPos = number % nCols;
+		int yPos = number / nCols;
+		int flags = 0;
+		int unknowns = 0;
+		Topology::ForEachNeighbor(xPos, yPos, nCols, nRows, [&](int neighbor) {
+			if ((cellFlags[neighbor] & ClearedBit) == 0) {
+				if (cellFlags[neighbor] & FlaggedBit) {
+					flags++;
+				}
+				else {
+					unknowns++;
+				}
+			}
+		});
+
+		int mines = bombsSurrounding[number];
+		if (unknowns == 0) {
+			continue;
+		}
+		if ((assistModes & AutoFlag) && flags + unknowns == mines) {
+			Topology::ForEachNeighbor(xPos, yPos, nCols, nRows, [this](int neighbor) {
+				if ((cellFlags[neighbor] & (FlaggedBit | ClearedBit)) == 0) {
+					FlipFlag(neighbor);
+				}
+			});
+		}
+		else if ((assistModes & AutoChord) && flags == mines) {
+			ClearAround(xPos, yPos, policy);
+		}
+	}
+
+	// A game that ended leaves numbers in the queue
+	for (uint32_t index : assistQueue) {
+		cellFlags[index] &= ~QueuedBit;
+	}
+	assistQueue.clear();
+}
+
+// Queues a revealed number for the assist to check
+void GameBoard::QueueForAssist(int index) {
+	if ((cellFlags[index] & (ClearedBit | QueuedBit)) == ClearedBit && bombsSurrounding[index] != 0) {
+		cellFlags[index] |= QueuedBit;
+		assistQueue.push_back(index);
+	}
+}
+
+// Turns the assist modes on or off, the assist queue is only allocated while one is on
+void GameBoard::SetAssistModes(uint8_t modes) {
+
+	assistModes = modes;
+	if (assistModes != 0) {
+		assistQueue.reserve(GetCellCount());
+	}
+}
+
+// Turns training mode on or off, the undo history is only kept (and its memory only allocated) in training mode
+void GameBoard::SetTrainingMode(bool IsEnabled) {
+
+	IsTrainingMode = IsEnabled;
+	if (IsTrainingMode) {
+		journal.Reset(journalWords, journalMoves);
+		journalIndices.reserve(GetCellCount());
+	}
+	else {
+		journal.Reset(0, 0);
+	}
+}
+
+// Turns the frontier index on or off. Turned on during a game, it is built from the cells visible so far
+void GameBoard::SetFrontierTracking(bool IsEnabled) {
+
+	IsFrontierTracked = IsEnabled;
+	if (IsFrontierTracked) {
+		frontier.Reset(nCols, nRows, topology);
+		for (int index = 0; index < GetCellCount(); index++) {
+			frontier.Update(index, visible[index]);
+		}
+	}
+	else {
+		frontier.Free();
+	}
+}
+
+// Turns the region index on or off. Turned on during a game, it is built from the board as it is
+void GameBoard::SetRegionTracking(bool IsEnabled) {
+
+	IsRegionTracked = IsEnabled;
+	if (IsRegionTracked) {
+		regions.Reset(nCols, nRows);
+		regions.Build(visible.data(), [this](int index) { return (cellFlags[index] & BombBit) != 0; });
+	}
+	else {
+		regions.Free();
+	}
+}
+
+// Undoes the last move: its revealed cells are covered again, or its flag is toggled back
+bool GameBoard::Undo() {
+
+	const MoveJournal::Move* move = IsTrainingMode ? journal.StepBack() : nullptr;
+	if (move == nullptr) {
+		return false;
+	}
+
+	// The assist's moves are undone with the move that set them off
+	changes.clear();
+	UndoCells(*move);
+	while ((move->type == AssistFlagMove || move->type == AssistRevealMove) && journal.CanUndo()) {
+		move = journal.StepBack();
+		UndoCells(*move);
+	}
+	status = static_cast<Status>(move->statusBefore);
+
+	return true;
+}
+
+// Applies the last undone move again
+bool GameBoard::Redo() {
+
+	const MoveJournal::Move* move = IsTrainingMode ? journal.StepForward() : nullptr;
+	if (move == nullptr) {
+		return false;
+	}
+
+	// The assist's moves are redone with the move that set them off
+	changes.clear();
+	RedoCells(*move);
+	const MoveJournal::Move* next = journal.PeekForward();
+	while (next != nullptr && (next->type == AssistFlagMove || next->type == AssistRevealMove)) {
+		move = journal.StepForward();
+		RedoCells(*move);
+		next = journal.PeekForward();
+	}
+	status = static_cast<Status>(move->statusAfter);
+
+	return true;
+}
+
+// Covers the cells a move revealed again, or toggles back the flags it toggled
+void GameBoard::UndoCells(const MoveJournal::Move& move) {
+	if (move.type == FlagMove || move.type == AssistFlagMove) {
+		journal.ForEachCell(move, [this](uint32_t index) { FlipFlag(index); });
+	}
+	else {
+		journal.ForEachCell(move, [this](uint32_t index) { CoverCell(index); UpdateOpenCell(index); });
+	}
+}
+
+void GameBoard::RedoCells(const MoveJournal::Move& move) {
+	if (move.type == FlagMove || move.type == AssistFlagMove) {
+		journal.ForEachCell(move, [this](uint32_t index) { FlipFlag(index); });
+	}
+	else {
+		journal.ForEachCell(move, [this](uint32_t index) { ClearCell(index); UpdateOpenCell(index); });
+	}
+}
+
+// Returns how much of the bomb placement is done (0 - 1), can be called from any thread
+double GameBoard::GetGenerationProgress() const {
+	int stepCount = generationStepCount;
+	return stepCount > 0 ? std::min(1.0, static_cast<double>(generationStepsDone) / stepCount) : 0.0;
+}
+
+// Places bombs at random coordinates (not on the first revealed cell or its neighbors, the 3x3 area around it
+// on a standard board). Returns false if the placement was cancelled (only large boards can be cancelled)
+template <class Topology>
+bool GameBoard::PlaceBombs(int xPos, int yPos, Topology policy) {
+
+	generationStepsDone = 0;
+	if (IsLargeBoard()) {
+		return PlaceBombsInParallel(xPos, yPos, policy);
+	}
+	generationStepCount = 1;
+
+	// Save all coordinates outside of the area around the first revealed cell,
+	// in the same order as the grid is created so a seed always gives the same board
+	possibleCoordinates.clear();
+	for (int i = 0; i < nCols; i++) {
+		for (int j = 0; j < nRows; j++) {
+			if (!Topology::IsNearCell(i, j, xPos, yPos, nCols, nRows)) {
+				possibleCoordinates.push_back(GetIndex(i, j));
+			}
+		}
+	}
+
+	// Randomize the order of the first numberOfBombs coordinates (partial Fisher-Yates shuffle),
+	// splitmix64 is used so a seed gives the same board with every compiler
+	int bombsToPlace = std::min(numberOfBombs, static_cast<int>(possibleCoordinates.size()));
+	uint64_t state = seed;
+	for (int i = 0; i < bombsToPlace; i++) {
+		uint64_t remaining = possibleCoordinates.size() - i;
+		int j = i + static_cast<int>(RandomBelow(state, remaining));
+		std::swap(possibleCoordinates[i], possibleCoordinates[j]);
+	}
+
+	// Place bombs at the first numberOfBombs coordinates, and count them for their neighbors
+	for (int i = 0; i < bombsToPlace; i++) {
+		int index = possibleCoordinates[i];
+		cellFlags[index] |= BombBit;
+
+		Topology::ForEachNeighbor(index % nCols, index / nCols, nCols, nRows, [this](int neighbor) { bombsSurrounding[neighbor]++; });
+	}
+
+	coveredSafeCells = GetCellCount() - bombsToPlace;
+	generationStepsDone = 1;
+	return true;
+}
+
+// Runs function(threadIndex, stripe) for every stripe of rows, on threadCount threads (the caller is one of them).
+// Stripes are handed out one at a time, so which thread runs a stripe never changes the result
+template <class Function>
+static void ForEachStripe(int threadCount, int stripeCount, Function function) {
+
+	std::atomic<int> nextStripe(0);
+	auto worker = [&](int threadIndex) {
+		for (int stripe = nextStripe++; stripe < stripeCount; stripe = nextStripe++) {
+			function(threadIndex, stripe);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadCount; i++) {
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+}
+
+// Places the bombs of a large board on several threads, each working on stripes of rows.
+// Every cell gets a counter-based random number from the seed and its index, and the bombs are placed on the
+// numberOfBombs cells with the lowest numbers (a uniformly random set of cells, whatever the # of threads):
+//   1. each thread counts the numbers of its stripes in buckets (by their top 16 bits), which gives the bucket
+//      holding the highest number that gets a bomb
+//   2. cells in lower buckets get a bomb, the few cells in that bucket are sorted to place the rest
+//   3. each thread counts the bombs surrounding the cells of its stripes
+template <class Topology>
+bool GameBoard::PlaceBombsInParallel(int xPos, int yPos, Topology policy) {
+
+	int rowsPerStripe = std::max(1, generationStripeCells / nCols);
+	int stripeCount = (nRows + rowsPerStripe - 1) / rowsPerStripe;
+	int threadCount = generationThreads > 0 ? generationThreads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	threadCount = std::min(threadCount, stripeCount);
+	generationStepCount = 3 * stripeCount;
+
+	// The first revealed cell and its neighbors never get a bomb
+	int neighbors[Topology::MaxNeighbors];
+	int possibleCount = GetCellCount() - 1 - Topology::GetNeighbors(xPos, yPos, nCols, nRows, neighbors);
+	int bombsToPlace = std::min(numberOfBombs, possibleCount);
+
+	// Calls function(index, randomNumber) for every cell of a stripe that can get a bomb
+	auto ForEachPossibleCell = [&](int stripe, auto function) {
+		int stripeEnd = std::min((stripe + 1) * rowsPerStripe, nRows);
+		for (int y = stripe * rowsPerStripe; y < stripeEnd; y++) {
+			bool IsNearFirstCell = Topology::IsNearRow(y, yPos, nRows);
+			for (int x = 0; x < nCols; x++) {
+				if (IsNearFirstCell && Topology::IsNearCell(x, y, xPos, yPos, nCols, nRows)) {
+					continue;
+				}
+				int index = GetIndex(x, y);
+				function(index, RandomAt(seed, index));
+			}
+		}
+	};
+
+	// 1. Count the random numbers in buckets, on each thread, then find the bucket of the last bomb
+	std::vector<std::vector<uint32_t>> histograms(threadCount, std::vector<uint32_t>(generationBuckets, 0));
+	ForEachStripe(threadCount, stripeCount, [&](int threadIndex, int stripe) {
+		if (!IsGenerationCancelled) {
+			uint32_t* histogram = histograms[threadIndex].data();
+			ForEachPossibleCell(stripe, [histogram](int, uint64_t number) { histogram[number >> 48]++; });
+		}
+		generationStepsDone++;
+	});
+
+	uint64_t bombsBelow = 0;
+	int lastBucket = 0;
+	while (lastBucket < generationBuckets) {
+		uint64_t bucketCount = 0;
+		for (const std::vector<uint32_t>& histogram : histograms) {
+			bucketCount += histogram[lastBucket];
+		}
+		if (bombsBelow + bucketCount >= static_cast<uint64_t>(bombsToPlace)) {
+			break;
+		}
+		bombsBelow += bucketCount;
+		lastBucket++;
+	}
+
+	// 2. Place the bombs in the lower buckets, and keep the cells in the last bucket
+	std::vector<std::vector<std::pair<uint64_t, uint32_t>>> lastBucketCells(threadCount);
+	ForEachStripe(threadCount, stripeCount, [&](int threadIndex, int stripe) {
+		if (!IsGenerationCancelled && bombsToPlace > 0) {
+			std::vector<std::pair<uint64_t, uint32_t>>& cells = lastBucketCells[threadIndex];
+			ForEachPossibleCell(stripe, [&](int index, uint64_t number) {
+				int bucket = static_cast<int>(number >> 48);
+				cellFlags[index] |= static_cast<uint8_t>(bucket < lastBucket) * BombBit;
+				if (bucket == lastBucket) {
+					cells.push_back({ number, static_cast<uint32_t>(index) });
+				}
+			});
+		}
+		generationStepsDone++;
+	});
+
+	// The remaining bombs go to the cells of the last bucket with the lowest numbers (ties go to the lowest index)
+	std::vector<std::pair<uint64_t, uint32_t>> candidates;
+	for (const std::vector<std::pair<uint64_t, uint32_t>>& cells : lastBucketCells) {
+		candidates.insert(candidates.end(), cells.begin(), cells.end());
+	}
+	size_t remainingBombs = static_cast<size_t>(bombsToPlace - bombsBelow);
+	if (!IsGenerationCancelled && remainingBombs > 0) {
+		std::nth_element(candidates.begin(), candidates.begin() + (remainingBombs - 1), candidates.end());
+		for (size_t i = 0; i < remainingBombs; i++) {
+			cellFlags[candidates[i].second] |= BombBit;
+		}
+	}
+
+	// 3. Count the bombs surrounding each cell
+	std::vector<std::vector<uint8_t>> columnSums(threadCount, std::vector<uint8_t>(nCols + 2, 0));
+	ForEachStripe(threadCount, stripeCount, [&](int threadIndex, int stripe) {
+		if (!IsGenerationCancelled) {
+			int stripeEnd = std::min((stripe + 1) * rowsPerStripe, nRows);
+			CountBombsInRows(stripe * rowsPerStripe, stripeEnd, columnSums[threadIndex].data(), policy);
+		}
+		generationStepsDone++;
+	});
+
+	// A cancelled placement removes the bombs placed so far
+	if (IsGenerationCancelled) {
+		for (uint8_t& flags : cellFlags) {
+			flags &= ~BombBit;
+		}
+		std::fill(bombsSurrounding.begin(), bombsSurrounding.end(), 0);
+		IsGenerationCancelled = false;
+		return false;
+	}
+
+	coveredSafeCells = GetCellCount() - bombsToPlace;
+	return true;
+}
+
+// Counts the bombs surrounding the cells of rows [firstRow, endRow) by visiting the neighbors of each cell
+template <class Topology>
+void GameBoard::CountBombsInRows(int firstRow, int endRow, uint8_t*, Topology) {
+
+	for (int y = firstRow; y < endRow; y++) {
+		for (int x = 0; x < nCols; x++) {
+			uint8_t count = 0;
+			Topology::ForEachNeighbor(x, y, nCols, nRows, [&](int neighbor) { count += cellFlags[neighbor] & BombBit; });
+			bombsSurrounding[GetIndex(x, y)] = count;
+		}
+	}
+}
+
+// Counts the bombs surrounding the cells of rows [firstRow, endRow) of a standard board: the sums of 3 rows
+// for each column, then of 3 columns (sums has room for nCols + 2 columns)
+void GameBoard::CountBombsInRows(int firstRow, int endRow, uint8_t* sums, StandardTopology) {
+
+	for (int y = firstRow; y < endRow; y++) {
+		const uint8_t* row = &cellFlags[GetIndex(0, y)];
+		for (int x = 0; x < nCols; x++) {
+			sums[x + 1] = row[x] & BombBit;
+		}
+		if (y > 0) {
+			for (int x = 0; x < nCols; x++) {
+				sums[x + 1] += row[x - nCols] & BombBit;
+			}
+		}
+		if (y < nRows - 1) {
+			for (int x = 0; x < nCols; x++) {
+				sums[x + 1] += row[x + nCols] & BombBit;
+			}
+		}
+		uint8_t* counts = &bombsSurrounding[GetIndex(0, y)];
+		for (int x = 0; x < nCols; x++) {
+			counts[x] = sums[x] + sums[x + 1] + sums[x + 2] - (row[x] & BombBit);
+		}
+	}
+}
+
+// Counts the bombs surrounding every cell with the board's shape (used by layouts, whose bombs aren't placed by a reveal)
+void GameBoard::CountAllBombs() {
+
+	std::vector<uint8_t> columnSums(nCols + 2, 0);
+	WithTopology(topology, [&](auto policy) { CountBombsInRows(0, nRows, columnSums.data(), policy); });
+}
+
+// Removes all flags placed before the first reveal
+void GameBoard::ClearFlagsBeforeFirstClick() {
+
+	for (int index = 0; index < GetCellCount(); index++) {
+		if (cellFlags[index] & FlaggedBit) {
+			cellFlags[index] &= ~FlaggedBit;
+			SetVisible(index, Covered);
+		}
+	}
+
+	numberFlagsPlaced = 0;
+	HasFlaggedBeforeFirstClick = false;
+}
+
+// Uses Flood Fill algorithm to clear all empty cells around the initial coordinate input.
+// Uses an explicit stack instead of recursion so huge empty areas can't overflow the call stack
+template <class Topology>
+void GameBoard::ClearEmpty(int xPos, int yPos, Topology) {
+
+	// Check that the cell is not a bomb and has not already been cleared
+	int index = GetIndex(xPos, yPos);
+	if (cellFlags[index] & (BombBit | ClearedBit)) {
+		return;
+	}
+
+	ClearCell(index);
+	if (bombsSurrounding[index] != 0) {
+		return;
+	}
+
+	// Cells are cleared when they are pushed, so each cell is pushed at most once
+	floodStack.clear();
+	floodStack.push_back(index);
+	while (!floodStack.empty()) {
+
+		int current = floodStack.back();
+		floodStack.pop_back();
+
+		// loop through the cells surrounding the current (empty) cell
+		Topology::ForEachNeighbor(current % nCols, current / nCols, nCols, nRows, [this](int newIndex) {
+			if (cellFlags[newIndex] & (BombBit | ClearedBit)) {
+				return;
+			}
+
+			ClearCell(newIndex);
+			if (bombsSurrounding[newIndex] == 0) {
+				floodStack.push_back(newIndex);
+			}
+		});
+	}
+}
+
+// Clears the empty area around a cell of a standard board. A large board fills the area cell by cell until it is
+// large and dense, then fills the rest on its bit planes (a row of 64 cells at a time) and clears the cells of the
+// area and the numbers around it in row order
+void GameBoard::ClearEmpty(int xPos, int yPos, StandardTopology policy) {
+
+	if (!IsLargeBoard()) {
+		ClearEmpty<StandardTopology>(xPos, yPos, policy);
+		return;
+	}
+
+	int index = GetIndex(xPos, yPos);
+	if (cellFlags[index] & (BombBit | ClearedBit)) {
+		return;
+	}
+
+	// Fill cell by cell, the same as the other boards, until the area has grown past a few rows worth of cells and
+	// covers a quarter of the rows it spans (the bit planes sweep whole rows, a thin winding area is faster cell by cell)
+	int64_t clearedCount = 0;
+	int64_t nextCheck = static_cast<int64_t>(floodBudgetRows) * nCols;
+	int areaFirstRow = yPos;
+	int areaLastRow = yPos;
+	bool IsDenseArea = false;
+	floodStack.clear();
+	if (ClearOpenCell(index)) {
+		floodStack.push_back(index);
+	}
+	while (!floodStack.empty() && !IsDenseArea) {
+
+		int current = floodStack.back();
+		floodStack.pop_back();
+
+		StandardTopology::ForEachNeighbor(current % nCols, current / nCols, nCols, nRows, [&](int newIndex) {
+			if (cellFlags[newIndex] & (BombBit | ClearedBit)) {
+				return;
+			}
+
+			clearedCount++;
+			if (ClearOpenCell(newIndex)) {
+				floodStack.push_back(newIndex);
+				areaFirstRow = std::min(areaFirstRow, newIndex / nCols);
+				areaLastRow = std::max(areaLastRow, newIndex / nCols);
+			}
+		});
+
+		if (clearedCount >= nextCheck) {
+			IsDenseArea = clearedCount * 4 >= static_cast<int64_t>(areaLastRow - areaFirstRow + 1) * nCols;
+			nextCheck *= 2;
+		}
+	}
+	if (floodStack.empty()) {
+		return;
+	}
+
+	// The empty cells left on the stack are the seeds of the rest of the area, every safe cell in it or next to it
+	// is cleared
+	if (!HasOpenCells) {
+		FindOpenCells();
+	}
+	int firstRow = nRows;
+	int lastRow = -1;
+	for (uint32_t seedIndex : floodStack) {
+		int seedRow = seedIndex / nCols;
+		floodRegion.Set(seedIndex % nCols, seedRow);
+		firstRow = std::min(firstRow, seedRow);
+		lastRow = std::max(lastRow, seedRow);
+	}
+	Bitboard::GrowRegion(openCells, floodRegion, firstRow, lastRow);
+	floodRegion.ForEachNear(std::max(firstRow - 1, 0), std::min(lastRow + 1, nRows - 1), [this](int x, int y) {
+		int index = GetIndex(x, y);
+		if (cellFlags[index] & (BombBit | ClearedBit)) {
+			return;
+		}
+
+		ClearCell(index);
+		if (bombsSurrounding[index] == 0) {
+			openCells.Reset(x, y);
+		}
+	});
+	floodRegion.ClearRows(firstRow, lastRow);
+}
+
+// Clears a safe cell of a large standard board, and takes it out of the open cells. Returns true if it has no bomb
+// around it (the flood fill goes on from it)
+bool GameBoard::ClearOpenCell(int index) {
+
+	ClearCell(index);
+	if (bombsSurrounding[index] != 0) {
+		return false;
+	}
+
+	if (HasOpenCells) {
+		openCells.Reset(index % nCols, index / nCols);
+	}
+	return true;
+}
+
+// Finds the covered safe cells with no bomb around them, the cells a flood fill goes through (the same as the
+// cells ClearEmpty pushes on its stack), a word of 64 cells at a time
+void GameBoard::FindOpenCells() {
+
+	for (int y = 0; y < nRows; y++) {
+		uint64_t* row = openCells.Row(y);
+		for (int x = 0; x < nCols; x += 64) {
+			uint64_t word = 0;
+			int index = GetIndex(x, y);
+			int bitCount = std::min(64, nCols - x);
+			for (int bit = 0; bit < bitCount; bit++) {
+				uint8_t closedBits = bombsSurrounding[index + bit] | (cellFlags[index + bit] & (BombBit | ClearedBit));
+				word |= static_cast<uint64_t>(closedBits == 0) << bit;
+			}
+			row[x / 64] = word;
+		}
+	}
+	HasOpenCells = true;
+}
+
+// Keeps the open cell of a cell covered or cleared outside of a flood fill (by an undo or a redo) up to date
+void GameBoard::UpdateOpenCell(int index) {
+	if (HasOpenCells && bombsSurrounding[index] == 0 && !(cellFlags[index] & BombBit)) {
+		if (cellFlags[index] & ClearedBit) {
+			openCells.Reset(index % nCols, index / nCols);
+		}
+		else {
+			openCells.Set(index % nCols, index / nCols);
+		}
+	}
+}
+
+// Marks a (non-bomb) cell as cleared and shows its number.
+// A flag on the cell is kept (and still counts for chording), same as the original grid
+void GameBoard::ClearCell(int index) {
+	cellFlags[index] |= ClearedBit;
+	coveredSafeCells--;
+	SetVisible(index, bombsSurrounding[index]);
+}
+
+// Covers a cleared cell again (undo of ClearCell), a flag kept on the cell is shown again
+void GameBoard::CoverCell(int index) {
+	cellFlags[index] &= ~ClearedBit;
+	coveredSafeCells++;
+	SetVisible(index, (cellFlags[index] & FlaggedBit) ? Flagged : Covered);
+}
+
+// Sets a flag on a covered cell, or removes it if the cell is already flagged
+void GameBoard::FlipFlag(int index) {
+	cellFlags[index] ^= FlaggedBit;
+	if (cellFlags[index] & FlaggedBit) {
+		numberFlagsPlaced++;
+		SetVisible(index, Flagged);
+	}
+	else {
+		numberFlagsPlaced--;
+		SetVisible(index, Covered);
+	}
+}
+
+// Stores the cells changed by a move (the changes from firstChange to endChange) in the undo history. The assist's
+// moves only take the changes of their kind (flags, or revealed numbers), and aren't stored if they changed nothing
+void GameBoard::RecordMove(MoveType type, Status statusBefore, Status statusAfter, size_t firstChange, size_t endChange) {
+
+	journalIndices.clear();
+	for (size_t i = firstChange; i < endChange; i++) {
+		bool IsFlagChange = changes[i].visible == Flagged || changes[i].visible == Covered;
+		if ((type == AssistFlagMove && !IsFlagChange) || (type == AssistRevealMove && IsFlagChange)) {
+			continue;
+		}
+		journalIndices.push_back(changes[i].index);
+	}
+
+	bool IsAssistMove = type == AssistFlagMove || type == AssistRevealMove;
+	if (IsAssistMove && journalIndices.empty() && statusBefore == statusAfter) {
+		return;
+	}
+	journal.Record(type, static_cast<uint8_t>(statusBefore), static_cast<uint8_t>(statusAfter), journalIndices.data(), journalIndices.size());
+}
+
+// Updates the visible value of a cell, and records the change for the last move (and in the frontier and region indices)
+void GameBoard::SetVisible(int index, uint8_t value) {
+	if (visible[index] != value) {
+		visible[index] = value;
+		changes.push_back({ static_cast<uint32_t>(index), value });
+		if (IsFrontierTracked) {
+			frontier.Update(index, value);
+		}
+		if (IsRegionTracked) {
+			regions.Update(index, value, (cellFlags[index] & BombBit) != 0);
+		}
+	}
+}
+
+// Determines if the cell is within the grid's index
+bool GameBoard::IsInGridIndex(int xPos, int yPos) const {
+	return xPos >= 0 && yPos >= 0 && xPos < nCols && yPos < nRows;
+}
+
+// Determines if the cell is an unflagged bomb
+bool GameBoard::IsUnflaggedBomb(int xPos, int yPos) const {
+	return (cellFlags[GetIndex(xPos, yPos)] & (BombBit | FlaggedBit)) == BombBit;
+}
+
+// Determines if the cell has not been cleared, and has not been flagged
+bool GameBoard::IsFlaggable(int xPos, int yPos) const {
+	return (cellFlags[GetIndex(xPos, yPos)] & (ClearedBit | FlaggedBit)) == 0;
+}
+
+// Counts the number of flags in the surrounding cells of input coordinate
+int GameBoard::CountFlagsSurrounding(int xPos, int yPos) const {
+	return WithTopology(topology, [&](auto policy) { return CountFlagsSurrounding(xPos, yPos, policy); });
+}
+
+template <class Topology>
+int GameBoard::CountFlagsSurrounding(int xPos, int yPos, Topology) const {
+
+	int count = 0;
+	Topology::ForEachNeighbor(xPos, yPos, nCols, nRows, [&](int neighbor) {
+		if (cellFlags[neighbor] & FlaggedBit) {
+			count++;
+		}
+	});
+
+	return count;
+}
+
+// Counts the 3BV of the board (the openings are flood filled like ClearEmpty, the cells reached are marked)
+int GameBoard::Count3BV(int* openingCount) {
+
+	if (openingCount != nullptr) {
+		*openingCount = 0;
+	}
+	if (status == Status::NotStarted) {
+		return 0;
+	}
+	return WithTopology(topology, [&](auto policy) { return Count3BV(openingCount, policy); });
+}
+
+template <class Topology>
+int GameBoard::Count3BV(int* openingCount, Topology) {
+
+	int count = 0;
+	int cellCount = GetCellCount();
+
+	// Each opening is one click: the empty cells joined to it and the numbers around them are marked
+	for (int index = 0; index < cellCount; index++) {
+		if ((cellFlags[index] & (BombBit | CountedBit)) != 0 || bombsSurrounding[index] != 0) {
+			continue;
+		}
+		count++;
+		cellFlags[index] |= CountedBit;
+		floodStack.clear();
+		floodStack.push_back(index);
+		while (!floodStack.empty()) {
+
+			int current = floodStack.back();
+			floodStack.pop_back();
+			Topology::ForEachNeighbor(current % nCols, current / nCols, nCols, nRows, [this](int newIndex) {
+				if (cellFlags[newIndex] & (BombBit | CountedBit)) {
+					return;
+				}
+
+				cellFlags[newIndex] |= CountedBit;
+				if (bombsSurrounding[newIndex] == 0) {
+					floodStack.push_back(newIndex);
+				}
+			});
+		}
+	}
+
+	if (openingCount != nullptr) {
+		*openingCount = count;
+	}
+
+	// Every number left takes a click of its own, and the marks are cleared
+	for (int index = 0; index < cellCount; index++) {
+		if ((cellFlags[index] & (BombBit | CountedBit)) == 0) {
+			count++;
+		}
+		cellFlags[index] &= ~CountedBit;
+	}
+	return count;
+}
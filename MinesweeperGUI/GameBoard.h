@@ -0,0 +1,278 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Arena.h"
+#include "Bitboard.h"
+#include "FrontierIndex.h"
+#include "MoveJournal.h"
+#include "RegionIndex.h"
+#include "Topology.h"
+#include "VisibleCell.h"
+
+// Stores the rules and state of a single minesweeper game without any UI code,
+// so the same game logic can be driven by the GUI (MainFrame) and by headless tools
+class GameBoard : public VisibleCellValues
+{
+public:
+
+	// Describes the state of the game as a whole
+	enum class Status : uint8_t {
+		NotStarted,
+		Playing,
+		Won,
+		Lost
+	};
+
+	// Describes a cell whose visible value was changed by the last move
+	struct CellChange {
+		uint32_t index;
+		uint8_t visible;
+	};
+	typedef ArenaVector<CellChange> ChangeList;
+
+	GameBoard();
+	GameBoard(int nCols, int nRows, int numberOfBombs);
+
+	// Define methods used to set up a game
+	void Resize(int nCols, int nRows, int numberOfBombs);
+	void NewGame(uint64_t seed);
+
+	// Define the cells of a known layout (LayoutImporter.h), loaded in place of random bombs. A revealed cell can also
+	// give the number shown on it (number + 1 in the bits from LayoutNumberShift, 0 for none), which is checked
+	enum LayoutCell : uint8_t {
+		LayoutMine = 1,
+		LayoutRevealed = 2,
+		LayoutFlagged = 4
+	};
+	static const int LayoutNumberShift = 4;
+
+	// Define methods used to load a layout: BeginLayout sizes the board, the rows are added one at a time (the layers
+	// of a row can be added separately), FinishLayout counts the bombs and checks the layout (the board is left without
+	// a layout if it returns false). The game is on from the start, and NewGame starts the same layout again (with its
+	// revealed and flagged cells) until the board is resized
+	void BeginLayout(int nCols, int nRows);
+	void AddLayoutRow(int yPos, const uint8_t* cells);
+	bool FinishLayout(std::string& error);
+	bool HasLayout() const { return IsLayoutFixed; }
+
+	// Define methods used to change the shape of the board (Topology.h), a new game is started with the same seed.
+	// GetTopology is the shape the board is played on: a toroidal board smaller than 3 x 3 is played as a standard one
+	// (FitTopology), and is toroidal again once it is resized to 3 x 3 or more
+	void SetTopology(TopologyType topology);
+	TopologyType GetTopology() const { return topology; }
+
+	// Define methods used to handle gameplay (each returns true if the board changed)
+	bool Reveal(int xPos, int yPos);
+	bool ToggleFlag(int xPos, int yPos);
+	bool Chord(int xPos, int yPos);
+
+	// Define methods used in training mode, where moves can be undone and redone
+	// (each returns true if the board changed, the changed cells are reported like any other move)
+	void SetTrainingMode(bool IsEnabled);
+	bool IsInTrainingMode() const { return IsTrainingMode; }
+	bool Undo();
+	bool Redo();
+	bool CanUndo() const { return IsTrainingMode && journal.CanUndo(); }
+	bool CanRedo() const { return IsTrainingMode && journal.CanRedo(); }
+
+	// Define the assist modes, which make the moves the numbers force after each move of the player: AutoFlag flags the
+	// covered cells around a number with as many of them as mines left, AutoChord reveals the cells around a number
+	// whose mines are all flagged. They start from the numbers around the cells the move changed and go on until no
+	// number forces a move. The cells they change are part of the move (undone and redone with it in training mode)
+	enum AssistMode : uint8_t {
+		AutoFlag = 1,
+		AutoChord = 2
+	};
+	void SetAssistModes(uint8_t modes);
+	uint8_t GetAssistModes() const { return assistModes; }
+
+	// Define methods used to keep the frontier and constraint index (FrontierIndex.h) up to date as moves happen.
+	// It is off by default, its memory is only allocated while it is on
+	void SetFrontierTracking(bool IsEnabled);
+	bool IsTrackingFrontier() const { return IsFrontierTracked; }
+	const FrontierIndex& GetFrontier() const { return frontier; }
+
+	// Define methods used to keep the region index (RegionIndex.h) up to date as moves happen, for the counts of the
+	// mines, flags and covered cells of any part of the board. It is off by default
+	void SetRegionTracking(bool IsEnabled);
+	bool IsTrackingRegions() const { return IsRegionTracked; }
+	const RegionIndex& GetRegions() const { return regions; }
+
+	// Define methods used to place the bombs of large boards on several threads. The bombs are placed by the first
+	// reveal, which can be run on another thread while the UI thread reads the progress (0 - 1) and cancels it.
+	// A cancelled first reveal returns false and leaves the board as it was
+	void SetGenerationThreads(int threadCount) { generationThreads = threadCount; }
+	double GetGenerationProgress() const;
+	void CancelGeneration() { IsGenerationCancelled = true; }
+	bool IsLargeBoard() const { return GetCellCount() >= ParallelGenerationCells; }
+
+	// Define methods that give read access to the board
+	const uint8_t* GetVisibleState() const { return visible.data(); }
+	const ChangeList& GetChanges() const { return changes; }
+	Status GetStatus() const { return status; }
+	int GetCols() const { return nCols; }
+	int GetRows() const { return nRows; }
+	int GetCellCount() const { return nCols * nRows; }
+	int GetNumberOfBombs() const { return numberOfBombs; }
+	int GetFlagsPlaced() const { return numberFlagsPlaced; }
+	uint64_t GetSeed() const { return seed; }
+	int GetIndex(int xPos, int yPos) const { return xPos + (yPos * nCols); }
+
+	// Define methods that report the arena holding the per cell buffers (a buffer that outgrew its place in the
+	// block got a block of its own, an overflow)
+	size_t GetArenaCapacity() const { return arena.GetCapacity(); }
+	int GetArenaOverflowCount() const { return arena.GetOverflowCount(); }
+
+	// Define methods that check for various cell conditions
+	bool IsInGridIndex(int xPos, int yPos) const;
+	bool IsBomb(int xPos, int yPos) const { return (cellFlags[GetIndex(xPos, yPos)] & BombBit) != 0; }
+	bool IsCleared(int xPos, int yPos) const { return (cellFlags[GetIndex(xPos, yPos)] & ClearedBit) != 0; }
+	bool IsFlagged(int xPos, int yPos) const { return (cellFlags[GetIndex(xPos, yPos)] & FlaggedBit) != 0; }
+	bool IsUnflaggedBomb(int xPos, int yPos) const;
+	bool IsFlaggable(int xPos, int yPos) const;
+	int CountBombsSurrounding(int xPos, int yPos) const { return bombsSurrounding[GetIndex(xPos, yPos)]; }
+	int CountFlagsSurrounding(int xPos, int yPos) const;
+
+	// Counts the 3BV of the board once the bombs are placed: the fewest clicks that clear it without flags (one for
+	// each opening, and one for each number that no opening reveals). Uses the flood fill buffer, so it is called
+	// between moves (0 before the first reveal). The # of openings is given too if openingCount isn't null
+	int Count3BV(int* openingCount = nullptr);
+
+	// Returns the next value of a splitmix64 random number generator (shared by every engine,
+	// so a seed places the same bombs with every compiler and every engine)
+	static uint64_t NextRandom(uint64_t& state) {
+		uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+		return z ^ (z >> 31);
+	}
+
+	// Returns a random number in [0, range) (range must be below 2^32)
+	static uint64_t RandomBelow(uint64_t& state, uint64_t range) {
+		return ((NextRandom(state) >> 32) * range) >> 32;
+	}
+
+	// Returns the random number for a counter (counter-based: it doesn't depend on any other number drawn,
+	// so cells can be given random numbers in any order, on any thread)
+	static uint64_t RandomAt(uint64_t seed, uint64_t counter) {
+		uint64_t state = seed + counter * 0x9E3779B97F4A7C15ull;
+		return NextRandom(state);
+	}
+
+	// Define the # of cells from which the bombs are placed on several threads (a seed gives a different board
+	// than it would with the single threaded placement, the same board for any # of threads)
+	static const int ParallelGenerationCells = 1 << 20;
+
+private:
+
+	// Define bits stored in cellFlags for each cell
+	enum CellBits : uint8_t {
+		BombBit = 1,
+		ClearedBit = 2,
+		FlaggedBit = 4,
+		LayoutRevealedBit = 8,
+		LayoutFlaggedBit = 16,
+		CountedBit = 32,    // set on the cells of the openings while Count3BV runs
+		QueuedBit = 64      // set on the numbers in the assist queue
+	};
+
+	// Define the types of moves stored in the journal (the assist's flags and reveals are stored after the move that
+	// set them off)
+	enum MoveType : uint8_t {
+		RevealMove,
+		FlagMove,
+		AssistFlagMove,
+		AssistRevealMove
+	};
+
+	// Define methods used internally by the gameplay methods. The ones that visit neighbors take the topology's
+	// policy (Topology.h), the gameplay methods pick it once per move
+	template <class Topology> bool Chord(int xPos, int yPos, Topology policy);
+	template <class Topology> void ClearAround(int xPos, int yPos, Topology policy);
+	template <class Topology> void RunAssist(Topology policy);
+	template <class Topology> int CountFlagsSurrounding(int xPos, int yPos, Topology policy) const;
+	template <class Topology> bool PlaceBombs(int xPos, int yPos, Topology policy);
+	template <class Topology> bool PlaceBombsInParallel(int xPos, int yPos, Topology policy);
+	template <class Topology> void CountBombsInRows(int firstRow, int endRow, uint8_t* sums, Topology policy);
+	void CountBombsInRows(int firstRow, int endRow, uint8_t* sums, StandardTopology policy);
+	template <class Topology> void ClearEmpty(int xPos, int yPos, Topology policy);
+	void ClearEmpty(int xPos, int yPos, StandardTopology policy);
+	void FindOpenCells();
+	void UpdateOpenCell(int index);
+	bool ClearOpenCell(int index);
+	template <class Topology> int Count3BV(int* openingCount, Topology policy);
+	void CountAllBombs();
+	void StartLayoutGame();
+	void ClearFlagsBeforeFirstClick();
+	void ClearCell(int index);
+	void CoverCell(int index);
+	void FlipFlag(int index);
+	void FinishMove(MoveType type, Status statusBefore);
+	void QueueForAssist(int index);
+	void RecordMove(MoveType type, Status statusBefore, Status statusAfter, size_t firstChange, size_t endChange);
+	void UndoCells(const MoveJournal::Move& move);
+	void RedoCells(const MoveJournal::Move& move);
+	void SetVisible(int index, uint8_t value);
+
+	// Define variables that are used in game initialization
+	int nCols = 0;
+	int nRows = 0;
+	int numberOfBombs = 0;
+	uint64_t seed = 0;
+	bool IsLayoutFixed = false;
+	TopologyType chosenTopology = TopologyType::Standard;
+	TopologyType topology = TopologyType::Standard;
+
+	// Define the arena that holds every per cell buffer of the board (laid out by Resize, freed with the board)
+	Arena arena;
+
+	// Define per cell data (indexed by xPos + yPos * nCols, same as the wxIDs of the grid)
+	ArenaVector<uint8_t> cellFlags{ ArenaAllocator<uint8_t>(&arena) };
+	ArenaVector<uint8_t> bombsSurrounding{ ArenaAllocator<uint8_t>(&arena) };
+	ArenaVector<uint8_t> visible{ ArenaAllocator<uint8_t>(&arena) };
+
+	// Define the list of cells changed by the last move
+	ChangeList changes{ ArenaAllocator<CellChange>(&arena) };
+
+	// Define buffers reused between moves so that gameplay does not allocate
+	ArenaVector<uint32_t> possibleCoordinates{ ArenaAllocator<uint32_t>(&arena) };
+	ArenaVector<uint32_t> floodStack{ ArenaAllocator<uint32_t>(&arena) };
+
+	// Define the bit planes used to flood fill large standard boards: the covered safe cells with no bomb around them
+	// (found by the first area too large to fill cell by cell in a game, kept up to date by the moves after it), and the
+	// region being filled (clear between moves)
+	Bitboard openCells;
+	Bitboard floodRegion;
+	bool HasOpenCells = false;
+
+	// Define the history of moves used in training mode (the first reveal places the bombs, so it starts the history)
+	MoveJournal journal;
+	ArenaVector<uint32_t> journalIndices{ ArenaAllocator<uint32_t>(&arena) };
+	bool IsTrainingMode = false;
+
+	// Define the assist modes on, and the numbers they have left to check
+	uint8_t assistModes = 0;
+	ArenaVector<uint32_t> assistQueue{ ArenaAllocator<uint32_t>(&arena) };
+
+	// Define the frontier and constraint index, updated with every visible change while it is on
+	FrontierIndex frontier;
+	bool IsFrontierTracked = false;
+
+	// Define the region index, updated with every visible change (and built once the bombs are placed) while it is on
+	RegionIndex regions;
+	bool IsRegionTracked = false;
+
+	// Define the threads used to place bombs on large boards (0 uses every core), and the progress of the placement
+	int generationThreads = 0;
+	std::atomic<int> generationStepsDone{ 0 };
+	std::atomic<int> generationStepCount{ 0 };
+	std::atomic<bool> IsGenerationCancelled{ false };
+
+	// Define variables used to track the game's progress
+	Status status = Status::NotStarted;
+	int numberFlagsPlaced = 0;
+	int coveredSafeCells = 0;
+	bool HasFlaggedBeforeFirstClick = false;
+};
@@ -0,0 +1,215 @@
+#include "GridRenderCache.h"
+#include <wx/dcmemory.h>
+#include <algorithm>
+#include <cmath>
+
+GridRenderCache::GridRenderCache(const wxColour& gridLineColour, const wxColour& backgroundColour)
+	: gridLineColour(gridLineColour), backgroundColour(backgroundColour) {
+}
+
+// Sets up the render tiles for the grid size, none of them are drawn yet
+void GridRenderCache::Reset(int nCols, int nRows, bool IsHexagonal) {
+
+	FreeTiles();
+	this->nCols = nCols;
+	this->nRows = nRows;
+	HasShiftedRows = IsHexagonal;
+	tileCols = (nCols + TileCells - 1) / TileCells;
+	tileRows = (nRows + TileCells - 1) / TileCells;
+	tiles.assign(static_cast<size_t>(tileCols) * tileRows, RenderTile());
+}
+
+// Changes the size of a cell in logical pixels and the DPI scale (the render tiles are drawn again when painted)
+void GridRenderCache::SetCellSize(int cellSize, double scaleFactor) {
+
+	if (cellSize == this->cellSize && scaleFactor == this->scaleFactor) {
+		return;
+	}
+	FreeTiles();
+	this->cellSize = cellSize;
+	this->scaleFactor = scaleFactor;
+	UpdateMaxTiles();
+}
+
+void GridRenderCache::SetMemoryBudget(size_t bytes) {
+	memoryBudget = bytes;
+	UpdateMaxTiles();
+}
+
+void GridRenderCache::SetViewSize(const wxSize& viewSize) {
+	this->viewSize = viewSize;
+	UpdateMaxTiles();
+}
+
+// The cache holds as many full render tiles as fit in the budget (32-bit pixels), but always the ones a view can
+// overlap: a view that isn't lined up with the render tiles overlaps one more column and row of them than it fills
+void GridRenderCache::UpdateMaxTiles() {
+	double tilePixels = std::ceil(TileCells * cellSize * scaleFactor);
+	size_t tileBytes = static_cast<size_t>(tilePixels * tilePixels * 4);
+	int viewTilePixels = std::max(1, TileCells * cellSize);
+	size_t viewTiles = static_cast<size_t>((std::max(0, viewSize.GetWidth()) + viewTilePixels - 1) / viewTilePixels + 1) *
+		((std::max(0, viewSize.GetHeight()) + viewTilePixels - 1) / viewTilePixels + 1);
+	maxTiles = std::max(viewTiles, memoryBudget / std::max<size_t>(tileBytes, 1));
+}
+
+// The last column of render tiles is wider by half a cell on a hexagonal board, to fit the end of the shifted rows
+wxSize GridRenderCache::GetGridSize() const {
+	return wxSize(nCols * cellSize + (HasShiftedRows ? cellSize / 2 : 0), nRows * cellSize);
+}
+
+// Marks a cell to draw again. The last cell of a shifted row in a render tile also shows on the next render tile
+void GridRenderCache::InvalidateCell(int x, int y) {
+
+	int tileIndex = (x / TileCells) + (y / TileCells) * tileCols;
+	MarkDirty(tileIndex, x % TileCells, y % TileCells);
+	if (GetRowShift(y) > 0 && x % TileCells == TileCells - 1 && x + 1 < nCols) {
+		MarkDirty(tileIndex + 1, -1, y % TileCells);
+	}
+}
+
+// Adds a cell (column i, row j inside the render tile) to the cells to draw again.
+// Render tiles that aren't cached don't keep track, they are drawn whole when painted
+void GridRenderCache::MarkDirty(int tileIndex, int i, int j) {
+
+	RenderTile& tile = tiles[tileIndex];
+	if (!tile.IsCached || tile.IsAllDirty) {
+		return;
+	}
+
+	// Past a quarter of the tile it is faster to draw every cell than to keep the list
+	if (tile.dirtyCells.size() >= TileCells * TileCells / 4) {
+		tile.IsAllDirty = true;
+		tile.dirtyCells.clear();
+	}
+	else {
+		tile.dirtyCells.push_back(static_cast<uint16_t>((i + 1) + j * (TileCells + 1)));
+	}
+}
+
+void GridRenderCache::InvalidateAll() {
+	for (int index : lru) {
+		tiles[index].IsAllDirty = true;
+		tiles[index].dirtyCells.clear();
+	}
+}
+
+void GridRenderCache::Draw(wxDC& dc, const wxRect& area, const wxPoint& viewOrigin, const std::vector<TileCache::Tile>& cellTiles, const TileCache& tileCache) {
+
+	int gridWidth = GetGridSize().x;
+	int gridHeight = GetGridSize().y;
+	int tilePixels = TileCells * cellSize;
+
+	// Fill the part of the area that is right of or below the grid
+	dc.SetPen(*wxTRANSPARENT_PEN);
+	dc.SetBrush(wxBrush(backgroundColour));
+	int right = gridWidth - viewOrigin.x;
+	int bottom = gridHeight - viewOrigin.y;
+	if (area.GetRight() >= right) {
+		dc.DrawRectangle(std::max(right, area.x), area.y, area.GetRight() + 1 - std::max(right, area.x), area.height);
+	}
+	if (area.GetBottom() >= bottom) {
+		dc.DrawRectangle(area.x, std::max(bottom, area.y), area.width, area.GetBottom() + 1 - std::max(bottom, area.y));
+	}
+	if (tiles.empty() || cellSize == 0) {
+		return;
+	}
+
+	// Paint every render tile that overlaps the area, drawing it first if needed
+	int firstTileX = std::max(0, (area.x + viewOrigin.x) / tilePixels);
+	int firstTileY = std::max(0, (area.y + viewOrigin.y) / tilePixels);
+	int lastTileX = std::min(tileCols - 1, (area.GetRight() + viewOrigin.x) / tilePixels);
+	int lastTileY = std::min(tileRows - 1, (area.GetBottom() + viewOrigin.y) / tilePixels);
+
+	for (int tileY = firstTileY; tileY <= lastTileY; tileY++) {
+		for (int tileX = firstTileX; tileX <= lastTileX; tileX++) {
+			int index = tileX + tileY * tileCols;
+			RenderTile& tile = tiles[index];
+
+			if (tile.IsCached) {
+				lru.splice(lru.begin(), lru, tile.lruPosition);
+			}
+			else {
+				lru.push_front(index);
+				tile.lruPosition = lru.begin();
+			}
+			DrawTile(tileX, tileY, tile, cellTiles, tileCache);
+
+			dc.DrawBitmap(tile.bitmap, tileX * tilePixels - viewOrigin.x, tileY * tilePixels - viewOrigin.y);
+			stats.blits++;
+		}
+	}
+
+	// Free the render tiles painted the longest time ago once the cache is over its budget
+	while (lru.size() > maxTiles) {
+		RenderTile& tile = tiles[lru.back()];
+		tile.bitmap = wxBitmap();
+		tile.dirtyCells.clear();
+		tile.IsCached = false;
+		tile.IsAllDirty = false;
+		lru.pop_back();
+		stats.evictions++;
+	}
+}
+
+// Draws the cells of a render tile that need it: every cell if the tile is new or all of it changed,
+// otherwise only the changed cells (the grid lines between the cells are never drawn again)
+void GridRenderCache::DrawTile(int tileX, int tileY, RenderTile& tile, const std::vector<TileCache::Tile>& cellTiles, const TileCache& tileCache) {
+
+	if (tile.IsCached && !tile.IsAllDirty && tile.dirtyCells.empty()) {
+		return;
+	}
+
+	int cols = std::min(TileCells, nCols - tileX * TileCells);
+	int rows = std::min(TileCells, nRows - tileY * TileCells);
+	int firstCol = tileX * TileCells;
+	int firstRow = tileY * TileCells;
+	int width = cols * cellSize + ((HasShiftedRows && tileX == tileCols - 1) ? cellSize / 2 : 0);
+
+	// Draws a cell at its column i and row j inside the render tile (i is -1 for the cell left of the tile)
+	auto DrawCell = [&](wxMemoryDC& dc, int i, int j) {
+		const TileCache::Tile& cell = cellTiles[static_cast<size_t>(firstRow + j) * nCols + firstCol + i];
+		dc.DrawBitmap(tileCache.Get(cell), i * cellSize + GetRowShift(firstRow + j), j * cellSize);
+	};
+
+	if (!tile.IsCached) {
+		tile.bitmap.CreateScaled(width, rows * cellSize, wxBITMAP_SCREEN_DEPTH, scaleFactor);
+		tile.IsCached = true;
+		tile.IsAllDirty = true;
+	}
+	wxMemoryDC dc(tile.bitmap);
+
+	if (tile.IsAllDirty) {
+		dc.SetBackground(wxBrush(gridLineColour));
+		dc.Clear();
+		for (int j = 0; j < rows; j++) {
+			int first = (firstCol > 0 && GetRowShift(firstRow + j) > 0) ? -1 : 0;
+			for (int i = first; i < cols; i++) {
+				DrawCell(dc, i, j);
+			}
+		}
+		stats.misses++;
+		stats.cellsDrawn += static_cast<uint64_t>(cols) * rows;
+	}
+	else {
+		for (uint16_t cell : tile.dirtyCells) {
+			DrawCell(dc, cell % (TileCells + 1) - 1, cell / (TileCells + 1));
+		}
+		stats.repairs++;
+		stats.cellsDrawn += tile.dirtyCells.size();
+	}
+
+	tile.IsAllDirty = false;
+	tile.dirtyCells.clear();
+}
+
+// Returns the share of painted render tiles that didn't have to be drawn from scratch
+double GridRenderCache::GetHitRate() const {
+	return stats.blits == 0 ? 1.0 : static_cast<double>(stats.blits - stats.misses) / stats.blits;
+}
+
+void GridRenderCache::FreeTiles() {
+	for (int index : lru) {
+		tiles[index] = RenderTile();
+	}
+	lru.clear();
+}
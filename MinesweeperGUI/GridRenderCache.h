@@ -0,0 +1,95 @@
+#pragma once
+#include <wx/wx.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <vector>
+#include "TileCache.h"
+
+// Keeps the grid drawn into offscreen bitmaps of TileCells x TileCells cells (render tiles), so painting the grid
+// only blits the render tiles in view. A render tile is drawn once when it first comes into view, after that only
+// the cells a move changed are drawn again on it. The render tiles that were in view the longest time ago are freed
+// when the cache grows past its memory budget, and are drawn again if they come back into view.
+// Hexagonal boards are drawn with their odd rows shifted right by half a cell, so each cell touches its 6 neighbors
+class GridRenderCache
+{
+public:
+
+	static const int TileCells = 32;
+
+	// Define the counts used by the instrumentation (since the last ResetStats)
+	struct Stats {
+		uint64_t blits = 0;        // render tiles painted to the screen
+		uint64_t misses = 0;       // render tiles drawn from scratch to paint them (new, evicted, or every cell changed)
+		uint64_t repairs = 0;      // render tiles that had changed cells drawn again to paint them
+		uint64_t cellsDrawn = 0;
+		uint64_t evictions = 0;
+	};
+
+	GridRenderCache(const wxColour& gridLineColour, const wxColour& backgroundColour);
+
+	// Define methods used to set up the cache (both free every render tile)
+	void Reset(int nCols, int nRows, bool IsHexagonal = false);
+	void SetCellSize(int cellSize, double scaleFactor);
+	void SetMemoryBudget(size_t bytes);
+
+	// Sets the size of the view the grid is painted in (logical pixels), the cache always holds the render tiles it
+	// can overlap
+	void SetViewSize(const wxSize& viewSize);
+
+	// Define methods that give the size of the grid in logical pixels, and the shift of a row (half a cell for the
+	// odd rows of a hexagonal board)
+	wxSize GetGridSize() const;
+	int GetRowShift(int y) const { return (HasShiftedRows && (y & 1)) ? cellSize / 2 : 0; }
+
+	// Define methods that mark cells to draw again the next time their render tile is painted
+	void InvalidateCell(int x, int y);
+	void InvalidateAll();
+
+	// Paints the part of the grid in an area of the view (in view coordinates). viewOrigin is the position of
+	// the view's top left corner in the grid, cellTiles has the tile of every cell (index x + y * nCols)
+	void Draw(wxDC& dc, const wxRect& area, const wxPoint& viewOrigin, const std::vector<TileCache::Tile>& cellTiles, const TileCache& tileCache);
+
+	// Define methods that give access to the instrumentation
+	const Stats& GetStats() const { return stats; }
+	void ResetStats() { stats = Stats(); }
+	double GetHitRate() const;
+	int GetCachedTileCount() const { return static_cast<int>(lru.size()); }
+	size_t GetMaxTileCount() const { return maxTiles; }
+
+private:
+
+	// Define the state of each render tile. The changed cells are stored by their position inside the tile (a shifted
+	// row also shows the end of the cell left of the tile, stored as column -1)
+	struct RenderTile {
+		wxBitmap bitmap;
+		std::vector<uint16_t> dirtyCells;
+		std::list<int>::iterator lruPosition;
+		bool IsCached = false;
+		bool IsAllDirty = false;
+	};
+
+	void MarkDirty(int tileIndex, int i, int j);
+	void DrawTile(int tileX, int tileY, RenderTile& tile, const std::vector<TileCache::Tile>& cellTiles, const TileCache& tileCache);
+	void FreeTiles();
+	void UpdateMaxTiles();
+
+	wxColour gridLineColour;
+	wxColour backgroundColour;
+
+	int nCols = 0;
+	int nRows = 0;
+	int tileCols = 0;
+	int tileRows = 0;
+	bool HasShiftedRows = false;
+	int cellSize = 0;
+	double scaleFactor = 1;
+	size_t memoryBudget = size_t(192) << 20;
+	wxSize viewSize = wxSize(0, 0);
+	size_t maxTiles = 1;
+
+	// Define the render tiles and their use order (most recently painted first)
+	std::vector<RenderTile> tiles;
+	std::list<int> lru;
+	Stats stats;
+};
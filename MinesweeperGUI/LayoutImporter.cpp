@@ -0,0 +1,302 @@
+#include "LayoutImporter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+// Define the size of the blocks the files are read in
+static const size_t blockBytes = 1 << 20;
+
+// Returns the LayoutCell bits of a character of a text grid, or -1 if it isn't a cell
+static int TextCell(int c) {
+	switch (c) {
+	case '.':
+		return 0;
+	case '*':
+		return GameBoard::LayoutMine;
+	case 'F':
+		return GameBoard::LayoutMine | GameBoard::LayoutFlagged;
+	case 'f':
+		return GameBoard::LayoutFlagged;
+	case 'o':
+		return GameBoard::LayoutRevealed;
+	default:
+		if (c >= '0' && c <= '8') {
+			return GameBoard::LayoutRevealed | ((c - '0' + 1) << GameBoard::LayoutNumberShift);
+		}
+		return -1;
+	}
+}
+
+bool LayoutImporter::Import(GameBoard& board, const std::string& minesPath, const std::string& revealedPath, const std::string& flaggedPath) {
+
+	error.clear();
+	if (!Open(minesPath) || !ReadHeader()) {
+		Close();
+		return false;
+	}
+
+	// Each row goes into the board as soon as it is read
+	board.BeginLayout(cols, rows);
+	bool IsRead = true;
+	for (int y = 0; y < rows && IsRead; y++) {
+		IsRead = ReadRow(y, 0);
+		if (IsRead) {
+			board.AddLayoutRow(y, row.data());
+		}
+	}
+	Close();
+
+	IsRead = IsRead && (revealedPath.empty() || ReadLayer(board, revealedPath, GameBoard::LayoutRevealed));
+	IsRead = IsRead && (flaggedPath.empty() || ReadLayer(board, flaggedPath, GameBoard::LayoutFlagged));
+	if (!IsRead) {
+		board.BeginLayout(board.GetCols(), board.GetRows());
+		return false;
+	}
+
+	std::string layoutError;
+	if (!board.FinishLayout(layoutError)) {
+		error = minesPath + ": " + layoutError;
+		return false;
+	}
+	return true;
+}
+
+// Adds the cells of a layer file (revealed or flagged) to the layout in the board, the layer must be the same size
+bool LayoutImporter::ReadLayer(GameBoard& board, const std::string& path, uint8_t layerBit) {
+
+	bool IsRead = Open(path) && ReadHeader();
+	if (IsRead && (cols != board.GetCols() || rows != board.GetRows())) {
+		IsRead = Fail("is " + std::to_string(cols) + " x " + std::to_string(rows) + ", the layout is "
+			+ std::to_string(board.GetCols()) + " x " + std::to_string(board.GetRows()));
+	}
+	for (int y = 0; y < rows && IsRead; y++) {
+		IsRead = ReadRow(y, layerBit);
+		if (IsRead) {
+			board.AddLayoutRow(y, row.data());
+		}
+	}
+	Close();
+	return IsRead;
+}
+
+std::string LayoutImporter::FindLayerPath(const std::string& path, const std::string& layerName) {
+
+	// The layer name goes before the extension
+	size_t dot = path.find_last_of('.');
+	size_t slash = path.find_last_of("/\\");
+	bool HasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+	std::string layerPath = HasExtension ? path.substr(0, dot) + "." + layerName + path.substr(dot) : path + "." + layerName;
+
+	FILE* layerFile = fopen(layerPath.c_str(), "rb");
+	if (layerFile == nullptr) {
+		return "";
+	}
+	fclose(layerFile);
+	return layerPath;
+}
+
+bool LayoutImporter::Open(const std::string& path) {
+
+	this->path = path;
+	file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		return Fail("can't be opened");
+	}
+	buffer.resize(blockBytes);
+	position = 0;
+	end = 0;
+	return true;
+}
+
+void LayoutImporter::Close() {
+
+	if (file != nullptr) {
+		fclose(file);
+		file = nullptr;
+	}
+}
+
+// Goes back to the start of the file
+void LayoutImporter::Rewind() {
+
+	rewind(file);
+	position = 0;
+	end = 0;
+}
+
+bool LayoutImporter::Fail(const std::string& message) {
+
+	error = path + " " + message;
+	return false;
+}
+
+// Finds the format and size of the file, and leaves it at its first row
+bool LayoutImporter::ReadHeader() {
+
+	int first = Get();
+	int second = Get();
+	if (first == 'P' && (second == '1' || second == '4')) {
+		format = second == '1' ? Format::PlainPbm : Format::RawPbm;
+		if (!ReadNumber(cols) || !ReadNumber(rows)) {
+			return Fail("doesn't have a valid PBM size");
+		}
+
+		// The rows of a raw PBM start after one whitespace character
+		if (format == Format::RawPbm && !isspace(Get())) {
+			return Fail("doesn't have a valid PBM header");
+		}
+	}
+	else {
+		format = Format::Text;
+		if (!CountTextRows()) {
+			return false;
+		}
+	}
+
+	if (cols <= 0 || rows <= 0) {
+		return Fail("is empty");
+	}
+	if (static_cast<int64_t>(cols) * rows > MaxCells) {
+		return Fail("is too big (" + std::to_string(cols) + " x " + std::to_string(rows) + " cells)");
+	}
+	if (cols > maxCols || rows > maxRows) {
+		return Fail("is too big (" + std::to_string(cols) + " x " + std::to_string(rows) + " cells, layouts of up to " +
+			std::to_string(maxCols) + " x " + std::to_string(maxRows) + " cells can be played)");
+	}
+	row.assign(cols, 0);
+	packedRow.assign((cols + 7) / 8, 0);
+	return true;
+}
+
+// Finds the size of a text grid by a first pass over the file (the width of the first line, and the # of lines up to
+// the last one that isn't empty), then goes back to its start
+bool LayoutImporter::CountTextRows() {
+
+	Rewind();
+	int64_t lineCount = 0;
+	int64_t lastLine = 0;
+	int64_t length = 0;
+	int64_t firstLength = -1;
+	while (Fill()) {
+		for (size_t i = 0; i < end; i++) {
+			uint8_t c = buffer[i];
+			if (c == '\n') {
+				firstLength = firstLength < 0 ? length : firstLength;
+				lineCount++;
+				lastLine = length > 0 ? lineCount : lastLine;
+				length = 0;
+			}
+			else if (c != '\r') {
+				length++;
+			}
+		}
+	}
+	if (length > 0) {
+		firstLength = firstLength < 0 ? length : firstLength;
+		lastLine = ++lineCount;
+	}
+	Rewind();
+
+	if (firstLength > MaxCells || lastLine > MaxCells) {
+		return Fail("is too big");
+	}
+	cols = static_cast<int>(std::max<int64_t>(firstLength, 0));
+	rows = static_cast<int>(lastLine);
+	return true;
+}
+
+// Reads a number of a PBM header (after whitespace and comments)
+bool LayoutImporter::ReadNumber(int& value) {
+
+	int c = Get();
+	while (isspace(c) || c == '#') {
+		if (c == '#') {
+			while (c != '\n' && c != EOF) {
+				c = Get();
+			}
+		}
+		c = Get();
+	}
+
+	value = 0;
+	if (!isdigit(c)) {
+		return false;
+	}
+	// A number bigger than MaxCells is refused before it is made (a hostile file would overflow it)
+	while (isdigit(c)) {
+		int digit = c - '0';
+		if (value > (MaxCells - digit) / 10) {
+			return false;
+		}
+		value = value * 10 + digit;
+		c = Get();
+	}
+
+	// The character after the number is whitespace, which ends a raw header, so it is given back
+	if (c != EOF) {
+		position--;
+	}
+	return true;
+}
+
+// Reads a row of the file into row, as LayoutCell values (layerBit for the set cells of a layer, 0 for the layout)
+bool LayoutImporter::ReadRow(int yPos, uint8_t layerBit) {
+
+	uint8_t setValue = layerBit != 0 ? layerBit : static_cast<uint8_t>(GameBoard::LayoutMine);
+
+	if (format == Format::RawPbm) {
+
+		// Copy the bytes of the row from the blocks read, then unpack the bits (the first cell is the high bit)
+		size_t copied = 0;
+		while (copied < packedRow.size()) {
+			if (position == end && !Fill()) {
+				return Fail("ends at row " + std::to_string(yPos + 1) + " of " + std::to_string(rows));
+			}
+			size_t count = std::min(packedRow.size() - copied, end - position);
+			memcpy(&packedRow[copied], &buffer[position], count);
+			copied += count;
+			position += count;
+		}
+		for (int x = 0; x < cols; x++) {
+			row[x] = (packedRow[x >> 3] >> (7 - (x & 7))) & 1 ? setValue : 0;
+		}
+		return true;
+	}
+
+	if (format == Format::PlainPbm) {
+		for (int x = 0; x < cols; x++) {
+			int c = Get();
+			while (isspace(c)) {
+				c = Get();
+			}
+			if (c == EOF) {
+				return Fail("ends at row " + std::to_string(yPos + 1) + " of " + std::to_string(rows));
+			}
+			if (c != '0' && c != '1') {
+				return Fail("has '" + std::string(1, static_cast<char>(c)) + "' in row " + std::to_string(yPos + 1));
+			}
+			row[x] = c == '1' ? setValue : 0;
+		}
+		return true;
+	}
+
+	// A line of a text grid, which must be as long as the first one
+	int length = 0;
+	for (int c = Get(); c != '\n' && c != EOF; c = Get()) {
+		if (c == '\r') {
+			continue;
+		}
+		int cell = layerBit != 0 ? (c == '.' ? 0 : layerBit) : TextCell(c);
+		if (cell < 0) {
+			return Fail("has '" + std::string(1, static_cast<char>(c)) + "' on line " + std::to_string(yPos + 1) + ", which isn't a cell");
+		}
+		if (length < cols) {
+			row[length] = static_cast<uint8_t>(cell);
+		}
+		length++;
+	}
+	if (length != cols) {
+		return Fail("has " + std::to_string(length) + " cells on line " + std::to_string(yPos + 1) + ", the first line has " + std::to_string(cols));
+	}
+	return true;
+}
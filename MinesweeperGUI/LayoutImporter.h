@@ -0,0 +1,83 @@
+#pragma once
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "GameBoard.h"
+
+// Loads a known mine layout into a GameBoard (designed puzzles, hard positions, regression boards) in place of random
+// bombs. The file is never read into memory as a whole: it is read in blocks, and each row goes into the board as
+// soon as it is read and checked. Two formats are read:
+//   - PBM bitmaps, plain (P1) or raw (P4), where a black (1) pixel is a mine
+//   - text grids with a line per row: '.' covered, '*' mine, 'F' flagged mine, 'f' flag on a safe cell, 'o' revealed,
+//     '0' - '8' revealed showing that number (checked against the mines around the cell)
+// The revealed and flagged cells can also come from layer files of the same size in either format, where a 1 pixel
+// or any character but '.' is a revealed or flagged cell
+class LayoutImporter
+{
+public:
+
+	// Define the largest layout that can be loaded
+	static const int64_t MaxCells = int64_t(1) << 30;
+
+	// Loads a layout and its optional layers (an empty path for none) into the board. Returns false with a message in
+	// GetError if a file can't be read or the layout isn't valid, the board is then left without bombs
+	bool Import(GameBoard& board, const std::string& minesPath, const std::string& revealedPath = "", const std::string& flaggedPath = "");
+	const std::string& GetError() const { return error; }
+
+	// Sets the largest layout the caller can play. A bigger file is refused from its header, before the board is sized
+	void SetMaxSize(int maxCols, int maxRows) {
+		this->maxCols = maxCols;
+		this->maxRows = maxRows;
+	}
+
+	// Returns the path of a layer next to a layout file ("board.revealed.pbm" for "board.pbm" and "revealed"),
+	// or "" if there is no such file
+	static std::string FindLayerPath(const std::string& path, const std::string& layerName);
+
+private:
+
+	enum class Format : uint8_t {
+		PlainPbm,
+		RawPbm,
+		Text
+	};
+
+	bool Open(const std::string& path);
+	void Close();
+	bool ReadHeader();
+	bool CountTextRows();
+	bool ReadNumber(int& value);
+	bool ReadRow(int yPos, uint8_t layerBit);
+	bool ReadLayer(GameBoard& board, const std::string& path, uint8_t layerBit);
+	bool Fail(const std::string& message);
+	void Rewind();
+
+	// Define the buffered reads of the file (Get returns EOF at the end of the file)
+	bool Fill() {
+		position = 0;
+		end = fread(buffer.data(), 1, buffer.size(), file);
+		return end > 0;
+	}
+	int Get() {
+		return position < end || Fill() ? buffer[position++] : EOF;
+	}
+
+	// Define the file being read, its format and size, and the block of it in memory
+	FILE* file = nullptr;
+	std::string path;
+	Format format = Format::Text;
+	int cols = 0;
+	int rows = 0;
+	int maxCols = INT_MAX;
+	int maxRows = INT_MAX;
+	std::vector<uint8_t> buffer;
+	size_t position = 0;
+	size_t end = 0;
+
+	// Define the row being read (LayoutCell values) and the bytes of a raw PBM row
+	std::vector<uint8_t> row;
+	std::vector<uint8_t> packedRow;
+	std::string error;
+};
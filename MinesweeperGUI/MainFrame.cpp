@@ -1,9 +1,14 @@
 ﻿#include "MainFrame.h"
 #include <wx/wx.h>
-#include <map>
 #include <random>
 #include <wx/msgdlg.h>
+#include <wx/filedlg.h>
+#include <wx/progdlg.h>
+#include <wx/dcbuffer.h>
+#include <wx/stopwatch.h>
+#include <algorithm>
 #include <cmath>
+#include <ctime>
 
 // Create Event table to handle Top bar buttons
 wxBEGIN_EVENT_TABLE(MainFrame, wxFrame)
@@ -11,17 +16,99 @@ EVT_BUTTON(homeButtonID, MainFrame::OnHomeClicked)
 EVT_BUTTON(hintButtonID, MainFrame::OnButtonHintClicked)
 EVT_BUTTON(flagButtonID, MainFrame::OnButtonFlagClicked)
 EVT_BUTTON(restartButtonID, MainFrame::OnButtonRestartClicked)
+EVT_BUTTON(undoButtonID, MainFrame::OnButtonUndoClicked)
+EVT_BUTTON(redoButtonID, MainFrame::OnButtonRedoClicked)
+EVT_BUTTON(zoomInButtonID, MainFrame::OnButtonZoomInClicked)
+EVT_BUTTON(zoomOutButtonID, MainFrame::OnButtonZoomOutClicked)
+EVT_MENU(undoButtonID, MainFrame::OnButtonUndoClicked)
+EVT_MENU(redoButtonID, MainFrame::OnButtonRedoClicked)
 wxEND_EVENT_TABLE()
 
+// Define the sizes of the cells for the zoom levels that show the cells (each cell has a grid line on its right and bottom)
+static const int cellZoomSizes[] = { 60, 45, 30, 20 };
+
+// Define the colors of the minimap and the zoomed out views (covered, revealed, flagged)
+static const MipPyramid::Palette minimapPalette = { { 160, 160, 160 }, { 235, 235, 235 }, { 220, 0, 0 } };
+
+// Define the size of the minimap shown next to the grid
+static const int minimapSize = 200;
+
+// Define the largest custom grid width and height (the grid is drawn, there is no window per cell)
+static const int maxGridSide = 4000;
+
+// Define the moves whose cells are shown by the reveal animation (a slice at a time from idle events), and the time
+// spent on a slice: with the paint that follows it the window still handles input within a 16 ms frame
+static const size_t revealAnimationCells = 4096;
+static const long long revealSliceMicroseconds = 6000;
+
 // Create window, call Start to build UI
-MainFrame::MainFrame(const wxString& title) : wxFrame(nullptr, wxID_ANY, title) {
+MainFrame::MainFrame(const wxString& title, StatsStore& stats) : wxFrame(nullptr, wxID_ANY, title), stats(stats) {
 	Start();
 }
 
+// Stops the engine thread (cancelling the first reveal if it is still running), the board must outlive it. The
+// profiler is stopped first, so no profile comes back to a window being destroyed
+MainFrame::~MainFrame() {
+	profiler.Stop();
+	engine.Stop();
+}
+
 // Creates Main Menu and status bar when program is started
 void MainFrame::Start() {
 	SetupMainMenu();
 	CreateStatusBar();
+
+	// The timer shows the progress of the first reveal
+	generationTimer.SetOwner(this);
+	this->Bind(wxEVT_TIMER, &MainFrame::OnGenerationTimer, this);
+
+	// The first idle event comes once the menu is shown and every event before it was handled
+	this->Bind(wxEVT_IDLE, &MainFrame::OnMenuIdle, this);
+}
+
+// Shows how long the menu took to handle input from the window being created (only once)
+void MainFrame::OnMenuIdle(wxIdleEvent& evt) {
+
+	this->Unbind(wxEVT_IDLE, &MainFrame::OnMenuIdle, this);
+	SetStatusText(wxString::Format("Menu ready in %.1f ms", startupStopWatch.TimeInMicro().ToDouble() / 1000.0));
+	evt.Skip();
+}
+
+// Shows the statistics of every board played, from the summary (however many games were played, the log isn't read)
+void MainFrame::OnStatsClicked(wxCommandEvent& evt) {
+
+	const std::vector<BoardStats>& boards = stats.GetSummary().GetBoards();
+	if (boards.empty()) {
+		wxMessageBox("No games played yet! (games in training mode, with an assist or on a loaded layout aren't counted)", "Statistics", wxOK | wxICON_INFORMATION);
+		return;
+	}
+
+	wxString text;
+	for (const BoardStats& boardStats : boards) {
+		wxString name = wxString::Format("%d x %d, %u mines", boardStats.nCols, boardStats.nRows, boardStats.numberOfBombs);
+		if (boardStats.topology != static_cast<uint8_t>(TopologyType::Standard) && boardStats.topology < topologyOptions.GetCount()) {
+			name += ", " + topologyOptions[boardStats.topology];
+		}
+		text += FormatStats(name, boardStats);
+	}
+	if (boards.size() > 1) {
+		text += FormatStats("All boards", stats.GetSummary().GetTotal());
+	}
+	wxMessageBox(text, "Statistics", wxOK | wxICON_INFORMATION);
+	evt.Skip();
+}
+
+// Formats the statistics of a board: the games won, the streaks, and the clear times and 3BV/s of the games won
+wxString MainFrame::FormatStats(const wxString& name, const BoardStats& boardStats) {
+
+	wxString text = wxString::Format("%s\n    %u games, %u won (%.0f%%), streak %u (best %u)\n", name, boardStats.games, boardStats.wins,
+		boardStats.games == 0 ? 0.0 : boardStats.wins * 100.0 / boardStats.games, boardStats.currentStreak, boardStats.bestStreak);
+	if (boardStats.wins > 0) {
+		const QuantileSketch& times = boardStats.winTimes;
+		text += wxString::Format("    best %.1f s, median %.1f s, 90%% %.1f s, %.2f 3BV/s\n", boardStats.bestMilliseconds / 1000.0,
+			times.GetQuantile(0.5) / 1000.0, times.GetQuantile(0.9) / 1000.0, boardStats.Get3BVPerSecond());
+	}
+	return text;
 }
 
 // This creates the panels, sizers, and controls for the main menu
@@ -72,8 +159,40 @@ void MainFrame::SetupMainMenu() {
 	// add sizer holding radio box and start button to a vertical sizer
 	vertOptionsSizer->Add(middleSizer, wxSizerFlags());
 
-	// Set up the manual input fields for grid size and number of bombs
-	SetupCustomInputs();
+	// Create the training mode check box (moves can be undone and redone in training mode)
+	trainingModeCheckBox = new wxCheckBox(panel, wxID_ANY, "Training Mode (undo / redo)");
+	trainingModeCheckBox->SetFont(fieldInputFont);
+	vertOptionsSizer->Add(trainingModeCheckBox, wxSizerFlags().Border(wxTOP, 5));
+
+	// Create the check boxes of the assist modes (the moves the numbers force are made after each move)
+	wxBoxSizer* assistSizer = new wxBoxSizer(wxHORIZONTAL);
+	autoFlagCheckBox = new wxCheckBox(panel, wxID_ANY, "Auto-flag");
+	autoFlagCheckBox->SetFont(fieldInputFont);
+	autoChordCheckBox = new wxCheckBox(panel, wxID_ANY, "Auto-chord");
+	autoChordCheckBox->SetFont(fieldInputFont);
+	assistSizer->Add(autoFlagCheckBox);
+	assistSizer->Add(autoChordCheckBox, wxSizerFlags().Border(wxLEFT, 20));
+	vertOptionsSizer->Add(assistSizer, wxSizerFlags().Border(wxTOP, 5));
+
+	// Create the button that shows the statistics of the games played
+	statsButton = new wxButton(panel, wxID_ANY, "Statistics");
+	statsButton->SetFont(fieldInputFont);
+	vertOptionsSizer->Add(statsButton, wxSizerFlags().Border(wxTOP, 5));
+	statsButton->Bind(wxEVT_COMMAND_BUTTON_CLICKED, &MainFrame::OnStatsClicked, this);
+
+	// Create the radio box used to pick the shape of the board (the order matches TopologyType)
+	topologyOptions.Add("Standard");
+	topologyOptions.Add("Toroidal (edges wrap)");
+	topologyOptions.Add("Hexagonal");
+	topologyOptions.Add("Knight's Move");
+	topologySelector = new wxRadioBox(panel, wxID_ANY,
+		"Select a Board Shape", wxDefaultPosition,
+		wxDefaultSize, topologyOptions, 2, wxRA_SPECIFY_COLS);
+	vertOptionsSizer->Add(topologySelector, wxSizerFlags().Border(wxTOP, 5).Expand());
+
+	// Create the sizer for the manual input fields for grid size and number of bombs
+	// (the fields are only created when the user presses "Custom")
+	lowerSizer = new wxBoxSizer(wxVERTICAL);
 
 	// Add manual input field to vertical sizer, add the vertical sizer to a horizontal sizer
 	// so that it will be alligned with the headline text when assigned to the main sizer
@@ -81,9 +200,6 @@ void MainFrame::SetupMainMenu() {
 	optionsSizer->Add(vertOptionsSizer);
 	mainSizer->Add(optionsSizer, wxSizerFlags().CenterHorizontal());
 
-	// Hide the custom input field (until user presses "Custom" button)
-	HideCustomInputs();
-
 	// assign main sizer to the panel and format properly
 	panel->SetSizerAndFit(mainSizer);
 	mainSizer->SetSizeHints(this);
@@ -93,6 +209,8 @@ void MainFrame::SetupMainMenu() {
 // When the main menu start button is pressed, this will determine what grid size to use
 // and will begin the game
 void MainFrame::OnStartClicked(wxCommandEvent& evt) {
+
+	firstFrameStopWatch.Start();
 	
 	// Checks if user has clicked on the Custom button before hitting start
 	if (gridSizerSelector->GetSelection() == 3)  
@@ -118,14 +236,93 @@ void MainFrame::OnStartClicked(wxCommandEvent& evt) {
 		numberOfBombs = 15;
 	}
 
-	// resize vector of vectors to proper grid size specified by user's choice
-	buttons.resize(nCols, std::vector<ButtonData>(nRows));
+	// Set up the board's rules, the engine thread sizes it for the grid once the game screen is shown
+	board.SetTrainingMode(trainingModeCheckBox->GetValue());
+	board.SetAssistModes((autoFlagCheckBox->GetValue() ? GameBoard::AutoFlag : 0) | (autoChordCheckBox->GetValue() ? GameBoard::AutoChord : 0));
+	board.SetTopology(static_cast<TopologyType>(topologySelector->GetSelection()));
+	board.SetRegionTracking(true);
+	ShowGame();
+}
+
+// Loads a mine layout chosen by the user (with the revealed and flagged layers next to it, if there are any),
+// and starts a game on it with the board shape and training mode picked in the menu
+void MainFrame::OnLoadLayoutClicked(wxCommandEvent& evt) {
+
+	wxFileDialog dialog(this, "Load a Mine Layout", "", "", "Mine layouts (*.pbm;*.txt)|*.pbm;*.txt|All files|*", wxFD_OPEN | wxFD_FILE_MUST_EXIST);
+	if (dialog.ShowModal() == wxID_CANCEL) {
+		return;
+	}
+	std::string path = dialog.GetPath().ToStdString();
+
+	board.SetTrainingMode(trainingModeCheckBox->GetValue());
+	board.SetAssistModes((autoFlagCheckBox->GetValue() ? GameBoard::AutoFlag : 0) | (autoChordCheckBox->GetValue() ? GameBoard::AutoChord : 0));
+	board.SetTopology(static_cast<TopologyType>(topologySelector->GetSelection()));
+	board.SetRegionTracking(true);
+	// The grid shows as many cells as a custom grid can have, a bigger layout is refused before the board is sized
+	LayoutImporter importer;
+	importer.SetMaxSize(maxGridSide, maxGridSide);
+	if (!importer.Import(board, path, LayoutImporter::FindLayerPath(path, "revealed"), LayoutImporter::FindLayerPath(path, "flagged"))) {
+		wxMessageBox(importer.GetError(), "Layout Error", wxOK | wxICON_ERROR);
+		return;
+	}
+	nCols = board.GetCols();
+	nRows = board.GetRows();
+	numberOfBombs = board.GetNumberOfBombs();
+
+	// The first frame is timed from the layout being loaded
+	firstFrameStopWatch.Start();
+	ShowGame();
+	evt.Skip();
+}
+
+// Sets up the game screen for the grid and hands the board over to the engine thread. Only what the first frame of
+// the grid needs is set up here: the engine sizes the board while the grid is painted, and the minimap is set up
+// after the first frame (BuildPyramid)
+void MainFrame::ShowGame() {
+
+	IsFirstFramePending = true;
+	IsPyramidReady = false;
 
 	// Hide the main menu, set up the UI elements for the grid
 	HideMainMenu();
 	SetupPanels();
 	SetupSizers();
 
+	// From here on only the engine thread uses the board, the grid shows the results of the moves sent to it
+	visibleCells.assign(static_cast<size_t>(nCols) * nRows, GameBoard::Covered);
+	gameStatus = GameBoard::Status::NotStarted;
+	flagsPlaced = 0;
+	IsRegionCountPending = false;
+	IsRegionCountStale = false;
+
+	// Every game of the screen is played on the same board, with the same options
+	gameRecord = {};
+	gameRecord.nCols = static_cast<uint16_t>(nCols);
+	gameRecord.nRows = static_cast<uint16_t>(nRows);
+	gameRecord.numberOfBombs = numberOfBombs;
+	gameRecord.topology = static_cast<uint8_t>(board.GetTopology());
+	gameRecord.options = (board.IsInTrainingMode() ? TrainingModeGame : 0) | (board.HasLayout() ? LayoutGame : 0) |
+		(board.GetAssistModes() != 0 ? AssistedGame : 0);
+	engine.Start(board, [this]() { CallAfter([this]() { OnEngineResults(); }); });
+
+	// A layout is on from the start, the cells it reveals and flags are shown by starting it again on the engine
+	if (board.HasLayout()) {
+		gameStatus = board.GetStatus();
+		SubmitMove(EngineThread::CommandType::NewGame, 0, 0, board.GetSeed());
+	}
+	else {
+
+		// A random game's board is sized by the engine, the grid doesn't wait for it
+		EngineThread::Command command;
+		command.type = EngineThread::CommandType::Resize;
+		command.width = nCols;
+		command.height = nRows;
+		command.numberOfBombs = numberOfBombs;
+		command.seed = CreateSeed();
+		engine.Submit(command);
+	}
+	RequestRegionCount();
+
 }
 
 // Determines if the user entered valid custom grid size and number of bombs
@@ -138,7 +335,7 @@ bool MainFrame::HandleCustomSelection() {
 
 	// Determines If user input for grid width is allowed 
 	if (!ValidateInput(gridWidthStr, false)) {
-		wxMessageBox("Invalid Grid Width! Please enter a number between 5 and 50.",
+		wxMessageBox("Invalid Grid Width! Please enter a number between 5 and 4000.",
 			"Input Error",
 			wxOK | wxICON_ERROR);
 		return false;
@@ -146,7 +343,7 @@ bool MainFrame::HandleCustomSelection() {
 
 	// Determines If user input for grid height is allowed 
 	if (!ValidateInput(gridHeightStr, false)) {
-		wxMessageBox("Invalid Grid Height! Please enter a number between 5 and 50.",
+		wxMessageBox("Invalid Grid Height! Please enter a number between 5 and 4000.",
 			"Input Error",
 			wxOK | wxICON_ERROR);
 		return false;
@@ -154,7 +351,7 @@ bool MainFrame::HandleCustomSelection() {
 
 	// Determines If user input for number of bombs is allowed 
 	if (!ValidateInput(numBombsStr, true)) {
-		wxMessageBox("Invalid Bomb Count! Please enter a number between 5 and 2490.",
+		wxMessageBox("Invalid Bomb Count! Please enter a number of at least 5.",
 			"Input Error",
 			wxOK | wxICON_ERROR);
 		return false;
@@ -193,24 +390,21 @@ void MainFrame::HideMainMenu() {
 	// Hide all elements of the main menu
 	headlineText->Hide();
 	gridSizerSelector->Hide();
-	gridWidthStaticText->Hide();
-	gridWidthTextCtrl->Hide();
-	gridHeightStaticText->Hide();
-	gridHeightTextCtrl->Hide();
-	numBombsStaticText->Hide();
-	numBombsTextCtrl->Hide();
+	lowerSizer->ShowItems(false);
 	startButton->Hide();
+	trainingModeCheckBox->Hide();
+	autoFlagCheckBox->Hide();
+	autoChordCheckBox->Hide();
+	statsButton->Hide();
+	topologySelector->Hide();
 
 	// Update layout 
 	panel->Layout();
 }
 
-// Creates input fields for grid width, height, and number of bombs
+// Creates input fields for grid width, height, and number of bombs (in the lower sizer, the first time they are shown)
 void MainFrame::SetupCustomInputs() {
 
-	// Create sizer to hold all text & input fields
-	lowerSizer = new wxBoxSizer(wxVERTICAL);
-
 	// Create labels for input fields 
 	gridWidthStaticText = new wxStaticText(panel, wxID_ANY, "Enter Grid Width");
 	gridHeightStaticText = new wxStaticText(panel, wxID_ANY, "Enter Grid Height");
@@ -221,6 +415,11 @@ void MainFrame::SetupCustomInputs() {
 	gridHeightTextCtrl = new wxTextCtrl(panel, wxID_ANY, "", wxDefaultPosition, wxSize(200, 40));
 	numBombsTextCtrl = new wxTextCtrl(panel, wxID_ANY, "", wxDefaultPosition, wxSize(200, 40));
 
+	// Create the button that loads a mine layout from a file (PBM or text grid) in place of random mines
+	loadLayoutButton = new wxButton(panel, wxID_ANY, "Load Layout...", wxDefaultPosition, wxSize(200, 40));
+	loadLayoutButton->SetFont(fieldInputFont);
+	loadLayoutButton->Bind(wxEVT_COMMAND_BUTTON_CLICKED, &MainFrame::OnLoadLayoutClicked, this);
+
 	// Assign fonts to the label texts
 	gridWidthStaticText->SetFont(fieldInputFont);
 	gridHeightStaticText->SetFont(fieldInputFont);
@@ -233,33 +432,27 @@ void MainFrame::SetupCustomInputs() {
 	lowerSizer->Add(gridHeightTextCtrl, wxSizerFlags());
 	lowerSizer->Add(numBombsStaticText, wxSizerFlags().Border(wxTOP, 10));
 	lowerSizer->Add(numBombsTextCtrl, wxSizerFlags());
+	lowerSizer->Add(loadLayoutButton, wxSizerFlags().Border(wxTOP, 10));
 }
 
 // Displays the custom input fields
 void MainFrame::ShowCustomInputs() {
 	
-	gridWidthStaticText->Show();
-	gridWidthTextCtrl->Show();
-	gridHeightStaticText->Show();
-	gridHeightTextCtrl->Show();
-	numBombsStaticText->Show();
-	numBombsTextCtrl->Show();
+	if (lowerSizer->IsEmpty()) {
+		SetupCustomInputs();
+	}
+	lowerSizer->ShowItems(true);
 
 	panel->Layout();
 
 	// change size of window to ensure that input fields are visible 
-	this->SetSize(500, 560);
+	this->SetSize(500, 600);
 }
 
 // Hide the custom input fields
 void MainFrame::HideCustomInputs() {
 
-	gridWidthStaticText->Hide();
-	gridWidthTextCtrl->Hide();
-	gridHeightStaticText->Hide();
-	gridHeightTextCtrl->Hide();
-	numBombsStaticText->Hide();
-	numBombsTextCtrl->Hide();
+	lowerSizer->ShowItems(false);
 
 	panel->Layout();
 }
@@ -284,7 +477,7 @@ void MainFrame::GoToMainMenu() {
 	this->Close(true);
 
 	// Create a new instance of the MainFrame 
-	MainFrame* newFrame = new MainFrame("Minesweeper");
+	MainFrame* newFrame = new MainFrame("Minesweeper", stats);
 	newFrame->SetClientSize(500, 500);
 	newFrame->Center();
 	newFrame->Show(true);
@@ -306,10 +499,31 @@ void MainFrame::SetupPanels() {
 	restartButton = new wxButton(panel, restartButtonID, restartChar, wxDefaultPosition, wxSize(50, 50));
 	restartButton->SetFont(headlineFont);
 
+	// Create the undo and redo buttons in training mode
+	if (board.IsInTrainingMode()) {
+		undoButton = new wxButton(panel, undoButtonID, undoChar, wxDefaultPosition, wxSize(50, 50));
+		undoButton->SetFont(headlineFont);
+
+		redoButton = new wxButton(panel, redoButtonID, redoChar, wxDefaultPosition, wxSize(50, 50));
+		redoButton->SetFont(headlineFont);
+	}
+
+	// Create the zoom buttons (the grid zooms out to views drawn from the minimap)
+	zoomOutButton = new wxButton(panel, zoomOutButtonID, zoomOutChar, wxDefaultPosition, wxSize(50, 50));
+	zoomOutButton->SetFont(headlineFont);
+
+	zoomInButton = new wxButton(panel, zoomInButtonID, zoomInChar, wxDefaultPosition, wxSize(50, 50));
+	zoomInButton->SetFont(headlineFont);
+	zoomInButton->Disable();
+
 	numBombsRemainingString = wxString::Format("%d", numberOfBombs);
 	numBombsRemainingTextCtrl = new wxTextCtrl(panel, wxID_ANY, numBombsRemainingString, wxDefaultPosition, wxSize(100, 50), wxTE_CENTER);
 	numBombsRemainingTextCtrl->SetFont(headlineFont);
 	numBombsRemainingTextCtrl->Disable();
+
+	// Create the count of the mines left in the part of the grid in view (kept up to date by the engine's region index)
+	regionMinesText = new wxStaticText(panel, wxID_ANY, "", wxDefaultPosition, wxSize(120, -1));
+	regionMinesText->SetFont(mainFont);
 	
 }
 
@@ -320,397 +534,576 @@ void MainFrame::SetupSizers() {
 	headlineTextGame = new wxStaticText(panel, wxID_ANY, "Minesweeper", wxDefaultPosition, wxDefaultSize);
 	headlineTextGame->SetFont(headlineFont);
 
-	// Create sizers for the game window, top bar, and grid 
+	// Create sizers for the game window and top bar
 	wxBoxSizer* mainSizerGame = new wxBoxSizer(wxVERTICAL);
 	wxBoxSizer* topBarSizerGame = new wxBoxSizer(wxHORIZONTAL);
-	gridSizer = new wxGridSizer(nCols, nRows, 0, 0);
 
 	// Add the hint button, flag button, headline text, and restart button to the top bar 
 	topBarSizerGame->Add(homeButton, wxSizerFlags().Border(wxRIGHT, 20));
 	topBarSizerGame->Add(hintButton, wxSizerFlags().Border(wxRIGHT, 20));
 	topBarSizerGame->Add(flagButton, wxSizerFlags().Border(wxRIGHT, 20));
 	topBarSizerGame->Add(numBombsRemainingTextCtrl, wxSizerFlags().Border(wxRIGHT, 20));
+	topBarSizerGame->Add(regionMinesText, wxSizerFlags().Center().Border(wxRIGHT, 20));
 	topBarSizerGame->Add(headlineTextGame, wxALL | wxEXPAND | wxCENTER);
 	topBarSizerGame->Add(restartButton, wxSizerFlags().Border(wxLEFT, 20));
 
+	// In training mode add the undo and redo buttons, and Ctrl+Z / Ctrl+Y shortcuts for them
+	if (board.IsInTrainingMode()) {
+		topBarSizerGame->Add(undoButton, wxSizerFlags().Border(wxLEFT, 20));
+		topBarSizerGame->Add(redoButton, wxSizerFlags().Border(wxLEFT, 5));
+
+		wxAcceleratorEntry shortcuts[2];
+		shortcuts[0].Set(wxACCEL_CTRL, static_cast<int>('Z'), undoButtonID);
+		shortcuts[1].Set(wxACCEL_CTRL, static_cast<int>('Y'), redoButtonID);
+		this->SetAcceleratorTable(wxAcceleratorTable(2, shortcuts));
+	}
+
+	// Add the zoom buttons after the other buttons
+	topBarSizerGame->Add(zoomOutButton, wxSizerFlags().Border(wxLEFT, 20));
+	topBarSizerGame->Add(zoomInButton, wxSizerFlags().Border(wxLEFT, 5));
+
 	// add top bar sizer to the main sizer
 	mainSizerGame->Add(topBarSizerGame, wxSizerFlags().CenterHorizontal());
 
-	// Create the scrolled window for the grid
+	// Create the scrolled window for the grid, the grid is painted in it from the render cache
 	scrolledWindow = new wxScrolledWindow(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxVSCROLL | wxHSCROLL);
 	scrolledWindow->SetScrollRate(5, 5);  
+	scrolledWindow->SetBackgroundStyle(wxBG_STYLE_PAINT);
 	scrolledWindow->Bind(wxEVT_MOUSEWHEEL, &MainFrame::OnMouseWheelScroll, this);
+	scrolledWindow->Bind(wxEVT_PAINT, &MainFrame::OnGridPaint, this);
+	scrolledWindow->Bind(wxEVT_SIZE, &MainFrame::OnGridSize, this);
 
-	// Call function to generate the button matrix, assigning each onto the gridSizer
-	CreateMatrix();
+	// Use dynamic event handling for right and left clicking on a cell
+	scrolledWindow->Bind(wxEVT_LEFT_DOWN, &MainFrame::OnGridLeftDown, this);
+	scrolledWindow->Bind(wxEVT_RIGHT_DOWN, &MainFrame::OnGridRightDown, this);
+
+	// Redraw the cell images when the window moves to a display with a different DPI
+	this->Bind(wxEVT_DPI_CHANGED, &MainFrame::OnDpiChanged, this);
 
-	// Add grid sizer to a scrolled window
-	scrolledWindow->SetSizerAndFit(gridSizer);
+	// Call function to set up the cells of the grid
+	CreateMatrix();
 
-	// Add scrolled window to the main sizer
-	mainSizerGame->Add(scrolledWindow, wxSizerFlags().Expand().Proportion(1));
+	// Create the zoomed out view of the grid, it takes the place of the cells when zoomed out
+	overviewWindow = new wxScrolledWindow(panel, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxVSCROLL | wxHSCROLL);
+	overviewWindow->SetScrollRate(5, 5);
+	overviewWindow->SetBackgroundStyle(wxBG_STYLE_PAINT);
+	overviewWindow->Bind(wxEVT_PAINT, &MainFrame::OnOverviewPaint, this);
+	overviewWindow->Bind(wxEVT_LEFT_DOWN, &MainFrame::OnOverviewClick, this);
+	overviewWindow->Bind(wxEVT_MOUSEWHEEL, &MainFrame::OnMouseWheelScroll, this);
+	overviewWindow->Hide();
+
+	// Create the minimap, clicking or dragging on it moves the view
+	minimapPanel = new wxPanel(panel, wxID_ANY, wxDefaultPosition, wxSize(minimapSize, minimapSize));
+	minimapPanel->SetBackgroundStyle(wxBG_STYLE_PAINT);
+	minimapPanel->Bind(wxEVT_PAINT, &MainFrame::OnMinimapPaint, this);
+	minimapPanel->Bind(wxEVT_LEFT_DOWN, &MainFrame::OnMinimapMouse, this);
+	minimapPanel->Bind(wxEVT_MOTION, &MainFrame::OnMinimapMouse, this);
+
+	// The minimap follows the view when it is scrolled
+	this->Bind(wxEVT_IDLE, &MainFrame::OnIdle, this);
+
+	// Add the scrolled window, the zoomed out view, and the minimap to the main sizer
+	wxBoxSizer* boardSizer = new wxBoxSizer(wxHORIZONTAL);
+	boardSizer->Add(scrolledWindow, wxSizerFlags().Expand().Proportion(1));
+	boardSizer->Add(overviewWindow, wxSizerFlags().Expand().Proportion(1));
+	boardSizer->Add(minimapPanel, wxSizerFlags().Top().Border(wxLEFT, 10));
+	mainSizerGame->Add(boardSizer, wxSizerFlags().Expand().Proportion(1));
 
 	// Assigns main sizer to the panel, adjusts size to fit window size
 	panel->SetSizerAndFit(mainSizerGame);
 	
 	// Resize and center the window
-	this->SetSize(700, 700);
+	this->SetSize(700 + minimapSize, 700);
 	this->Center();
 }
 
-// This handles the scrolledWindow scroll up and down (wxWidgets takes care of the behavior)
+// This handles the scrolledWindow scroll up and down (wxWidgets takes care of the behavior),
+// Ctrl + mouse wheel zooms in and out instead
 void MainFrame::OnMouseWheelScroll(wxMouseEvent& evt) {
+
+	if (evt.ControlDown() && evt.GetWheelRotation() != 0) {
+		SetZoom(evt.GetWheelRotation() > 0 ? zoom - 1 : zoom + 1);
+		return;
+	}
 	evt.Skip();
 }
 
-// Assign values to a matrix (vector of vectors) of ButtonData struct.
-// Assigns coordinate, wxID, creates and assigns buttons to the grid sizer
-// Also binds each button to the dynamic event handler 
+// Sets every cell to covered, and sets up the render cache and the scrollable area for the grid size
 void MainFrame::CreateMatrix() {
 
-	// Loop through all cells in the grid
-	for (int i = 0; i < nCols; i++) {
-		for (int j = 0; j < nRows; j++) {
+	// Draw the cell images for the scrolled window's DPI
+	tileCache.Build(tileSize, scrolledWindow->GetContentScaleFactor());
 
-			// save coordinate & wxID for each button
-			buttons[i][j].xPos = i;
-			buttons[i][j].yPos = j;
-			buttons[i][j].wxID = 1000 + (i + (j * nCols));
-
-			// Create button, set a minimum size, add it to the grid sizer
-			buttons[i][j].button = new wxButton(scrolledWindow, buttons[i][j].wxID);
-			buttons[i][j].button->SetMinSize(buttonSize);
-			gridSizer->Add(buttons[i][j].button, 1, wxEXPAND | wxALL);
-
-			// Use dynamic event handling for right and left clicking on a cell
-			buttons[i][j].button->Bind(wxEVT_COMMAND_BUTTON_CLICKED, &MainFrame::OnButtonClicked, this);
-			buttons[i][j].button->Bind(wxEVT_RIGHT_DOWN, &MainFrame::OnRightClick, this);
+	// The cells are drawn into render tiles when they are first painted
+	cellTiles.assign(static_cast<size_t>(nCols) * nRows, TileCache::Covered);
+	CancelReveal();
+	renderCache.Reset(nCols, nRows, board.GetTopology() == TopologyType::Hexagonal);
+	renderCache.SetCellSize(cellSize, scrolledWindow->GetContentScaleFactor());
+	scrolledWindow->SetVirtualSize(renderCache.GetGridSize());
+}
 
-			// Create a map of buttons and their corresponding wxIDs (for use in dynamic event handler)
-			buttonMap[buttons[i][j].wxID] = &buttons[i][j];
+// Gets called when the user left clicks on the grid
+void MainFrame::OnGridLeftDown(wxMouseEvent& evt) {
 
-			// Save all coordinates in a vector 
-			possibleCoordinates.push_back({i, j});
-		}
+	int x, y;
+	if (FindCellAt(evt.GetPosition(), x, y)) {
+		OnCellPressed(x, y);
 	}
-}
 
-// Gets called when any of the grid buttons are pressed (dynamic event)
-void MainFrame::OnButtonClicked(wxCommandEvent &evt) {
-
-	// get ID of button clicked
-	int buttonID = evt.GetId();
+	evt.Skip();
+}
 
-	// Get the button coordinates (saved to class variable)
-	FindButtonCoordinates(buttonID);
+// Gets called when the user right clicks on the grid
+void MainFrame::OnGridRightDown(wxMouseEvent& evt) {
 
-	// handles first button press
-	if (IsFirstButtonPress) {
-		OnFirstButtonPressed(xPos, yPos);
-		IsFirstButtonPress = false;
-	}
-	else { // handles all button presses after the first
-		OnButtonPressed(xPos, yPos);
+	// Place or remove a flag (the board ignores cells that have been cleared)
+	int x, y;
+	if (FindCellAt(evt.GetPosition(), x, y) && !IsGenerating) {
+		SubmitMove(EngineThread::CommandType::Flag, x, y);
 	}
 
 	evt.Skip();
 }
 
-// Gets called when the user right clicks on any of the grid buttons 
-void MainFrame::OnRightClick(wxMouseEvent& evt) {
+// Finds the cell under a point of the grid's scrolled window, returns false if the point is past the grid
+// (the odd rows of a hexagonal board are shifted right by half a cell)
+bool MainFrame::FindCellAt(const wxPoint& position, int& x, int& y) {
 
-	// get ID of button clicked
-	int buttonID = evt.GetId();
+	wxPoint gridPosition = scrolledWindow->CalcUnscrolledPosition(position);
+	if (gridPosition.y < 0) {
+		return false;
+	}
+	y = gridPosition.y / cellSize;
+	gridPosition.x -= renderCache.GetRowShift(y);
+	if (gridPosition.x < 0) {
+		return false;
+	}
+	x = gridPosition.x / cellSize;
+	return x < nCols && y < nRows;
+}
 
-	// Get the button coordinates (saved to class variable)
-	FindButtonCoordinates(buttonID);
+// Determines if cell click is a flag placement or a reveal, then updates the changed cells.
+// The first cell pressed is always a reveal (the board places the bombs around it)
+void MainFrame::OnCellPressed(int xPos, int yPos) {
 
-	// If the button has not been cleared then place a flag 
-	if (!buttons[xPos][yPos].IsCleared) {
-		SetFlag(xPos, yPos);
+	// The board can't be used while the first reveal is placing the bombs
+	if (IsGenerating) {
+		return;
 	}
 
-	HasFlaggedBeforeFirstClick = true;
+	// If user has entered flag mode (handled using event table and flag button)
+	if (InFlagMode && gameStatus != GameBoard::Status::NotStarted) {
+		SubmitMove(EngineThread::CommandType::Flag, xPos, yPos);
+	}
+	else if (gameStatus == GameBoard::Status::NotStarted) {
+		StartFirstReveal(xPos, yPos);
+	}
+	else { // User is not in flag mode: reveal the cell, or chord if it is already revealed
+		SubmitMove(EngineThread::CommandType::Reveal, xPos, yPos);
+	}
+}
 
-	evt.Skip();
+// Sends a move to the engine thread, its result is shown when it comes back (OnEngineResults)
+bool MainFrame::SubmitMove(EngineThread::CommandType type, int xPos, int yPos, uint64_t seed) {
+
+	EngineThread::Command command;
+	command.type = type;
+	command.xPos = xPos;
+	command.yPos = yPos;
+	command.seed = seed;
+	if (!engine.Submit(command)) {
+		SetStatusText("Too many moves are waiting for the game engine, the move was dropped");
+		return false;
+	}
+	return true;
 }
 
-// Finds the coordinates of a button based on its wxID
-void MainFrame::FindButtonCoordinates(int buttonID) {
+// Sends a command that works on the cells in view (FindHint, CountRegion) to the engine thread
+bool MainFrame::SubmitViewCommand(EngineThread::CommandType type) {
+
+	wxRect view = GetViewCells();
+	EngineThread::Command command;
+	command.type = type;
+	command.xPos = view.x;
+	command.yPos = view.y;
+	command.width = view.width;
+	command.height = view.height;
+	if (!engine.Submit(command)) {
+		SetStatusText("Too many moves are waiting for the game engine, the move was dropped");
+		return false;
+	}
+	return true;
+}
 
-	// Use map to find the coordinates of the button that was clicked (based off its wxID)
-	auto mapIterator = buttonMap.find(buttonID);
-	if (mapIterator != buttonMap.end()) {
-		ButtonData* buttonData = mapIterator->second; // mapIterator->second returns ButtonData pointer 
+// Asks the engine to count the mines left in view, unless a count is on its way (it is then counted again after it).
+// Nothing is sent while the first reveal places the bombs, the cells it reveals ask for a count
+void MainFrame::RequestRegionCount() {
 
-		// the coordinates are obtained from the ButtonData pointer found above
-		xPos = buttonData->xPos;
-		yPos = buttonData->yPos;
+	if (IsGenerating) {
+		return;
 	}
+	if (IsRegionCountPending) {
+		IsRegionCountStale = true;
+		return;
+	}
+	countedView = GetViewCells();
+	IsRegionCountPending = SubmitViewCommand(EngineThread::CommandType::CountRegion);
 }
 
-// Ensures that first button pressed cannot be a bomb
-// generate bombs in random positions (not in initial 3x3)
-// clear empty cells around initial click
-void MainFrame::OnFirstButtonPressed(int xPos, int yPos) {
+// Displays the mines left in view counted by the engine, and counts again if the view or board changed meanwhile
+void MainFrame::ShowRegionCount(const EngineThread::Result& result) {
 
-	// if user placed any flags before clicking a button, restart the game
-	if (HasFlaggedBeforeFirstClick) {
-		ReStart();
+	IsRegionCountPending = false;
+	if (result.status == GameBoard::Status::NotStarted) {
+		regionMinesText->SetLabel("");
+	}
+	else {
+		regionMinesText->SetLabel(wxString::Format("%d in view", result.regionCounts[RegionIndex::UnflaggedMines]));
+	}
+	if (IsRegionCountStale) {
+		IsRegionCountStale = false;
+		RequestRegionCount();
 	}
+}
 
-	HideButton(xPos, yPos);
-	RemoveUnallowedCoordinates(xPos, yPos);
-	RandomizeCoordinateOrder();
-	PlaceBombs();
-	ClearEmpty(xPos, yPos);
+// Sends the first reveal (which places the bombs) to the engine thread, the window stays responsive
+// while the bombs of a big board are placed. No other move is sent until it is done
+void MainFrame::StartFirstReveal(int xPos, int yPos) {
+
+	if (SubmitMove(EngineThread::CommandType::Reveal, xPos, yPos)) {
+		IsGenerating = true;
+		generationStopWatch.Start();
+		generationTimer.Start(100);
+	}
 }
 
-// Determines if button click is a flag placement, revealed cell, empty cell, or bomb
-void MainFrame::OnButtonPressed(int xPos, int yPos) {
+// Shows the cells revealed by the first reveal, or nothing if it was cancelled
+void MainFrame::OnFirstRevealDone(const EngineThread::Result& result) {
 
-	// If user has entered flag mode (handled using event table and flag button)
-	if (InFlagMode) {
+	generationTimer.Stop();
+	IsGenerating = false;
 
-		// Ensure that user cannot place a flag on a revealed cell (has a number or is empty)
-		if (!buttons[xPos][yPos].IsCleared) {
-			SetFlag(xPos, yPos);
-		}
+	if (generationDialog != nullptr) {
+		generationDialog->Destroy();
+		generationDialog = nullptr;
 	}
-	else { // User is not in flag mode 
 
-		// Cell clicked is a bomb and not flagged, end game, prompt a restart 
-		if (IsUnflaggedBomb(xPos, yPos)) {
+	// A cancelled first reveal leaves the game as it was
+	if (result.status == GameBoard::Status::NotStarted) {
+		SetStatusText("Placing the mines was cancelled");
+		return;
+	}
 
-			//buttons[xPos][yPos].button->SetLabel(bombChar);
-			ShowMinesAndFalseFlags();
-			if (wxMessageBox(wxT("KABOOM! \t Restart?"), wxT("Game Over"), wxYES_NO | wxICON_ERROR) == wxYES) {
-				ReStart();
-			}
-		} 
-		// If player clicks on an already revealed cell
-		else if (buttons[xPos][yPos].IsCleared) {
-			RevealSurroundingCells(xPos, yPos); 
-		}
-		// If cell clicked is not a bomb, and not flagged
-		else if (!buttons[xPos][yPos].IsFlagged) { 
+	gameStartTime = result.endTime;
+	ProfileBoard(result);
+	if (result.IsChanged) {
+		ApplyBoardChanges(result);
+	}
+}
 
-			int surroundingBombs = CountBombsSurrounding(xPos, yPos);
-			buttons[xPos][yPos].numMinesSurrounding = surroundingBombs;
-			buttons[xPos][yPos].button->SetBackgroundColour(backgroundColor);
+// Shows the results of the moves done by the engine thread, in the order the moves were sent.
+// The game over message is shown once every result is applied (its dialog handles events, more results can come in)
+void MainFrame::OnEngineResults() {
 
-			// Check if there are no surrounding bombs (cell is empty)
-			if (surroundingBombs == 0) {
-				ClearEmpty(xPos, yPos);
-				CheckForVictory();
+	bool IsGameOverCheckNeeded = false;
+	bool IsBoardChanged = false;
+	engine.DrainResults([&](const EngineThread::Result& result) {
+
+		IsBoardChanged |= result.IsChanged;
+
+		gameStatus = result.status;
+		flagsPlaced = result.flagsPlaced;
+		if (result.status == GameBoard::Status::Lost && result.statusBefore != GameBoard::Status::Lost) {
+			lostMines = result.mines;
+			falseFlags = result.falseFlags;
+		}
+
+		switch (result.command.type) {
+		case EngineThread::CommandType::NewGame:
+			StartGameRecord(result);
+			ApplyNewGame();
+			if (!result.changes.empty()) {
+				ApplyBoardChanges(result);
 			}
-			else { // has surrounding bombs: Label how many bombs surround the cell
-				LabelCell(xPos, yPos, surroundingBombs);
+			break;
+		case EngineThread::CommandType::Resize:
+
+			// Every cell of the grid is already shown covered, the board is now ready for the first reveal
+			StartGameRecord(result);
+			break;
+		case EngineThread::CommandType::FindHint:
+			ShowHint(result);
+			break;
+		case EngineThread::CommandType::CountRegion:
+			ShowRegionCount(result);
+			break;
+		case EngineThread::CommandType::Undo:
 
-				if (IsGridCleared()) {
-					CheckForVictory();
+			// A lost game showed all of the mines, so every cell is set from the board again
+			if (result.IsChanged && result.statusBefore == GameBoard::Status::Lost) {
+				for (const GameBoard::CellChange& change : result.changes) {
+					visibleCells[change.index] = change.visible;
 				}
+				RedrawAllCells();
+			}
+			else if (result.IsChanged) {
+				ApplyBoardChanges(result);
+			}
+			break;
+		default:
+			if (IsGenerating && result.command.type == EngineThread::CommandType::Reveal && result.statusBefore == GameBoard::Status::NotStarted) {
+				OnFirstRevealDone(result);
+			}
+			else if (result.IsChanged) {
+				ApplyBoardChanges(result);
 			}
+			break;
 		}
-	}	
-}
 
-// Makes button inoperatble, transparent, and removes the text
-void MainFrame::HideButton(int xPos, int yPos) {
-	//buttons[xPos][yPos].button->SetBackgroundColour(panel->GetBackgroundColour());
-	buttons[xPos][yPos].button->SetBackgroundColour(backgroundColor);
-	buttons[xPos][yPos].button->Disable();
-	buttons[xPos][yPos].button->SetLabel("");
+		// The engine scores the move that ended the game, and the game over is shown whatever the move was (a flag
+		// ends the game when the assist chords around it)
+		bool IsOver = result.status == GameBoard::Status::Won || result.status == GameBoard::Status::Lost;
+		if (IsOver && result.status != result.statusBefore) {
+			RecordGame(result);
+			IsGameOverCheckNeeded = true;
+		}
+	});
+
+	// The mines left in view change with the moves (a new game changes them too)
+	if (IsBoardChanged) {
+		RequestRegionCount();
+	}
+	if (IsGameOverCheckNeeded) {
+		CheckForGameOver();
+	}
 }
 
-// Removes coordinates inside of a 3x3 area around the initial clicked cell
-void MainFrame::RemoveUnallowedCoordinates(int xPos, int yPos) {
+// Shows the progress of the first reveal, once it has taken long enough to notice. Cancel stops it
+void MainFrame::OnGenerationTimer(wxTimerEvent& evt) {
 
-	// Loop through all coordinates from beginning to end in the possibleCoordinates vector
-	for (auto iterator = possibleCoordinates.begin(); iterator != possibleCoordinates.end();) {
-		
-		// get current coordinate
-		int x = iterator->first;
-		int y = iterator->second;
+	if (generationDialog == nullptr && generationStopWatch.Time() >= 300) {
+		generationDialog = new wxProgressDialog("Minesweeper", "Placing the mines...", 100, this, wxPD_CAN_ABORT | wxPD_ELAPSED_TIME);
+	}
 
-		if (x >= xPos - 1 && x <= xPos + 1 && y >= yPos - 1 && y <= yPos + 1) {
-			iterator = possibleCoordinates.erase(iterator); // remove coordinate (erase automatically incriments iterator)
-		}
-		else { // If coordinate is not within 5x5 area, manually incriment iterator
-			++iterator;
+	// The dialog stays below 100% until the reveal is done (it would stop accepting a cancel at 100%)
+	if (generationDialog != nullptr) {
+		int percent = std::min(99, static_cast<int>(board.GetGenerationProgress() * 100));
+		if (!generationDialog->Update(percent)) {
+			board.CancelGeneration();
 		}
 	}
 }
 
-// Randomize coordinates order (so that bombs are placed at random)
-void MainFrame::RandomizeCoordinateOrder() {
-	std::random_device rd;               
-	std::mt19937 gen(rd());              
-	std::shuffle(possibleCoordinates.begin(), possibleCoordinates.end(), gen);
-}
+// Updates the tiles of all cells changed by a move done by the engine thread.
+// The cells of big moves are shown by the reveal animation instead, so the window stays responsive
+void MainFrame::ApplyBoardChanges(const EngineThread::Result& result) {
 
-// Places bombs at the first numberOfBombs coordinates in the randomized possibleCoordinates vector 
-void MainFrame::PlaceBombs() {
-	
-	// loop through first numberOfBombs of possible coordinates vector, place bomb at each
-	for (int i = 0; i < numberOfBombs; i++) {
-		int x_coordinate = possibleCoordinates[i].first;
-		int y_coordinate = possibleCoordinates[i].second;
-		buttons[x_coordinate][y_coordinate].IsBomb = true;
+	int64_t receiveTime = EngineThread::Now();
+	const std::vector<GameBoard::CellChange>& changes = result.changes;
+	for (const GameBoard::CellChange& change : changes) {
+		visibleCells[change.index] = change.visible;
 	}
-}
-
-// Uses Flood Fill algorithm to clear all empty cells around the initial coordinate input
-void MainFrame::ClearEmpty(int xPos, int yPos) {
 
-	// Check if cell is within bounds of grid, is not a bomb, and has not already been cleared
-	if (xPos < 0 || yPos < 0 || xPos >= nCols || yPos >= nRows || buttons[xPos][yPos].IsBomb || buttons[xPos][yPos].IsCleared) {
-		return; 
+	// The animation grows from the cell that was clicked (undo, redo and new games have none, they grow from their
+	// first cell changed)
+	if (changes.size() >= revealAnimationCells) {
+		bool HasClickedCell = result.command.type == EngineThread::CommandType::Reveal || result.command.type == EngineThread::CommandType::Flag;
+		int originIndex = HasClickedCell ? result.command.xPos + result.command.yPos * nCols : static_cast<int>(changes.front().index);
+		QueueReveal(changes, originIndex % nCols, originIndex / nCols);
+		UpdateBombsRemaining();
+		return;
 	}
 
-	// Mark the current cell as cleared and hide it
-	buttons[xPos][yPos].IsCleared = true;
-	HideButton(xPos, yPos);
+	wxStopWatch paintTimer;
+	for (const GameBoard::CellChange& change : changes) {
+		UpdateCell(change.index);
+	}
+	ReportPaintTime(static_cast<int>(changes.size()), paintTimer);
+	ReportMoveLatency(result, receiveTime, static_cast<int>(changes.size()));
+	RefreshBoardViews();
 
-	// Define all possible single movements from an initial coordinate
-	const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
-	const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+	UpdateBombsRemaining();
+}
 
-	// Count how many bombs are surrounding the current cell
-	int surroundingBombs = CountBombsSurrounding(xPos, yPos);
+// Shows in the status bar how long a move took from the input to the screen: waiting in the command queue,
+// in the engine (with the heap allocations the engine made), on its way back to the UI thread, and drawing the changed cells
+void MainFrame::ReportMoveLatency(const EngineThread::Result& result, int64_t receiveTime, int cellCount) {
 
-	// If cell is empty (no bombs surrounding it)
-	if (surroundingBombs == 0) {
+	int64_t shownTime = EngineThread::Now();
+	SetStatusText(wxString::Format("Move shown %.2f ms after the input: queued %.2f ms, engine %.2f ms (%llu allocations), to the UI %.2f ms, drawing %d cells %.2f ms",
+		(shownTime - result.command.submitTime) / 1e6, (result.startTime - result.command.submitTime) / 1e6, (result.endTime - result.startTime) / 1e6,
+		static_cast<unsigned long long>(result.allocations), (receiveTime - result.endTime) / 1e6, cellCount, (shownTime - receiveTime) / 1e6));
+}
 
-		// loop through the 8 cells surrounding the current cell
-		for (int i = 0; i < 8; i++) {
+// Adds the cells changed by a move to the reveal animation, sorted by their distance from the origin (the clicked
+// cell) so the revealed area grows outward. The board is already up to date, the cells read their state from it
+// when they are shown, so a cell changed again by a later move is never shown out of date
+void MainFrame::QueueReveal(const std::vector<GameBoard::CellChange>& changes, int originX, int originY) {
+
+	// Start a new animation, or add to the one still running
+	if (revealPosition == revealQueue.size()) {
+		CancelReveal();
+		revealSlices = 0;
+		longestRevealSlice = 0;
+		revealStopWatch.Start();
+	}
 
-			int newX = xPos + dx[i];
-			int newY = yPos + dy[i];
+	// Sort the cells with a counting sort on their distance (at most the longest side of the grid)
+	auto Distance = [&](uint32_t index) {
+		return std::max(std::abs(static_cast<int>(index % nCols) - originX), std::abs(static_cast<int>(index / nCols) - originY));
+	};
 
-			// If the cell is within the bounds of the grid, call ClearEmpty (recursion)
-			if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
-				ClearEmpty(newX, newY);  
-			}
-		}
+	revealDistanceCounts.assign(std::max(nCols, nRows) + 1, 0);
+	for (const GameBoard::CellChange& change : changes) {
+		revealDistanceCounts[Distance(change.index) + 1]++;
+	}
+	size_t start = revealQueue.size();
+	for (size_t i = 1; i < revealDistanceCounts.size(); i++) {
+		revealDistanceCounts[i] += revealDistanceCounts[i - 1];
 	}
-	else { // If there are bomb(s) surrounding the current cell
-		buttons[xPos][yPos].numMinesSurrounding = surroundingBombs;
-		LabelCell(xPos, yPos, surroundingBombs);
+	revealQueue.resize(start + changes.size());
+	for (const GameBoard::CellChange& change : changes) {
+		revealQueue[start + revealDistanceCounts[Distance(change.index)]++] = change.index;
 	}
 }
 
-// This checks if the grid has been cleared 
-bool MainFrame::IsGridCleared() {
+// Shows the next cells of the reveal animation until the slice's time is used up, returns true if cells are left.
+// When the animation is done the status bar shows how long it took and its longest slice
+bool MainFrame::ApplyRevealSlice() {
 
-	// Loop through all of the cells in the grid 
-	for (int i = 0; i < nCols; i++) {
-		for (int j = 0; j < nRows; j++) {
+	wxStopWatch sliceTimer;
+	size_t firstCell = revealPosition;
+	while (revealPosition < revealQueue.size()) {
+		UpdateCell(revealQueue[revealPosition++]);
 
-			// If cell is not cleared nor a bomb, grid is not cleared 
-			if (!buttons[i][j].IsCleared && !buttons[i][j].IsBomb) {
-				return false; 
-			}
+		// The clock is read every 256 cells, reading it for every cell would cost more than the cell
+		if ((revealPosition - firstCell) % 256 == 0 && sliceTimer.TimeInMicro().GetValue() >= revealSliceMicroseconds) {
+			break;
 		}
 	}
+	scrolledWindow->Refresh(false);
+	RefreshBoardViews();
+
+	revealSlices++;
+	longestRevealSlice = std::max(longestRevealSlice, sliceTimer.TimeInMicro().ToDouble() / 1000.0);
+	if (revealPosition < revealQueue.size()) {
+		return true;
+	}
+
+	SetStatusText(wxString::Format("Revealed %d cells in %.0f ms over %d slices (longest slice %.2f ms)",
+		static_cast<int>(revealQueue.size()), revealStopWatch.TimeInMicro().ToDouble() / 1000.0, revealSlices, longestRevealSlice));
 
-	return true; // if grid is cleared
+	bool IsGameOver = IsGameOverPending;
+	CancelReveal();
+	if (IsGameOver) {
+		CheckForGameOver();
+	}
+	return false;
 }
 
-// Counts how many bumbs are surrounding the cell at inputted coordinates
-int MainFrame::CountBombsSurrounding(int xPos, int yPos) {
+// Stops the reveal animation (every cell is about to be set from the board, or the grid changes)
+void MainFrame::CancelReveal() {
+	revealQueue.clear();
+	revealPosition = 0;
+	IsGameOverPending = false;
+}
 
-	// Define all possible single movements from an initial coordinate
-	const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
-	const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+// Sets the tile of a cell from the cell's visible state on the board
+void MainFrame::UpdateCell(int index) {
 
-	int count = 0;
+	int x = index % nCols;
+	int y = index / nCols;
+	uint8_t visible = visibleCells[index];
+	if (IsPyramidReady) {
+		pyramid.Update(index, visible);
+	}
 
-	// Iterate through the 8 surrounding cells, incriment count if there is a bomb  
-	for (int i = 0; i < 8; i++) {
-		int newX = xPos + dx[i];
-		int newY = yPos + dy[i];
-		if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
-			if (buttons[newX][newY].IsBomb) {
-				count++;  
-			}
-		}
+	if (visible == GameBoard::Flagged) {
+		SetCellTile(x, y, TileCache::Flag);
 	}
+	else if (visible == GameBoard::Covered) {
 
-	return count;
+		// A removed flag is changed to the flag mode indicator while in flag mode
+		if (InFlagMode) {
+			SetCellTile(x, y, TileCache::FlagIndicator);
+		}
+		else {
+			SetCellTile(x, y, TileCache::Covered);
+		}
+	}
+	else { // the revealed cell shows its number (an empty tile for 0)
+		SetCellTile(x, y, static_cast<TileCache::Tile>(visible));
+	}
 }
 
-// Creates cell label (always a number) and sets its color
-void MainFrame::LabelCell(int xPos, int yPos, int surroundingBombs) {
-
-	buttons[xPos][yPos].IsCleared = true;
+// Sets the tile of a cell, its render tile draws it again the next time it is painted
+void MainFrame::SetCellTile(int xPos, int yPos, TileCache::Tile tile) {
 
-	// Make sure button is enabled, set text to the number of surrounding bombs
-	buttons[xPos][yPos].button->Enable();
-	buttons[xPos][yPos].button->SetBackgroundColour(backgroundColor);
-	buttons[xPos][yPos].button->SetLabel(wxString::Format("%d", surroundingBombs));
-	
-	// Set text color based on # of surrounding bombs
-	switch (surroundingBombs) {
-		case 1: // color: blue
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(0, 0, 255));
-			break;
-		case 2: // color: green
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(0, 128, 0));
-			break;
-		case 3: // color: red
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(255, 0, 0));
-			break;
-		case 4: // color: dark blue
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(0, 0, 139));
-			break;
-		case 5: // color: dark red
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(139, 0, 0));
-			break;
-		case 6: // color: cadet blue
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(95, 158, 160));
-			break;
-		case 7: // color: black
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(0, 0, 0));
-			break;
-		case 8: // color: gray
-			buttons[xPos][yPos].button->SetForegroundColour(wxColour(128, 128, 128));
-			break;
+	TileCache::Tile& cellTile = cellTiles[xPos + static_cast<size_t>(yPos) * nCols];
+	if (cellTile != tile) {
+		cellTile = tile;
+		renderCache.InvalidateCell(xPos, yPos);
 	}
-	buttons[xPos][yPos].button->Refresh();
 }
 
-// Sets cell label to a flag, also allowes user to remove flags  
-void MainFrame::SetFlag(int xPos, int yPos) {
+// Paints the updated cells now and shows how long updating them took in the status bar
+void MainFrame::ReportPaintTime(int cellCount, const wxStopWatch& paintTimer) {
 
-	// If there isn't a flag in the cell, add one 
-	if (!buttons[xPos][yPos].IsFlagged) { 
-		buttons[xPos][yPos].button->SetLabel(flagSetChar);
-		buttons[xPos][yPos].IsFlagged = true;
-		numberFlagsPlaced++;
+	if (cellCount == 0) {
+		return;
 	}
-	else { // Remove Flag
-		if (InFlagMode) { // If user is in flag mode and clicks on a flag,
-			
-			// Set flag icon is changed to a box 
-			buttons[xPos][yPos].button->SetLabel(flagIndicatorChar);
-		}
-		else { // If user is not in flag mode (right click) and clicks on a flag
 
-			// Remove the flag icon 
-			buttons[xPos][yPos].button->SetLabel("");
-		}
+	scrolledWindow->Refresh(false);
+	scrolledWindow->Update();
+	double milliseconds = paintTimer.TimeInMicro().ToDouble() / 1000.0;
+	SetStatusText(wxString::Format("Updated %d cells in %.2f ms (%.2f ms per 1,000 cells)",
+		cellCount, milliseconds, milliseconds * 1000.0 / cellCount));
+}
 
-		buttons[xPos][yPos].IsFlagged = false;
-		numberFlagsPlaced--;
-	}	
+// Draws the tiles again for the new DPI, the render tiles are drawn again from them
+void MainFrame::OnDpiChanged(wxDPIChangedEvent& evt) {
 
-	UpdateBombsRemaining();
+	tileCache.Build(tileSize, scrolledWindow->GetContentScaleFactor());
+	renderCache.SetCellSize(cellSize, scrolledWindow->GetContentScaleFactor());
+	scrolledWindow->Refresh(false);
+
+	evt.Skip();
+}
+
+// Keeps the render tiles the view of the grid can overlap at its new size cached
+void MainFrame::OnGridSize(wxSizeEvent& evt) {
+
+	renderCache.SetViewSize(scrolledWindow->GetClientSize());
+	evt.Skip();
+}
+
+// Paints the grid from the render cache. After a scroll the status bar shows how long the frame took
+// and how many render tiles were painted without drawing them from scratch
+void MainFrame::OnGridPaint(wxPaintEvent& evt) {
+
+	wxPaintDC dc(scrolledWindow);
+	wxStopWatch frameTimer;
+	wxPoint viewOrigin = scrolledWindow->CalcUnscrolledPosition(wxPoint(0, 0));
+	renderCache.Draw(dc, scrolledWindow->GetUpdateClientRect(), viewOrigin, cellTiles, tileCache);
+
+	if (viewOrigin != lastPaintOrigin) {
+		lastPaintOrigin = viewOrigin;
+		double milliseconds = frameTimer.TimeInMicro().ToDouble() / 1000.0;
+		SetStatusText(wxString::Format("Scroll frame in %.2f ms, render tile hit rate %.1f%% (%d of %d render tiles cached)",
+			milliseconds, renderCache.GetHitRate() * 100.0, renderCache.GetCachedTileCount(), static_cast<int>(renderCache.GetMaxTileCount())));
+	}
+
+	// The minimap is set up once the first frame is shown
+	if (IsFirstFramePending) {
+		IsFirstFramePending = false;
+		SetStatusText(wxString::Format("First frame of the %d x %d grid in %.1f ms", nCols, nRows, firstFrameStopWatch.TimeInMicro().ToDouble() / 1000.0));
+		CallAfter([this]() { BuildPyramid(); });
+	}
 }
 
 void MainFrame::UpdateBombsRemaining() {
 
-	int bombsRemaining = numberOfBombs - numberFlagsPlaced;
+	int bombsRemaining = numberOfBombs - flagsPlaced;
 
 	// Check to ensure that the user has not placed more flags than there are bombs,
 	// Display a question mark if they have 
@@ -729,30 +1122,100 @@ void MainFrame::UpdateBombsRemaining() {
 
 }
 
-// Check if the player has won, ends game if so
-bool MainFrame::CheckForVictory() {
+// Starts the record of the game started by the engine (a layout game is on from the start, its time starts here)
+void MainFrame::StartGameRecord(const EngineThread::Result& result) {
+	gameRecord.seed = result.command.seed;
+	gameRecord.options &= ~ProfiledGame;
+	gameRecord.forcedGuesses = 0;
+	gameRecord.longestChain = 0;
+	gameRecord.openings = 0;
+	gameStartTime = result.endTime;
+	IsGameRecorded = false;
+	gameNumber++;
+}
+
+// Adds the game ended by a move to the statistics, with the 3BV the engine counted
+void MainFrame::RecordGame(const EngineThread::Result& result) {
 
-	bool IsVictory = false;
+	if (IsGameRecorded) {
+		return;
+	}
+	IsGameRecorded = true;
+	gameRecord.finishTime = static_cast<int64_t>(std::time(nullptr));
+	gameRecord.milliseconds = static_cast<uint32_t>(std::max<int64_t>(result.endTime - gameStartTime, 0) / 1000000);
+	gameRecord.bbbv = result.bbbv;
+	gameRecord.IsWon = result.status == GameBoard::Status::Won;
+	stats.Add(gameRecord);
+}
+
+// Profiles the board placed by the first reveal on the profiler's pool (its bombs are placed again there from the
+// seed). A loaded layout has no seed, and a board too large to be profiled before the next move isn't profiled
+void MainFrame::ProfileBoard(const EngineThread::Result& result) {
+
+	if ((gameRecord.options & LayoutGame) || static_cast<long long>(nCols) * nRows > DifficultyProfiler::MaxProfiledCells) {
+		return;
+	}
+	BoardSetup setup;
+	setup.nCols = nCols;
+	setup.nRows = nRows;
+	setup.numberOfBombs = numberOfBombs;
+	setup.topology = static_cast<TopologyType>(gameRecord.topology);
+	setup.seed = gameRecord.seed;
+	setup.firstX = result.command.xPos;
+	setup.firstY = result.command.yPos;
+	uint64_t game = gameNumber;
+	profiler.Submit(setup, [this, game](const BoardProfile& profile) { CallAfter([this, game, profile]() { OnBoardProfiled(game, profile); }); });
+}
 
-	// Determine if the grid is empty (player has won)
-	if (IsGridCleared()) {
-		IsVictory = true;
+// Shows the difficulty of the board, and adds it to the game's record (the game may have ended already, its record
+// is then kept without it)
+void MainFrame::OnBoardProfiled(uint64_t game, const BoardProfile& profile) {
+
+	if (game != gameNumber || IsGameRecorded || !profile.IsProfiled) {
+		return;
+	}
+	gameRecord.options |= ProfiledGame;
+	gameRecord.forcedGuesses = static_cast<uint8_t>(std::min(profile.forcedGuesses, 255));
+	gameRecord.longestChain = static_cast<uint16_t>(std::min(profile.longestChain, 65535));
+	gameRecord.openings = static_cast<uint16_t>(std::min(profile.openings, 65535));
+	SetStatusText(wxString::Format("Board difficulty: 3BV %d, %d openings, %d forced guesses, longest chain of %d deduction rounds (profiled in %.1f ms)",
+		profile.bbbv, profile.openings, profile.forcedGuesses, profile.longestChain, profile.milliseconds));
+}
+
+// Check if the player has won or lost, ends game if so
+bool MainFrame::CheckForGameOver() {
+
+	// A game ended by a big move is shown as over once the reveal animation has shown all of its cells
+	bool IsOver = gameStatus == GameBoard::Status::Lost || gameStatus == GameBoard::Status::Won;
+	if (IsOver && revealPosition < revealQueue.size()) {
+		IsGameOverPending = true;
+		return true;
 	}
 
-	// If Player has won, display a message and prompt a restart
-	if (IsVictory) {
+	// Cell revealed was a bomb, show all mines, prompt a restart
+	if (gameStatus == GameBoard::Status::Lost) {
 
-		// ask user if they want to restart 
+		ShowMinesAndFalseFlags();
+		if (wxMessageBox(wxT("KABOOM! \t Restart?"), wxT("Game Over"), wxYES_NO | wxICON_ERROR) == wxYES) {
+			ReStart();
+		}
+		return true;
+	}
+
+	// If Player has won (grid is cleared), display a message and prompt a restart
+	if (gameStatus == GameBoard::Status::Won) {
+
+		// ask user if they want to restart
 		int userResponse = wxMessageBox(wxT("VICTORY! \t Restart?"), wxT("Mines Sweeped!"), wxYES_NO | wxICON_ASTERISK);
-			
-		// If user wants to restart 
+
+		// If user wants to restart
 		if (userResponse == wxYES) {
 			ReStart();
-			return true;
 		}
+		return true;
 	}
-	
-	return IsVictory;
+
+	return false;
 }
 
 // When the home button is clicked: go to main menu
@@ -764,50 +1227,54 @@ void MainFrame::OnHomeClicked(wxCommandEvent& evt) {
 // Shows the first bomb that isn't flagged
 void MainFrame::OnButtonHintClicked(wxCommandEvent& evt) {
 
-	bool FoundBomb = false;
+	if (IsGenerating) {
+		return;
+	}
 
-	// If not already in hint mode: on entering hint mode 
+	// If not already in hint mode: on entering hint mode, the engine finds the unflagged bomb closest to the view
+	// (ShowHint displays it)
 	if (!InHintMode) {
-
 		InHintMode = true;
-
-		// loop through all of the cells 
-		for (int i = 0; i < nCols; i++) {
-			for (int j = 0; j < nRows; j++) {
-
-				// Find the first unflagged bomb & display it 
-				if (IsUnflaggedBomb(i, j)) {
-					FoundBomb = true;
-					buttons[i][j].button->SetLabel(bombChar);
-					break;
-				}
-			}
-			if (FoundBomb) { break; }
-		}
+		SubmitViewCommand(EngineThread::CommandType::FindHint);
 	}
-	else { // on exiting hint mode 
+	else { // on exiting hint mode, hide the bomb again
 
 		InHintMode = false;
-		
-		// loop through all of the cells 
-		for (int i = 0; i < nCols; i++) {
-			for (int j = 0; j < nRows; j++) {
-
-				// hide all of the unflagged bombs 
-				if (IsUnflaggedBomb(i, j)) {
-					buttons[i][j].button->SetLabel("");
-				}
-			}
+		if (hintCell >= 0) {
+			UpdateCell(hintCell);
+			hintCell = -1;
 		}
 	}
+	scrolledWindow->Refresh(false);
 
 	evt.Skip();
 }
 
+// Displays the bomb found by the engine, if the player is still in hint mode, scrolling to it when it is out of view
+void MainFrame::ShowHint(const EngineThread::Result& result) {
+
+	if (InHintMode && !result.mines.empty()) {
+		hintCell = static_cast<int>(result.mines.front());
+		int xPos = hintCell % nCols;
+		int yPos = hintCell / nCols;
+		SetCellTile(xPos, yPos, TileCache::Hint);
+		if (!GetViewCells().Contains(xPos, yPos)) {
+			CenterView((xPos + 0.5) / nCols, (yPos + 0.5) / nRows);
+		}
+		scrolledWindow->Refresh(false);
+	}
+}
+
 // Is executed when the flag button in the top bar is pressed 
 void MainFrame::OnButtonFlagClicked(wxCommandEvent& evt) {
 
 	// if not in flag mode, enter flag mode 
+	wxStopWatch paintTimer;
+	int cellsChanged = 0;
+	if (IsGenerating) {
+		return;
+	}
+
 	if (!InFlagMode) { 
 		InFlagMode = true;
 
@@ -816,8 +1283,9 @@ void MainFrame::OnButtonFlagClicked(wxCommandEvent& evt) {
 			for (int j = 0; j < nRows; j++) {
 
 				// check if cell is flaggable, if so they display an indication that the player can flag it 
-				if (IsFlaggable(i, j)) {
-					buttons[i][j].button->SetLabel(flagIndicatorChar);
+				if (visibleCells[i + static_cast<size_t>(j) * nCols] == GameBoard::Covered) {
+					SetCellTile(i, j, TileCache::FlagIndicator);
+					cellsChanged++;
 				}
 			}
 		}
@@ -830,217 +1298,414 @@ void MainFrame::OnButtonFlagClicked(wxCommandEvent& evt) {
 		 	 for (int j = 0; j < nRows; j++) {
 
 				 // If cell is flaggable, remove the indication that the player can flag it 
-		 	 	 if (IsFlaggable(i, j)) {
-					buttons[i][j].button->SetLabel("");
+		 	 	 if (visibleCells[i + static_cast<size_t>(j) * nCols] == GameBoard::Covered) {
+					SetCellTile(i, j, TileCache::Covered);
+					cellsChanged++;
 				 }
 			 }
 		 }
 	}
+	ReportPaintTime(cellsChanged, paintTimer);
 	evt.Skip();
 }
 
 // Is executed when the restart button in the top bar is pressed
 void MainFrame::OnButtonRestartClicked(wxCommandEvent& evt) {
-	ReStart();
+	if (!IsGenerating) {
+		ReStart();
+	}
 	evt.Skip();
 }
 
-// Restart the game with the same grid size and # of bombs
-void MainFrame::ReStart() {
+// Undoes the last move in training mode
+void MainFrame::OnButtonUndoClicked(wxCommandEvent& evt) {
+	if (!IsGenerating) {
+		SubmitMove(EngineThread::CommandType::Undo, 0, 0);
+	}
+	evt.Skip();
+}
 
-	// Loop through all of the cells are set all to their default state
-	for (int i = 0; i < nCols; i++) {
-		for (int j = 0; j < nRows; j++) {
-			buttons[i][j].IsBomb = false;
-			buttons[i][j].IsCleared = false;
-			buttons[i][j].IsFlagged = false;
-			buttons[i][j].button->SetLabel("");
-			buttons[i][j].button->Enable();
-			buttons[i][j].button->SetBackgroundColour(wxColour(*wxWHITE));
-			buttons[i][j].button->Show();
-			buttons[i][j].button->SetForegroundColour(wxColor(0, 0, 0));
-		}
+// Applies the last undone move again in training mode
+void MainFrame::OnButtonRedoClicked(wxCommandEvent& evt) {
+	if (!IsGenerating) {
+		SubmitMove(EngineThread::CommandType::Redo, 0, 0);
 	}
+	evt.Skip();
+}
 
-	// Reset bombs counter display
-	numberFlagsPlaced = 0;
-	UpdateBombsRemaining();
+// Zooms in one level (toward bigger cells)
+void MainFrame::OnButtonZoomInClicked(wxCommandEvent& evt) {
+	SetZoom(zoom - 1);
+	evt.Skip();
+}
 
-	// Reset booleans for game beginning
-	IsFirstButtonPress = true;
-	InFlagMode = false;
-	InHintMode = false;
-	HasFlaggedBeforeFirstClick = false;
+// Zooms out one level (toward views of the whole grid)
+void MainFrame::OnButtonZoomOutClicked(wxCommandEvent& evt) {
+	SetZoom(zoom + 1);
+	evt.Skip();
+}
+
+// Changes the zoom level, keeping the same part of the grid in the center of the view. The first levels change
+// the size of the cells, the levels after them hide the cells and show the grid drawn from the minimap pyramid
+void MainFrame::SetZoom(int newZoom) {
+
+	// The zoomed out views are drawn from the pyramid, which is set up after the first frame
+	if (!IsPyramidReady) {
+		return;
+	}
+	newZoom = std::max(0, std::min(newZoom, GetMaxZoom()));
+	if (newZoom == zoom) {
+		return;
+	}
+
+	double left, top, width, height;
+	GetViewRect(left, top, width, height);
+	zoom = newZoom;
+
+	if (IsOverviewZoom()) {
+		int level, scale;
+		GetOverviewScale(zoom, level, scale);
+		overviewWindow->SetVirtualSize(pyramid.GetLevelCols(level) * scale, pyramid.GetLevelRows(level) * scale);
+		overviewWindow->Refresh(false);
+	}
+	else if (cellSize != cellZoomSizes[zoom]) {
+		ApplyCellZoom();
+	}
+
+	// Show the cells or the zoomed out view, and move back to the same center
+	scrolledWindow->Show(!IsOverviewZoom());
+	overviewWindow->Show(IsOverviewZoom());
+	panel->Layout();
+	CenterView(left + width / 2, top + height / 2);
 
+	zoomInButton->Enable(zoom > 0);
+	zoomOutButton->Enable(zoom < GetMaxZoom());
+	minimapPanel->Refresh(false);
 }
 
-// Determines if user inputted grid width or height is valid 
-bool MainFrame::ValidateInput(wxString& inputStr, bool IsBombEntry) {
+// Resizes the cells for the zoom level (the tiles and the render tiles are drawn again for the new size)
+void MainFrame::ApplyCellZoom() {
 
-	// initialize intermediate variable 
-	long value;
+	cellSize = cellZoomSizes[zoom];
+	tileSize = wxSize(cellSize - 1, cellSize - 1);
+	tileCache.Build(tileSize, scrolledWindow->GetContentScaleFactor());
+	renderCache.SetCellSize(cellSize, scrolledWindow->GetContentScaleFactor());
 
-	// Check if the string can be converted to a number 
-	if (!inputStr.ToLong(&value)) {
-		return false;
+	scrolledWindow->SetVirtualSize(renderCache.GetGridSize());
+	scrolledWindow->Refresh(false);
+}
+
+// Returns the last zoom level needed, the first zoomed out view that shows the whole grid
+int MainFrame::GetMaxZoom() {
+
+	wxSize size = GetActiveView()->GetClientSize();
+	int maxZoom = cellZoomCount;
+	int level, scale;
+	GetOverviewScale(maxZoom, level, scale);
+	while (level < pyramid.GetLevelCount() - 1 &&
+		(pyramid.GetLevelCols(level) * scale > size.GetWidth() || pyramid.GetLevelRows(level) * scale > size.GetHeight())) {
+		GetOverviewScale(++maxZoom, level, scale);
 	}
+	return maxZoom;
+}
 
-	// Check if the input is for number of bombs
-	if (!IsBombEntry) {
-		// Check if the number is within the allowed range for width and height
-		if (value < 5 || value > 50) {
-			return false;
-		}
+// Gives the pyramid level and the # of screen pixels per pixel of a zoomed out view
+// (level 0 is drawn at 8, 4, 2 and 1 pixels per cell, the levels above it at 1 pixel per pixel)
+void MainFrame::GetOverviewScale(int zoomLevel, int& level, int& scale) const {
+
+	int overview = zoomLevel - cellZoomCount;
+	if (overview < 4) {
+		level = 0;
+		scale = 8 >> overview;
 	}
 	else {
-		// Check if the number is within the allowed range for number of bombs
-		if (value < 5 || value > 2490) {
-			return false;
-		}
+		level = overview - 3;
+		scale = 1;
 	}
+}
 
-	return true;
+// Gives the pyramid level and the # of screen pixels per pixel that fit the whole grid in the minimap
+void MainFrame::GetMinimapScale(int& level, int& scale) {
+
+	wxSize size = minimapPanel->GetClientSize();
+	level = pyramid.GetLevelToFit(size.GetWidth(), size.GetHeight());
+	scale = std::max(1, std::min(size.GetWidth() / pyramid.GetLevelCols(level), size.GetHeight() / pyramid.GetLevelRows(level)));
+}
+
+// Returns the window showing the grid at the current zoom level
+wxScrolledWindow* MainFrame::GetActiveView() {
+	return IsOverviewZoom() ? overviewWindow : scrolledWindow;
 }
 
-// Determines if the cell is an unflagged bomb
-bool MainFrame::IsUnflaggedBomb(int xPos, int yPos) {
+// Gives the part of the grid in view, as fractions of the whole grid
+void MainFrame::GetViewRect(double& left, double& top, double& width, double& height) {
 
-	if (buttons[xPos][yPos].IsBomb && !buttons[xPos][yPos].IsFlagged) {
-		return true;
+	wxScrolledWindow* view = GetActiveView();
+	wxSize virtualSize = view->GetVirtualSize();
+	wxSize clientSize = view->GetClientSize();
+	wxPoint viewStart = view->CalcUnscrolledPosition(wxPoint(0, 0));
+	double virtualWidth = std::max(virtualSize.GetWidth(), 1);
+	double virtualHeight = std::max(virtualSize.GetHeight(), 1);
+
+	left = viewStart.x / virtualWidth;
+	top = viewStart.y / virtualHeight;
+	width = std::min(1.0, clientSize.GetWidth() / virtualWidth);
+	height = std::min(1.0, clientSize.GetHeight() / virtualHeight);
+}
+
+// Gives the cells in view (the cells partly in view are included)
+wxRect MainFrame::GetViewCells() {
+
+	double left, top, width, height;
+	GetViewRect(left, top, width, height);
+	int firstCol = std::min(static_cast<int>(left * nCols), nCols - 1);
+	int firstRow = std::min(static_cast<int>(top * nRows), nRows - 1);
+	int lastCol = std::min(static_cast<int>(std::ceil((left + width) * nCols)), nCols);
+	int lastRow = std::min(static_cast<int>(std::ceil((top + height) * nRows)), nRows);
+	return wxRect(firstCol, firstRow, std::max(lastCol - firstCol, 1), std::max(lastRow - firstRow, 1));
+}
+
+// Scrolls the view so that a point of the grid (as fractions of the whole grid) is in the center
+void MainFrame::CenterView(double centerX, double centerY) {
+
+	wxScrolledWindow* view = GetActiveView();
+	wxSize virtualSize = view->GetVirtualSize();
+	wxSize clientSize = view->GetClientSize();
+	int pixelsPerUnitX, pixelsPerUnitY;
+	view->GetScrollPixelsPerUnit(&pixelsPerUnitX, &pixelsPerUnitY);
+
+	int x = std::max(0, static_cast<int>(centerX * virtualSize.GetWidth()) - clientSize.GetWidth() / 2);
+	int y = std::max(0, static_cast<int>(centerY * virtualSize.GetHeight()) - clientSize.GetHeight() / 2);
+	view->Scroll(x / std::max(pixelsPerUnitX, 1), y / std::max(pixelsPerUnitY, 1));
+}
+
+// Draws the minimap and the zoomed out view again after cells changed
+void MainFrame::RefreshBoardViews() {
+
+	minimapPanel->Refresh(false);
+	if (IsOverviewZoom()) {
+		overviewWindow->Refresh(false);
 	}
-	else {
-		return false;
+}
+
+// Sets up the minimap pyramid for the grid, with the cells the engine changed before it was set up
+void MainFrame::BuildPyramid() {
+
+	pyramid.Reset(nCols, nRows, minimapPalette);
+	int cellCount = static_cast<int>(visibleCells.size());
+	for (int index = 0; index < cellCount; index++) {
+		if (visibleCells[index] != GameBoard::Covered) {
+			pyramid.Update(index, visibleCells[index]);
+		}
 	}
+	IsPyramidReady = true;
+	minimapPanel->Refresh(false);
 }
 
-// Determines if the cell is within the grid's index
-bool MainFrame::IsInGridIndex(int xPos, int yPos) {
-	if (xPos >= 0 && yPos >= 0 && xPos < nCols && yPos < nRows) {
-		return true;
+// Draws a block of pixels of a pyramid level into a bitmap (the pixel buffer is reused between frames)
+wxBitmap MainFrame::RenderPyramid(int level, int firstCol, int firstRow, int cols, int rows, int scale) {
+
+	int width = cols * scale;
+	int height = rows * scale;
+	pyramidPixels.resize(static_cast<size_t>(width) * height * 3);
+	pyramid.Render(level, firstCol, firstRow, cols, rows, scale, pyramidPixels.data());
+
+	// The image uses the buffer without copying it, the bitmap is converted from it
+	wxImage image(width, height, pyramidPixels.data(), true);
+	return wxBitmap(image);
+}
+
+// Draws the whole grid in the minimap, with an outline around the part of the grid in view
+void MainFrame::OnMinimapPaint(wxPaintEvent& evt) {
+
+	wxAutoBufferedPaintDC dc(minimapPanel);
+	dc.SetBackground(wxBrush(panel->GetBackgroundColour()));
+	dc.Clear();
+	if (!IsPyramidReady) {
+		return;
 	}
-	else {
-		return false;
+
+	int level, scale;
+	GetMinimapScale(level, scale);
+	int width = pyramid.GetLevelCols(level) * scale;
+	int height = pyramid.GetLevelRows(level) * scale;
+	dc.DrawBitmap(RenderPyramid(level, 0, 0, pyramid.GetLevelCols(level), pyramid.GetLevelRows(level), scale), 0, 0);
+
+	double left, top, viewWidth, viewHeight;
+	GetViewRect(left, top, viewWidth, viewHeight);
+	dc.SetPen(wxPen(*wxBLUE, 2));
+	dc.SetBrush(*wxTRANSPARENT_BRUSH);
+	dc.DrawRectangle(static_cast<int>(left * width), static_cast<int>(top * height),
+		std::max(4, static_cast<int>(viewWidth * width)), std::max(4, static_cast<int>(viewHeight * height)));
+}
+
+// Clicking or dragging on the minimap moves the view to center on that point
+void MainFrame::OnMinimapMouse(wxMouseEvent& evt) {
+
+	if (!evt.LeftIsDown() || !IsPyramidReady) {
+		evt.Skip();
+		return;
 	}
+
+	int level, scale;
+	GetMinimapScale(level, scale);
+	double width = pyramid.GetLevelCols(level) * scale;
+	double height = pyramid.GetLevelRows(level) * scale;
+	CenterView(std::min(1.0, evt.GetX() / width), std::min(1.0, evt.GetY() / height));
+	minimapPanel->Refresh(false);
 }
 
-// Determmines if the cell has not been cleared, and has not been flagged
-bool MainFrame::IsFlaggable(int xPos, int yPos) {
+// Draws the part of the zoomed out view that is visible, from the pyramid level of the zoom
+void MainFrame::OnOverviewPaint(wxPaintEvent& evt) {
+
+	wxAutoBufferedPaintDC dc(overviewWindow);
+	overviewWindow->DoPrepareDC(dc);
+	dc.SetBackground(wxBrush(panel->GetBackgroundColour()));
+	dc.Clear();
+
+	int level, scale;
+	GetOverviewScale(zoom, level, scale);
+	wxPoint viewStart = overviewWindow->CalcUnscrolledPosition(wxPoint(0, 0));
+	wxSize clientSize = overviewWindow->GetClientSize();
+	int firstCol = viewStart.x / scale;
+	int firstRow = viewStart.y / scale;
+	int cols = std::min(pyramid.GetLevelCols(level) - firstCol, clientSize.GetWidth() / scale + 2);
+	int rows = std::min(pyramid.GetLevelRows(level) - firstRow, clientSize.GetHeight() / scale + 2);
+
+	if (cols > 0 && rows > 0) {
+		dc.DrawBitmap(RenderPyramid(level, firstCol, firstRow, cols, rows, scale), firstCol * scale, firstRow * scale);
+	}
+}
 
-	if (!buttons[xPos][yPos].IsCleared && !buttons[xPos][yPos].IsFlagged) {
-		return true;
+// Clicking on the zoomed out view zooms back in to the cells, centered on the clicked point
+void MainFrame::OnOverviewClick(wxMouseEvent& evt) {
+
+	wxPoint position = overviewWindow->CalcUnscrolledPosition(evt.GetPosition());
+	wxSize virtualSize = overviewWindow->GetVirtualSize();
+	double centerX = position.x / static_cast<double>(std::max(virtualSize.GetWidth(), 1));
+	double centerY = position.y / static_cast<double>(std::max(virtualSize.GetHeight(), 1));
+
+	SetZoom(0);
+	CenterView(centerX, centerY);
+}
+
+// Shows the next slice of the reveal animation (asking for another idle event until it is done),
+// and draws the minimap again when the view was scrolled, so its outline follows the view
+void MainFrame::OnIdle(wxIdleEvent& evt) {
+
+	if (revealPosition < revealQueue.size() && ApplyRevealSlice()) {
+		evt.RequestMore();
 	}
-	else {
-		return false;
+
+	wxPoint viewStart = GetActiveView()->GetViewStart();
+	if (viewStart != lastViewStart) {
+		lastViewStart = viewStart;
+		minimapPanel->Refresh(false);
 	}
+
+	// Count the mines left in view again when the view was scrolled, zoomed or resized
+	if (GetViewCells() != countedView) {
+		RequestRegionCount();
+	}
+	evt.Skip();
 }
 
-// Allows user to click on a numbered cell with the 
-// same number of flags surrounding it as its number 
-// and clear any surrounding cells 
-void MainFrame::RevealSurroundingCells(int xPos, int yPos) {
+// Sets every cell's tile from the board (used after the mines were shown on a lost game)
+void MainFrame::RedrawAllCells() {
 
-	// Only checks if the number of flags surrounding a cell equals the number of mines
-	// surround the cell. This doesn't check if the flags were placed correctly 
-	// So, if the user flags incorrectly and a mine is in the surrounding cells, the game ends
-	int numFlagsSurrounding = CountFlagsSurrounding(xPos, yPos);
-	if (numFlagsSurrounding == buttons[xPos][yPos].numMinesSurrounding) {
-		ClearSurroundingCells(xPos, yPos);
+	CancelReveal();
+	wxStopWatch paintTimer;
+	int cellCount = static_cast<int>(visibleCells.size());
+	for (int index = 0; index < cellCount; index++) {
+		UpdateCell(index);
 	}
+	ReportPaintTime(cellCount, paintTimer);
+	RefreshBoardViews();
+
+	UpdateBombsRemaining();
 }
 
-// Counts the number of flags in the 8 surrounding cells of input coordinate
-int MainFrame::CountFlagsSurrounding(int xPos, int yPos) {
-	// Define all possible single movements from an initial coordinate
-	const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
-	const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+// Restart the game with the same grid size and # of bombs
+void MainFrame::ReStart() {
 
-	int count = 0;
+	// Start a new game on the board (bombs are placed on the first cell press), the grid is reset once the engine started it
+	SubmitMove(EngineThread::CommandType::NewGame, 0, 0, CreateSeed());
+}
 
-	// Iterate through the 8 surrounding cells, incriment count if there is a bomb  
-	for (int i = 0; i < 8; i++) {
-		int newX = xPos + dx[i];
-		int newY = yPos + dy[i];
-		if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
-			if (buttons[newX][newY].IsFlagged) {
-				count++;
-			}
-		}
+// Resets the grid for the new game started by the engine
+void MainFrame::ApplyNewGame() {
+
+	// Set all of the cells to their default state, every render tile is drawn again
+	CancelReveal();
+	wxStopWatch paintTimer;
+	std::fill(visibleCells.begin(), visibleCells.end(), GameBoard::Covered);
+	lostMines.clear();
+	falseFlags.clear();
+	hintCell = -1;
+	std::fill(cellTiles.begin(), cellTiles.end(), TileCache::Covered);
+	renderCache.InvalidateAll();
+	renderCache.ResetStats();
+	ReportPaintTime(nCols * nRows, paintTimer);
+
+	// Cover every cell of the minimap again
+	if (IsPyramidReady) {
+		pyramid.Clear();
 	}
+	RefreshBoardViews();
 
-	return count;
-}
+	// Reset bombs counter display
+	UpdateBombsRemaining();
 
-// Clears cells around a numbered cell
-void MainFrame::ClearSurroundingCells(int xPos, int yPos) {
+	// Reset booleans for game beginning
+	InFlagMode = false;
+	InHintMode = false;
 
-	// Define all possible single movements from an initial coordinate
-	const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
-	const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+}
 
-	// Iterate through the 8 surrounding cells, incriment count if there is a bomb  
-	for (int i = 0; i < 8; i++) {
-		int newX = xPos + dx[i];
-		int newY = yPos + dy[i];
-		if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
+// Creates a random seed that the board uses to place the bombs
+uint64_t MainFrame::CreateSeed() {
+	std::random_device rd;
+	return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
 
-			// check if current surrounding cell is a mine  
-			if (IsUnflaggedBomb(newX, newY)) {
-				//buttons[newX][newY].button->SetLabel(bombChar);
-				ShowMinesAndFalseFlags();
+// Determines if user inputted grid width or height is valid 
+bool MainFrame::ValidateInput(wxString& inputStr, bool IsBombEntry) {
 
-				int userResponse = wxMessageBox(wxT("KABOOM! \t Restart?"), wxT("Game Over"), wxYES_NO | wxICON_ERROR);
-				if (userResponse == wxYES) {
-					ReStart();
-					return;
-				}
+	// initialize intermediate variable 
+	long value;
 
-			} 
-			// Ensure that flags are not removed 
-			else if (!buttons[newX][newY].IsFlagged) {
-
-				int surroundingBombs = CountBombsSurrounding(newX, newY);
-				buttons[newX][newY].numMinesSurrounding = surroundingBombs;
-
-				// Check if there are no surrounding bombs (cell is empty)
-				if (surroundingBombs == 0) {
-					ClearEmpty(newX, newY);
-					if (IsGridCleared()) {
-						if (CheckForVictory()) {
-							return;
-						}
-					}
-				}
-				else { // has surrounding bombs: Label how many bombs surround the cell
-					LabelCell(newX, newY, surroundingBombs);
-
-					// check for victory 
-					if (IsGridCleared()) {
-						if (CheckForVictory()) {
-							return;
-						}
-					}
-				}
-			}
+	// Check if the string can be converted to a number 
+	if (!inputStr.ToLong(&value)) {
+		return false;
+	}
+
+	// Check if the input is for number of bombs
+	if (!IsBombEntry) {
+		// Check if the number is within the allowed range for width and height
+		if (value < 5 || value > maxGridSide) {
+			return false;
 		}
 	}
+	else {
+		// Check if the number is within the allowed range for number of bombs (the grid size is checked after)
+		if (value < 5 || value > static_cast<long>(maxGridSide) * maxGridSide) {
+			return false;
+		}
+	}
+
+	return true;
 }
 
 // Displays all unflagged mines and false flags after a play has lost
 void MainFrame::ShowMinesAndFalseFlags() {
 	
-	// Loop through all of the cells in the grid 
-	for (int i = 0; i < nCols; i++) {
-		for (int j = 0; j < nRows; j++) {
-
-			// If cell is a false flag
-			if (buttons[i][j].IsFlagged && !buttons[i][j].IsBomb) {
-				buttons[i][j].button->SetLabel(falseFlagChar);
-			}
-			// if cell is an unflagged bomb
-			else if (IsUnflaggedBomb(i, j)) {
-				buttons[i][j].button->SetLabel(bombChar);
-			}
-		}
+	// The engine listed the false flags and the unflagged bombs when the game was lost
+	for (uint32_t index : falseFlags) {
+		SetCellTile(index % nCols, index / nCols, TileCache::FalseFlag);
+	}
+	for (uint32_t index : lostMines) {
+		SetCellTile(index % nCols, index / nCols, TileCache::Bomb);
 	}
+	scrolledWindow->Refresh(false);
 	
 }
\ No newline at end of file
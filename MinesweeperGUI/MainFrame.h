@@ -1,12 +1,22 @@
 #pragma once
 #include <wx/wx.h>
+#include <wx/stopwatch.h>
+#include <wx/timer.h>
 #include <vector>
-#include <map>
+#include "DifficultyProfiler.h"
+#include "EngineThread.h"
+#include "GameBoard.h"
+#include "GridRenderCache.h"
+#include "LayoutImporter.h"
+#include "MipPyramid.h"
+#include "StatsStore.h"
+#include "TileCache.h"
 
 class MainFrame : public wxFrame
 {
 public:
-	MainFrame(const wxString& title);
+	MainFrame(const wxString& title, StatsStore& stats);
+	~MainFrame();
 
 private:
 
@@ -14,6 +24,9 @@ private:
 	void Start();
 	void SetupMainMenu();
 	void SetupCustomInputs();
+	void OnMenuIdle(wxIdleEvent& evt);
+	void OnStatsClicked(wxCommandEvent& evt);
+	wxString FormatStats(const wxString& name, const BoardStats& boardStats);
 
 	// Define methods that are used for Custom selection in main menu
 	bool HandleCustomSelection(); 
@@ -24,6 +37,8 @@ private:
 
 	// Define methods that handle transition from main menu to the game
 	void OnStartClicked(wxCommandEvent& evt);
+	void OnLoadLayoutClicked(wxCommandEvent& evt);
+	void ShowGame();
 	void HideMainMenu();
 
 	// Define methods to setup the game UI elements 
@@ -31,48 +46,80 @@ private:
 	void SetupSizers();
 	void CreateMatrix();
 
-	// Define methods used to handle gameplay
-	void FindButtonCoordinates(int buttonID);
-	void OnButtonPressed(int xPos, int yPos);
-	void OnFirstButtonPressed(int xPos, int yPos);
-	void HideButton(int xPos, int yPos);
-	void RemoveUnallowedCoordinates(int xPos, int yPos);
-	void RandomizeCoordinateOrder();
-	void PlaceBombs();
-	int CountBombsSurrounding(int xPos, int yPos);
-	void ClearEmpty(int xPos, int yPos);
-	bool IsGridCleared();
-	void LabelCell(int xPos, int yPos, int surroundingBombs);
-	void SetFlag(int, int);
-	bool CheckForVictory();
+	// Define methods used to handle gameplay (the rules themselves live in GameBoard)
+	bool FindCellAt(const wxPoint& position, int& x, int& y);
+	void OnCellPressed(int xPos, int yPos);
+	bool SubmitMove(EngineThread::CommandType type, int xPos, int yPos, uint64_t seed = 0);
+	bool SubmitViewCommand(EngineThread::CommandType type);
+	void RequestRegionCount();
+	void ShowRegionCount(const EngineThread::Result& result);
+	void StartFirstReveal(int xPos, int yPos);
+	void OnFirstRevealDone(const EngineThread::Result& result);
+	void OnEngineResults();
+	void ApplyBoardChanges(const EngineThread::Result& result);
+	void ReportMoveLatency(const EngineThread::Result& result, int64_t receiveTime, int cellCount);
+	void ShowHint(const EngineThread::Result& result);
+	void QueueReveal(const std::vector<GameBoard::CellChange>& changes, int originX, int originY);
+	bool ApplyRevealSlice();
+	void CancelReveal();
+	void UpdateCell(int index);
+	void SetCellTile(int xPos, int yPos, TileCache::Tile tile);
+	void ReportPaintTime(int cellCount, const wxStopWatch& paintTimer);
+	bool CheckForGameOver();
 	void ReStart();
-	void RevealSurroundingCells(int xPos, int yPos);
-	int CountFlagsSurrounding(int xPos, int yPos);
-	void ClearSurroundingCells(int xPos, int yPos);
+	void ApplyNewGame();
+	void RedrawAllCells();
+	uint64_t CreateSeed();
 	void ShowMinesAndFalseFlags();
 	void UpdateBombsRemaining();
+	void StartGameRecord(const EngineThread::Result& result);
+	void RecordGame(const EngineThread::Result& result);
+	void ProfileBoard(const EngineThread::Result& result);
+	void OnBoardProfiled(uint64_t game, const BoardProfile& profile);
+
+	// Define methods used for the minimap and zoom (the zoomed out views are drawn from the minimap pyramid)
+	void SetZoom(int newZoom);
+	void ApplyCellZoom();
+	int GetMaxZoom();
+	bool IsOverviewZoom() const { return zoom >= cellZoomCount; }
+	void GetOverviewScale(int zoomLevel, int& level, int& scale) const;
+	void GetMinimapScale(int& level, int& scale);
+	wxScrolledWindow* GetActiveView();
+	void GetViewRect(double& left, double& top, double& width, double& height);
+	wxRect GetViewCells();
+	void CenterView(double centerX, double centerY);
+	void RefreshBoardViews();
+	void BuildPyramid();
+	wxBitmap RenderPyramid(int level, int firstCol, int firstRow, int cols, int rows, int scale);
 
 	// Define method that will bring user back to main menu
 	void GoToMainMenu();
 
 	// Define methods that are used for in-game event handling
 	wxDECLARE_EVENT_TABLE();
-	void OnButtonClicked(wxCommandEvent& evt);
+	void OnGridLeftDown(wxMouseEvent& evt);
+	void OnGridRightDown(wxMouseEvent& evt);
+	void OnGridPaint(wxPaintEvent& evt);
+	void OnGridSize(wxSizeEvent& evt);
 	void OnMouseWheelScroll(wxMouseEvent& event);
 	void OnHomeClicked(wxCommandEvent& evt);
 	void OnButtonHintClicked(wxCommandEvent& evt);
 	void OnButtonFlagClicked(wxCommandEvent& evt);
 	void OnButtonRestartClicked(wxCommandEvent& evt);
-	void OnRightClick(wxMouseEvent& evt);
-
-	// Define methods that check for various cell conditions 
-	bool IsUnflaggedBomb(int xPos, int yPos);
-	bool IsInGridIndex(int xPos, int yPos);
-	bool IsFlaggable(int xPos, int yPos);
+	void OnButtonUndoClicked(wxCommandEvent& evt);
+	void OnButtonRedoClicked(wxCommandEvent& evt);
+	void OnDpiChanged(wxDPIChangedEvent& evt);
+	void OnGenerationTimer(wxTimerEvent& evt);
+	void OnButtonZoomInClicked(wxCommandEvent& evt);
+	void OnButtonZoomOutClicked(wxCommandEvent& evt);
+	void OnMinimapPaint(wxPaintEvent& evt);
+	void OnMinimapMouse(wxMouseEvent& evt);
+	void OnOverviewPaint(wxPaintEvent& evt);
+	void OnOverviewClick(wxMouseEvent& evt);
+	void OnIdle(wxIdleEvent& evt);
 
 	// Define Universal UI elements (used in menu and game)
 	wxPanel* panel;
-	wxSize buttonSize = wxSize(60, 60);
 	wxFont headlineFont = wxFont(wxFontInfo(wxSize(0, 36)).Bold());
 	wxFont mainFont = wxFont(wxFontInfo(wxSize(0, 24)).Bold());
 	wxFont fieldInputFont = wxFont(wxFontInfo(wxSize(0, 24)));
@@ -87,6 +134,21 @@ private:
 	wxUniChar flagIndicatorChar = wxUniChar(0x0001F3F3);
 	wxUniChar homeChar = wxUniChar(0x0001F3E0);
 	wxUniChar falseFlagChar = wxUniChar(0x00002716); // 0x00002612
+	wxUniChar undoChar = wxUniChar(0x000021B6);
+	wxUniChar redoChar = wxUniChar(0x000021B7);
+	wxUniChar zoomInChar = wxUniChar(0x0000002B);
+	wxUniChar zoomOutChar = wxUniChar(0x00002212);
+
+	// Define the pre-drawn cell images (numbers, flags, bombs), drawn once for the tile size and DPI
+	// (a tile is a cell without the grid lines on its right and bottom)
+	int cellSize = 60;
+	wxSize tileSize = wxSize(59, 59);
+	TileCache tileCache = TileCache(flagSetChar, flagIndicatorChar, bombChar, falseFlagChar, wxColour(*wxWHITE), backgroundColor);
+
+	// Define the grid drawn into render tiles of 32 x 32 cells, and the tile shown on each cell (index x + y * nCols)
+	GridRenderCache renderCache = GridRenderCache(wxColour(160, 160, 160), backgroundColor);
+	std::vector<TileCache::Tile> cellTiles;
+	wxPoint lastPaintOrigin;
 
 	// Define sizers for Main Menu
 	wxBoxSizer* lowerSizer;
@@ -99,68 +161,122 @@ private:
 	wxStaticText* gridWidthStaticText;
 	wxStaticText* gridHeightStaticText;
 	wxStaticText* numBombsStaticText;
+	wxButton* loadLayoutButton;
 	wxStaticText* headlineTextGame;
 	wxArrayString gridSizeOptions;
 	wxButton* startButton;
+	wxCheckBox* trainingModeCheckBox;
+	wxCheckBox* autoFlagCheckBox;
+	wxCheckBox* autoChordCheckBox;
+	wxButton* statsButton;
+	wxRadioBox* topologySelector;
+	wxArrayString topologyOptions;
 	wxTextCtrl* numBombsRemainingTextCtrl;
 	wxString numBombsRemainingString;
+	wxStaticText* regionMinesText;
 
 	// Define variables used for game UI elements 
 	wxStaticText* headlineText;
-	wxGridSizer* gridSizer;
 	wxSizerFlags buttonFlags;
 	wxBoxSizer* mainSizer;
 	wxScrolledWindow* scrolledWindow;
-	int numberFlagsPlaced = 0;
+
+	// Define the minimap and the zoomed out view of the grid, both drawn from the pyramid
+	wxPanel* minimapPanel;
+	wxScrolledWindow* overviewWindow;
+	MipPyramid pyramid;
+	bool IsPyramidReady = false;
+	std::vector<uint8_t> pyramidPixels;
+	wxPoint lastViewStart;
+
+	// Define the zoom: the first levels are cell sizes, the levels after them are zoomed out views
+	static const int cellZoomCount = 4;
+	int zoom = 0;
 
 	// Define game UI buttons 
 	wxButton* homeButton;
 	wxButton* hintButton;
 	wxButton* flagButton;
 	wxButton* restartButton;
+	wxButton* undoButton;
+	wxButton* redoButton;
+	wxButton* zoomInButton;
+	wxButton* zoomOutButton;
 
 	// Define wxIDs for game UI buttons
 	enum IDs {
 		homeButtonID = 5,
 		hintButtonID = 4,
 		flagButtonID = 3,
-		restartButtonID = 2
+		restartButtonID = 2,
+		undoButtonID = 6,
+		redoButtonID = 7,
+		zoomInButtonID = 8,
+		zoomOutButtonID = 9
 	};
 
-	// Define struct used to store the data for each cell in the grid
-	struct ButtonData {
-		int wxID;
-		int numMinesSurrounding;
-		bool IsBomb = false;
-		wxButton* button;
-		int xPos;
-		int yPos;
-		bool IsCleared = false;
-		bool IsFlagged = false;
-	};
+	// Define the game rules and state of every cell (bombs, cleared, flagged). Once the game screen is set up only the
+	// engine thread uses the board (it is declared after the board, so it stops first)
+	GameBoard board;
+	EngineThread engine;
+
+	// Define what the UI knows of the game, kept up to date from the results of the engine: the visible state of
+	// every cell, and the mines and false flags shown when the game is lost
+	std::vector<uint8_t> visibleCells;
+	GameBoard::Status gameStatus = GameBoard::Status::NotStarted;
+	int flagsPlaced = 0;
+	std::vector<uint32_t> lostMines;
+	std::vector<uint32_t> falseFlags;
+	int hintCell = -1;
 
-	// Define vector of vectors that stores all of the grid cells
-	std::vector<std::vector<ButtonData>> buttons;
+	// Define the statistics of every game (kept by the app), and the record of the game being played: it is filled in
+	// as the game goes, and added to the statistics when the game ends (once, a game lost and undone in training mode
+	// isn't added again). The time runs from the end of the first reveal (the start of a layout game)
+	StatsStore& stats;
+	GameRecord gameRecord = {};
+	int64_t gameStartTime = 0;
+	bool IsGameRecorded = false;
 
-	// Define a map that links a cell with its respective coordinates 
-	std::map<int, ButtonData*> buttonMap;
+	// Define the pool that profiles the difficulty of each board after its first reveal, and the # of the game
+	// being played (a profile that comes back after its game ended is dropped)
+	DifficultyProfiler profiler;
+	uint64_t gameNumber = 0;
 
-	// Define a vector that stores coordinates that bombs can be placed in
-	std::vector<std::pair<int, int>> possibleCoordinates;
+	// Define the count of the mines left in view (one count is asked of the engine at a time, a view or board that
+	// changed while it was being counted is counted again when it comes back)
+	wxRect countedView;
+	bool IsRegionCountPending = false;
+	bool IsRegionCountStale = false;
 
 	// Define variables that are used in game initialization 
 	int nRows;
 	int nCols;
 	int numberOfBombs;
 
-	// Define variables that are used in event handling 
-	int xPos = 0;
-	int yPos = 0;
+	// Define the progress shown while the engine runs the first reveal (it places the bombs)
+	wxTimer generationTimer;
+	wxStopWatch generationStopWatch;
+	wxProgressDialog* generationDialog = nullptr;
+
+	// Define the reveal animation: the cells changed by big moves that are left to show (from revealPosition on),
+	// and the counts used to sort them and to time the animation
+	std::vector<uint32_t> revealQueue;
+	std::vector<uint32_t> revealDistanceCounts;
+	size_t revealPosition = 0;
+	wxStopWatch revealStopWatch;
+	int revealSlices = 0;
+	double longestRevealSlice = 0;
+	bool IsGameOverPending = false;
+
+	// Define the startup times shown in the status bar: from the window being created to the menu handling input,
+	// and from the Start click to the first frame of the grid (the rest of the game screen is set up after it)
+	wxStopWatch startupStopWatch;
+	wxStopWatch firstFrameStopWatch;
+	bool IsFirstFramePending = false;
 
 	// Define booleans to drive intended behaviors
-	bool IsFirstButtonPress = true;
 	bool InFlagMode = false;
 	bool InHintMode = false;
-	bool HasFlaggedBeforeFirstClick = false;
+	bool IsGenerating = false;
 
 };
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "MinesweeperAPI.h"
+#include "RulesEngine.h"
+#include <algorithm>
+#include <cstddef>
+#include <new>
+
+// The C handle holds the engine of its grid size (the specialized engine of a preset size), which never changes
+// for the game's life, so the visible state stays where it is
+struct ms_game {
+	std::unique_ptr<RulesEngine> engine;
+};
+
+// The change list and visible values are handed out without copying, so the layouts must match
+static_assert(sizeof(ms_change) == sizeof(GameBoard::CellChange), "ms_change layout must match GameBoard::CellChange");
+static_assert(offsetof(ms_change, index) == offsetof(GameBoard::CellChange, index), "ms_change layout must match GameBoard::CellChange");
+static_assert(offsetof(ms_change, visible) == offsetof(GameBoard::CellChange, visible), "ms_change layout must match GameBoard::CellChange");
+static_assert(MS_COVERED == GameBoard::Covered && MS_FLAGGED == GameBoard::Flagged, "visible values must match GameBoard");
+static_assert(MS_LOST == static_cast<int>(GameBoard::Status::Lost), "status values must match GameBoard");
+
+// Runs a call into the engine so that no exception crosses the C boundary (a board too big for the memory throws
+// std::bad_alloc, a large first reveal starts threads), failed is returned instead. The calls that only read the
+// board can't throw and are made directly
+template <class Result, class Function>
+static Result CallEngine(Result failed, Function function) {
+	try {
+		return function();
+	}
+	catch (...) {
+		return failed;
+	}
+}
+
+uint32_t ms_api_version(void) {
+	return MS_API_VERSION;
+}
+
+ms_game* ms_create(int cols, int rows, int bombs, uint64_t seed) {
+
+	// Ensure that the grid exists and that there is room for the bombs outside the first 3x3 area (the first cell
+	// revealed and its neighbors, fewer cells on a grid narrower than 3)
+	if (cols <= 0 || rows <= 0 || bombs < 0 || static_cast<int64_t>(cols) * rows > INT32_MAX ||
+		bombs > cols * rows - std::min(cols, 3) * std::min(rows, 3)) {
+		return nullptr;
+	}
+
+	ms_game* game = new (std::nothrow) ms_game();
+	if (game == nullptr) {
+		return nullptr;
+	}
+	bool IsCreated = CallEngine(false, [&]() {
+		game->engine = RulesEngine::Create(cols, rows, bombs);
+		game->engine->NewGame(seed);
+		return true;
+	});
+	if (!IsCreated) {
+		delete game;
+		return nullptr;
+	}
+	return game;
+}
+
+void ms_destroy(ms_game* game) {
+	delete game;
+}
+
+void ms_new_game(ms_game* game, uint64_t seed) {
+	CallEngine(false, [&]() { game->engine->NewGame(seed); return true; });
+}
+
+int ms_reveal(ms_game* game, int xPos, int yPos) {
+	return CallEngine(0, [&]() { return game->engine->Reveal(xPos, yPos) ? 1 : 0; });
+}
+
+int ms_flag(ms_game* game, int xPos, int yPos) {
+	return CallEngine(0, [&]() { return game->engine->ToggleFlag(xPos, yPos) ? 1 : 0; });
+}
+
+int ms_chord(ms_game* game, int xPos, int yPos) {
+	return CallEngine(0, [&]() { return game->engine->Chord(xPos, yPos) ? 1 : 0; });
+}
+
+const uint8_t* ms_visible(const ms_game* game) {
+	return game->engine->GetVisibleState();
+}
+
+const ms_change* ms_changes(const ms_game* game, uint32_t* count) {
+	*count = static_cast<uint32_t>(game->engine->GetChangeCount());
+	return reinterpret_cast<const ms_change*>(game->engine->GetChanges());
+}
+
+int ms_status(const ms_game* game) {
+	return static_cast<int>(game->engine->GetStatus());
+}
+
+int ms_cols(const ms_game* game) {
+	return game->engine->GetCols();
+}
+
+int ms_rows(const ms_game* game) {
+	return game->engine->GetRows();
+}
+
+int ms_bombs(const ms_game* game) {
+	return game->engine->GetNumberOfBombs();
+}
+
+int ms_flags_placed(const ms_game* game) {
+	return game->engine->GetFlagsPlaced();
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+
+// Stable C ABI over GameBoard, so in-process agents (bots, solvers, other languages)
+// can play games without any IPC and without copying the board after every move.
+//
+// The visible state is a packed buffer of one byte per cell (index = xPos + yPos * cols):
+// 0 - 8 for a revealed cell, MS_COVERED or MS_FLAGGED. The pointer returned by ms_visible
+// stays valid (and is updated in place) until the game is destroyed.
+// The changes returned by ms_changes are only valid until the next move.
+
+#if defined(_WIN32)
+	#if defined(MINESWEEPER_API_EXPORTS)
+		#define MS_API __declspec(dllexport)
+	#else
+		#define MS_API __declspec(dllimport)
+	#endif
+#else
+	#define MS_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Define the version of the ABI (only incremented on incompatible changes)
+#define MS_API_VERSION 1
+
+// Define the values of the visible state buffer that aren't a number
+#define MS_COVERED 9
+#define MS_FLAGGED 10
+
+// Define the state of a game as a whole
+#define MS_NOT_STARTED 0
+#define MS_PLAYING 1
+#define MS_WON 2
+#define MS_LOST 3
+
+typedef struct ms_game ms_game;
+
+// Define a cell whose visible value was changed by the last move
+typedef struct ms_change {
+	uint32_t index;
+	uint8_t visible;
+} ms_change;
+
+MS_API uint32_t ms_api_version(void);
+
+// Creates a game (bombs are placed from the seed on the first reveal), returns NULL on invalid sizes, if the bombs
+// don't fit outside the 3x3 area around the first reveal, or if the board can't be allocated
+MS_API ms_game* ms_create(int cols, int rows, int bombs, uint64_t seed);
+MS_API void ms_destroy(ms_game* game);
+MS_API void ms_new_game(ms_game* game, uint64_t seed);
+
+// Moves return 1 if the board changed and 0 otherwise (also if the move failed, out of memory: no exception ever
+// leaves the library)
+MS_API int ms_reveal(ms_game* game, int xPos, int yPos);
+MS_API int ms_flag(ms_game* game, int xPos, int yPos);
+MS_API int ms_chord(ms_game* game, int xPos, int yPos);
+
+// Read access to the board
+MS_API const uint8_t* ms_visible(const ms_game* game);
+MS_API const ms_change* ms_changes(const ms_game* game, uint32_t* count);
+MS_API int ms_status(const ms_game* game);
+MS_API int ms_cols(const ms_game* game);
+MS_API int ms_rows(const ms_game* game);
+MS_API int ms_bombs(const ms_game* game);
+MS_API int ms_flags_placed(const ms_game* game);
+
+#ifdef __cplusplus
+}
+#endif
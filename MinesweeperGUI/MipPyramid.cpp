@@ -0,0 +1,132 @@
+#include "MipPyramid.h"
+#include "VisibleCell.h"
+#include <algorithm>
+
+// Allocates every level for the grid size, up to the level that is a single pixel
+void MipPyramid::Reset(int nCols, int nRows, const Palette& palette) {
+
+	this->nCols = nCols;
+	this->nRows = nRows;
+	this->palette = palette;
+
+	levels.clear();
+	for (int level = 1; GetLevelCols(level - 1) > 1 || GetLevelRows(level - 1) > 1; level++) {
+		levels.push_back(std::vector<Texel>(static_cast<size_t>(GetLevelCols(level)) * GetLevelRows(level)));
+	}
+	Clear();
+}
+
+// Covers every cell again (a new game on the same grid)
+void MipPyramid::Clear() {
+	cells.assign(static_cast<size_t>(nCols) * nRows, CoveredCell);
+	Texel covered = { 0, 0, { palette.covered[0], palette.covered[1], palette.covered[2] }, false };
+	for (std::vector<Texel>& texels : levels) {
+		std::fill(texels.begin(), texels.end(), covered);
+	}
+}
+
+void MipPyramid::Update(int index, uint8_t visible) {
+
+	uint8_t state = (visible == VisibleCellValues::Flagged) ? FlaggedCell : (visible == VisibleCellValues::Covered) ? CoveredCell : RevealedCell;
+	uint8_t previous = cells[index];
+	if (state == previous) {
+		return;
+	}
+	cells[index] = state;
+
+	// Move the cell from its previous count to its new count in the pixel covering it on every level
+	int x = index % nCols;
+	int y = index / nCols;
+	for (size_t i = 0; i < levels.size(); i++) {
+		int level = static_cast<int>(i) + 1;
+		Texel& texel = levels[i][static_cast<size_t>(y >> level) * GetLevelCols(level) + (x >> level)];
+		texel.revealed += (state == RevealedCell) - (previous == RevealedCell);
+		texel.flagged += (state == FlaggedCell) - (previous == FlaggedCell);
+		texel.IsDirty = true;
+	}
+}
+
+int MipPyramid::GetLevelToFit(int width, int height) const {
+	int level = 0;
+	while (level < GetLevelCount() - 1 && (GetLevelCols(level) > width || GetLevelRows(level) > height)) {
+		level++;
+	}
+	return level;
+}
+
+uint32_t MipPyramid::GetRevealed(int level, int x, int y) const {
+	if (level == 0) {
+		return cells[static_cast<size_t>(y) * nCols + x] == RevealedCell;
+	}
+	return levels[level - 1][static_cast<size_t>(y) * GetLevelCols(level) + x].revealed;
+}
+
+uint32_t MipPyramid::GetFlagged(int level, int x, int y) const {
+	if (level == 0) {
+		return cells[static_cast<size_t>(y) * nCols + x] == FlaggedCell;
+	}
+	return levels[level - 1][static_cast<size_t>(y) * GetLevelCols(level) + x].flagged;
+}
+
+// Returns the # of cells a pixel covers (pixels on the right and bottom edges can cover fewer)
+uint32_t MipPyramid::GetCellCount(int level, int x, int y) const {
+	uint32_t cols = std::min(1 << level, nCols - (x << level));
+	uint32_t rows = std::min(1 << level, nRows - (y << level));
+	return cols * rows;
+}
+
+void MipPyramid::Render(int level, int firstCol, int firstRow, int cols, int rows, int scale, uint8_t* rgb) {
+
+	size_t rowBytes = static_cast<size_t>(cols) * scale * 3;
+	for (int j = 0; j < rows; j++) {
+		int y = firstRow + j;
+		uint8_t* line = rgb + static_cast<size_t>(j) * scale * rowBytes;
+		uint8_t* pixel = line;
+
+		if (level == 0) {
+			const uint8_t* states = &cells[static_cast<size_t>(y) * nCols + firstCol];
+			for (int i = 0; i < cols; i++) {
+				const uint8_t* colour = (states[i] == RevealedCell) ? palette.revealed : (states[i] == FlaggedCell) ? palette.flagged : palette.covered;
+				for (int s = 0; s < scale; s++, pixel += 3) {
+					pixel[0] = colour[0];
+					pixel[1] = colour[1];
+					pixel[2] = colour[2];
+				}
+			}
+		}
+		else {
+			Texel* texels = &levels[level - 1][static_cast<size_t>(y) * GetLevelCols(level) + firstCol];
+			uint64_t cellRows = std::min(1 << level, nRows - (y << level));
+			for (int i = 0; i < cols; i++) {
+				Texel& texel = texels[i];
+				if (texel.IsDirty) {
+					Blend(level, firstCol + i, texel, cellRows);
+				}
+				for (int s = 0; s < scale; s++, pixel += 3) {
+					pixel[0] = texel.colour[0];
+					pixel[1] = texel.colour[1];
+					pixel[2] = texel.colour[2];
+				}
+			}
+		}
+
+		// The other lines of a scaled pixel are copies of the first
+		for (int s = 1; s < scale; s++) {
+			std::copy(line, line + rowBytes, line + s * rowBytes);
+		}
+	}
+}
+
+// Blends the color of a pixel by the share of covered, revealed and flagged cells. Pixels inside the grid
+// cover 4^level cells, so the division is a shift (pixels on the right and bottom edges can cover fewer)
+void MipPyramid::Blend(int level, int x, Texel& texel, uint64_t cellRows) const {
+
+	uint64_t cellCount = cellRows * std::min(1 << level, nCols - (x << level));
+	uint64_t covered = cellCount - texel.revealed - texel.flagged;
+	bool IsFullPixel = cellCount == (uint64_t(1) << (2 * level));
+	for (int c = 0; c < 3; c++) {
+		uint64_t sum = covered * palette.covered[c] + texel.revealed * palette.revealed[c] + texel.flagged * palette.flagged[c];
+		texel.colour[c] = static_cast<uint8_t>(IsFullPixel ? sum >> (2 * level) : sum / cellCount);
+	}
+	texel.IsDirty = false;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stores downsampled images of the board for the minimap and the zoomed out views. Level 0 has one pixel per cell
+// (covered, revealed or flagged), and each next level halves the width and height, every pixel counting the revealed
+// and flagged cells it covers (the rest are covered). It is updated from the cells changed by each move,
+// one pixel per level for each cell, so it is never rebuilt while a game is played. Each pixel keeps its blended
+// color, which is only blended again when the pixel is drawn after one of its cells changed
+class MipPyramid
+{
+public:
+
+	// Define the colors used to draw the pixels (a pixel covering several cells blends them by their share)
+	struct Palette {
+		uint8_t covered[3];
+		uint8_t revealed[3];
+		uint8_t flagged[3];
+	};
+
+	// Define methods used to set up the pyramid (every cell starts covered)
+	void Reset(int nCols, int nRows, const Palette& palette);
+	void Clear();
+
+	// Updates the pyramid for a cell whose visible value changed (a GameBoard visible value)
+	void Update(int index, uint8_t visible);
+
+	// Define methods that give the size of each level
+	int GetLevelCount() const { return static_cast<int>(levels.size()) + 1; }
+	int GetLevelCols(int level) const { return (nCols + (1 << level) - 1) >> level; }
+	int GetLevelRows(int level) const { return (nRows + (1 << level) - 1) >> level; }
+
+	// Returns the lowest level that fits in the given # of pixels
+	int GetLevelToFit(int width, int height) const;
+
+	// Draws a block of pixels of a level as RGB, each pixel scaled to scale x scale
+	// (rgb must hold cols * rows * scale * scale * 3 bytes)
+	void Render(int level, int firstCol, int firstRow, int cols, int rows, int scale, uint8_t* rgb);
+
+	// Define methods that give read access to the counts (used to check the pyramid against the board)
+	uint32_t GetRevealed(int level, int x, int y) const;
+	uint32_t GetFlagged(int level, int x, int y) const;
+	uint32_t GetCellCount(int level, int x, int y) const;
+
+private:
+
+	// Define the values stored for each cell of level 0
+	enum CellState : uint8_t {
+		CoveredCell,
+		RevealedCell,
+		FlaggedCell
+	};
+
+	// Define the counts and the color stored for each pixel of the levels above 0
+	struct Texel {
+		uint32_t revealed;
+		uint32_t flagged;
+		uint8_t colour[3];
+		bool IsDirty;
+	};
+
+	void Blend(int level, int x, Texel& texel, uint64_t cellRows) const;
+
+	int nCols = 0;
+	int nRows = 0;
+	Palette palette = {};
+	std::vector<uint8_t> cells;
+	std::vector<std::vector<Texel>> levels;
+};
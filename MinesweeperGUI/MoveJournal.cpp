@@ -0,0 +1,107 @@
+#include "MoveJournal.h"
+#include <algorithm>
+
+static size_t RoundUpToPowerOf2(size_t value) {
+	size_t power = 1;
+	while (power < value) {
+		power <<= 1;
+	}
+	return power;
+}
+
+// Allocates the ring buffers (the only place the journal allocates), an empty journal records nothing
+void MoveJournal::Reset(size_t capacityWords, size_t capacityMoves) {
+
+	std::vector<uint32_t>(capacityWords > 0 ? RoundUpToPowerOf2(capacityWords) : 0).swap(words);
+	std::vector<Move>(capacityMoves > 0 ? RoundUpToPowerOf2(capacityMoves) : 0).swap(moves);
+	Clear();
+}
+
+// Forgets every move
+void MoveJournal::Clear() {
+	nextWord = 0;
+	firstMove = 0;
+	moveCount = 0;
+	appliedMoves = 0;
+}
+
+bool MoveJournal::Record(uint8_t type, uint8_t statusBefore, uint8_t statusAfter, uint32_t* indices, size_t count) {
+
+	if (words.empty() || moves.empty()) {
+		return false;
+	}
+
+	// Sort the cells so consecutive indices form ranges, and count the ranges
+	std::sort(indices, indices + count);
+	uint32_t rangeCount = 0;
+	for (size_t i = 0; i < count; i++) {
+		if (i == 0 || indices[i] != indices[i - 1] + 1) {
+			rangeCount++;
+		}
+	}
+	size_t wordsNeeded = 2 * static_cast<size_t>(rangeCount);
+
+	// The moves that were undone are replaced by this move
+	if (appliedMoves < moveCount) {
+		nextWord = MoveAt(appliedMoves).firstWord;
+		moveCount = appliedMoves;
+	}
+
+	if (wordsNeeded > words.size()) {
+		Clear();
+		return false;
+	}
+
+	// Drop the oldest moves until this move fits
+	while (moveCount > 0 && (moveCount == moves.size() || nextWord + wordsNeeded - MoveAt(0).firstWord > words.size())) {
+		DropOldest();
+	}
+
+	// Write the ranges
+	Move move = { nextWord, rangeCount, type, statusBefore, statusAfter };
+	uint64_t position = nextWord;
+	for (size_t i = 0; i < count; i++) {
+		if (i == 0 || indices[i] != indices[i - 1] + 1) {
+			words[position & (words.size() - 1)] = indices[i];
+			words[(position + 1) & (words.size() - 1)] = 1;
+			position += 2;
+		}
+		else {
+			words[(position - 1) & (words.size() - 1)]++;
+		}
+	}
+
+	moves[(firstMove + moveCount) & (moves.size() - 1)] = move;
+	moveCount++;
+	appliedMoves = moveCount;
+	nextWord = position;
+	return true;
+}
+
+// Returns the last applied move, which is now undone
+const MoveJournal::Move* MoveJournal::StepBack() {
+	if (!CanUndo()) {
+		return nullptr;
+	}
+	appliedMoves--;
+	return &MoveAt(appliedMoves);
+}
+
+// Returns the first undone move, which is now applied again
+const MoveJournal::Move* MoveJournal::StepForward() {
+	if (!CanRedo()) {
+		return nullptr;
+	}
+	appliedMoves++;
+	return &MoveAt(appliedMoves - 1);
+}
+
+size_t MoveJournal::GetUsedWords() const {
+	return moveCount > 0 ? static_cast<size_t>(nextWord - MoveAt(0).firstWord) : 0;
+}
+
+void MoveJournal::DropOldest() {
+	firstMove = (firstMove + 1) & (moves.size() - 1);
+	moveCount--;
+	appliedMoves = std::min(appliedMoves, moveCount);
+}
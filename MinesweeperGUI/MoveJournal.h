@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Stores the cells changed by each move of a game, so the moves can be undone and redone.
+// Only the indices of the changed cells are kept (what happened to them is known from the type of move),
+// packed as ranges of consecutive indices since a big opening is mostly runs along the rows.
+// The ranges and moves are kept in ring buffers of fixed size, when they are full the oldest moves are dropped
+class MoveJournal
+{
+public:
+
+	// Describes one recorded move, its ranges are 2 words each (first index, # of cells)
+	struct Move {
+		uint64_t firstWord;
+		uint32_t rangeCount;
+		uint8_t type;
+		uint8_t statusBefore;
+		uint8_t statusAfter;
+	};
+
+	// Define methods used to set up the journal (the capacities are rounded up to powers of 2)
+	void Reset(size_t capacityWords, size_t capacityMoves);
+	void Clear();
+
+	// Records a move after the last applied move (moves that were undone can no longer be redone).
+	// Sorts the indices in place. Returns false if the move is too big to be stored, the history is then cleared
+	bool Record(uint8_t type, uint8_t statusBefore, uint8_t statusAfter, uint32_t* indices, size_t count);
+
+	// Define methods that move through the history (they return nullptr at either end)
+	bool CanUndo() const { return appliedMoves > 0; }
+	bool CanRedo() const { return appliedMoves < moveCount; }
+	const Move* StepBack();
+	const Move* StepForward();
+
+	// Returns the move StepForward would apply, without applying it (nullptr at the end)
+	const Move* PeekForward() const { return CanRedo() ? &MoveAt(appliedMoves) : nullptr; }
+
+	// Calls function(index) for every cell changed by a move
+	template <class Function>
+	void ForEachCell(const Move& move, Function function) const {
+		for (uint32_t i = 0; i < move.rangeCount; i++) {
+			uint32_t first = Word(move.firstWord + 2 * i);
+			uint32_t length = Word(move.firstWord + 2 * i + 1);
+			for (uint32_t index = first; index < first + length; index++) {
+				function(index);
+			}
+		}
+	}
+
+	// Define methods that report the memory used by the journal
+	size_t GetUsedWords() const;
+	size_t GetCapacityWords() const { return words.size(); }
+	size_t GetMoveCount() const { return moveCount; }
+
+private:
+
+	uint32_t Word(uint64_t position) const { return words[position & (words.size() - 1)]; }
+	const Move& MoveAt(size_t i) const { return moves[(firstMove + i) & (moves.size() - 1)]; }
+	void DropOldest();
+
+	// Define the ring buffers (words are addressed by their position since the journal was cleared)
+	std::vector<uint32_t> words;
+	std::vector<Move> moves;
+	uint64_t nextWord = 0;
+
+	// Define the recorded moves, oldest first, and how many of them are applied (the rest can be redone)
+	size_t firstMove = 0;
+	size_t moveCount = 0;
+	size_t appliedMoves = 0;
+};
@@ -0,0 +1,331 @@
+#pragma once
+#include "GameBoard.h"
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+
+// Game engine specialized at compile time for one of the preset grid sizes in OnStartClicked.
+// Follows exactly the same rules (and places the same bombs for a seed) as GameBoard,
+// but the dimensions and neighbor offsets are constants, and the grid has a one cell border
+// that is marked as cleared, so the flood fill and chording never need a bounds check.
+// Cell indices, visible values and changes are the same as GameBoard (xPos + yPos * nCols)
+template <int NCols, int NRows, int NumberOfBombs>
+class PresetBoard
+{
+public:
+
+	static constexpr int Cols = NCols;
+	static constexpr int Rows = NRows;
+	static constexpr int Bombs = NumberOfBombs;
+	static constexpr int CellCount = NCols * NRows;
+
+	static_assert(NCols >= 3 && NRows >= 3, "the grid must be at least 3x3");
+	static_assert(NumberOfBombs < CellCount - 9, "too many bombs for the grid");
+
+	PresetBoard() {
+		NewGame(0);
+	}
+
+	// Restart the game, bombs are placed using the seed when the first cell is revealed
+	void NewGame(uint64_t seed) {
+
+		this->seed = seed;
+		bombs.reset();
+		flagged.reset();
+		cleared = Tables().border;
+		visible.fill(GameBoard::Covered);
+		changeCount = 0;
+
+		status = GameBoard::Status::NotStarted;
+		numberFlagsPlaced = 0;
+		coveredSafeCells = CellCount - NumberOfBombs;
+		HasFlaggedBeforeFirstClick = false;
+	}
+
+	// Reveals a cell (same rules as GameBoard::Reveal)
+	bool Reveal(int xPos, int yPos) {
+
+		if (!IsInGridIndex(xPos, yPos) || status == GameBoard::Status::Won || status == GameBoard::Status::Lost) {
+			return false;
+		}
+
+		int cell = PaddedIndex(xPos, yPos);
+		if (cleared[cell]) {
+			return Chord(xPos, yPos);
+		}
+
+		changeCount = 0;
+		GameBoard::Status previousStatus = status;
+
+		if (status == GameBoard::Status::NotStarted) {
+			if (HasFlaggedBeforeFirstClick) {
+				ClearFlagsBeforeFirstClick();
+			}
+			PlaceBombs(xPos, yPos);
+			status = GameBoard::Status::Playing;
+			ClearEmpty(cell);
+		}
+		else if (bombs[cell] && !flagged[cell]) {
+			status = GameBoard::Status::Lost;
+		}
+		else if (!flagged[cell]) {
+			ClearEmpty(cell);
+		}
+
+		if (status == GameBoard::Status::Playing && coveredSafeCells == 0) {
+			status = GameBoard::Status::Won;
+		}
+
+		return changeCount != 0 || status != previousStatus;
+	}
+
+	// Sets or removes a flag (same rules as GameBoard::ToggleFlag)
+	bool ToggleFlag(int xPos, int yPos) {
+
+		if (!IsInGridIndex(xPos, yPos) || status == GameBoard::Status::Won || status == GameBoard::Status::Lost) {
+			return false;
+		}
+
+		int cell = PaddedIndex(xPos, yPos);
+		if (cleared[cell]) {
+			return false;
+		}
+
+		changeCount = 0;
+		flagged.flip(cell);
+		numberFlagsPlaced += flagged[cell] ? 1 : -1;
+		SetVisible(cell, flagged[cell] ? GameBoard::Flagged : GameBoard::Covered);
+
+		if (status == GameBoard::Status::NotStarted) {
+			HasFlaggedBeforeFirstClick = true;
+		}
+
+		return true;
+	}
+
+	// Clears the cells around a numbered cell (same rules as GameBoard::Chord)
+	bool Chord(int xPos, int yPos) {
+
+		if (!IsInGridIndex(xPos, yPos) || status != GameBoard::Status::Playing) {
+			return false;
+		}
+
+		int cell = PaddedIndex(xPos, yPos);
+		if (!cleared[cell]) {
+			return false;
+		}
+
+		changeCount = 0;
+		if (CountFlagsSurrounding(cell) != CountBombsSurrounding(cell)) {
+			return false;
+		}
+
+		// The border cells are never bombs or flagged, and are already cleared, so no bounds check is needed
+		for (int i = 0; i < 8; i++) {
+			int neighbor = cell + NeighborOffsets[i];
+
+			if (bombs[neighbor] && !flagged[neighbor]) {
+				status = GameBoard::Status::Lost;
+				return true;
+			}
+
+			if (!flagged[neighbor]) {
+				ClearEmpty(neighbor);
+				if (coveredSafeCells == 0) {
+					status = GameBoard::Status::Won;
+					return true;
+				}
+			}
+		}
+
+		return changeCount != 0;
+	}
+
+	// Define methods that give read access to the board
+	const uint8_t* GetVisibleState() const { return visible.data(); }
+	const GameBoard::CellChange* GetChanges() const { return changes.data(); }
+	int GetChangeCount() const { return changeCount; }
+	GameBoard::Status GetStatus() const { return status; }
+	int GetFlagsPlaced() const { return numberFlagsPlaced; }
+	bool IsBomb(int xPos, int yPos) const { return bombs[PaddedIndex(xPos, yPos)]; }
+
+	static constexpr bool IsInGridIndex(int xPos, int yPos) {
+		return static_cast<unsigned>(xPos) < static_cast<unsigned>(NCols) && static_cast<unsigned>(yPos) < static_cast<unsigned>(NRows);
+	}
+
+private:
+
+	// Define the size of the grid including its border
+	static constexpr int Stride = NCols + 2;
+	static constexpr int PaddedCellCount = Stride * (NRows + 2);
+
+	// Define all possible single movements from a cell, in the same order as GameBoard's dx / dy
+	static constexpr std::array<int, 8> NeighborOffsets = { {
+		-1, -Stride, 1, Stride, -1 - Stride, -1 + Stride, 1 - Stride, 1 + Stride
+	} };
+
+	static constexpr int PaddedIndex(int xPos, int yPos) {
+		return (xPos + 1) + (yPos + 1) * Stride;
+	}
+
+	static constexpr int CellIndex(int cell) {
+		return (cell % Stride - 1) + (cell / Stride - 1) * NCols;
+	}
+
+	// Define the tables that only depend on the grid size (built once per preset)
+	struct PresetTables {
+		std::bitset<PaddedCellCount> border;
+		std::array<uint16_t, CellCount> allCoordinates;
+	};
+
+	static const PresetTables& Tables() {
+		static const PresetTables tables = BuildTables();
+		return tables;
+	}
+
+	// Builds the mask of border cells (they are treated as already cleared), and the list of all
+	// cells in the same order GameBoard builds its possible coordinates (xPos outer, yPos inner)
+	static PresetTables BuildTables() {
+		PresetTables tables;
+		for (int cell = 0; cell < PaddedCellCount; cell++) {
+			int x = cell % Stride;
+			int y = cell / Stride;
+			if (x == 0 || y == 0 || x == Stride - 1 || y == NRows + 1) {
+				tables.border.set(cell);
+			}
+		}
+		for (int i = 0; i < NCols; i++) {
+			for (int j = 0; j < NRows; j++) {
+				tables.allCoordinates[i * NRows + j] = static_cast<uint16_t>(PaddedIndex(i, j));
+			}
+		}
+		return tables;
+	}
+
+	int CountBombsSurrounding(int cell) const {
+		int count = 0;
+		for (int offset : NeighborOffsets) {
+			count += bombs[cell + offset];
+		}
+		return count;
+	}
+
+	int CountFlagsSurrounding(int cell) const {
+		int count = 0;
+		for (int offset : NeighborOffsets) {
+			count += flagged[cell + offset];
+		}
+		return count;
+	}
+
+	// Places bombs exactly like GameBoard::PlaceBombs, so a seed gives the same board
+	void PlaceBombs(int xPos, int yPos) {
+
+		// Copy the precomputed list of cells, leaving out the 3x3 area around the first revealed cell
+		// (in each of the 3 columns the left out cells are one contiguous run)
+		const std::array<uint16_t, CellCount>& allCoordinates = Tables().allCoordinates;
+		std::array<uint16_t, CellCount> possibleCoordinates;
+		int possibleCount = 0;
+		int firstRow = std::max(yPos - 1, 0);
+		int lastRow = std::min(yPos + 1, NRows - 1);
+		for (int i = 0; i < NCols; i++) {
+			const uint16_t* column = &allCoordinates[i * NRows];
+			if (i < xPos - 1 || i > xPos + 1) {
+				std::copy(column, column + NRows, &possibleCoordinates[possibleCount]);
+				possibleCount += NRows;
+			}
+			else {
+				std::copy(column, column + firstRow, &possibleCoordinates[possibleCount]);
+				possibleCount += firstRow;
+				std::copy(column + lastRow + 1, column + NRows, &possibleCoordinates[possibleCount]);
+				possibleCount += NRows - lastRow - 1;
+			}
+		}
+
+		uint64_t state = seed;
+		for (int i = 0; i < NumberOfBombs; i++) {
+			int j = i + static_cast<int>(GameBoard::RandomBelow(state, possibleCount - i));
+			std::swap(possibleCoordinates[i], possibleCoordinates[j]);
+			bombs.set(possibleCoordinates[i]);
+		}
+	}
+
+	void ClearFlagsBeforeFirstClick() {
+		for (int cell = 0; cell < PaddedCellCount; cell++) {
+			if (flagged[cell]) {
+				SetVisible(cell, GameBoard::Covered);
+			}
+		}
+		flagged.reset();
+		numberFlagsPlaced = 0;
+		HasFlaggedBeforeFirstClick = false;
+	}
+
+	// Flood fill without bounds checks (the border stops it)
+	void ClearEmpty(int cell) {
+
+		if (bombs[cell] || cleared[cell]) {
+			return;
+		}
+
+		if (ClearCell(cell) != 0) {
+			return;
+		}
+
+		int stackSize = 0;
+		floodStack[stackSize++] = static_cast<uint16_t>(cell);
+		while (stackSize > 0) {
+			int current = floodStack[--stackSize];
+			for (int offset : NeighborOffsets) {
+				int neighbor = current + offset;
+				if (bombs[neighbor] || cleared[neighbor]) {
+					continue;
+				}
+				if (ClearCell(neighbor) == 0) {
+					floodStack[stackSize++] = static_cast<uint16_t>(neighbor);
+				}
+			}
+		}
+	}
+
+	// Marks a cell as cleared, shows its number and returns it
+	int ClearCell(int cell) {
+		cleared.set(cell);
+		coveredSafeCells--;
+		int surroundingBombs = CountBombsSurrounding(cell);
+		SetVisible(cell, static_cast<uint8_t>(surroundingBombs));
+		return surroundingBombs;
+	}
+
+	void SetVisible(int cell, uint8_t value) {
+		int index = CellIndex(cell);
+		if (visible[index] != value) {
+			visible[index] = value;
+			changes[changeCount++] = { static_cast<uint32_t>(index), value };
+		}
+	}
+
+	// Define the cell planes (padded) and the visible state (not padded, same as GameBoard)
+	std::bitset<PaddedCellCount> bombs;
+	std::bitset<PaddedCellCount> cleared;
+	std::bitset<PaddedCellCount> flagged;
+	std::array<uint8_t, CellCount> visible;
+
+	// Define the changes made by the last move, and the flood fill stack (no allocations)
+	std::array<GameBoard::CellChange, 2 * CellCount> changes; // the first reveal can remove flags, then reveal
+	int changeCount = 0;
+	std::array<uint16_t, CellCount> floodStack;
+
+	uint64_t seed = 0;
+	GameBoard::Status status = GameBoard::Status::NotStarted;
+	int numberFlagsPlaced = 0;
+	int coveredSafeCells = 0;
+	bool HasFlaggedBeforeFirstClick = false;
+};
+
+// Define the engines for the three preset grid sizes of the main menu
+// (the GUI calls the 30x16 preset nRows = 30, nCols = 16)
+typedef PresetBoard<9, 9, 15> PresetBoard9x9;
+typedef PresetBoard<16, 16, 50> PresetBoard16x16;
+typedef PresetBoard<16, 30, 100> PresetBoard30x16;
@@ -0,0 +1,403 @@
+#include "RegionIndex.h"
+#include "VisibleCell.h"
+#include <algorithm>
+#include <bitset>
+
+static int PopCount(uint64_t word) {
+#if defined(__GNUC__)
+	return __builtin_popcountll(word);
+#else
+	return static_cast<int>(std::bitset<64>(word).count());
+#endif
+}
+
+// Spreads the 8 bits of a byte to the lowest bit of each byte of a word (bit i to byte i)
+static uint64_t SpreadBits(uint64_t byte) {
+	uint64_t lanes = (byte * 0x0101010101010101ull) & 0x8040201008040201ull;
+	return ((lanes + 0x7F7F7F7F7F7F7F7Full) >> 7) & 0x0101010101010101ull;
+}
+
+// Turns each row of a grid of counts (width x height, row by row) into a 1D Fenwick tree in place
+static void MakeRowTrees(uint32_t* tree, int width, int height) {
+	for (int y = 0; y < height; y++) {
+		uint32_t* row = &tree[y * static_cast<size_t>(width)];
+		for (int i = 1; i <= width; i++) {
+			int parent = i + (i & -i);
+			if (parent <= width) {
+				row[parent - 1] += row[i - 1];
+			}
+		}
+	}
+}
+
+// Turns each column of a grid of counts into a 1D Fenwick tree in place (the columns are added a whole row at a time)
+static void MakeColumnTrees(uint32_t* tree, int width, int height) {
+	for (int j = 1; j <= height; j++) {
+		int parent = j + (j & -j);
+		if (parent <= height) {
+			uint32_t* parentRow = &tree[(parent - 1) * static_cast<size_t>(width)];
+			const uint32_t* row = &tree[(j - 1) * static_cast<size_t>(width)];
+			for (int x = 0; x < width; x++) {
+				parentRow[x] += row[x];
+			}
+		}
+	}
+}
+
+// Allocates the bits and trees for the grid size
+void RegionIndex::Reset(int nCols, int nRows) {
+
+	this->nCols = nCols;
+	this->nRows = nRows;
+	wordsPerRow = (nCols + 63) / 64;
+	blockCols = (nCols + BlockSide - 1) / BlockSide;
+	blockRows = (nRows + BlockSide - 1) / BlockSide;
+
+	for (int layer = 0; layer < LayerCount; layer++) {
+		bits[layer].assign(static_cast<size_t>(wordsPerRow) * nRows, 0);
+		trees[layer].assign(static_cast<size_t>(blockCols) * blockRows, 0);
+		columnTrees[layer].assign(static_cast<size_t>(nCols) * blockRows, 0);
+		rowTrees[layer].assign(static_cast<size_t>(blockCols) * nRows, 0);
+	}
+	Clear();
+}
+
+// Covers every cell again (a new game on the same grid, the bombs are not placed yet)
+void RegionIndex::Clear() {
+
+	ClearBits();
+	uint64_t lastWordMask = ~0ull >> ((64 - nCols % 64) % 64);
+	for (int y = 0; y < nRows; y++) {
+		uint64_t* row = &bits[CoveredCells][y * static_cast<size_t>(wordsPerRow)];
+		std::fill(row, row + wordsPerRow, ~0ull);
+		row[wordsPerRow - 1] = lastWordMask;
+	}
+	BuildTrees();
+}
+
+// Frees the bits and trees (the index is no longer kept up to date)
+void RegionIndex::Free() {
+
+	*this = RegionIndex();
+}
+
+void RegionIndex::ClearBits() {
+	for (int layer = 0; layer < LayerCount; layer++) {
+		std::fill(bits[layer].begin(), bits[layer].end(), 0);
+	}
+}
+
+// Sets the bits of a cell whose bits are all clear
+void RegionIndex::SetBits(int xPos, int yPos, uint8_t visible, bool IsBomb) {
+
+	size_t word = yPos * static_cast<size_t>(wordsPerRow) + (xPos >> 6);
+	uint64_t bit = 1ull << (xPos & 63);
+	if (visible == VisibleCellValues::Flagged) {
+		bits[Flags][word] |= bit;
+	}
+	else {
+		if (IsBomb) {
+			bits[UnflaggedMines][word] |= bit;
+		}
+		if (visible == VisibleCellValues::Covered) {
+			bits[CoveredCells][word] |= bit;
+		}
+	}
+}
+
+// Builds the trees from the bits: the count of each block of each row (added up into the count of the block) and of
+// each column of each row of blocks, then each is turned into a Fenwick tree in place (the block tree is a tree of
+// rows and of columns, the two directions are independent)
+void RegionIndex::BuildTrees() {
+
+	for (int layer = 0; layer < LayerCount; layer++) {
+		std::vector<uint32_t>& tree = trees[layer];
+		std::vector<uint32_t>& columnTree = columnTrees[layer];
+		std::vector<uint32_t>& rowTree = rowTrees[layer];
+		std::fill(tree.begin(), tree.end(), 0);
+
+		// A block of a row is a byte of the row (a word holds 8 blocks of a row)
+		for (int y = 0; y < nRows; y++) {
+			const uint64_t* row = &bits[layer][y * static_cast<size_t>(wordsPerRow)];
+			uint32_t* rowBlocks = &rowTree[y * static_cast<size_t>(blockCols)];
+			uint32_t* blocks = &tree[(y / BlockSide) * static_cast<size_t>(blockCols)];
+			for (int blockX = 0; blockX < blockCols; blockX++) {
+				rowBlocks[blockX] = PopCount((row[blockX >> 3] >> ((blockX & 7) * BlockSide)) & 0xFF);
+				blocks[blockX] += rowBlocks[blockX];
+			}
+		}
+
+		// The rows of a row of blocks are added a word at a time into 4 bit planes (a count of 0 - 8 for each column
+		// of the word), then the counts of 8 columns at a time are read from the planes (a byte per column)
+		for (int blockY = 0; blockY < blockRows; blockY++) {
+			uint32_t* columns = &columnTree[blockY * static_cast<size_t>(nCols)];
+			int endY = std::min(nRows, (blockY + 1) * BlockSide);
+			for (int word = 0; word < wordsPerRow; word++) {
+				uint64_t planes[4] = {};
+				for (int y = blockY * BlockSide; y < endY; y++) {
+					uint64_t carry = bits[layer][y * static_cast<size_t>(wordsPerRow) + word];
+					for (uint64_t& plane : planes) {
+						uint64_t nextCarry = plane & carry;
+						plane ^= carry;
+						carry = nextCarry;
+					}
+				}
+				int wordCols = std::min(64, nCols - word * 64);
+				for (int first = 0; first < wordCols; first += 8) {
+					uint64_t counts = SpreadBits((planes[0] >> first) & 0xFF) | SpreadBits((planes[1] >> first) & 0xFF) << 1 |
+						SpreadBits((planes[2] >> first) & 0xFF) << 2 | SpreadBits((planes[3] >> first) & 0xFF) << 3;
+					for (int bit = 0; bit < std::min(8, wordCols - first); bit++) {
+						columns[word * 64 + first + bit] = static_cast<uint32_t>((counts >> (bit * 8)) & 0xFF);
+					}
+				}
+			}
+		}
+
+		MakeRowTrees(tree.data(), blockCols, blockRows);
+		MakeColumnTrees(tree.data(), blockCols, blockRows);
+		MakeColumnTrees(columnTree.data(), nCols, blockRows);
+		MakeRowTrees(rowTree.data(), blockCols, nRows);
+	}
+}
+
+void RegionIndex::Update(int index, uint8_t visible, bool IsBomb) {
+
+	int xPos = index % nCols;
+	int yPos = index / nCols;
+	bool IsFlag = visible == VisibleCellValues::Flagged;
+	bool layerValues[LayerCount] = { IsBomb && !IsFlag, IsFlag, visible == VisibleCellValues::Covered };
+
+	for (int layer = 0; layer < LayerCount; layer++) {
+		if (IsSet(static_cast<Layer>(layer), xPos, yPos) != layerValues[layer]) {
+			bits[layer][yPos * static_cast<size_t>(wordsPerRow) + (xPos >> 6)] ^= 1ull << (xPos & 63);
+			Add(static_cast<Layer>(layer), xPos, yPos, layerValues[layer] ? 1 : -1);
+		}
+	}
+}
+
+void RegionIndex::Add(Layer layer, int xPos, int yPos, int delta) {
+
+	std::vector<uint32_t>& tree = trees[layer];
+	for (int i = xPos / BlockSide + 1; i <= blockCols; i += i & -i) {
+		for (int j = yPos / BlockSide + 1; j <= blockRows; j += j & -j) {
+			tree[(j - 1) * static_cast<size_t>(blockCols) + (i - 1)] += delta;
+		}
+	}
+	for (int j = yPos / BlockSide + 1; j <= blockRows; j += j & -j) {
+		columnTrees[layer][(j - 1) * static_cast<size_t>(nCols) + xPos] += delta;
+	}
+	uint32_t* rowTree = &rowTrees[layer][yPos * static_cast<size_t>(blockCols)];
+	for (int i = xPos / BlockSide + 1; i <= blockCols; i += i & -i) {
+		rowTree[i - 1] += delta;
+	}
+}
+
+// Returns the # of cells of a layer in the blocks before endBlockX and endBlockY
+int RegionIndex::CountBlocks(Layer layer, int endBlockX, int endBlockY) const {
+
+	const std::vector<uint32_t>& tree = trees[layer];
+	uint32_t count = 0;
+	for (int i = endBlockX; i > 0; i -= i & -i) {
+		for (int j = endBlockY; j > 0; j -= j & -j) {
+			count += tree[(j - 1) * static_cast<size_t>(blockCols) + (i - 1)];
+		}
+	}
+	return static_cast<int>(count);
+}
+
+// Returns the # of cells of a layer in a column, in the blocks from firstBlockY to before endBlockY
+int RegionIndex::CountColumn(Layer layer, int xPos, int firstBlockY, int endBlockY) const {
+
+	const std::vector<uint32_t>& columnTree = columnTrees[layer];
+	uint32_t count = 0;
+	for (int j = endBlockY; j > 0; j -= j & -j) {
+		count += columnTree[(j - 1) * static_cast<size_t>(nCols) + xPos];
+	}
+	for (int j = firstBlockY; j > 0; j -= j & -j) {
+		count -= columnTree[(j - 1) * static_cast<size_t>(nCols) + xPos];
+	}
+	return static_cast<int>(count);
+}
+
+// Returns the # of cells of a layer in a row, in the blocks from firstBlockX to before endBlockX
+int RegionIndex::CountRow(Layer layer, int yPos, int firstBlockX, int endBlockX) const {
+
+	const uint32_t* rowTree = &rowTrees[layer][yPos * static_cast<size_t>(blockCols)];
+	uint32_t count = 0;
+	for (int i = endBlockX; i > 0; i -= i & -i) {
+		count += rowTree[i - 1];
+	}
+	for (int i = firstBlockX; i > 0; i -= i & -i) {
+		count -= rowTree[i - 1];
+	}
+	return static_cast<int>(count);
+}
+
+// Returns the # of cells of a layer in a rectangle from the bits, row by row (right and bottom are excluded)
+int RegionIndex::CountCells(Layer layer, int left, int top, int right, int bottom) const {
+
+	if (left >= right || top >= bottom) {
+		return 0;
+	}
+	int firstWord = left >> 6;
+	int lastWord = (right - 1) >> 6;
+	uint64_t firstMask = ~0ull << (left & 63);
+	uint64_t lastMask = ~0ull >> (63 - ((right - 1) & 63));
+
+	int count = 0;
+	for (int y = top; y < bottom; y++) {
+		const uint64_t* row = &bits[layer][y * static_cast<size_t>(wordsPerRow)];
+		for (int word = firstWord; word <= lastWord; word++) {
+			uint64_t value = row[word];
+			if (word == firstWord) {
+				value &= firstMask;
+			}
+			if (word == lastWord) {
+				value &= lastMask;
+			}
+			count += PopCount(value);
+		}
+	}
+	return count;
+}
+
+int RegionIndex::Count(Layer layer, int xPos, int yPos, int width, int height) const {
+
+	int left = std::max(xPos, 0);
+	int top = std::max(yPos, 0);
+	int right = std::min(xPos + width, nCols);
+	int bottom = std::min(yPos + height, nRows);
+	if (left >= right || top >= bottom) {
+		return 0;
+	}
+
+	// The whole blocks inside the rectangle (the blocks on the right and bottom edges of the board are whole as far
+	// as the board goes), the columns and rows of its edges beside them, and the cells of its corners. Without a whole
+	// block across, every column is an edge (and every row without one down)
+	int firstBlockX = (left + BlockSide - 1) / BlockSide;
+	int firstBlockY = (top + BlockSide - 1) / BlockSide;
+	int endBlockX = right == nCols ? blockCols : right / BlockSide;
+	int endBlockY = bottom == nRows ? blockRows : bottom / BlockSide;
+	bool HasBlockCols = firstBlockX < endBlockX;
+	bool HasBlockRows = firstBlockY < endBlockY;
+	int innerLeft = HasBlockCols ? firstBlockX * BlockSide : right;
+	int innerTop = HasBlockRows ? firstBlockY * BlockSide : bottom;
+	int innerRight = HasBlockCols ? std::min(endBlockX * BlockSide, right) : right;
+	int innerBottom = HasBlockRows ? std::min(endBlockY * BlockSide, bottom) : bottom;
+
+	int count = 0;
+	if (HasBlockCols && HasBlockRows) {
+		count += CountBlocks(layer, endBlockX, endBlockY) - CountBlocks(layer, firstBlockX, endBlockY)
+			- CountBlocks(layer, endBlockX, firstBlockY) + CountBlocks(layer, firstBlockX, firstBlockY);
+	}
+	if (HasBlockRows) {
+		for (int x = left; x < innerLeft; x++) {
+			count += CountColumn(layer, x, firstBlockY, endBlockY);
+		}
+		for (int x = innerRight; x < right; x++) {
+			count += CountColumn(layer, x, firstBlockY, endBlockY);
+		}
+	}
+	if (HasBlockCols) {
+		for (int y = top; y < innerTop; y++) {
+			count += CountRow(layer, y, firstBlockX, endBlockX);
+		}
+		for (int y = innerBottom; y < bottom; y++) {
+			count += CountRow(layer, y, firstBlockX, endBlockX);
+		}
+	}
+	count += CountCells(layer, left, top, innerLeft, innerTop);
+	count += CountCells(layer, innerRight, top, right, innerTop);
+	count += CountCells(layer, left, innerBottom, innerLeft, bottom);
+	count += CountCells(layer, innerRight, innerBottom, right, bottom);
+	return count;
+}
+
+// Finds a cell of a layer in a rectangle that has one, by halving the rectangle (on block edges while it is big,
+// so the counts come from the trees)
+int RegionIndex::Locate(Layer layer, int left, int top, int right, int bottom) const {
+
+	while (right - left > 1 || bottom - top > 1) {
+		if (right - left >= bottom - top) {
+			int middle = (left + right) / 2;
+			if (right - left > 2 * BlockSide) {
+				middle &= ~(BlockSide - 1);
+			}
+			if (Count(layer, left, top, middle - left, bottom - top) > 0) {
+				right = middle;
+			}
+			else {
+				left = middle;
+			}
+		}
+		else {
+			int middle = (top + bottom) / 2;
+			if (bottom - top > 2 * BlockSide) {
+				middle &= ~(BlockSide - 1);
+			}
+			if (Count(layer, left, top, right - left, middle - top) > 0) {
+				bottom = middle;
+			}
+			else {
+				top = middle;
+			}
+		}
+	}
+	return left + top * nCols;
+}
+
+int RegionIndex::FindNearest(Layer layer, int xPos, int yPos, int width, int height) const {
+
+	if (nCols == 0 || CountBlocks(layer, blockCols, blockRows) == 0) {
+		return -1;
+	}
+
+	// Keep at least one cell of the rectangle on the board
+	int left = std::min(std::max(xPos, 0), nCols - 1);
+	int top = std::min(std::max(yPos, 0), nRows - 1);
+	int right = std::max(left + 1, std::min(xPos + width, nCols));
+	int bottom = std::max(top + 1, std::min(yPos + height, nRows));
+	auto CountAround = [&](int distance) {
+		int aroundLeft = std::max(left - distance, 0);
+		int aroundTop = std::max(top - distance, 0);
+		return Count(layer, aroundLeft, aroundTop, std::min(right + distance, nCols) - aroundLeft, std::min(bottom + distance, nRows) - aroundTop);
+	};
+	if (CountAround(0) > 0) {
+		return Locate(layer, left, top, right, bottom);
+	}
+
+	// Find the smallest distance around the rectangle that has a cell (the counts only grow with the distance)
+	int lowDistance = 0;
+	int highDistance = std::max(nCols, nRows);
+	while (highDistance - lowDistance > 1) {
+		int distance = (lowDistance + highDistance) / 2;
+		if (CountAround(distance) > 0) {
+			highDistance = distance;
+		}
+		else {
+			lowDistance = distance;
+		}
+	}
+
+	// The cell is in the ring between the two distances: above, below, left or right of the inner rectangle
+	int outerLeft = std::max(left - highDistance, 0);
+	int outerTop = std::max(top - highDistance, 0);
+	int outerRight = std::min(right + highDistance, nCols);
+	int outerBottom = std::min(bottom + highDistance, nRows);
+	int innerLeft = std::max(left - lowDistance, 0);
+	int innerTop = std::max(top - lowDistance, 0);
+	int innerRight = std::min(right + lowDistance, nCols);
+	int innerBottom = std::min(bottom + lowDistance, nRows);
+	const int pieces[4][4] = {
+		{ outerLeft, outerTop, outerRight, innerTop },
+		{ outerLeft, innerBottom, outerRight, outerBottom },
+		{ outerLeft, innerTop, innerLeft, innerBottom },
+		{ innerRight, innerTop, outerRight, innerBottom }
+	};
+	for (const int* piece : pieces) {
+		if (Count(layer, piece[0], piece[1], piece[2] - piece[0], piece[3] - piece[1]) > 0) {
+			return Locate(layer, piece[0], piece[1], piece[2], piece[3]);
+		}
+	}
+	return -1;
+}
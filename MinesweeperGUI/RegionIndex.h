@@ -0,0 +1,88 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Counts the unflagged mines, the flags and the covered unflagged cells of any rectangle of the board, and finds the
+// one closest to a rectangle, without scanning the board (so hints and the counts of the cells in view stay instant
+// on the largest boards). Each layer keeps a bit per cell, a 2D Fenwick tree over blocks of 8 x 8 cells, and a 1D
+// Fenwick tree over the blocks of each column and of each row. A rectangle is counted from the 2D tree for its whole
+// blocks, from the column and row trees for the columns and rows of its edges (fewer than 8 on each side), and from
+// the bits for its corners (fewer than 8 x 8 cells each), so a count takes O(log^2 blocks) whatever the size of the
+// rectangle and FindNearest makes O(log(cols + rows)) counts. A move updates the trees of each changed cell in
+// O(log^2 blocks). The column and row trees take a byte per cell for each layer
+class RegionIndex
+{
+public:
+
+	// Define the layers that can be counted
+	enum Layer : uint8_t {
+		UnflaggedMines,
+		Flags,
+		CoveredCells,   // covered and not flagged
+		LayerCount
+	};
+
+	// Define methods used to set up the index (every cell starts covered, with no mines)
+	void Reset(int nCols, int nRows);
+	void Clear();
+	void Free();
+
+	// Sets every cell from the visible state (GameBoard visible values) and IsBomb(index), once the bombs are placed
+	template <class Function>
+	void Build(const uint8_t* visible, Function IsBomb) {
+		ClearBits();
+		for (int y = 0; y < nRows; y++) {
+			for (int x = 0; x < nCols; x++) {
+				int index = x + y * nCols;
+				SetBits(x, y, visible[index], IsBomb(index));
+			}
+		}
+		BuildTrees();
+	}
+
+	// Updates the index for a cell whose visible value changed (a GameBoard visible value)
+	void Update(int index, uint8_t visible, bool IsBomb);
+
+	// Returns the # of cells of a layer in a rectangle (clipped to the board)
+	int Count(Layer layer, int xPos, int yPos, int width, int height) const;
+
+	// Returns the index of a cell of a layer at the smallest distance (in rows or columns) from a rectangle,
+	// one inside the rectangle if there is one, or -1 if the layer is empty
+	int FindNearest(Layer layer, int xPos, int yPos, int width, int height) const;
+
+	bool IsAllocated() const { return !bits[0].empty(); }
+
+private:
+
+	// Define the side of the blocks counted by the Fenwick trees (a power of 2)
+	static const int BlockSide = 8;
+
+	void ClearBits();
+	void SetBits(int xPos, int yPos, uint8_t visible, bool IsBomb);
+	void BuildTrees();
+	void Add(Layer layer, int xPos, int yPos, int delta);
+	int CountBlocks(Layer layer, int endBlockX, int endBlockY) const;
+	int CountColumn(Layer layer, int xPos, int firstBlockY, int endBlockY) const;
+	int CountRow(Layer layer, int yPos, int firstBlockX, int endBlockX) const;
+	int CountCells(Layer layer, int left, int top, int right, int bottom) const;
+	int Locate(Layer layer, int left, int top, int right, int bottom) const;
+	bool IsSet(Layer layer, int xPos, int yPos) const {
+		return (bits[layer][yPos * static_cast<size_t>(wordsPerRow) + (xPos >> 6)] >> (xPos & 63)) & 1;
+	}
+
+	int nCols = 0;
+	int nRows = 0;
+	int wordsPerRow = 0;
+	int blockCols = 0;
+	int blockRows = 0;
+
+	// Define the bits of each layer (row by row, wordsPerRow words per row), the Fenwick tree of the # of cells of
+	// each layer in each block (indexed by blockX + blockY * blockCols), and the trees of the # of cells of each column
+	// in each row of blocks (indexed by xPos + blockY * nCols) and of each row in each column of blocks (indexed by
+	// blockX + yPos * blockCols)
+	std::vector<uint64_t> bits[LayerCount];
+	std::vector<uint32_t> trees[LayerCount];
+	std::vector<uint32_t> columnTrees[LayerCount];
+	std::vector<uint32_t> rowTrees[LayerCount];
+};
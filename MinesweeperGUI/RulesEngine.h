@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include "GameBoard.h"
+#include "PresetBoard.h"
+
+// Plays games of one size with the moves of the rules only (no undo, topologies, assists or indices), for the callers
+// that play many games without a window: the C library and the game server. Games of the preset sizes of the main
+// menu are played on the compile-time specialized PresetBoard (the same bombs for a seed and the same changes as
+// GameBoard, in less time), the others on a GameBoard. The window keeps its GameBoard for every size, it needs what
+// PresetBoard doesn't have (undo in training mode, the board shapes, the assists, and the indices behind hints,
+// the counts in view and the difficulty profile)
+class RulesEngine
+{
+public:
+
+	virtual ~RulesEngine() {}
+
+	// Creates the engine for a grid size (a GameBoard that places its bombs on up to generationThreads threads, 0 for
+	// every core, if it isn't a preset). Throws std::bad_alloc if the board can't be allocated
+	static std::unique_ptr<RulesEngine> Create(int nCols, int nRows, int numberOfBombs, int generationThreads = 0);
+
+	// Define the moves of a game (the same as GameBoard's)
+	virtual void NewGame(uint64_t seed) = 0;
+	virtual bool Reveal(int xPos, int yPos) = 0;
+	virtual bool ToggleFlag(int xPos, int yPos) = 0;
+	virtual bool Chord(int xPos, int yPos) = 0;
+
+	// Define methods that give the state of the game, the visible state stays at the same address for the engine's
+	// life, the changes are the ones of the last move
+	virtual const uint8_t* GetVisibleState() const = 0;
+	virtual const GameBoard::CellChange* GetChanges() const = 0;
+	virtual int GetChangeCount() const = 0;
+	virtual GameBoard::Status GetStatus() const = 0;
+	virtual int GetFlagsPlaced() const = 0;
+
+	int GetCols() const { return nCols; }
+	int GetRows() const { return nRows; }
+	int GetNumberOfBombs() const { return numberOfBombs; }
+	int GetCellCount() const { return nCols * nRows; }
+
+protected:
+
+	RulesEngine(int nCols, int nRows, int numberOfBombs) : nCols(nCols), nRows(nRows), numberOfBombs(numberOfBombs) {}
+
+private:
+
+	// Returns true if a grid size is the one of a preset engine
+	template <class Preset>
+	static bool IsPresetSize(int nCols, int nRows, int numberOfBombs) {
+		return nCols == Preset::Cols && nRows == Preset::Rows && numberOfBombs == Preset::Bombs;
+	}
+
+	int nCols;
+	int nRows;
+	int numberOfBombs;
+};
+
+// Plays the games of any size on a GameBoard
+class GameBoardRules : public RulesEngine
+{
+public:
+
+	GameBoardRules(int nCols, int nRows, int numberOfBombs, int generationThreads) : RulesEngine(nCols, nRows, numberOfBombs) {
+		board.SetGenerationThreads(generationThreads);
+		board.Resize(nCols, nRows, numberOfBombs);
+	}
+
+	void NewGame(uint64_t seed) override { board.NewGame(seed); }
+	bool Reveal(int xPos, int yPos) override { return board.Reveal(xPos, yPos); }
+	bool ToggleFlag(int xPos, int yPos) override { return board.ToggleFlag(xPos, yPos); }
+	bool Chord(int xPos, int yPos) override { return board.Chord(xPos, yPos); }
+	const uint8_t* GetVisibleState() const override { return board.GetVisibleState(); }
+	const GameBoard::CellChange* GetChanges() const override { return board.GetChanges().data(); }
+	int GetChangeCount() const override { return static_cast<int>(board.GetChanges().size()); }
+	GameBoard::Status GetStatus() const override { return board.GetStatus(); }
+	int GetFlagsPlaced() const override { return board.GetFlagsPlaced(); }
+
+private:
+
+	GameBoard board;
+};
+
+// Plays the games of a preset size on its PresetBoard
+template <class Preset>
+class PresetRules : public RulesEngine
+{
+public:
+
+	PresetRules() : RulesEngine(Preset::Cols, Preset::Rows, Preset::Bombs) {}
+
+	void NewGame(uint64_t seed) override { board.NewGame(seed); }
+	bool Reveal(int xPos, int yPos) override { return board.Reveal(xPos, yPos); }
+	bool ToggleFlag(int xPos, int yPos) override { return board.ToggleFlag(xPos, yPos); }
+	bool Chord(int xPos, int yPos) override { return board.Chord(xPos, yPos); }
+	const uint8_t* GetVisibleState() const override { return board.GetVisibleState(); }
+	const GameBoard::CellChange* GetChanges() const override { return board.GetChanges(); }
+	int GetChangeCount() const override { return board.GetChangeCount(); }
+	GameBoard::Status GetStatus() const override { return board.GetStatus(); }
+	int GetFlagsPlaced() const override { return board.GetFlagsPlaced(); }
+
+private:
+
+	Preset board;
+};
+
+inline std::unique_ptr<RulesEngine> RulesEngine::Create(int nCols, int nRows, int numberOfBombs, int generationThreads) {
+
+	if (IsPresetSize<PresetBoard9x9>(nCols, nRows, numberOfBombs)) {
+		return std::unique_ptr<RulesEngine>(new PresetRules<PresetBoard9x9>());
+	}
+	if (IsPresetSize<PresetBoard16x16>(nCols, nRows, numberOfBombs)) {
+		return std::unique_ptr<RulesEngine>(new PresetRules<PresetBoard16x16>());
+	}
+	if (IsPresetSize<PresetBoard30x16>(nCols, nRows, numberOfBombs)) {
+		return std::unique_ptr<RulesEngine>(new PresetRules<PresetBoard30x16>());
+	}
+	return std::unique_ptr<RulesEngine>(new GameBoardRules(nCols, nRows, numberOfBombs, generationThreads));
+}
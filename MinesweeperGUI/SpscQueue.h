@@ -0,0 +1,103 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Queue of a fixed capacity (a power of 2) between one thread that pushes and one thread that pops, without locks.
+// The head and tail positions only grow: each is written by one thread and read by the other (release / acquire),
+// and each thread keeps its own copy of the other's position so it only reads the shared one when the queue looks
+// full or empty. The positions are padded apart so the two threads don't write to the same cache line
+template <class T>
+class SpscQueue
+{
+public:
+
+	explicit SpscQueue(size_t capacity) : slots(capacity), mask(capacity - 1) {
+	}
+
+	// Moves an item into the queue, returns false (leaving the item as it was) if the queue is full.
+	// Only called by the pushing thread
+	bool TryPush(T& item) {
+		size_t tail = tailPosition.load(std::memory_order_relaxed);
+		if (tail - knownHead == slots.size()) {
+			knownHead = headPosition.load(std::memory_order_acquire);
+			if (tail - knownHead == slots.size()) {
+				return false;
+			}
+		}
+		slots[tail & mask] = std::move(item);
+		tailPosition.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Moves the oldest item out of the queue, returns false if the queue is empty. Only called by the popping thread
+	bool TryPop(T& item) {
+		size_t head = headPosition.load(std::memory_order_relaxed);
+		if (head == knownTail) {
+			knownTail = tailPosition.load(std::memory_order_acquire);
+			if (head == knownTail) {
+				return false;
+			}
+		}
+		item = std::move(slots[head & mask]);
+		headPosition.store(head + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Gives the slot the next item is written to, in place: it still holds the item that was there before, so the
+	// item's buffers reuse its memory. Returns nullptr if the queue is full, Push adds the item once it is written.
+	// Only called by the pushing thread
+	T* GetPushSlot() {
+		size_t tail = tailPosition.load(std::memory_order_relaxed);
+		if (tail - knownHead == slots.size()) {
+			knownHead = headPosition.load(std::memory_order_acquire);
+			if (tail - knownHead == slots.size()) {
+				return nullptr;
+			}
+		}
+		return &slots[tail & mask];
+	}
+
+	void Push() {
+		tailPosition.store(tailPosition.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Gives the oldest item in place, nullptr if the queue is empty. Pop hands its slot back to the pushing thread.
+	// Only called by the popping thread
+	T* GetFront() {
+		size_t head = headPosition.load(std::memory_order_relaxed);
+		if (head == knownTail) {
+			knownTail = tailPosition.load(std::memory_order_acquire);
+			if (head == knownTail) {
+				return nullptr;
+			}
+		}
+		return &slots[head & mask];
+	}
+
+	void Pop() {
+		headPosition.store(headPosition.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	// Determines if the queue is empty (only exact on the popping thread, another thread may push at any time)
+	bool IsEmpty() const {
+		return headPosition.load(std::memory_order_relaxed) == tailPosition.load(std::memory_order_acquire);
+	}
+
+	size_t GetCapacity() const { return slots.size(); }
+
+private:
+
+	std::vector<T> slots;
+	size_t mask;
+
+	// Define the popping thread's position and its copy of the tail, then the pushing thread's
+	char padding0[64];
+	std::atomic<size_t> headPosition{ 0 };
+	size_t knownTail = 0;
+	char padding1[64];
+	std::atomic<size_t> tailPosition{ 0 };
+	size_t knownHead = 0;
+	char padding2[64];
+};
@@ -0,0 +1,293 @@
+#include "StatsStore.h"
+#include <cmath>
+#include <cstring>
+
+// Define how much each bucket of a sketch grows over the one before it
+static const double bucketGrowth = 1.04;
+
+// Define the most boards a summary file is read with (more is a broken file)
+static const uint32_t maxSummaryBoards = 1 << 20;
+
+void QuantileSketch::Add(uint32_t milliseconds) {
+	buckets[GetBucket(milliseconds)]++;
+	count++;
+}
+
+void QuantileSketch::Merge(const QuantileSketch& other) {
+	for (int bucket = 0; bucket < BucketCount; bucket++) {
+		buckets[bucket] += other.buckets[bucket];
+	}
+	count += other.count;
+}
+
+// Finds the bucket of the time of that rank (the times are ranked from 1, the rank is rounded up)
+double QuantileSketch::GetQuantile(double quantile) const {
+
+	if (count == 0) {
+		return 0;
+	}
+	uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * count));
+	rank = std::min(std::max<uint64_t>(rank, 1), count);
+	uint64_t timesBelow = 0;
+	for (int bucket = 0; bucket < BucketCount; bucket++) {
+		timesBelow += buckets[bucket];
+		if (timesBelow >= rank) {
+			return GetBucketValue(bucket);
+		}
+	}
+	return GetBucketValue(BucketCount - 1);
+}
+
+// Bucket 0 holds the times of 0 and 1 ms
+int QuantileSketch::GetBucket(uint32_t milliseconds) {
+
+	if (milliseconds <= 1) {
+		return 0;
+	}
+	int bucket = static_cast<int>(std::ceil(std::log(static_cast<double>(milliseconds)) / std::log(bucketGrowth)));
+	return std::min(bucket, BucketCount - 1);
+}
+
+// Returns the time halfway (relative to its size) between the ends of a bucket, the farthest from both ends
+double QuantileSketch::GetBucketValue(int bucket) {
+	return bucket == 0 ? 1 : std::pow(bucketGrowth, bucket) * 2 / (1 + bucketGrowth);
+}
+
+// Adds a game to the statistics of its board (a board played for the first time is added at the end)
+void StatsSummary::Add(const GameRecord& record) {
+
+	recordCount++;
+	if (record.options & (TrainingModeGame | LayoutGame | AssistedGame)) {
+		return;
+	}
+
+	auto stats = std::find_if(boards.begin(), boards.end(), [&](const BoardStats& board) { return board.IsSameBoard(record); });
+	if (stats == boards.end()) {
+		BoardStats board = {};
+		board.nCols = record.nCols;
+		board.nRows = record.nRows;
+		board.numberOfBombs = record.numberOfBombs;
+		board.topology = record.topology;
+		boards.push_back(board);
+		stats = boards.end() - 1;
+	}
+
+	stats->games++;
+	if (!record.IsWon) {
+		stats->currentStreak = 0;
+		return;
+	}
+	stats->wins++;
+	stats->currentStreak++;
+	stats->bestStreak = std::max(stats->bestStreak, stats->currentStreak);
+	stats->bestMilliseconds = stats->wins == 1 ? record.milliseconds : std::min(stats->bestMilliseconds, record.milliseconds);
+	stats->winMilliseconds += record.milliseconds;
+	stats->winBbbv += record.bbbv;
+	stats->winTimes.Add(record.milliseconds);
+}
+
+void StatsSummary::Clear() {
+	boards.clear();
+	recordCount = 0;
+}
+
+// The total has no board, its streaks are the longest of the boards
+BoardStats StatsSummary::GetTotal() const {
+
+	BoardStats total = {};
+	for (const BoardStats& board : boards) {
+		if (board.wins > 0) {
+			total.bestMilliseconds = total.wins == 0 ? board.bestMilliseconds : std::min(total.bestMilliseconds, board.bestMilliseconds);
+		}
+		total.games += board.games;
+		total.wins += board.wins;
+		total.currentStreak = std::max(total.currentStreak, board.currentStreak);
+		total.bestStreak = std::max(total.bestStreak, board.bestStreak);
+		total.winMilliseconds += board.winMilliseconds;
+		total.winBbbv += board.winBbbv;
+		total.winTimes.Merge(board.winTimes);
+	}
+	return total;
+}
+
+bool StatsSummary::Read(const std::string& path) {
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		return false;
+	}
+	SummaryHeader header;
+	bool IsRead = fread(&header, sizeof(header), 1, file) == 1 && std::string(header.magic, 8) == STATS_SUMMARY_MAGIC &&
+		header.version == StatsFileVersion && header.boardCount <= maxSummaryBoards;
+
+	std::vector<BoardStats> boardsRead;
+	if (IsRead) {
+		boardsRead.resize(header.boardCount);
+		IsRead = fread(boardsRead.data(), sizeof(BoardStats), header.boardCount, file) == header.boardCount;
+	}
+	fclose(file);
+
+	if (IsRead) {
+		boards.swap(boardsRead);
+		recordCount = header.recordCount;
+	}
+	return IsRead;
+}
+
+bool StatsSummary::Write(const std::string& path) const {
+
+	std::string newPath = path + ".new";
+	FILE* file = fopen(newPath.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+	SummaryHeader header = {};
+	memcpy(header.magic, STATS_SUMMARY_MAGIC, sizeof(header.magic));
+	header.version = StatsFileVersion;
+	header.boardCount = static_cast<uint32_t>(boards.size());
+	header.recordCount = recordCount;
+	bool IsWritten = fwrite(&header, sizeof(header), 1, file) == 1;
+	IsWritten &= fwrite(boards.data(), sizeof(BoardStats), boards.size(), file) == boards.size();
+	IsWritten &= fclose(file) == 0;
+
+	// rename doesn't replace a file on Windows, the old summary is removed first there
+	if (IsWritten && std::rename(newPath.c_str(), path.c_str()) != 0) {
+		std::remove(path.c_str());
+		IsWritten = std::rename(newPath.c_str(), path.c_str()) == 0;
+	}
+	return IsWritten;
+}
+
+StatsStore::~StatsStore() {
+	Close();
+}
+
+bool StatsStore::Open(const std::string& logPath, const std::string& summaryPath) {
+
+	Close();
+	this->summaryPath = summaryPath;
+	summary.Clear();
+
+	// A missing or empty log is started with its header, any other file that isn't a log is left as it is
+	int64_t recordCount = CountLogRecords(logPath);
+	if (recordCount < 0) {
+		FILE* file = fopen(logPath.c_str(), "ab");
+		bool IsEmpty = file != nullptr && fseek(file, 0, SEEK_END) == 0 && ftell(file) == 0;
+		LogHeader header = {};
+		memcpy(header.magic, STATS_LOG_MAGIC, sizeof(header.magic));
+		header.version = StatsFileVersion;
+		header.recordSize = sizeof(GameRecord);
+		bool IsCreated = IsEmpty && fwrite(&header, sizeof(header), 1, file) == 1;
+		if (file != nullptr) {
+			IsCreated &= fclose(file) == 0;
+		}
+		if (!IsCreated) {
+			return false;
+		}
+		recordCount = 0;
+	}
+
+	// The summary catches up with the records written after it (a summary ahead of the log is of another log)
+	if (!summary.Read(summaryPath) || summary.GetRecordCount() > static_cast<uint64_t>(recordCount)) {
+		summary.Clear();
+	}
+	uint64_t firstRecord = summary.GetRecordCount();
+	ReadLog(logPath, firstRecord, recordCount - firstRecord, [this](const GameRecord& record) { summary.Add(record); });
+	writtenSummary = summary;
+
+	// New records go after the last whole record
+	logFile = fopen(logPath.c_str(), "r+b");
+	if (logFile == nullptr || fseek(logFile, static_cast<long>(sizeof(LogHeader) + recordCount * sizeof(GameRecord)), SEEK_SET) != 0) {
+		Close();
+		return false;
+	}
+
+	// A summary that caught up is written again, so the records aren't read on the next open
+	if (firstRecord != static_cast<uint64_t>(recordCount)) {
+		writtenSummary.Write(summaryPath);
+	}
+	IsStopping = false;
+	thread = std::thread([this]() { Run(); });
+	return true;
+}
+
+void StatsStore::Close() {
+
+	if (thread.joinable()) {
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			IsStopping = true;
+		}
+		recordReady.notify_one();
+		thread.join();
+	}
+	if (logFile != nullptr) {
+		fclose(logFile);
+		logFile = nullptr;
+	}
+	queue.clear();
+}
+
+void StatsStore::Add(const GameRecord& record) {
+
+	summary.Add(record);
+	if (!thread.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queue.push_back(record);
+	}
+	recordReady.notify_one();
+}
+
+int64_t StatsStore::CountLogRecords(const std::string& path) {
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		return -1;
+	}
+	LogHeader header;
+	bool IsLog = fread(&header, sizeof(header), 1, file) == 1 && IsLogHeader(header) && fseek(file, 0, SEEK_END) == 0;
+	int64_t size = IsLog ? ftell(file) : -1;
+	fclose(file);
+	return size < 0 ? -1 : (size - static_cast<int64_t>(sizeof(LogHeader))) / static_cast<int64_t>(sizeof(GameRecord));
+}
+
+bool StatsStore::IsLogHeader(const LogHeader& header) {
+	return std::string(header.magic, 8) == STATS_LOG_MAGIC && header.version == StatsFileVersion && header.recordSize == sizeof(GameRecord);
+}
+
+// Writes the records queued since the last time it woke up, then the summary that holds them. The records are
+// flushed before the summary is written, so a summary is never ahead of the log. It stops writing if a write fails
+// (the games are still added to the app's summary)
+void StatsStore::Run() {
+
+	std::vector<GameRecord> records;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			recordReady.wait(lock, [this]() { return IsStopping || !queue.empty(); });
+			records.swap(queue);
+		}
+		if (records.empty()) {
+			return;
+		}
+
+		if (logFile != nullptr) {
+			bool IsWritten = fwrite(records.data(), sizeof(GameRecord), records.size(), logFile) == records.size();
+			IsWritten &= fflush(logFile) == 0;
+			if (IsWritten) {
+				for (const GameRecord& record : records) {
+					writtenSummary.Add(record);
+				}
+				writtenSummary.Write(summaryPath);
+			}
+			else {
+				fclose(logFile);
+				logFile = nullptr;
+			}
+		}
+		records.clear();
+	}
+}
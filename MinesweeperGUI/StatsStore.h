@@ -0,0 +1,221 @@
+#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Keeps the statistics of every game played: a log of fixed size records (one per game, appended when the game ends)
+// and a summary of the games of each board (counts, streaks, clear times) updated with each record, so the
+// statistics show at once however many games were played. Both are files: the log is a LogHeader followed by the
+// records, the summary a SummaryHeader followed by a BoardStats for each board. The summary tells how many records of
+// the log it holds, so on open only the records written after it are read (the whole log is read if the summary is
+// missing or doesn't match the log). The files are written by a thread of their own, a game end never waits for the
+// disk. Values are in host byte order
+
+// Define the magic and version at the start of the files
+#define STATS_LOG_MAGIC "MSSTATS1"
+#define STATS_SUMMARY_MAGIC "MSSUMRY1"
+const uint32_t StatsFileVersion = 1;
+
+// Define a distribution of times that any two of can be merged (the games of every board into the total): the times
+// are counted in buckets growing by 4% each (bucket i holds the times above 1.04^(i - 1) and up to 1.04^i ms), and a
+// quantile is the middle of its bucket, within 2% of the exact time. Times of over 5 days are counted in the last bucket
+class QuantileSketch
+{
+public:
+
+	static const int BucketCount = 512;
+
+	void Add(uint32_t milliseconds);
+	void Merge(const QuantileSketch& other);
+	uint64_t GetCount() const { return count; }
+
+	// Returns the time in milliseconds below which the given part (0 - 1) of the times are, 0 if there are none
+	double GetQuantile(double quantile) const;
+
+	static int GetBucket(uint32_t milliseconds);
+	static double GetBucketValue(int bucket);
+
+private:
+
+	uint64_t count = 0;
+	uint32_t buckets[BucketCount] = {};
+};
+
+// Define the options a game was played with
+enum GameOptions : uint8_t {
+	TrainingModeGame = 1,   // moves could be undone
+	LayoutGame = 2,         // the bombs came from a loaded layout
+	AssistedGame = 4,       // an assist mode made the forced moves (GameBoard::AssistMode)
+	ProfiledGame = 8        // the board's difficulty was profiled (DifficultyProfiler.h), the difficulty fields are set
+};
+
+// Define the record of a game (40 bytes, the layout must not change). The time runs from the end of the first
+// reveal to the end of the last move, the 3BV is GameBoard::Count3BV. The difficulty fields are 0 in a game that
+// wasn't profiled, and are held at the largest value they can hold
+struct GameRecord {
+	int64_t finishTime;        // seconds since 1970
+	uint64_t seed;
+	uint32_t milliseconds;
+	uint32_t bbbv;
+	uint32_t numberOfBombs;
+	uint16_t nCols;
+	uint16_t nRows;
+	uint8_t IsWon;
+	uint8_t topology;          // TopologyType
+	uint8_t options;           // GameOptions
+	uint8_t forcedGuesses;
+	uint16_t longestChain;
+	uint16_t openings;
+};
+
+// Define the statistics of the games of a board (a size, # of bombs and shape). The clear times and 3BV are of the
+// games won. Games played in training mode, with an assist or on a loaded layout are kept in the log, but not in the
+// summary
+struct BoardStats {
+	uint16_t nCols;
+	uint16_t nRows;
+	uint32_t numberOfBombs;
+	uint8_t topology;
+	uint8_t reserved[3];
+	uint32_t games;
+	uint32_t wins;
+	uint32_t currentStreak;
+	uint32_t bestStreak;
+	uint32_t bestMilliseconds;
+	uint64_t winMilliseconds;
+	uint64_t winBbbv;
+	QuantileSketch winTimes;
+
+	bool IsSameBoard(const GameRecord& record) const {
+		return nCols == record.nCols && nRows == record.nRows && numberOfBombs == record.numberOfBombs && topology == record.topology;
+	}
+
+	// Returns the 3BV cleared per second of the games won, 0 if none were won
+	double Get3BVPerSecond() const { return winMilliseconds == 0 ? 0 : winBbbv * 1000.0 / winMilliseconds; }
+};
+
+// Define the headers at the start of the files (32 bytes each, the layouts must not change)
+struct LogHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint8_t reserved[16];
+};
+
+struct SummaryHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t boardCount;
+	uint64_t recordCount;
+	uint8_t reserved[8];
+};
+
+static_assert(sizeof(GameRecord) == 40, "GameRecord layout changed");
+static_assert(sizeof(BoardStats) == 2104, "BoardStats layout changed");
+static_assert(sizeof(LogHeader) == 32, "LogHeader layout changed");
+static_assert(sizeof(SummaryHeader) == 32, "SummaryHeader layout changed");
+
+// Define the summary of the log: the statistics of each board in the order they were first played, and the # of
+// records of the log they hold
+class StatsSummary
+{
+public:
+
+	void Add(const GameRecord& record);
+	void Clear();
+	const std::vector<BoardStats>& GetBoards() const { return boards; }
+	uint64_t GetRecordCount() const { return recordCount; }
+
+	// Returns the statistics of every board merged into one
+	BoardStats GetTotal() const;
+
+	// Define methods that read and write a summary file. Write replaces the file at once (it writes a new file and
+	// renames it), so a summary is never left half written. Read returns false if the file is missing or broken
+	bool Read(const std::string& path);
+	bool Write(const std::string& path) const;
+
+private:
+
+	std::vector<BoardStats> boards;
+	uint64_t recordCount = 0;
+};
+
+class StatsStore
+{
+public:
+
+	StatsStore() = default;
+	~StatsStore();
+
+	// Opens the log (it is created if there is none) and the summary, and starts the thread that writes them.
+	// Returns false if the log can't be opened or isn't a log, the games are then only kept until the app closes
+	bool Open(const std::string& logPath, const std::string& summaryPath);
+
+	// Writes the games still queued and stops the thread
+	void Close();
+
+	// Adds a game that ended: the summary is updated at once, the record is written by the thread
+	void Add(const GameRecord& record);
+	const StatsSummary& GetSummary() const { return summary; }
+
+	// Reads the records of a log from a record on (up to count of them), returns false if it isn't a log.
+	// function(record) is called for each record read
+	template <class Function>
+	static bool ReadLog(const std::string& path, uint64_t firstRecord, uint64_t count, Function function);
+
+	// Returns the # of whole records in a log (a record cut short by a crash is written over), -1 if it isn't a log
+	static int64_t CountLogRecords(const std::string& path);
+	static bool IsLogHeader(const LogHeader& header);
+
+private:
+
+	void Run();
+
+	// Define the summary shown by the app, and the one the thread writes (it adds the same records in the same order)
+	StatsSummary summary;
+	StatsSummary writtenSummary;
+
+	// Define the files, only used by the thread once it runs
+	FILE* logFile = nullptr;
+	std::string summaryPath;
+
+	// Define the records waiting to be written and what the thread sleeps on
+	std::thread thread;
+	std::mutex queueMutex;
+	std::condition_variable recordReady;
+	std::vector<GameRecord> queue;
+	bool IsStopping = false;
+};
+
+template <class Function>
+bool StatsStore::ReadLog(const std::string& path, uint64_t firstRecord, uint64_t count, Function function) {
+
+	FILE* file = fopen(path.c_str(), "rb");
+	if (file == nullptr) {
+		return false;
+	}
+	LogHeader header;
+	bool IsLog = fread(&header, sizeof(header), 1, file) == 1 && IsLogHeader(header);
+
+	// The records are read a block at a time
+	if (IsLog && fseek(file, static_cast<long>(sizeof(LogHeader) + firstRecord * sizeof(GameRecord)), SEEK_SET) == 0) {
+		std::vector<GameRecord> records(4096);
+		while (count > 0) {
+			size_t read = fread(records.data(), sizeof(GameRecord), static_cast<size_t>(std::min<uint64_t>(count, records.size())), file);
+			for (size_t i = 0; i < read; i++) {
+				function(static_cast<const GameRecord&>(records[i]));
+			}
+			if (read == 0) {
+				break;
+			}
+			count -= read;
+		}
+	}
+	fclose(file);
+	return IsLog;
+}
@@ -0,0 +1,197 @@
+#include "TileCache.h"
+#include <wx/dcmemory.h>
+#include <wx/image.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Define the text color of each number (index 0 is never drawn)
+static const unsigned char numberColours[9][3] = {
+	{ 0, 0, 0 },
+	{ 0, 0, 255 },     // 1: blue
+	{ 0, 128, 0 },     // 2: green
+	{ 255, 0, 0 },     // 3: red
+	{ 0, 0, 139 },     // 4: dark blue
+	{ 139, 0, 0 },     // 5: dark red
+	{ 95, 158, 160 },  // 6: cadet blue
+	{ 0, 0, 0 },       // 7: black
+	{ 128, 128, 128 }  // 8: gray
+};
+
+TileCache::TileCache(wxUniChar flagChar, wxUniChar flagIndicatorChar, wxUniChar bombChar, wxUniChar falseFlagChar,
+	const wxColour& coveredColour, const wxColour& revealedColour)
+	: flagChar(flagChar), flagIndicatorChar(flagIndicatorChar), bombChar(bombChar), falseFlagChar(falseFlagChar),
+	coveredColour(coveredColour), revealedColour(revealedColour) {
+}
+
+// Draws every tile at the physical pixel size for the scale, then marks the bitmaps with the scale
+// so they are shown at the logical tile size
+void TileCache::Build(const wxSize& tileSize, double scaleFactor) {
+
+	if (IsBuilt() && tileSize == builtSize && scaleFactor == builtScaleFactor) {
+		return;
+	}
+
+	wxSize size(static_cast<int>(std::lround(tileSize.x * scaleFactor)), static_cast<int>(std::lround(tileSize.y * scaleFactor)));
+	wxFont numberFont(wxFontInfo(wxSize(0, size.y * 3 / 5)).Bold());
+	wxFont glyphFont(wxFontInfo(wxSize(0, size.y / 2)));
+
+	// Check which emoji the fonts can draw (the rest use vector art)
+	IsVectorArt.fill(false);
+	IsVectorArt[Flag] = !IsGlyphDrawable(flagChar, glyphFont, size);
+	IsVectorArt[FlagIndicator] = !IsGlyphDrawable(flagIndicatorChar, glyphFont, size);
+	IsVectorArt[Bomb] = !IsGlyphDrawable(bombChar, glyphFont, size);
+	IsVectorArt[FalseFlag] = !IsGlyphDrawable(falseFlagChar, glyphFont, size);
+	IsVectorArt[Hint] = IsVectorArt[Bomb];
+
+	for (int tile = 0; tile < TileCount; tile++) {
+		tiles[tile] = DrawTile(static_cast<Tile>(tile), size, numberFont, glyphFont);
+		tiles[tile].SetScaleFactor(scaleFactor);
+	}
+
+	builtSize = tileSize;
+	builtScaleFactor = scaleFactor;
+}
+
+bool TileCache::IsUsingVectorArt() const {
+	return std::find(IsVectorArt.begin(), IsVectorArt.end(), true) != IsVectorArt.end();
+}
+
+// Draws one tile: the background of a covered or revealed cell, then its number or glyph
+wxBitmap TileCache::DrawTile(Tile tile, const wxSize& size, const wxFont& numberFont, const wxFont& glyphFont) {
+
+	wxBitmap bitmap(size.x, size.y);
+	wxMemoryDC dc(bitmap);
+
+	// Revealed cells use the revealed background, the hint is highlighted
+	if (tile <= 8) {
+		dc.SetBackground(wxBrush(revealedColour));
+	}
+	else if (tile == Hint) {
+		dc.SetBackground(wxBrush(hintColour));
+	}
+	else {
+		dc.SetBackground(wxBrush(coveredColour));
+	}
+	dc.Clear();
+
+	if (tile >= 1 && tile <= 8) {
+		const unsigned char* colour = numberColours[tile];
+		DrawCenteredText(dc, size, wxString::Format("%d", static_cast<int>(tile)), numberFont, wxColour(colour[0], colour[1], colour[2]));
+	}
+	else if (tile != 0 && tile != Covered) {
+		DrawGlyph(dc, size, tile, glyphFont);
+	}
+
+	dc.SelectObject(wxNullBitmap);
+	return bitmap;
+}
+
+void TileCache::DrawGlyph(wxDC& dc, const wxSize& size, Tile tile, const wxFont& glyphFont) {
+
+	if (IsVectorArt[tile]) {
+		DrawVectorArt(dc, size, tile);
+		return;
+	}
+
+	// The hint shows the bomb, like the hint button always has
+	wxUniChar glyph = bombChar;
+	if (tile == Flag) {
+		glyph = flagChar;
+	}
+	else if (tile == FlagIndicator) {
+		glyph = flagIndicatorChar;
+	}
+	else if (tile == FalseFlag) {
+		glyph = falseFlagChar;
+	}
+	DrawCenteredText(dc, size, wxString(glyph), glyphFont, *wxBLACK);
+}
+
+// Returns a point given as a fraction of the largest square that fits in the tile
+static wxPoint TilePoint(const wxSize& size, double x, double y) {
+	int side = std::min(size.x, size.y);
+	return wxPoint((size.x - side) / 2 + static_cast<int>(x * side), (size.y - side) / 2 + static_cast<int>(y * side));
+}
+
+// Draws the built in art for a glyph the fonts don't have
+void TileCache::DrawVectorArt(wxDC& dc, const wxSize& size, Tile tile) {
+
+	int side = std::min(size.x, size.y);
+	int lineWidth = std::max(1, side / 16);
+
+	if (tile == Flag || tile == FlagIndicator) {
+
+		// Pole and base
+		wxColour poleColour = (tile == Flag) ? wxColour(0, 0, 0) : wxColour(128, 128, 128);
+		dc.SetPen(wxPen(poleColour, lineWidth));
+		dc.SetBrush(wxBrush(poleColour));
+		wxPoint poleTop = TilePoint(size, 0.58, 0.18);
+		wxPoint poleBottom = TilePoint(size, 0.58, 0.78);
+		dc.DrawLine(poleTop.x, poleTop.y, poleBottom.x, poleBottom.y);
+		wxPoint baseLeft = TilePoint(size, 0.32, 0.76);
+		dc.DrawRectangle(baseLeft.x, baseLeft.y, side * 2 / 5, std::max(2, side / 12));
+
+		// Red flag, or white flag with a gray outline for the flag mode indicator
+		wxPoint flag[3] = { poleTop, TilePoint(size, 0.58, 0.50), TilePoint(size, 0.20, 0.34) };
+		dc.SetPen(wxPen(tile == Flag ? wxColour(220, 0, 0) : wxColour(128, 128, 128), lineWidth));
+		dc.SetBrush(wxBrush(tile == Flag ? wxColour(220, 0, 0) : wxColour(255, 255, 255)));
+		dc.DrawPolygon(3, flag);
+	}
+	else if (tile == Bomb || tile == Hint) {
+
+		// Spikes, body and a highlight
+		wxPoint center = TilePoint(size, 0.5, 0.5);
+		int spike = side * 9 / 25;
+		int diagonal = spike * 7 / 10;
+		dc.SetPen(wxPen(wxColour(0, 0, 0), std::max(1, side / 14)));
+		dc.DrawLine(center.x - spike, center.y, center.x + spike, center.y);
+		dc.DrawLine(center.x, center.y - spike, center.x, center.y + spike);
+		dc.DrawLine(center.x - diagonal, center.y - diagonal, center.x + diagonal, center.y + diagonal);
+		dc.DrawLine(center.x - diagonal, center.y + diagonal, center.x + diagonal, center.y - diagonal);
+		dc.SetBrush(wxBrush(wxColour(0, 0, 0)));
+		dc.DrawCircle(center.x, center.y, side * 13 / 50);
+		wxPoint highlight = TilePoint(size, 0.42, 0.42);
+		dc.SetPen(*wxTRANSPARENT_PEN);
+		dc.SetBrush(*wxWHITE_BRUSH);
+		dc.DrawCircle(highlight.x, highlight.y, std::max(1, side / 16));
+	}
+	else if (tile == FalseFlag) {
+
+		// Heavy X
+		dc.SetPen(wxPen(wxColour(0, 0, 0), std::max(2, side / 8)));
+		wxPoint topLeft = TilePoint(size, 0.28, 0.28);
+		wxPoint bottomRight = TilePoint(size, 0.72, 0.72);
+		dc.DrawLine(topLeft.x, topLeft.y, bottomRight.x, bottomRight.y);
+		dc.DrawLine(topLeft.x, bottomRight.y, bottomRight.x, topLeft.y);
+	}
+}
+
+void TileCache::DrawCenteredText(wxDC& dc, const wxSize& size, const wxString& text, const wxFont& font, const wxColour& colour) {
+	dc.SetFont(font);
+	dc.SetTextForeground(colour);
+	wxSize extent = dc.GetTextExtent(text);
+	dc.DrawText(text, (size.x - extent.x) / 2, (size.y - extent.y) / 2);
+}
+
+// Draws the glyph and a code point no font has (drawn as the missing glyph box). If nothing was drawn,
+// or the glyph looks the same as the missing glyph box, the fonts can't draw it
+bool TileCache::IsGlyphDrawable(wxUniChar glyph, const wxFont& font, const wxSize& size) {
+
+	wxImage images[2];
+	wxUniChar glyphs[2] = { glyph, wxUniChar(0x0010FFFD) };
+	for (int i = 0; i < 2; i++) {
+		wxBitmap bitmap(size.x, size.y);
+		wxMemoryDC dc(bitmap);
+		dc.SetBackground(*wxWHITE_BRUSH);
+		dc.Clear();
+		DrawCenteredText(dc, size, wxString(glyphs[i]), font, *wxBLACK);
+		dc.SelectObject(wxNullBitmap);
+		images[i] = bitmap.ConvertToImage();
+	}
+
+	size_t bytes = static_cast<size_t>(size.x) * size.y * 3;
+	const unsigned char* glyphPixels = images[0].GetData();
+	bool IsBlank = std::all_of(glyphPixels, glyphPixels + bytes, [](unsigned char value) { return value == 255; });
+	return !IsBlank && std::memcmp(glyphPixels, images[1].GetData(), bytes) != 0;
+}
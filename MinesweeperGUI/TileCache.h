@@ -0,0 +1,59 @@
+#pragma once
+#include <wx/wx.h>
+#include <array>
+#include <cstdint>
+
+// Stores a pre-drawn bitmap for every way a grid cell can look, so updating a cell is a bitmap change
+// instead of formatting a label and shaping its text (the emoji go through font fallback every time).
+// The tiles are drawn once per tile size and DPI scale. If the fonts can't draw one of the emoji
+// (see fonts-noto-color-emoji in the README), simple vector art is drawn for it instead
+class TileCache
+{
+public:
+
+	// Define the tiles, 0 - 8 are the revealed numbers (the same values as GameBoard's visible state)
+	enum Tile : uint8_t {
+		Covered = 9,
+		Flag = 10,
+		FlagIndicator,
+		Bomb,
+		FalseFlag,
+		Hint,
+		TileCount
+	};
+
+	TileCache(wxUniChar flagChar, wxUniChar flagIndicatorChar, wxUniChar bombChar, wxUniChar falseFlagChar,
+		const wxColour& coveredColour, const wxColour& revealedColour);
+
+	// Draws all of the tiles (does nothing if they are already drawn for this size and scale)
+	void Build(const wxSize& tileSize, double scaleFactor);
+
+	// Define methods that give access to the tiles
+	const wxBitmap& Get(Tile tile) const { return tiles[tile]; }
+	bool IsBuilt() const { return builtScaleFactor > 0; }
+	bool IsUsingVectorArt() const;
+
+private:
+
+	// Define methods used to draw the tiles (in physical pixels)
+	wxBitmap DrawTile(Tile tile, const wxSize& size, const wxFont& numberFont, const wxFont& glyphFont);
+	void DrawGlyph(wxDC& dc, const wxSize& size, Tile tile, const wxFont& glyphFont);
+	void DrawVectorArt(wxDC& dc, const wxSize& size, Tile tile);
+	void DrawCenteredText(wxDC& dc, const wxSize& size, const wxString& text, const wxFont& font, const wxColour& colour);
+	bool IsGlyphDrawable(wxUniChar glyph, const wxFont& font, const wxSize& size);
+
+	// Define the emoji and colors used for the tiles
+	wxUniChar flagChar;
+	wxUniChar flagIndicatorChar;
+	wxUniChar bombChar;
+	wxUniChar falseFlagChar;
+	wxColour coveredColour;
+	wxColour revealedColour;
+	wxColour hintColour = wxColour(255, 236, 140);
+
+	// Define the tiles and what they were drawn for
+	std::array<wxBitmap, TileCount> tiles;
+	std::array<bool, TileCount> IsVectorArt = {};
+	wxSize builtSize;
+	double builtScaleFactor = 0;
+};
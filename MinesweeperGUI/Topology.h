@@ -0,0 +1,169 @@
+#pragma once
+#include <cstdint>
+#include <cstdlib>
+
+// Define the shapes a board can have. The rules are the same on every shape, only which cells are neighbors changes
+enum class TopologyType : uint8_t {
+	Standard,   // square cells, 8 neighbors
+	Toroidal,   // square cells, 8 neighbors, the edges wrap around to the opposite side (a grid smaller than 3 x 3 is played as a standard one)
+	Hexagonal,  // hexagonal cells, 6 neighbors (odd rows are shifted right by half a cell)
+	Knight      // square cells, the 8 cells a chess knight can move to are the neighbors
+};
+
+// Returns the topology a grid of nCols x nRows is played on: a toroidal grid narrower than 3 cells would wrap a cell
+// onto itself or count the same neighbor twice, so it is played as a standard grid
+inline TopologyType FitTopology(TopologyType topology, int nCols, int nRows) {
+	if (topology == TopologyType::Toroidal && (nCols < 3 || nRows < 3)) {
+		return TopologyType::Standard;
+	}
+	return topology;
+}
+
+// Each topology is a policy with the same static methods, and the engine algorithms are templates on the policy,
+// so the neighbor loops of each topology are compiled on their own (the standard loops are the same as before).
+//   ForEachNeighbor calls function(index) with the index (x + y * nCols) of each neighbor of a cell
+//   GetNeighbors lists the indices of the neighbors of a cell, and returns their # (for loops that stop early)
+//   IsNearRow / IsNearCell tell if a cell is a given cell or one of its neighbors (used to keep the first
+//   revealed cell free of bombs), IsNearRow only checks the rows so whole rows can be skipped
+template <class Topology>
+struct TopologyPolicy {
+
+	static int GetNeighbors(int xPos, int yPos, int nCols, int nRows, int* neighbors) {
+		int count = 0;
+		Topology::ForEachNeighbor(xPos, yPos, nCols, nRows, [&](int index) { neighbors[count++] = index; });
+		return count;
+	}
+};
+
+struct StandardTopology : TopologyPolicy<StandardTopology> {
+
+	static const int MaxNeighbors = 8;
+
+	// Define all possible single movements from an initial coordinate
+	// (the order matters: chording stops at the first unflagged bomb found in this order)
+	static constexpr int dx[MaxNeighbors] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+	static constexpr int dy[MaxNeighbors] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+
+	template <class Function>
+	static void ForEachNeighbor(int xPos, int yPos, int nCols, int nRows, Function function) {
+		for (int i = 0; i < MaxNeighbors; i++) {
+			int newX = xPos + dx[i];
+			int newY = yPos + dy[i];
+			if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
+				function(newX + newY * nCols);
+			}
+		}
+	}
+
+	static bool IsNearRow(int yPos, int centerY, int) {
+		return std::abs(yPos - centerY) <= 1;
+	}
+
+	static bool IsNearCell(int xPos, int yPos, int centerX, int centerY, int, int) {
+		return std::abs(xPos - centerX) <= 1 && std::abs(yPos - centerY) <= 1;
+	}
+};
+
+struct ToroidalTopology : TopologyPolicy<ToroidalTopology> {
+
+	static const int MaxNeighbors = 8;
+
+	template <class Function>
+	static void ForEachNeighbor(int xPos, int yPos, int nCols, int nRows, Function function) {
+		for (int i = 0; i < MaxNeighbors; i++) {
+			function(Wrap(xPos + StandardTopology::dx[i], nCols) + Wrap(yPos + StandardTopology::dy[i], nRows) * nCols);
+		}
+	}
+
+	static bool IsNearRow(int yPos, int centerY, int nRows) {
+		int distance = std::abs(yPos - centerY);
+		return distance <= 1 || distance >= nRows - 1;
+	}
+
+	static bool IsNearCell(int xPos, int yPos, int centerX, int centerY, int nCols, int nRows) {
+		int distance = std::abs(xPos - centerX);
+		return IsNearRow(yPos, centerY, nRows) && (distance <= 1 || distance >= nCols - 1);
+	}
+
+	static int Wrap(int position, int size) {
+		return position < 0 ? position + size : position >= size ? position - size : position;
+	}
+};
+
+struct HexagonalTopology : TopologyPolicy<HexagonalTopology> {
+
+	static const int MaxNeighbors = 6;
+
+	// Define the movements to the neighbors on even rows and on odd rows (odd rows are shifted right by half a cell,
+	// so their neighbors above and below are one column further right)
+	static constexpr int dx[2][MaxNeighbors] = { { -1, 1, -1, 0, -1, 0 }, { -1, 1, 0, 1, 0, 1 } };
+	static constexpr int dy[MaxNeighbors] = { 0, 0, -1, -1, 1, 1 };
+
+	template <class Function>
+	static void ForEachNeighbor(int xPos, int yPos, int nCols, int nRows, Function function) {
+		const int* rowDx = dx[yPos & 1];
+		for (int i = 0; i < MaxNeighbors; i++) {
+			int newX = xPos + rowDx[i];
+			int newY = yPos + dy[i];
+			if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
+				function(newX + newY * nCols);
+			}
+		}
+	}
+
+	static bool IsNearRow(int yPos, int centerY, int) {
+		return std::abs(yPos - centerY) <= 1;
+	}
+
+	static bool IsNearCell(int xPos, int yPos, int centerX, int centerY, int, int) {
+		int offset = xPos - centerX;
+		if (yPos == centerY) {
+			return std::abs(offset) <= 1;
+		}
+		return std::abs(yPos - centerY) == 1 && (offset == 0 || offset == ((centerY & 1) ? 1 : -1));
+	}
+};
+
+struct KnightTopology : TopologyPolicy<KnightTopology> {
+
+	static const int MaxNeighbors = 8;
+
+	static constexpr int dx[MaxNeighbors] = { -2, -2, -1, -1, 1, 1, 2, 2 };
+	static constexpr int dy[MaxNeighbors] = { -1, 1, -2, 2, -2, 2, -1, 1 };
+
+	template <class Function>
+	static void ForEachNeighbor(int xPos, int yPos, int nCols, int nRows, Function function) {
+		for (int i = 0; i < MaxNeighbors; i++) {
+			int newX = xPos + dx[i];
+			int newY = yPos + dy[i];
+			if (newX >= 0 && newY >= 0 && newX < nCols && newY < nRows) {
+				function(newX + newY * nCols);
+			}
+		}
+	}
+
+	static bool IsNearRow(int yPos, int centerY, int) {
+		return std::abs(yPos - centerY) <= 2;
+	}
+
+	static bool IsNearCell(int xPos, int yPos, int centerX, int centerY, int, int) {
+		int distanceX = std::abs(xPos - centerX);
+		int distanceY = std::abs(yPos - centerY);
+		return (distanceX == 0 && distanceY == 0) || (distanceX == 1 && distanceY == 2) || (distanceX == 2 && distanceY == 1);
+	}
+};
+
+// Returns function(policy) called with the policy of a topology, so the loops in function are compiled for it
+template <class Function>
+auto WithTopology(TopologyType topology, Function function) {
+	switch (topology) {
+	case TopologyType::Toroidal:
+		return function(ToroidalTopology());
+	case TopologyType::Hexagonal:
+		return function(HexagonalTopology());
+	case TopologyType::Knight:
+		return function(KnightTopology());
+	default:
+		return function(StandardTopology());
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+
+// Define the values stored in GameBoard's visible state buffer, 0 - 8 are revealed cells (# of surrounding bombs).
+// GameBoard inherits them (GameBoard::Covered), the indexes that follow the visible state use them without the board
+struct VisibleCellValues {
+	enum VisibleCell : uint8_t {
+		Covered = 9,
+		Flagged = 10
+	};
+};
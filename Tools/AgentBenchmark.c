@@ -0,0 +1,165 @@
+/*
+ * Benchmark for the C ABI (MinesweeperAPI.h): a simple agent plays random games from a single thread.
+ * The agent keeps its own set of covered cells, updated only from the per-move change list,
+ * and reads the visible state in place, so the measured time is the game logic itself.
+ * Setting up a game (ms_new_game, and its first reveal, which places the bombs) is timed on its own,
+ * so the moves per second are the cost of the moves made once the bombs are placed.
+ */
+
+#include "../MinesweeperGUI/MinesweeperAPI.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Define the agent's set of covered cells (swap remove, position table gives O(1) updates) */
+typedef struct CoveredSet {
+	uint32_t* cells;
+	uint32_t* positions;
+	uint32_t count;
+} CoveredSet;
+
+static uint64_t rngState = 0x9E3779B97F4A7C15ull;
+
+/* xorshift64, fast enough to not show up in the measurement */
+static uint64_t NextRandom(void) {
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 7;
+	rngState ^= rngState << 17;
+	return rngState;
+}
+
+static double SecondsNow(void) {
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return now.tv_sec + now.tv_nsec * 1e-9;
+}
+
+/* Marks every cell as covered (used when a new game starts) */
+static void ResetCoveredSet(CoveredSet* set, uint32_t cellCount) {
+	for (uint32_t i = 0; i < cellCount; i++) {
+		set->cells[i] = i;
+		set->positions[i] = i;
+	}
+	set->count = cellCount;
+}
+
+/* Removes a cell from the set if it is in it */
+static void RemoveCovered(CoveredSet* set, uint32_t index) {
+	uint32_t position = set->positions[index];
+	if (position >= set->count || set->cells[position] != index) {
+		return;
+	}
+	uint32_t last = set->cells[--set->count];
+	set->cells[position] = last;
+	set->positions[last] = position;
+}
+
+/* Adds a cell to the set if it isn't already in it */
+static void AddCovered(CoveredSet* set, uint32_t index) {
+	uint32_t position = set->positions[index];
+	if (position < set->count && set->cells[position] == index) {
+		return;
+	}
+	set->cells[set->count] = index;
+	set->positions[index] = set->count++;
+}
+
+int main(int argc, char** argv) {
+
+	int cols = argc > 1 ? atoi(argv[1]) : 30;
+	int rows = argc > 2 ? atoi(argv[2]) : 16;
+	int bombs = argc > 3 ? atoi(argv[3]) : 99;
+	double seconds = argc > 4 ? atof(argv[4]) : 3.0;
+
+	ms_game* game = ms_create(cols, rows, bombs, 1);
+	if (game == NULL) {
+		fprintf(stderr, "Invalid board: %dx%d with %d bombs\n", cols, rows, bombs);
+		return 1;
+	}
+
+	uint32_t cellCount = (uint32_t)cols * (uint32_t)rows;
+	CoveredSet covered;
+	covered.cells = malloc(cellCount * sizeof(uint32_t));
+	covered.positions = malloc(cellCount * sizeof(uint32_t));
+	ResetCoveredSet(&covered, cellCount);
+
+	/* The visible buffer is read in place, it stays valid for the whole benchmark */
+	const uint8_t* visible = ms_visible(game);
+
+	uint64_t moves = 0;
+	uint64_t games = 0;
+	uint64_t changedCells = 0;
+	uint64_t firstReveals = 0;
+	double setupSeconds = 0;
+	double start = SecondsNow();
+	double end = start;
+
+	while (end - start < seconds) {
+
+		/* Check the clock every 1024 moves */
+		for (int i = 0; i < 1024; i++) {
+
+			int status = ms_status(game);
+			if (status == MS_WON || status == MS_LOST || covered.count == 0) {
+				double setupStart = SecondsNow();
+				ms_new_game(game, NextRandom());
+				ResetCoveredSet(&covered, cellCount);
+				setupSeconds += SecondsNow() - setupStart;
+				status = MS_NOT_STARTED;
+				games++;
+			}
+
+			/* Reveal a random covered cell, or flag it once in a while */
+			uint32_t index = covered.cells[NextRandom() % covered.count];
+			int xPos = (int)(index % (uint32_t)cols);
+			int yPos = (int)(index / (uint32_t)cols);
+			if (NextRandom() % 8 == 0) {
+				ms_flag(game, xPos, yPos);
+			}
+			else if (status == MS_NOT_STARTED) {
+				double setupStart = SecondsNow();
+				ms_reveal(game, xPos, yPos);
+				setupSeconds += SecondsNow() - setupStart;
+				firstReveals++;
+			}
+			else {
+				ms_reveal(game, xPos, yPos);
+			}
+			moves++;
+
+			/* Update the agent's own structure from the change list only */
+			uint32_t changeCount;
+			const ms_change* changes = ms_changes(game, &changeCount);
+			for (uint32_t c = 0; c < changeCount; c++) {
+				if (changes[c].visible == MS_COVERED) {
+					AddCovered(&covered, changes[c].index);
+				}
+				else {
+					RemoveCovered(&covered, changes[c].index);
+				}
+			}
+			changedCells += changeCount;
+		}
+
+		end = SecondsNow();
+	}
+
+	/* The moves' time is what is left once the games are set up */
+	double elapsed = end - start;
+	double moveSeconds = elapsed - setupSeconds;
+	uint64_t playedMoves = moves - firstReveals;
+	printf("board:          %dx%d, %d bombs (first visible byte %u)\n", cols, rows, bombs, visible[0]);
+	printf("moves:          %llu in %.2f s (%.2f s setting up %llu games)\n", (unsigned long long)moves, elapsed, setupSeconds,
+		(unsigned long long)games);
+	printf("moves/s:        %.0f (%.1f ns per move, game setup and first reveals not included)\n", playedMoves / moveSeconds,
+		moveSeconds * 1e9 / playedMoves);
+	printf("game setup:     %.1f ns per game (new game, and the first reveal placing the bombs)\n", setupSeconds * 1e9 / games);
+	printf("games/s:        %.0f (%.1f moves per game)\n", games / elapsed, (double)moves / games);
+	printf("overall:        %.0f moves/s (%.1f ns per move, game setup included)\n", moves / elapsed, elapsed * 1e9 / moves);
+	printf("changed cells:  %.2f per move\n", (double)changedCells / moves);
+
+	free(covered.cells);
+	free(covered.positions);
+	ms_destroy(game);
+	return 0;
+}
@@ -0,0 +1,227 @@
+// Check that gameplay doesn't allocate: counts the heap allocations (MinesweeperGUI/AllocationCounters.h) made by
+// setting up a board and by playing seeded games on it, on every topology, with training mode, the frontier index and
+// the assist modes on and off. Once a board has been set up, new games and moves (reveals, flags, chords, undos and
+// redos) must make no allocation at all, and the per cell buffers must fit in the board's arena: the check fails
+// otherwise.
+// A large board, whose bombs are placed on several threads, is played too (the placement allocates, the moves must not).
+// Then games are played through the engine thread the way the window plays them (MinesweeperGUI/EngineThread.h): once
+// every slot of the result queue has been used, the moves, hints and region counts must make no allocation on either
+// thread, the copy of their changes into the results and taking the results included
+//
+// usage: allocationbench [cols] [rows] [bombs] [games]
+
+#include "../MinesweeperGUI/AllocationCounters.h"
+#include "../MinesweeperGUI/EngineThread.h"
+#include "../MinesweeperGUI/GameBoard.h"
+#include <cstdio>
+#include <cstdlib>
+
+static const char* const topologyNames[] = { "standard", "toroidal", "hexagonal", "knight" };
+static const TopologyType topologies[] = { TopologyType::Standard, TopologyType::Toroidal, TopologyType::Hexagonal, TopologyType::Knight };
+
+static uint64_t Allocations() {
+	return AllocationCounters::GetTotal().allocations;
+}
+
+// Plays seeded games with a random agent, returns the allocations made by the moves (the first reveal of each game,
+// which places the bombs, is counted in placementAllocations instead)
+static uint64_t PlayGames(GameBoard& board, int games, int firstGame, uint64_t& placementAllocations, uint64_t& moves) {
+
+	uint64_t allocations = 0;
+	uint64_t agentState = 3 + firstGame;
+	int cellCount = board.GetCellCount();
+	placementAllocations = 0;
+	moves = 0;
+
+	for (int game = firstGame; game < firstGame + games; game++) {
+		uint64_t before = Allocations();
+		board.NewGame(game);
+		allocations += Allocations() - before;
+
+		while (board.GetStatus() != GameBoard::Status::Won && board.GetStatus() != GameBoard::Status::Lost) {
+			int index = static_cast<int>(GameBoard::RandomBelow(agentState, cellCount));
+			int x = index % board.GetCols();
+			int y = index / board.GetCols();
+			int kind = static_cast<int>(GameBoard::RandomBelow(agentState, 10));
+			bool IsFirstReveal = board.GetStatus() == GameBoard::Status::NotStarted;
+
+			// Reveals (a revealed cell is chorded), flags, and some undos and redos in training mode
+			before = Allocations();
+			if (kind < 6 || IsFirstReveal) {
+				board.Reveal(x, y);
+			}
+			else if (kind < 8) {
+				board.ToggleFlag(x, y);
+			}
+			else if (kind < 9) {
+				board.Undo();
+			}
+			else {
+				board.Redo();
+			}
+			uint64_t moveAllocations = Allocations() - before;
+			(IsFirstReveal ? placementAllocations : allocations) += moveAllocations;
+			moves++;
+		}
+	}
+	return allocations;
+}
+
+// Sets up a board and plays games on it, returns false (and prints why) if gameplay allocated
+static bool CheckBoard(const char* name, int nCols, int nRows, int numberOfBombs, TopologyType topology, bool IsTraining, bool IsTracked, bool IsAssisted,
+	int games) {
+
+	uint64_t before = Allocations();
+	GameBoard board;
+	board.SetTrainingMode(IsTraining);
+	board.SetFrontierTracking(IsTracked);
+	board.SetAssistModes(IsAssisted ? GameBoard::AutoFlag | GameBoard::AutoChord : 0);
+	board.SetTopology(topology);
+	board.Resize(nCols, nRows, numberOfBombs);
+	uint64_t setupAllocations = Allocations() - before;
+
+	// A first game warms up anything that is only allocated once (there should be nothing)
+	uint64_t placementAllocations;
+	uint64_t moves;
+	uint64_t warmUpAllocations = PlayGames(board, 1, 0, placementAllocations, moves);
+	uint64_t allocations = PlayGames(board, games, 1, placementAllocations, moves);
+
+	printf("%-9s %-8s %-8s %-6s %3llu to set up, %llu in the first game, %llu in %llu moves, %llu placing bombs, arena %.1f KB\n",
+		name, IsTraining ? "training" : "-", IsTracked ? "frontier" : "-", IsAssisted ? "assist" : "-", static_cast<unsigned long long>(setupAllocations),
+		static_cast<unsigned long long>(warmUpAllocations), static_cast<unsigned long long>(allocations), static_cast<unsigned long long>(moves),
+		static_cast<unsigned long long>(placementAllocations), board.GetArenaCapacity() / 1024.0);
+
+	if (allocations != 0 || warmUpAllocations != 0 || board.GetArenaOverflowCount() != 0) {
+		printf("gameplay allocated (%d arena overflows)\n", board.GetArenaOverflowCount());
+		return false;
+	}
+	if (!board.IsLargeBoard() && placementAllocations != 0) {
+		printf("placing the bombs of a small board allocated\n");
+		return false;
+	}
+	return true;
+}
+
+// Sends a command to the engine and waits for its result, returns the game's status after it and adds the allocations
+// the engine counted for it
+static GameBoard::Status SendCommand(EngineThread& engine, const EngineThread::Command& command, uint64_t& engineAllocations) {
+
+	GameBoard::Status status = GameBoard::Status::NotStarted;
+	bool IsDone = false;
+	engine.Submit(command);
+	while (!IsDone) {
+		engine.DrainResults([&](const EngineThread::Result& result) {
+			engineAllocations += result.allocations;
+			status = result.status;
+			IsDone = true;
+		});
+		if (!IsDone) {
+			std::this_thread::yield();
+		}
+	}
+	return status;
+}
+
+// Plays seeded games through the engine with a random agent (moves, and a hint and a region count now and then),
+// returns the # of commands sent
+static uint64_t PlayEngineGames(EngineThread& engine, int nCols, int nRows, int games, int firstGame, uint64_t& engineAllocations) {
+
+	uint64_t agentState = 3 + firstGame;
+	uint64_t commands = 0;
+	for (int game = firstGame; game < firstGame + games; game++) {
+		EngineThread::Command command;
+		command.type = EngineThread::CommandType::NewGame;
+		command.seed = game;
+		GameBoard::Status status = SendCommand(engine, command, engineAllocations);
+		commands++;
+
+		while (status != GameBoard::Status::Won && status != GameBoard::Status::Lost) {
+			int kind = static_cast<int>(GameBoard::RandomBelow(agentState, 20));
+			command = EngineThread::Command();
+			command.xPos = static_cast<int>(GameBoard::RandomBelow(agentState, nCols));
+			command.yPos = static_cast<int>(GameBoard::RandomBelow(agentState, nRows));
+			command.width = nCols - command.xPos;
+			command.height = nRows - command.yPos;
+			if (kind < 12 || status == GameBoard::Status::NotStarted) {
+				command.type = EngineThread::CommandType::Reveal;
+			}
+			else if (kind < 15) {
+				command.type = EngineThread::CommandType::Flag;
+			}
+			else if (kind < 17) {
+				command.type = kind < 16 ? EngineThread::CommandType::Undo : EngineThread::CommandType::Redo;
+			}
+			else {
+				command.type = kind < 19 ? EngineThread::CommandType::FindHint : EngineThread::CommandType::CountRegion;
+			}
+			status = SendCommand(engine, command, engineAllocations);
+			commands++;
+		}
+	}
+	return commands;
+}
+
+// Plays games on a board through the engine thread, returns false (and prints why) if the commands allocated once
+// every slot of the result queue was used
+static bool CheckEngine(int nCols, int nRows, int numberOfBombs, int games) {
+
+	GameBoard board;
+	board.SetTrainingMode(true);
+	board.SetFrontierTracking(true);
+	board.SetRegionTracking(true);
+	board.Resize(nCols, nRows, numberOfBombs);
+	EngineThread engine;
+	engine.Start(board, []() {});
+
+	// The first games use every slot of the result queue (and reserve their lists)
+	uint64_t warmUpAllocations = 0;
+	uint64_t warmUpCommands = 0;
+	int game = 0;
+	while (warmUpCommands < 2 * EngineThread::ResultQueueCapacity) {
+		warmUpCommands += PlayEngineGames(engine, nCols, nRows, 1, game++, warmUpAllocations);
+	}
+
+	uint64_t engineAllocations = 0;
+	uint64_t before = Allocations();
+	uint64_t commands = PlayEngineGames(engine, nCols, nRows, games, game, engineAllocations);
+	uint64_t allocations = Allocations() - before;
+	engine.Stop();
+
+	printf("engine    %llu in %llu warm-up commands, %llu in %llu commands (%llu counted by the engine)\n",
+		static_cast<unsigned long long>(warmUpAllocations), static_cast<unsigned long long>(warmUpCommands), static_cast<unsigned long long>(allocations),
+		static_cast<unsigned long long>(commands), static_cast<unsigned long long>(engineAllocations));
+	if (allocations != 0 || engineAllocations != 0) {
+		printf("gameplay through the engine thread allocated\n");
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 30;
+	int nRows = argc > 2 ? atoi(argv[2]) : 16;
+	int numberOfBombs = argc > 3 ? atoi(argv[3]) : 99;
+	int games = argc > 4 ? atoi(argv[4]) : 2000;
+	printf("%dx%d board, %d bombs, %d games per setup\n", nCols, nRows, numberOfBombs, games);
+
+	for (int i = 0; i < 4; i++) {
+		for (int mode = 0; mode < 8; mode++) {
+			if (!CheckBoard(topologyNames[i], nCols, nRows, numberOfBombs, topologies[i], (mode & 1) != 0, (mode & 2) != 0, (mode & 4) != 0, games)) {
+				return 1;
+			}
+		}
+	}
+
+	// The bombs of a large board are placed on several threads, which allocates their buffers
+	if (!CheckBoard("large", 1200, 1000, 1200 * 1000 / 5, TopologyType::Standard, true, true, true, 2)) {
+		return 1;
+	}
+
+	// The moves as the window sends them, their results are written in the slots of the result queue
+	if (!CheckEngine(nCols, nRows, numberOfBombs, games)) {
+		return 1;
+	}
+	printf("no allocations during gameplay\n");
+	return 0;
+}
@@ -0,0 +1,299 @@
+// Check and benchmark for the assist modes (GameBoard::SetAssistModes): plays seeded games with both modes on, on
+// every topology, and checks after each move that no number is left forcing a move (the frontier index lists the
+// numbers whose mines are all flagged, and the ones with as many mines left as covered cells), that the assist never
+// loses a game the player's flags didn't mislead it into, and that undo and redo in training mode take an assisted
+// move back and forth as a whole. Checks that a flag the assist chords around can end a game, as a change the window
+// sees (wrong flags lose it, right ones win it). Then plays the same moves on a large board with the assist, and without it followed
+// by sweeps of the whole board until no number forces a move, checking both give the same board and timing them
+//
+// usage: assistbench [cols] [rows] [bombPercent] [moves]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const topologyNames[] = { "standard", "toroidal", "hexagonal", "knight" };
+static const TopologyType topologies[] = { TopologyType::Standard, TopologyType::Toroidal, TopologyType::Hexagonal, TopologyType::Knight };
+
+// Define what is compared when a move is undone and redone
+struct Snapshot {
+	std::vector<uint8_t> visible;
+	GameBoard::Status status;
+	int flagsPlaced;
+};
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static void TakeSnapshot(const GameBoard& board, Snapshot& snapshot) {
+	const uint8_t* visible = board.GetVisibleState();
+	snapshot.visible.assign(visible, visible + board.GetCellCount());
+	snapshot.status = board.GetStatus();
+	snapshot.flagsPlaced = board.GetFlagsPlaced();
+}
+
+static bool IsSameSnapshot(const GameBoard& board, const Snapshot& snapshot) {
+	return board.GetStatus() == snapshot.status && board.GetFlagsPlaced() == snapshot.flagsPlaced &&
+		memcmp(board.GetVisibleState(), snapshot.visible.data(), snapshot.visible.size()) == 0;
+}
+
+// Picks a random covered unflagged cell (a safe one if IsSafe), returns false if there is none
+static bool PickCoveredCell(const GameBoard& board, uint64_t& random, bool IsSafe, int& xPos, int& yPos) {
+
+	const uint8_t* visible = board.GetVisibleState();
+	int cellCount = board.GetCellCount();
+	int start = static_cast<int>(GameBoard::RandomBelow(random, cellCount));
+	for (int i = 0; i < cellCount; i++) {
+		int index = (start + i) % cellCount;
+		xPos = index % board.GetCols();
+		yPos = index / board.GetCols();
+		if (visible[index] == GameBoard::Covered && (!IsSafe || !board.IsBomb(xPos, yPos))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Plays games with random moves (reveals, flags that can be wrong, chords, undos) and checks the board after each
+// one, returns false (and prints why) at the first failure
+static bool CheckGames(TopologyType topology, int gameCount, int& moveCount) {
+
+	GameBoard board(30, 16, 99);
+	board.SetTopology(topology);
+	board.SetTrainingMode(true);
+	board.SetFrontierTracking(true);
+	board.SetAssistModes(GameBoard::AutoFlag | GameBoard::AutoChord);
+	Snapshot before;
+	Snapshot after;
+
+	for (int game = 0; game < gameCount; game++) {
+		uint64_t random = game;
+		board.NewGame(game);
+		bool HasWrongFlag = false;
+
+		while (board.GetStatus() == GameBoard::Status::NotStarted || board.GetStatus() == GameBoard::Status::Playing) {
+			TakeSnapshot(board, before);
+			int xPos = 0;
+			int yPos = 0;
+			uint64_t choice = GameBoard::RandomBelow(random, 10);
+			bool IsRevealOfSafeCell = false;
+			bool IsChanged = false;
+
+			if (board.GetStatus() == GameBoard::Status::NotStarted || choice < 6) {
+				// Reveal, mostly safe cells so the games last
+				bool IsSafe = board.GetStatus() != GameBoard::Status::NotStarted && choice < 5;
+				if (!PickCoveredCell(board, random, IsSafe, xPos, yPos)) {
+					break;
+				}
+				IsRevealOfSafeCell = board.GetStatus() == GameBoard::Status::NotStarted || !board.IsBomb(xPos, yPos);
+				IsChanged = board.Reveal(xPos, yPos);
+			}
+			else if (choice < 8) {
+				// Flag a covered cell, a bomb or not
+				if (!PickCoveredCell(board, random, false, xPos, yPos)) {
+					break;
+				}
+				HasWrongFlag |= !board.IsBomb(xPos, yPos);
+				IsChanged = board.ToggleFlag(xPos, yPos);
+			}
+			else if (choice < 9) {
+				// Chord any cell (most chords change nothing)
+				int index = static_cast<int>(GameBoard::RandomBelow(random, board.GetCellCount()));
+				IsChanged = board.Chord(index % board.GetCols(), index / board.GetCols());
+			}
+			else {
+				board.Undo();
+				moveCount++;
+				continue;
+			}
+			moveCount++;
+
+			GameBoard::Status status = board.GetStatus();
+			if (status == GameBoard::Status::Playing && (!board.GetFrontier().GetSatisfiedNumbers().empty() ||
+				!board.GetFrontier().GetSaturatedNumbers().empty())) {
+				printf("%s game %d: a number still forces a move after move %d\n", topologyNames[static_cast<int>(topology)], game, moveCount);
+				return false;
+			}
+			if (status == GameBoard::Status::Lost && IsRevealOfSafeCell && !HasWrongFlag) {
+				printf("%s game %d: the assist lost the game with every flag right\n", topologyNames[static_cast<int>(topology)], game);
+				return false;
+			}
+
+			// The move and the assist's moves after it are undone and redone as one
+			if (IsChanged && before.status != GameBoard::Status::NotStarted) {
+				TakeSnapshot(board, after);
+				if (!board.Undo() || !IsSameSnapshot(board, before)) {
+					printf("%s game %d: undo of move %d didn't restore the board\n", topologyNames[static_cast<int>(topology)], game, moveCount);
+					return false;
+				}
+				if (!board.Redo() || !IsSameSnapshot(board, after)) {
+					printf("%s game %d: redo of move %d didn't restore the board\n", topologyNames[static_cast<int>(topology)], game, moveCount);
+					return false;
+				}
+			}
+		}
+	}
+	return true;
+}
+
+// Flags cells after the first reveal, only wrong ones or only right ones, until the assist chords around a flag and
+// ends the game. The flag that ends it must be reported as a change (the window shows the game over from it), and
+// the game must be lost by wrong flags and won by right ones. Returns false (and prints why) at the first failure
+static bool CheckFlagEndings(TopologyType topology, int gameCount, int& endedGames) {
+
+	for (int game = 0; game < 2 * gameCount; game++) {
+		bool IsRightFlags = game % 2 == 1;
+		GameBoard board(9, 9, 15);
+		board.SetTopology(topology);
+		board.SetAssistModes(GameBoard::AutoChord);
+		board.NewGame(game / 2);
+		board.Reveal(4, 4);
+
+		for (int index = 0; index < board.GetCellCount() && board.GetStatus() == GameBoard::Status::Playing; index++) {
+			int xPos = index % board.GetCols();
+			int yPos = index / board.GetCols();
+			if (board.GetVisibleState()[index] != GameBoard::Covered || board.IsBomb(xPos, yPos) != IsRightFlags) {
+				continue;
+			}
+			bool IsChanged = board.ToggleFlag(xPos, yPos);
+			GameBoard::Status status = board.GetStatus();
+			if (status == GameBoard::Status::Playing) {
+				continue;
+			}
+			endedGames++;
+			GameBoard::Status expected = IsRightFlags ? GameBoard::Status::Won : GameBoard::Status::Lost;
+			if (!IsChanged || status != expected) {
+				printf("%s game %d: the flag on (%d, %d) ended the game %s%s\n", topologyNames[static_cast<int>(topology)], game / 2, xPos, yPos,
+					status == GameBoard::Status::Won ? "won" : "lost", IsChanged ? "" : " without a change");
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Makes the moves the numbers force by sweeping the whole board until a sweep changes nothing (the assist without
+// the queue), returns the # of sweeps
+static int SweepBoard(GameBoard& board) {
+
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	const uint8_t* visible = board.GetVisibleState();
+	int sweeps = 0;
+	bool IsChanged = true;
+
+	while (IsChanged && board.GetStatus() == GameBoard::Status::Playing) {
+		IsChanged = false;
+		sweeps++;
+		WithTopology(board.GetTopology(), [&](auto policy) {
+			typedef decltype(policy) Topology;
+			int neighbors[Topology::MaxNeighbors];
+			for (int index = 0; index < board.GetCellCount(); index++) {
+				if (visible[index] == 0 || visible[index] >= GameBoard::Covered) {
+					continue;
+				}
+				int xPos = index % nCols;
+				int yPos = index / nCols;
+				int count = Topology::GetNeighbors(xPos, yPos, nCols, nRows, neighbors);
+				int flags = 0;
+				int unknowns = 0;
+				for (int i = 0; i < count; i++) {
+					flags += visible[neighbors[i]] == GameBoard::Flagged;
+					unknowns += visible[neighbors[i]] == GameBoard::Covered;
+				}
+				if (unknowns > 0 && flags + unknowns == visible[index]) {
+					for (int i = 0; i < count; i++) {
+						if (visible[neighbors[i]] == GameBoard::Covered) {
+							board.ToggleFlag(neighbors[i] % nCols, neighbors[i] / nCols);
+						}
+					}
+					IsChanged = true;
+				}
+				else if (unknowns > 0 && flags == visible[index]) {
+					board.Chord(xPos, yPos);
+					IsChanged = true;
+				}
+			}
+		});
+	}
+	return sweeps;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 1000;
+	int nRows = argc > 2 ? atoi(argv[2]) : 1000;
+	int bombPercent = argc > 3 ? atoi(argv[3]) : 18;
+	int moves = argc > 4 ? atoi(argv[4]) : 30;
+	bool IsPassed = true;
+
+	for (TopologyType topology : topologies) {
+		int moveCount = 0;
+		Clock::time_point start = Clock::now();
+		bool IsChecked = CheckGames(topology, 300, moveCount);
+		printf("%-10s 300 games, %d moves checked in %.0f ms: %s\n", topologyNames[static_cast<int>(topology)], moveCount,
+			MillisecondsSince(start), IsChecked ? "ok" : "FAILED");
+		IsPassed &= IsChecked;
+	}
+	for (TopologyType topology : topologies) {
+		int endedGames = 0;
+		bool IsChecked = CheckFlagEndings(topology, 300, endedGames);
+		printf("%-10s %d games ended by a flag: %s\n", topologyNames[static_cast<int>(topology)], endedGames, IsChecked ? "ok" : "FAILED");
+		IsPassed &= IsChecked;
+	}
+
+	// The same safe reveals on a board with the assist and one swept after each move
+	int numberOfBombs = static_cast<int>(static_cast<int64_t>(nCols) * nRows * bombPercent / 100);
+	GameBoard assisted(nCols, nRows, numberOfBombs);
+	GameBoard swept(nCols, nRows, numberOfBombs);
+	assisted.SetAssistModes(GameBoard::AutoFlag | GameBoard::AutoChord);
+	assisted.NewGame(1);
+	swept.NewGame(1);
+
+	uint64_t random = 1;
+	double assistedMilliseconds = 0;
+	double sweptMilliseconds = 0;
+	long long changedCells = 0;
+	int sweeps = 0;
+	int movesMade = 0;
+	for (; movesMade < moves && assisted.GetStatus() != GameBoard::Status::Won; movesMade++) {
+		int xPos = 0;
+		int yPos = 0;
+		if (!PickCoveredCell(assisted, random, movesMade > 0, xPos, yPos)) {
+			break;
+		}
+
+		Clock::time_point start = Clock::now();
+		assisted.Reveal(xPos, yPos);
+		assistedMilliseconds += MillisecondsSince(start);
+		changedCells += assisted.GetChanges().size();
+
+		start = Clock::now();
+		swept.Reveal(xPos, yPos);
+		sweeps += SweepBoard(swept);
+		sweptMilliseconds += MillisecondsSince(start);
+
+		if (assisted.GetStatus() != swept.GetStatus() ||
+			memcmp(assisted.GetVisibleState(), swept.GetVisibleState(), assisted.GetCellCount()) != 0) {
+			printf("the assisted and swept boards differ after move %d\n", movesMade + 1);
+			IsPassed = false;
+			break;
+		}
+	}
+
+	printf("%dx%d, %d bombs, %d moves: %lld cells changed\n", nCols, nRows, numberOfBombs, movesMade, changedCells);
+	printf("assist           %10.2f ms/move  %8.3f us/changed cell\n", assistedMilliseconds / std::max(movesMade, 1),
+		assistedMilliseconds * 1000 / std::max(changedCells, 1LL));
+	printf("board sweeps     %10.2f ms/move  (%d sweeps)\n", sweptMilliseconds / std::max(movesMade, 1), sweeps);
+	printf("speedup          %10.1fx\n", sweptMilliseconds / std::max(assistedMilliseconds, 1e-9));
+
+	printf(IsPassed ? "all checks passed\n" : "CHECKS FAILED\n");
+	return IsPassed ? 0 : 1;
+}
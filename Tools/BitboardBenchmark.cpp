@@ -0,0 +1,289 @@
+// Benchmark comparing cell at a time board operations (the way GameBoard works on small boards) with the
+// Bitboard kernels, portable and AVX2, on a very large board. Every result is checked against
+// the cell at a time version, and a GameBoard game with the same bombs (which flood fills a large board
+// on bit planes) checks the flood fill, over its first reveal and then over more reveals, undos and redos.
+
+#include "../MinesweeperGUI/Bitboard.h"
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define all possible single movements from a cell, same as GameBoard
+static const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+static const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+
+// Define the board shared by every version, one byte per cell
+struct Board {
+	int nCols = 0;
+	int nRows = 0;
+	std::vector<uint8_t> bombs;
+	std::vector<uint8_t> bombsSurrounding;
+	std::vector<uint8_t> revealed;
+	std::vector<uint8_t> frontier;
+	std::vector<int> floodStack;
+};
+
+static void CountNeighborsScalar(Board& board) {
+	for (int y = 0; y < board.nRows; y++) {
+		for (int x = 0; x < board.nCols; x++) {
+			int count = 0;
+			for (int k = 0; k < 8; k++) {
+				int nx = x + dx[k];
+				int ny = y + dy[k];
+				if (nx >= 0 && ny >= 0 && nx < board.nCols && ny < board.nRows) {
+					count += board.bombs[nx + ny * board.nCols];
+				}
+			}
+			board.bombsSurrounding[x + y * board.nCols] = static_cast<uint8_t>(count);
+		}
+	}
+}
+
+// Reveals like GameBoard::ClearEmpty: the cell, and every cell next to a revealed zero (the cells revealed
+// before are kept, and a fill doesn't go through them)
+static void RevealScalar(Board& board, int xStart, int yStart) {
+	if (board.revealed[xStart + yStart * board.nCols] || board.bombs[xStart + yStart * board.nCols]) {
+		return;
+	}
+	board.floodStack.clear();
+	board.revealed[xStart + yStart * board.nCols] = 1;
+	board.floodStack.push_back(xStart + yStart * board.nCols);
+	while (!board.floodStack.empty()) {
+		int index = board.floodStack.back();
+		board.floodStack.pop_back();
+		if (board.bombsSurrounding[index] != 0) {
+			continue;
+		}
+		int x = index % board.nCols;
+		int y = index / board.nCols;
+		for (int k = 0; k < 8; k++) {
+			int nx = x + dx[k];
+			int ny = y + dy[k];
+			int neighbor = nx + ny * board.nCols;
+			if (nx >= 0 && ny >= 0 && nx < board.nCols && ny < board.nRows && !board.revealed[neighbor] && !board.bombs[neighbor]) {
+				board.revealed[neighbor] = 1;
+				board.floodStack.push_back(neighbor);
+			}
+		}
+	}
+}
+
+static void FloodFillScalar(Board& board, int xStart, int yStart) {
+	std::fill(board.revealed.begin(), board.revealed.end(), 0);
+	RevealScalar(board, xStart, yStart);
+}
+
+static void FrontierScalar(Board& board) {
+	for (int y = 0; y < board.nRows; y++) {
+		for (int x = 0; x < board.nCols; x++) {
+			bool IsFrontier = false;
+			for (int k = 0; k < 8 && !board.revealed[x + y * board.nCols] && !IsFrontier; k++) {
+				int nx = x + dx[k];
+				int ny = y + dy[k];
+				IsFrontier = nx >= 0 && ny >= 0 && nx < board.nCols && ny < board.nRows && board.revealed[nx + ny * board.nCols];
+			}
+			board.frontier[x + y * board.nCols] = IsFrontier;
+		}
+	}
+}
+
+// Define the same data as bit planes
+struct BitBoards {
+	Bitboard bombs;
+	Bitboard safe;
+	Bitboard planes[4];
+	Bitboard zeros;
+	Bitboard start;
+	Bitboard region;
+	Bitboard revealed;
+	Bitboard covered;
+	Bitboard frontier;
+};
+
+static void CountNeighborsBitboard(BitBoards& boards) {
+	Bitboard::CountNeighbors(boards.bombs, boards.planes);
+}
+
+// The reveal is the connected zeros around the start cell, dilated once to add the numbers around them
+static void FloodFillBitboard(BitBoards& boards, int xStart, int yStart) {
+	boards.zeros = boards.safe;
+	for (int plane = 0; plane < 4; plane++) {
+		boards.zeros.AndNot(boards.planes[plane]);
+	}
+	boards.start.Clear();
+	boards.start.Set(xStart, yStart);
+	Bitboard::FloodFill(boards.start, boards.zeros, boards.region);
+	Bitboard::Dilate(boards.region, boards.revealed);
+	boards.revealed.And(boards.safe);
+	boards.revealed.Or(boards.start);
+}
+
+static void FrontierBitboard(BitBoards& boards) {
+	boards.covered = boards.revealed;
+	boards.covered.Invert();
+	Bitboard::Frontier(boards.covered, boards.revealed, boards.frontier);
+}
+
+// Runs an operation a number of times and returns the average time in milliseconds
+template <class Operation>
+static double TimeMs(int repetitions, Operation operation) {
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < repetitions; i++) {
+		operation();
+	}
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count() / repetitions;
+}
+
+static bool IsSameCounts(const Board& board, const BitBoards& boards) {
+	for (int y = 0; y < board.nRows; y++) {
+		for (int x = 0; x < board.nCols; x++) {
+			int count = boards.planes[0].Get(x, y) + 2 * boards.planes[1].Get(x, y) + 4 * boards.planes[2].Get(x, y) + 8 * boards.planes[3].Get(x, y);
+			if (count != board.bombsSurrounding[x + y * board.nCols]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Returns true if the game has cleared the cells that are revealed on the board
+static bool IsSameCleared(const Board& board, const GameBoard& game) {
+	for (int i = 0; i < game.GetCellCount(); i++) {
+		if ((game.GetVisibleState()[i] <= 8) != (board.revealed[i] != 0)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Plays more reveals on covered safe cells of the game (with an undo and a redo after some of them), the same
+// reveals on the board, and checks that they clear the same cells. Returns the time of the game's reveals in ms
+static double CheckReveals(Board& board, GameBoard& game, int revealCount, bool& IsCorrect) {
+
+	double revealMs = 0;
+	uint64_t state = 7;
+	for (int i = 0; i < revealCount && game.GetStatus() == GameBoard::Status::Playing; i++) {
+		int index = static_cast<int>(GameBoard::RandomBelow(state, game.GetCellCount()));
+		if (board.bombs[index] || board.revealed[index]) {
+			continue;
+		}
+		int x = index % board.nCols;
+		int y = index / board.nCols;
+
+		revealMs += TimeMs(1, [&] { game.Reveal(x, y); });
+		if (i % 4 == 0 && game.CanUndo()) {
+			game.Undo();
+			game.Redo();
+		}
+		RevealScalar(board, x, y);
+	}
+	IsCorrect &= IsSameCleared(board, game);
+	return revealMs;
+}
+
+static bool IsSame(const std::vector<uint8_t>& cells, const Bitboard& bits) {
+	for (int y = 0; y < bits.GetHeight(); y++) {
+		for (int x = 0; x < bits.GetWidth(); x++) {
+			if ((cells[x + y * bits.GetWidth()] != 0) != bits.Get(x, y)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 4096;
+	int nRows = argc > 2 ? atoi(argv[2]) : 4096;
+	int bombPercent = argc > 3 ? atoi(argv[3]) : 5;
+	int repetitions = argc > 4 ? atoi(argv[4]) : 5;
+
+	if (nCols < 3 || nRows < 3 || bombPercent < 1 || bombPercent > 80 || repetitions < 1) {
+		fprintf(stderr, "usage: %s [cols] [rows] [bomb percent 1-80] [repetitions]\n", argv[0]);
+		return 2;
+	}
+
+	// Play the first click of a GameBoard game in the middle of the board, and copy its bombs
+	int numberOfBombs = static_cast<int>(static_cast<int64_t>(nCols) * nRows * bombPercent / 100);
+	int xStart = nCols / 2;
+	int yStart = nRows / 2;
+	GameBoard game(nCols, nRows, numberOfBombs);
+	game.SetTrainingMode(true);
+	game.NewGame(2024);
+	double firstRevealMs = TimeMs(1, [&] { game.Reveal(xStart, yStart); });
+
+	Board board;
+	board.nCols = nCols;
+	board.nRows = nRows;
+	board.bombs.assign(game.GetCellCount(), 0);
+	board.bombsSurrounding.assign(game.GetCellCount(), 0);
+	board.revealed.assign(game.GetCellCount(), 0);
+	board.frontier.assign(game.GetCellCount(), 0);
+	board.floodStack.reserve(game.GetCellCount());
+
+	BitBoards boards;
+	boards.bombs.Resize(nCols, nRows);
+	boards.start.Resize(nCols, nRows);
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			if (game.IsBomb(x, y)) {
+				board.bombs[x + y * nCols] = 1;
+				boards.bombs.Set(x, y);
+			}
+		}
+	}
+	boards.safe = boards.bombs;
+	boards.safe.Invert();
+
+	// Time the cell at a time versions
+	double cells = static_cast<double>(nCols) * nRows;
+	double countScalar = TimeMs(repetitions, [&] { CountNeighborsScalar(board); });
+	double floodScalar = TimeMs(repetitions, [&] { FloodFillScalar(board, xStart, yStart); });
+	double frontierScalar = TimeMs(repetitions, [&] { FrontierScalar(board); });
+
+	// The scalar flood fill must match the game
+	std::vector<uint8_t> cleared(game.GetCellCount(), 0);
+	for (int i = 0; i < game.GetCellCount(); i++) {
+		cleared[i] = game.GetVisibleState()[i] <= 8;
+	}
+	bool IsCorrect = cleared == board.revealed;
+
+	printf("%dx%d board, %d bombs, first reveal opens %zu cells (%.2f ms in GameBoard, bombs placed)\n", nCols, nRows, numberOfBombs,
+		static_cast<size_t>(std::count(cleared.begin(), cleared.end(), 1)), firstRevealMs);
+	printf("%-16s count neighbors %8.2f ms (%6.2f ns/cell) | flood fill %8.2f ms | frontier %8.2f ms\n",
+		"cell at a time", countScalar, countScalar * 1e6 / cells, floodScalar, frontierScalar);
+
+	// Time the bitboard kernels, portable first, then AVX2 if the CPU has it
+	bool HasAvx2 = Bitboard::HasAvx2();
+	for (int pass = 0; pass < (HasAvx2 ? 2 : 1); pass++) {
+		Bitboard::SetUseAvx2(pass == 1);
+
+		double countBits = TimeMs(repetitions, [&] { CountNeighborsBitboard(boards); });
+		double floodBits = TimeMs(repetitions, [&] { FloodFillBitboard(boards, xStart, yStart); });
+		double frontierBits = TimeMs(repetitions, [&] { FrontierBitboard(boards); });
+
+		bool IsSameResult = IsSameCounts(board, boards) && IsSame(board.revealed, boards.revealed) && IsSame(board.frontier, boards.frontier);
+		IsCorrect &= IsSameResult;
+
+		printf("%-16s count neighbors %8.2f ms (%6.2f ns/cell) | flood fill %8.2f ms | frontier %8.2f ms | speedup %.1fx / %.1fx / %.1fx %s\n",
+			pass == 1 ? "bitboard avx2" : "bitboard 64 bit", countBits, countBits * 1e6 / cells, floodBits, frontierBits,
+			countScalar / countBits, floodScalar / floodBits, frontierScalar / frontierBits,
+			IsSameResult ? "(same results)" : "(RESULTS DIFFER)");
+	}
+
+	// Go on with the game, the later reveals must clear the same cells as the cell at a time flood fill
+	int revealCount = 1000;
+	bool IsSameReveals = true;
+	double revealMs = CheckReveals(board, game, revealCount, IsSameReveals);
+	IsCorrect &= IsSameReveals;
+	printf("%-16s %d more reveals (with undo and redo) %8.2f ms %s\n", "GameBoard", revealCount, revealMs,
+		IsSameReveals ? "(same cells)" : "(CELLS DIFFER)");
+
+	return IsCorrect ? 0 : 1;
+}
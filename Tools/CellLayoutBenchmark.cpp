@@ -0,0 +1,303 @@
+// Benchmark for the cell layouts (MinesweeperGUI/CellLayout.h) on a very large board: the same board is stored row
+// major and in tiled layouts of 8 x 8 and 16 x 16 blocks, and each layout runs the same workloads:
+//   - flood fill: the opening of a board with few mines, revealed from its center
+//   - solver pass: every revealed number checked against the covered cells and flags around it (a number that has
+//     as many flags around it, or as many flags and covered cells, decides the cells around it), run on row major
+//     strips (a tiled layout copies each block to rows first)
+//   - views: the revealed cells of views of the board at random places
+// The results of each tiled layout must be the ones of the row major layout, it fails if they aren't.
+//
+// usage: celllayoutbench [cols] [rows] [bombPermille] [views]
+
+#include "../MinesweeperGUI/CellLayout.h"
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the bits of a cell (the # of bombs around it is in the low bits). Places outside the board (the padding of
+// the last blocks, and the cells around the board) hold BorderCell: neither covered nor flagged, with no number
+enum CellBits : uint8_t {
+	CountMask = 15,
+	BombBit = 16,
+	RevealedBit = 32,
+	FlaggedBit = 64,
+	BorderCell = RevealedBit
+};
+
+// Define the size of the views read (the cells of a window at the smallest zoom)
+static const int viewCols = 140;
+static const int viewRows = 100;
+
+// Define the results of the workloads, compared between the layouts
+struct Results {
+	uint64_t revealed = 0;
+	uint64_t decided = 0;
+	uint64_t viewRevealed = 0;
+	double floodMilliseconds = 0;
+	double solverMilliseconds = 0;
+	double viewMilliseconds = 0;
+};
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Places the bombs from the position of each cell (so every layout gets the same board), flags some of them,
+// and counts the bombs around each cell
+template <class Layout>
+static void CreateBoard(const Layout& layout, std::vector<uint8_t>& cells, int bombPermille) {
+
+	int nCols = layout.GetCols();
+	int nRows = layout.GetRows();
+	cells.assign(layout.GetStorageSize(), BorderCell);
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			uint64_t random = GameBoard::RandomAt(1, x + static_cast<uint64_t>(y) * nCols);
+			bool IsBomb = static_cast<int>(random % 1000) < bombPermille;
+			bool IsFlagged = IsBomb && (random >> 32) % 4 == 0;
+			cells[layout.GetIndex(x, y)] = (IsBomb ? BombBit : 0) | (IsFlagged ? FlaggedBit : 0);
+		}
+	}
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			size_t index = layout.GetIndex(x, y);
+			for (int dy = -1; dy <= 1; dy++) {
+				for (int dx = -1; dx <= 1; dx++) {
+					bool IsOnBoard = x + dx >= 0 && y + dy >= 0 && x + dx < nCols && y + dy < nRows;
+					if ((dx != 0 || dy != 0) && IsOnBoard && (cells[layout.GetNeighbor(index, x, y, dx, dy)] & BombBit)) {
+						cells[index]++;
+					}
+				}
+			}
+		}
+	}
+}
+
+// Define a cell waiting in the flood fill's stack, with its place in the layout
+struct StackedCell {
+	int x;
+	int y;
+	size_t index;
+};
+
+// Reveals the opening around a cell (the cells with no bombs around them reveal their neighbors), returns the # of
+// cells revealed. The neighbors are found from the cell's place in the layout
+template <class Layout>
+static uint64_t FloodFill(const Layout& layout, std::vector<uint8_t>& cells, int startX, int startY) {
+
+	int nCols = layout.GetCols();
+	int nRows = layout.GetRows();
+	std::vector<StackedCell> stack;
+	stack.push_back({ startX, startY, layout.GetIndex(startX, startY) });
+	cells[stack.back().index] |= RevealedBit;
+	uint64_t revealed = 1;
+
+	while (!stack.empty()) {
+		StackedCell cell = stack.back();
+		stack.pop_back();
+		int x = cell.x;
+		int y = cell.y;
+
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				if (x + dx < 0 || y + dy < 0 || x + dx >= nCols || y + dy >= nRows) {
+					continue;
+				}
+				size_t neighborIndex = layout.GetNeighbor(cell.index, x, y, dx, dy);
+				uint8_t& neighbor = cells[neighborIndex];
+				if ((neighbor & (RevealedBit | BombBit | FlaggedBit)) == 0) {
+					neighbor |= RevealedBit;
+					revealed++;
+					if ((neighbor & CountMask) == 0) {
+						stack.push_back({ x + dx, y + dy, neighborIndex });
+					}
+				}
+			}
+		}
+	}
+	return revealed;
+}
+
+// Returns 1 if a revealed number decides the cells around it (cell points into row major cells, rowStride apart,
+// that have a cell or BorderCell all around it). Written without branches on the neighbors so the rows vectorize
+static inline int IsDecided(const uint8_t* cell, ptrdiff_t rowStride) {
+
+	const ptrdiff_t offsets[8] = { -rowStride - 1, -rowStride, -rowStride + 1, -1, 1, rowStride - 1, rowStride, rowStride + 1 };
+	int covered = 0;
+	int flags = 0;
+	for (ptrdiff_t offset : offsets) {
+		uint8_t neighbor = cell[offset];
+		covered += (neighbor & (RevealedBit | FlaggedBit)) == 0;
+		flags += (neighbor & FlaggedBit) != 0;
+	}
+	int number = *cell & CountMask;
+	return (*cell & RevealedBit) != 0 && number > 0 && covered > 0 && (number == flags || number == flags + covered);
+}
+
+// Runs the solver pass on row major cells: the inside of the board in place, and the edges from a copy of the rows
+// around them with BorderCell around the board
+static uint64_t SolverPass(const RowMajorLayout& layout, const std::vector<uint8_t>& cells) {
+
+	int nCols = layout.GetCols();
+	int nRows = layout.GetRows();
+	uint64_t decided = 0;
+	for (int y = 1; y < nRows - 1; y++) {
+		const uint8_t* row = &cells[layout.GetIndex(0, y)];
+		for (int x = 1; x < nCols - 1; x++) {
+			decided += IsDecided(row + x, nCols);
+		}
+	}
+
+	// The edge cells are copied with BorderCell around them, a strip of 3 rows at a time
+	size_t stride = static_cast<size_t>(nCols) + 2;
+	std::vector<uint8_t> strip(3 * stride);
+	auto RunOnEdges = [&](int y) {
+		std::fill(strip.begin(), strip.end(), BorderCell);
+		for (int j = 0; j < 3; j++) {
+			if (y - 1 + j >= 0 && y - 1 + j < nRows) {
+				std::copy_n(&cells[layout.GetIndex(0, y - 1 + j)], nCols, &strip[j * stride + 1]);
+			}
+		}
+		bool IsEdgeRow = y == 0 || y == nRows - 1;
+		for (int x = 0; x < nCols; x++) {
+			if (IsEdgeRow || x == 0 || x == nCols - 1) {
+				decided += IsDecided(&strip[stride + 1 + x], stride);
+			}
+		}
+	};
+	for (int y = 0; y < nRows; y++) {
+		RunOnEdges(y);
+	}
+	return decided;
+}
+
+// Runs the solver pass on a tiled layout a row of blocks at a time: the blocks are copied to rows, with the row of
+// cells above and below them from the blocks next to them (BorderCell off the board), and the row major kernel runs
+// on the rows. The padding of the last blocks holds BorderCell, so it is the edge of the board in the rows too
+template <int BlockShift>
+static uint64_t SolverPass(const TiledLayout<BlockShift>& layout, const std::vector<uint8_t>& cells) {
+
+	typedef TiledLayout<BlockShift> Layout;
+	const int side = Layout::BlockSide;
+	int blockCols = layout.GetBlockCols();
+	int blockRows = layout.GetBlockRows();
+	size_t stride = static_cast<size_t>(blockCols) * side + 2;
+	std::vector<uint8_t> rows((side + 2) * stride);
+	uint64_t decided = 0;
+
+	for (int blockY = 0; blockY < blockRows; blockY++) {
+		std::fill(rows.begin(), rows.end(), BorderCell);
+		for (int blockX = 0; blockX < blockCols; blockX++) {
+			size_t block = blockX + static_cast<size_t>(blockY) * blockCols;
+			uint8_t* blockStart = &rows[stride + 1 + static_cast<size_t>(blockX) * side];
+			Layout::CopyBlockToRows(cells.data(), block, blockStart, stride);
+			for (int i = 0; i < side; i++) {
+				if (blockY > 0) {
+					blockStart[i - stride] = cells[(block - blockCols) * Layout::BlockCells + Layout::Interleave(i, side - 1)];
+				}
+				if (blockY < blockRows - 1) {
+					blockStart[i + side * stride] = cells[(block + blockCols) * Layout::BlockCells + Layout::Interleave(i, 0)];
+				}
+			}
+		}
+		for (int j = 0; j < side; j++) {
+			const uint8_t* row = &rows[(j + 1) * stride + 1];
+			for (int x = 0; x < layout.GetCols(); x++) {
+				decided += IsDecided(row + x, stride);
+			}
+		}
+	}
+	return decided;
+}
+
+// Counts the revealed cells of views of the board at random places
+template <class Layout>
+static uint64_t ReadViews(const Layout& layout, const std::vector<uint8_t>& cells, int views) {
+
+	uint64_t state = 3;
+	uint64_t revealed = 0;
+	int cols = std::min(viewCols, layout.GetCols());
+	int rows = std::min(viewRows, layout.GetRows());
+	for (int view = 0; view < views; view++) {
+		int left = static_cast<int>(GameBoard::RandomBelow(state, layout.GetCols() - cols + 1));
+		int top = static_cast<int>(GameBoard::RandomBelow(state, layout.GetRows() - rows + 1));
+		for (int y = top; y < top + rows; y++) {
+			for (int x = left; x < left + cols; x++) {
+				revealed += (cells[layout.GetIndex(x, y)] & RevealedBit) != 0;
+			}
+		}
+	}
+	return revealed;
+}
+
+// Runs every workload on a layout (the board is made for it first, that isn't timed)
+template <class Layout>
+static Results RunLayout(const Layout& layout, int bombPermille, int views) {
+
+	Results results;
+	std::vector<uint8_t> cells;
+	CreateBoard(layout, cells, bombPermille);
+
+	// The opening starts at the first cell right of the center with no bombs around it
+	int startX = layout.GetCols() / 2;
+	int startY = layout.GetRows() / 2;
+	while (startX < layout.GetCols() - 1 && cells[layout.GetIndex(startX, startY)] != 0) {
+		startX++;
+	}
+
+	Clock::time_point start = Clock::now();
+	results.revealed = FloodFill(layout, cells, startX, startY);
+	results.floodMilliseconds = MillisecondsSince(start);
+
+	// The solver pass is run a few times, the fastest is kept
+	for (int run = 0; run < 3; run++) {
+		start = Clock::now();
+		results.decided = SolverPass(layout, cells);
+		double milliseconds = MillisecondsSince(start);
+		results.solverMilliseconds = run == 0 ? milliseconds : std::min(results.solverMilliseconds, milliseconds);
+	}
+
+	start = Clock::now();
+	results.viewRevealed = ReadViews(layout, cells, views);
+	results.viewMilliseconds = MillisecondsSince(start);
+	return results;
+}
+
+static void PrintResults(const char* name, const Results& results, const Results& rowMajor) {
+	printf("%-14s %10.1f ms %10.1f ms %10.1f ms   %5.2fx %5.2fx %5.2fx\n", name, results.floodMilliseconds, results.solverMilliseconds,
+		results.viewMilliseconds, rowMajor.floodMilliseconds / results.floodMilliseconds,
+		rowMajor.solverMilliseconds / results.solverMilliseconds, rowMajor.viewMilliseconds / results.viewMilliseconds);
+}
+
+static bool IsSameResults(const Results& results, const Results& rowMajor) {
+	return results.revealed == rowMajor.revealed && results.decided == rowMajor.decided && results.viewRevealed == rowMajor.viewRevealed;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 10000;
+	int nRows = argc > 2 ? atoi(argv[2]) : 10000;
+	int bombPermille = argc > 3 ? atoi(argv[3]) : 20;
+	int views = argc > 4 ? atoi(argv[4]) : 2000;
+
+	// Every layout sets up its own board, one at a time (a 10000 x 10000 board takes 100 MB)
+	Results rowMajor = RunLayout(RowMajorLayout(nCols, nRows), bombPermille, views);
+	Results tiled8 = RunLayout(TiledLayout<3>(nCols, nRows), bombPermille, views);
+	Results tiled16 = RunLayout(TiledLayout<4>(nCols, nRows), bombPermille, views);
+
+	printf("%dx%d board, %.1f%% bombs: %llu cells revealed by the opening, %llu numbers decide their cells\n", nCols, nRows, bombPermille / 10.0,
+		static_cast<unsigned long long>(rowMajor.revealed), static_cast<unsigned long long>(rowMajor.decided));
+	printf("%-14s %13s %13s %13s   %s\n", "layout", "flood fill", "solver pass", "views", "speedup over row major");
+	PrintResults("row major", rowMajor, rowMajor);
+	PrintResults("8x8 tiles", tiled8, rowMajor);
+	PrintResults("16x16 tiles", tiled16, rowMajor);
+
+	bool IsPassed = IsSameResults(tiled8, rowMajor) && IsSameResults(tiled16, rowMajor);
+	printf(IsPassed ? "every layout gives the same results\n" : "a tiled layout gives different results than row major\n");
+	return IsPassed ? 0 : 1;
+}
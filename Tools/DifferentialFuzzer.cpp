@@ -0,0 +1,851 @@
+// Differential fuzzer: plays random, seeded move sequences on a reference model of the game rules
+// (written cell at a time, the way the original MainFrame code was) and on the optimized engines
+// (GameBoard, and the PresetBoard engines for the preset grid sizes), and compares the boards after every move.
+// A failing game is shrunk to a short list of moves that still fails, and printed (and saved) as a replay.
+//
+// usage: fuzzer [--games N] [--seconds S] [--seed N] [--min-games-per-minute N] [--out file]
+//        fuzzer --replay file
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include "../MinesweeperGUI/PresetBoard.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define all possible single movements from a cell (the same order as the original code)
+static const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+static const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+
+// Define the moves a fuzzed game is made of (UndoRedo undoes and redoes the last move on engines that can)
+enum class MoveType : uint8_t {
+	Reveal,
+	Flag,
+	Chord,
+	UndoRedo
+};
+
+struct Move {
+	MoveType type;
+	int xPos;
+	int yPos;
+};
+
+// Define the engines that are compared against the reference model
+enum class EngineKind : uint8_t {
+	Generic,
+	Preset9x9,
+	Preset16x16,
+	Preset30x16
+};
+
+static const char* engineNames[] = { "generic", "preset9x9", "preset16x16", "preset30x16" };
+
+// Describes one fuzzed game, everything needed to replay it
+struct FuzzCase {
+	EngineKind engine = EngineKind::Generic;
+	int nCols = 0;
+	int nRows = 0;
+	int numberOfBombs = 0;
+	uint64_t seed = 0;
+	std::vector<Move> moves;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Reference model
+// ---------------------------------------------------------------------------------------------
+
+// Reference model of the rules, kept close to the original MainFrame code: a grid of cells with booleans,
+// a recursive flood fill, and a victory check that scans the whole grid. It follows the rules GameBoard
+// documents where the original depended on the UI: losing and winning end the game, the win is checked
+// after the first click too, and bombs are placed from the seed the same way as GameBoard::PlaceBombs
+class ReferenceBoard
+{
+public:
+
+	void NewGame(int nCols, int nRows, int numberOfBombs, uint64_t seed) {
+		this->nCols = nCols;
+		this->nRows = nRows;
+		this->numberOfBombs = numberOfBombs;
+		this->seed = seed;
+		buttons.assign(nCols, std::vector<Cell>(nRows));
+		status = GameBoard::Status::NotStarted;
+		numberFlagsPlaced = 0;
+		IsFirstButtonPress = true;
+		HasFlaggedBeforeFirstClick = false;
+	}
+
+	// Left click on a cell (OnButtonClicked)
+	void Reveal(int xPos, int yPos) {
+
+		if (IsGameOver()) {
+			return;
+		}
+
+		if (IsFirstButtonPress) {
+			OnFirstButtonPressed(xPos, yPos);
+			IsFirstButtonPress = false;
+			status = GameBoard::Status::Playing;
+			CheckForVictory();
+			return;
+		}
+
+		if (IsUnflaggedBomb(xPos, yPos)) {
+			status = GameBoard::Status::Lost;
+		}
+		else if (buttons[xPos][yPos].IsCleared) {
+			RevealSurroundingCells(xPos, yPos);
+		}
+		else if (!buttons[xPos][yPos].IsFlagged) {
+			int surroundingBombs = CountBombsSurrounding(xPos, yPos);
+			buttons[xPos][yPos].numMinesSurrounding = surroundingBombs;
+			if (surroundingBombs == 0) {
+				ClearEmpty(xPos, yPos);
+				CheckForVictory();
+			}
+			else {
+				LabelCell(xPos, yPos, surroundingBombs);
+				CheckForVictory();
+			}
+		}
+	}
+
+	// Right click on a cell (OnRightClick)
+	void Flag(int xPos, int yPos) {
+
+		if (IsGameOver()) {
+			return;
+		}
+
+		if (!buttons[xPos][yPos].IsCleared) {
+			SetFlag(xPos, yPos);
+			if (IsFirstButtonPress) {
+				HasFlaggedBeforeFirstClick = true;
+			}
+		}
+	}
+
+	// Chord on a revealed cell
+	void Chord(int xPos, int yPos) {
+		if (status == GameBoard::Status::Playing && buttons[xPos][yPos].IsCleared) {
+			RevealSurroundingCells(xPos, yPos);
+		}
+	}
+
+	// Builds the visible state the engines keep (covered, flagged, or the number of a cleared cell)
+	void GetVisibleState(std::vector<uint8_t>& visible) const {
+		visible.resize(static_cast<size_t>(nCols) * nRows);
+		for (int i = 0; i < nCols; i++) {
+			for (int j = 0; j < nRows; j++) {
+				const Cell& cell = buttons[i][j];
+				uint8_t value = GameBoard::Covered;
+				if (cell.IsCleared) {
+					value = static_cast<uint8_t>(cell.numMinesSurrounding);
+				}
+				else if (cell.IsFlagged) {
+					value = GameBoard::Flagged;
+				}
+				visible[i + j * nCols] = value;
+			}
+		}
+	}
+
+	// Define methods used to pick moves and check the engines
+	GameBoard::Status GetStatus() const { return status; }
+	int GetFlagsPlaced() const { return numberFlagsPlaced; }
+	bool IsCleared(int xPos, int yPos) const { return buttons[xPos][yPos].IsCleared; }
+	bool IsFlagged(int xPos, int yPos) const { return buttons[xPos][yPos].IsFlagged; }
+	bool IsBomb(int xPos, int yPos) const { return buttons[xPos][yPos].IsBomb; }
+	bool IsGameOver() const { return status == GameBoard::Status::Won || status == GameBoard::Status::Lost; }
+
+private:
+
+	struct Cell {
+		bool IsBomb = false;
+		bool IsCleared = false;
+		bool IsFlagged = false;
+		int numMinesSurrounding = 0;
+	};
+
+	bool IsInGridIndex(int xPos, int yPos) const {
+		return xPos >= 0 && yPos >= 0 && xPos < nCols && yPos < nRows;
+	}
+
+	bool IsUnflaggedBomb(int xPos, int yPos) const {
+		return buttons[xPos][yPos].IsBomb && !buttons[xPos][yPos].IsFlagged;
+	}
+
+	void OnFirstButtonPressed(int xPos, int yPos) {
+
+		// flags placed before the first click are removed (the original restarted the game)
+		if (HasFlaggedBeforeFirstClick) {
+			for (int i = 0; i < nCols; i++) {
+				for (int j = 0; j < nRows; j++) {
+					buttons[i][j].IsFlagged = false;
+				}
+			}
+			numberFlagsPlaced = 0;
+			HasFlaggedBeforeFirstClick = false;
+		}
+
+		// Save all coordinates outside of the 3x3 area around the first click, shuffle them, place the bombs
+		std::vector<std::pair<int, int>> possibleCoordinates;
+		for (int i = 0; i < nCols; i++) {
+			for (int j = 0; j < nRows; j++) {
+				if (i < xPos - 1 || i > xPos + 1 || j < yPos - 1 || j > yPos + 1) {
+					possibleCoordinates.push_back({ i, j });
+				}
+			}
+		}
+		uint64_t state = seed;
+		int bombsToPlace = std::min(numberOfBombs, static_cast<int>(possibleCoordinates.size()));
+		for (int i = 0; i < bombsToPlace; i++) {
+			int j = i + static_cast<int>(GameBoard::RandomBelow(state, possibleCoordinates.size() - i));
+			std::swap(possibleCoordinates[i], possibleCoordinates[j]);
+			buttons[possibleCoordinates[i].first][possibleCoordinates[i].second].IsBomb = true;
+		}
+
+		ClearEmpty(xPos, yPos);
+	}
+
+	void ClearEmpty(int xPos, int yPos) {
+
+		if (!IsInGridIndex(xPos, yPos) || buttons[xPos][yPos].IsBomb || buttons[xPos][yPos].IsCleared) {
+			return;
+		}
+
+		buttons[xPos][yPos].IsCleared = true;
+
+		int surroundingBombs = CountBombsSurrounding(xPos, yPos);
+		if (surroundingBombs == 0) {
+			for (int i = 0; i < 8; i++) {
+				ClearEmpty(xPos + dx[i], yPos + dy[i]);
+			}
+		}
+		else {
+			LabelCell(xPos, yPos, surroundingBombs);
+		}
+	}
+
+	void LabelCell(int xPos, int yPos, int surroundingBombs) {
+		buttons[xPos][yPos].IsCleared = true;
+		buttons[xPos][yPos].numMinesSurrounding = surroundingBombs;
+	}
+
+	void SetFlag(int xPos, int yPos) {
+		buttons[xPos][yPos].IsFlagged = !buttons[xPos][yPos].IsFlagged;
+		numberFlagsPlaced += buttons[xPos][yPos].IsFlagged ? 1 : -1;
+	}
+
+	void RevealSurroundingCells(int xPos, int yPos) {
+		if (CountFlagsSurrounding(xPos, yPos) == buttons[xPos][yPos].numMinesSurrounding) {
+			ClearSurroundingCells(xPos, yPos);
+		}
+	}
+
+	void ClearSurroundingCells(int xPos, int yPos) {
+		for (int i = 0; i < 8; i++) {
+			int newX = xPos + dx[i];
+			int newY = yPos + dy[i];
+			if (!IsInGridIndex(newX, newY)) {
+				continue;
+			}
+
+			if (IsUnflaggedBomb(newX, newY)) {
+				status = GameBoard::Status::Lost;
+				return;
+			}
+			else if (!buttons[newX][newY].IsFlagged) {
+				int surroundingBombs = CountBombsSurrounding(newX, newY);
+				buttons[newX][newY].numMinesSurrounding = surroundingBombs;
+				if (surroundingBombs == 0) {
+					ClearEmpty(newX, newY);
+				}
+				else {
+					LabelCell(newX, newY, surroundingBombs);
+				}
+				if (CheckForVictory()) {
+					return;
+				}
+			}
+		}
+	}
+
+	int CountBombsSurrounding(int xPos, int yPos) const {
+		int count = 0;
+		for (int i = 0; i < 8; i++) {
+			if (IsInGridIndex(xPos + dx[i], yPos + dy[i]) && buttons[xPos + dx[i]][yPos + dy[i]].IsBomb) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	int CountFlagsSurrounding(int xPos, int yPos) const {
+		int count = 0;
+		for (int i = 0; i < 8; i++) {
+			if (IsInGridIndex(xPos + dx[i], yPos + dy[i]) && buttons[xPos + dx[i]][yPos + dy[i]].IsFlagged) {
+				count++;
+			}
+		}
+		return count;
+	}
+
+	bool IsGridCleared() const {
+		for (int i = 0; i < nCols; i++) {
+			for (int j = 0; j < nRows; j++) {
+				if (!buttons[i][j].IsCleared && !buttons[i][j].IsBomb) {
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	bool CheckForVictory() {
+		if (IsGridCleared()) {
+			status = GameBoard::Status::Won;
+			return true;
+		}
+		return false;
+	}
+
+	int nCols = 0;
+	int nRows = 0;
+	int numberOfBombs = 0;
+	uint64_t seed = 0;
+	std::vector<std::vector<Cell>> buttons;
+	GameBoard::Status status = GameBoard::Status::NotStarted;
+	int numberFlagsPlaced = 0;
+	bool IsFirstButtonPress = true;
+	bool HasFlaggedBeforeFirstClick = false;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Engines under test
+// ---------------------------------------------------------------------------------------------
+
+// Gives the fuzzer the same view of every engine
+class TestEngine
+{
+public:
+	virtual ~TestEngine() {}
+	virtual void NewGame(int nCols, int nRows, int numberOfBombs, uint64_t seed) = 0;
+	virtual bool Reveal(int xPos, int yPos) = 0;
+	virtual bool Flag(int xPos, int yPos) = 0;
+	virtual bool Chord(int xPos, int yPos) = 0;
+	virtual bool CanUndo() const { return false; }
+	virtual bool Undo() { return false; }
+	virtual bool Redo() { return false; }
+	virtual bool HasUndo() const { return false; }
+	virtual const uint8_t* GetVisibleState() const = 0;
+	virtual GameBoard::Status GetStatus() const = 0;
+	virtual int GetFlagsPlaced() const = 0;
+
+	// Applies the changes reported by the last move to a copy of the visible state
+	virtual void ApplyChanges(std::vector<uint8_t>& mirror) const = 0;
+};
+
+// GameBoard is run in training mode, so its undo history is checked as well
+class GameBoardEngine : public TestEngine
+{
+public:
+	GameBoardEngine() { board.SetTrainingMode(true); }
+	void NewGame(int nCols, int nRows, int numberOfBombs, uint64_t seed) override {
+		if (board.GetCols() != nCols || board.GetRows() != nRows || board.GetNumberOfBombs() != numberOfBombs) {
+			board.Resize(nCols, nRows, numberOfBombs);
+		}
+		board.NewGame(seed);
+	}
+	bool Reveal(int xPos, int yPos) override { return board.Reveal(xPos, yPos); }
+	bool Flag(int xPos, int yPos) override { return board.ToggleFlag(xPos, yPos); }
+	bool Chord(int xPos, int yPos) override { return board.Chord(xPos, yPos); }
+	bool CanUndo() const override { return board.CanUndo(); }
+	bool Undo() override { return board.Undo(); }
+	bool Redo() override { return board.Redo(); }
+	bool HasUndo() const override { return true; }
+	const uint8_t* GetVisibleState() const override { return board.GetVisibleState(); }
+	GameBoard::Status GetStatus() const override { return board.GetStatus(); }
+	int GetFlagsPlaced() const override { return board.GetFlagsPlaced(); }
+	void ApplyChanges(std::vector<uint8_t>& mirror) const override {
+		for (const GameBoard::CellChange& change : board.GetChanges()) {
+			mirror[change.index] = change.visible;
+		}
+	}
+private:
+	GameBoard board;
+};
+
+template <class Preset>
+class PresetEngine : public TestEngine
+{
+public:
+	PresetEngine() : board(new Preset()) {}
+	void NewGame(int, int, int, uint64_t seed) override { board->NewGame(seed); }
+	bool Reveal(int xPos, int yPos) override { return board->Reveal(xPos, yPos); }
+	bool Flag(int xPos, int yPos) override { return board->ToggleFlag(xPos, yPos); }
+	bool Chord(int xPos, int yPos) override { return board->Chord(xPos, yPos); }
+	const uint8_t* GetVisibleState() const override { return board->GetVisibleState(); }
+	GameBoard::Status GetStatus() const override { return board->GetStatus(); }
+	int GetFlagsPlaced() const override { return board->GetFlagsPlaced(); }
+	void ApplyChanges(std::vector<uint8_t>& mirror) const override {
+		for (int i = 0; i < board->GetChangeCount(); i++) {
+			mirror[board->GetChanges()[i].index] = board->GetChanges()[i].visible;
+		}
+	}
+private:
+	std::unique_ptr<Preset> board;
+};
+
+// ---------------------------------------------------------------------------------------------
+// Playing and checking games
+// ---------------------------------------------------------------------------------------------
+
+// Define everything used to play one case (reused between games so the fuzzer doesn't allocate per game)
+struct Fuzzer {
+	ReferenceBoard reference;
+	std::unique_ptr<TestEngine> engines[4];
+	std::vector<uint8_t> expected;
+	std::vector<uint8_t> previousExpected;
+	std::vector<uint8_t> beforeMove;
+	std::vector<uint8_t> mirror;
+	GameBoard::Status previousStatus = GameBoard::Status::NotStarted;
+	int previousFlags = 0;
+	bool HasUndoSnapshot = false;
+	std::string difference;
+	uint64_t gamesWon = 0;
+	uint64_t gamesLost = 0;
+
+	Fuzzer() {
+		engines[0].reset(new GameBoardEngine());
+		engines[1].reset(new PresetEngine<PresetBoard9x9>());
+		engines[2].reset(new PresetEngine<PresetBoard16x16>());
+		engines[3].reset(new PresetEngine<PresetBoard30x16>());
+	}
+};
+
+static const char* StatusName(GameBoard::Status status) {
+	static const char* names[] = { "NotStarted", "Playing", "Won", "Lost" };
+	return names[static_cast<int>(status)];
+}
+
+// Compares an engine's board with the expected visible state, status and # of flags
+static bool IsSameBoard(Fuzzer& fuzzer, TestEngine& engine, const std::vector<uint8_t>& expected, GameBoard::Status status, int flags, const char* when) {
+
+	const uint8_t* visible = engine.GetVisibleState();
+	for (size_t i = 0; i < expected.size(); i++) {
+		if (visible[i] != expected[i]) {
+			fuzzer.difference = std::string(when) + ": cell " + std::to_string(i) + " is " + std::to_string(visible[i]) + ", expected " + std::to_string(expected[i]);
+			return false;
+		}
+		if (fuzzer.mirror[i] != visible[i]) {
+			fuzzer.difference = std::string(when) + ": the changes reported for cell " + std::to_string(i) + " don't match its visible state";
+			return false;
+		}
+	}
+	if (engine.GetStatus() != status) {
+		fuzzer.difference = std::string(when) + ": status is " + StatusName(engine.GetStatus()) + ", expected " + StatusName(status);
+		return false;
+	}
+	if (engine.GetFlagsPlaced() != flags) {
+		fuzzer.difference = std::string(when) + ": " + std::to_string(engine.GetFlagsPlaced()) + " flags placed, expected " + std::to_string(flags);
+		return false;
+	}
+	return true;
+}
+
+// Plays a move on the reference model and the engine, returns false if they differ afterwards
+static bool PlayMove(Fuzzer& fuzzer, TestEngine& engine, const Move& move) {
+
+	ReferenceBoard& reference = fuzzer.reference;
+	char when[64];
+	const char* typeNames = "RFCU";
+	snprintf(when, sizeof(when), "after %c %d %d", typeNames[static_cast<int>(move.type)], move.xPos, move.yPos);
+
+	// Undo and redo the last move, the engine must go back to the board before it and then return
+	if (move.type == MoveType::UndoRedo) {
+		if (!engine.HasUndo()) {
+			return true;
+		}
+		if (engine.CanUndo() != fuzzer.HasUndoSnapshot) {
+			fuzzer.difference = std::string(when) + ": CanUndo is " + (engine.CanUndo() ? "true" : "false");
+			return false;
+		}
+		if (!fuzzer.HasUndoSnapshot) {
+			return true;
+		}
+		engine.Undo();
+		engine.ApplyChanges(fuzzer.mirror);
+		if (!IsSameBoard(fuzzer, engine, fuzzer.previousExpected, fuzzer.previousStatus, fuzzer.previousFlags, "after undo")) {
+			return false;
+		}
+		engine.Redo();
+		engine.ApplyChanges(fuzzer.mirror);
+		return IsSameBoard(fuzzer, engine, fuzzer.expected, reference.GetStatus(), reference.GetFlagsPlaced(), "after redo");
+	}
+
+	GameBoard::Status statusBefore = reference.GetStatus();
+	int flagsBefore = reference.GetFlagsPlaced();
+	fuzzer.beforeMove.swap(fuzzer.expected);
+
+	bool IsChanged = false;
+	if (move.type == MoveType::Reveal) {
+		reference.Reveal(move.xPos, move.yPos);
+		IsChanged = engine.Reveal(move.xPos, move.yPos);
+	}
+	else if (move.type == MoveType::Flag) {
+		reference.Flag(move.xPos, move.yPos);
+		IsChanged = engine.Flag(move.xPos, move.yPos);
+	}
+	else {
+		reference.Chord(move.xPos, move.yPos);
+		IsChanged = engine.Chord(move.xPos, move.yPos);
+	}
+	engine.ApplyChanges(fuzzer.mirror);
+	reference.GetVisibleState(fuzzer.expected);
+
+	// The engine must report a change exactly when the reference board changed
+	bool IsReferenceChanged = fuzzer.expected != fuzzer.beforeMove || reference.GetStatus() != statusBefore;
+	if (IsChanged != IsReferenceChanged) {
+		fuzzer.difference = std::string(when) + ": the engine returned " + (IsChanged ? "true" : "false") + " but the board " + (IsReferenceChanged ? "changed" : "didn't change");
+		return false;
+	}
+
+	// Remember the board before the last move that changed it (the first reveal can't be undone)
+	if (IsReferenceChanged) {
+		fuzzer.previousExpected.swap(fuzzer.beforeMove);
+		fuzzer.HasUndoSnapshot = statusBefore != GameBoard::Status::NotStarted;
+		fuzzer.previousStatus = statusBefore;
+		fuzzer.previousFlags = flagsBefore;
+	}
+
+	return IsSameBoard(fuzzer, engine, fuzzer.expected, reference.GetStatus(), reference.GetFlagsPlaced(), when);
+}
+
+static void StartCase(Fuzzer& fuzzer, TestEngine& engine, const FuzzCase& fuzzCase) {
+	fuzzer.reference.NewGame(fuzzCase.nCols, fuzzCase.nRows, fuzzCase.numberOfBombs, fuzzCase.seed);
+	engine.NewGame(fuzzCase.nCols, fuzzCase.nRows, fuzzCase.numberOfBombs, fuzzCase.seed);
+	fuzzer.reference.GetVisibleState(fuzzer.expected);
+	fuzzer.previousExpected = fuzzer.expected;
+	fuzzer.mirror = fuzzer.expected;
+	fuzzer.HasUndoSnapshot = false;
+}
+
+// Replays a case, returns true if it fails
+static bool Fails(Fuzzer& fuzzer, const FuzzCase& fuzzCase) {
+	TestEngine& engine = *fuzzer.engines[static_cast<int>(fuzzCase.engine)];
+	StartCase(fuzzer, engine, fuzzCase);
+	for (const Move& move : fuzzCase.moves) {
+		if (!PlayMove(fuzzer, engine, move)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Picks a random cell, trying a few times to find one that matches the condition
+template <class Condition>
+static bool PickCell(uint64_t& state, const FuzzCase& fuzzCase, Condition condition, int& xPos, int& yPos) {
+	for (int attempt = 0; attempt < 16; attempt++) {
+		xPos = static_cast<int>(GameBoard::RandomBelow(state, fuzzCase.nCols));
+		yPos = static_cast<int>(GameBoard::RandomBelow(state, fuzzCase.nRows));
+		if (condition(xPos, yPos)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// Picks the next move from the reference board, biased toward the interesting cases: flags next to
+// revealed numbers (often wrong), chords, and flags before the first click. Most reveals are of safe cells
+// (the reference knows where the bombs are) so games last long enough to be won
+static Move ChooseMove(uint64_t& state, const FuzzCase& fuzzCase, const ReferenceBoard& reference) {
+
+	Move move = { MoveType::Reveal, 0, 0 };
+	int roll = static_cast<int>(GameBoard::RandomBelow(state, 100));
+
+	auto IsCovered = [&](int x, int y) { return !reference.IsCleared(x, y); };
+	auto IsCleared = [&](int x, int y) { return reference.IsCleared(x, y); };
+	auto IsSafe = [&](int x, int y) { return !reference.IsCleared(x, y) && !reference.IsBomb(x, y); };
+	auto IsNextToCleared = [&](int x, int y) {
+		if (reference.IsCleared(x, y)) {
+			return false;
+		}
+		for (int i = 0; i < 8; i++) {
+			int newX = x + dx[i];
+			int newY = y + dy[i];
+			if (newX >= 0 && newY >= 0 && newX < fuzzCase.nCols && newY < fuzzCase.nRows && reference.IsCleared(newX, newY)) {
+				return true;
+			}
+		}
+		return false;
+	};
+
+	if (reference.GetStatus() == GameBoard::Status::NotStarted) {
+		move.type = roll < 20 ? MoveType::Flag : MoveType::Reveal;
+		PickCell(state, fuzzCase, IsCovered, move.xPos, move.yPos);
+	}
+	else if (roll < 8) {
+		move.type = MoveType::UndoRedo;
+	}
+	else if (roll < 20) {
+		move.type = MoveType::Flag;
+		PickCell(state, fuzzCase, IsCovered, move.xPos, move.yPos);
+	}
+	else if (roll < 40) {
+		move.type = MoveType::Flag;
+		PickCell(state, fuzzCase, IsNextToCleared, move.xPos, move.yPos);
+	}
+	else if (roll < 60) {
+		move.type = roll < 50 ? MoveType::Chord : MoveType::Reveal;
+		PickCell(state, fuzzCase, IsCleared, move.xPos, move.yPos);
+	}
+	else {
+		move.type = MoveType::Reveal;
+		if (roll < 90) {
+			PickCell(state, fuzzCase, IsSafe, move.xPos, move.yPos);
+		}
+		else {
+			PickCell(state, fuzzCase, IsCovered, move.xPos, move.yPos);
+		}
+	}
+
+	return move;
+}
+
+// Creates a random case: a random engine, board size and # of bombs
+static FuzzCase CreateCase(uint64_t caseSeed) {
+
+	FuzzCase fuzzCase;
+	uint64_t state = caseSeed;
+	fuzzCase.engine = static_cast<EngineKind>(GameBoard::RandomBelow(state, 4));
+	fuzzCase.seed = GameBoard::NextRandom(state);
+
+	if (fuzzCase.engine == EngineKind::Preset9x9) {
+		fuzzCase.nCols = PresetBoard9x9::Cols, fuzzCase.nRows = PresetBoard9x9::Rows, fuzzCase.numberOfBombs = PresetBoard9x9::Bombs;
+	}
+	else if (fuzzCase.engine == EngineKind::Preset16x16) {
+		fuzzCase.nCols = PresetBoard16x16::Cols, fuzzCase.nRows = PresetBoard16x16::Rows, fuzzCase.numberOfBombs = PresetBoard16x16::Bombs;
+	}
+	else if (fuzzCase.engine == EngineKind::Preset30x16) {
+		fuzzCase.nCols = PresetBoard30x16::Cols, fuzzCase.nRows = PresetBoard30x16::Rows, fuzzCase.numberOfBombs = PresetBoard30x16::Bombs;
+	}
+	else {
+		// Mostly small boards (the edges matter most), sometimes up to 40x40, with 0 bombs up to nearly full
+		int maxSize = GameBoard::RandomBelow(state, 4) == 0 ? 40 : 10;
+		fuzzCase.nCols = 3 + static_cast<int>(GameBoard::RandomBelow(state, maxSize - 2));
+		fuzzCase.nRows = 3 + static_cast<int>(GameBoard::RandomBelow(state, maxSize - 2));
+		int maxBombs = fuzzCase.nCols * fuzzCase.nRows - 10;
+		fuzzCase.numberOfBombs = maxBombs > 0 ? static_cast<int>(GameBoard::RandomBelow(state, maxBombs + 1)) : 0;
+	}
+
+	return fuzzCase;
+}
+
+// Plays a new random game, choosing each move from the reference board. Returns false (with the moves
+// played so far in the case) if the engine differs from the reference
+static bool FuzzGame(Fuzzer& fuzzer, uint64_t caseSeed, FuzzCase& fuzzCase, uint64_t& moveCount) {
+
+	fuzzCase = CreateCase(caseSeed);
+	TestEngine& engine = *fuzzer.engines[static_cast<int>(fuzzCase.engine)];
+	StartCase(fuzzer, engine, fuzzCase);
+
+	uint64_t state = caseSeed ^ 0x5DEECE66Dull;
+	int maxMoves = 4 * fuzzCase.nCols * fuzzCase.nRows;
+	for (int i = 0; i < maxMoves && !fuzzer.reference.IsGameOver(); i++) {
+		fuzzCase.moves.push_back(ChooseMove(state, fuzzCase, fuzzer.reference));
+		moveCount++;
+		if (!PlayMove(fuzzer, engine, fuzzCase.moves.back())) {
+			return false;
+		}
+	}
+
+	fuzzer.gamesWon += fuzzer.reference.GetStatus() == GameBoard::Status::Won;
+	fuzzer.gamesLost += fuzzer.reference.GetStatus() == GameBoard::Status::Lost;
+
+	// Undo and redo the last move of the game (the loss or the win) too
+	fuzzCase.moves.push_back({ MoveType::UndoRedo, 0, 0 });
+	return PlayMove(fuzzer, engine, fuzzCase.moves.back());
+}
+
+// Removes moves from a failing case while it keeps failing: chunks of half the moves first, then smaller chunks
+static FuzzCase Shrink(Fuzzer& fuzzer, FuzzCase failing) {
+
+	for (size_t chunk = failing.moves.size() / 2; chunk >= 1; chunk /= 2) {
+		size_t start = 0;
+		while (start < failing.moves.size()) {
+			FuzzCase candidate = failing;
+			size_t end = std::min(start + chunk, candidate.moves.size());
+			candidate.moves.erase(candidate.moves.begin() + start, candidate.moves.begin() + end);
+			if (Fails(fuzzer, candidate)) {
+				failing = candidate;
+			}
+			else {
+				start += chunk;
+			}
+		}
+	}
+
+	// Run it once more so the difference describes the shrunk case
+	Fails(fuzzer, failing);
+	return failing;
+}
+
+// ---------------------------------------------------------------------------------------------
+// Replay files
+// ---------------------------------------------------------------------------------------------
+
+static std::string FormatReplay(const FuzzCase& fuzzCase) {
+	std::ostringstream text;
+	text << "engine " << engineNames[static_cast<int>(fuzzCase.engine)] << "\n";
+	text << "board " << fuzzCase.nCols << " " << fuzzCase.nRows << " " << fuzzCase.numberOfBombs << "\n";
+	text << "seed " << fuzzCase.seed << "\n";
+	for (const Move& move : fuzzCase.moves) {
+		text << "RFCU"[static_cast<int>(move.type)] << " " << move.xPos << " " << move.yPos << "\n";
+	}
+	return text.str();
+}
+
+static bool ParseReplay(const char* path, FuzzCase& fuzzCase) {
+
+	std::ifstream file(path);
+	if (!file) {
+		return false;
+	}
+
+	std::string word;
+	while (file >> word) {
+		if (word == "engine") {
+			std::string name;
+			file >> name;
+			for (int i = 0; i < 4; i++) {
+				if (name == engineNames[i]) {
+					fuzzCase.engine = static_cast<EngineKind>(i);
+				}
+			}
+		}
+		else if (word == "board") {
+			file >> fuzzCase.nCols >> fuzzCase.nRows >> fuzzCase.numberOfBombs;
+		}
+		else if (word == "seed") {
+			file >> fuzzCase.seed;
+		}
+		else if (word.size() == 1 && strchr("RFCU", word[0]) != nullptr) {
+			Move move = { static_cast<MoveType>(strchr("RFCU", word[0]) - "RFCU"), 0, 0 };
+			file >> move.xPos >> move.yPos;
+			if (move.xPos < 0 || move.yPos < 0 || move.xPos >= fuzzCase.nCols || move.yPos >= fuzzCase.nRows) {
+				return false;
+			}
+			fuzzCase.moves.push_back(move);
+		}
+		else {
+			return false;
+		}
+	}
+	return fuzzCase.nCols >= 3 && fuzzCase.nRows >= 3;
+}
+
+int main(int argc, char** argv) {
+
+	uint64_t games = 0;
+	double seconds = 0;
+	uint64_t seed = 1;
+	double minGamesPerMinute = 100000;
+	const char* replayPath = nullptr;
+	const char* outPath = "fuzz-failure.txt";
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--games") == 0 && i + 1 < argc) {
+			games = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+			seconds = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			seed = strtoull(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--min-games-per-minute") == 0 && i + 1 < argc) {
+			minGamesPerMinute = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			replayPath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+			outPath = argv[++i];
+		}
+		else {
+			fprintf(stderr, "usage: %s [--games N] [--seconds S] [--seed N] [--min-games-per-minute N] [--out file] | --replay file\n", argv[0]);
+			return 2;
+		}
+	}
+	if (games == 0 && seconds == 0) {
+		games = 100000;
+	}
+
+	Fuzzer fuzzer;
+
+	// Replay a saved case
+	if (replayPath != nullptr) {
+		FuzzCase fuzzCase;
+		if (!ParseReplay(replayPath, fuzzCase)) {
+			fprintf(stderr, "could not read replay %s\n", replayPath);
+			return 2;
+		}
+		if (Fails(fuzzer, fuzzCase)) {
+			printf("FAIL (%s, %zu moves): %s\n", engineNames[static_cast<int>(fuzzCase.engine)], fuzzCase.moves.size(), fuzzer.difference.c_str());
+			return 1;
+		}
+		printf("PASS (%s, %zu moves)\n", engineNames[static_cast<int>(fuzzCase.engine)], fuzzCase.moves.size());
+		return 0;
+	}
+
+	// Fuzz new games until the game count or the time limit is reached
+	uint64_t state = seed;
+	uint64_t gamesPlayed = 0;
+	uint64_t moveCount = 0;
+	Clock::time_point start = Clock::now();
+	FuzzCase fuzzCase;
+
+	while (true) {
+		double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+		if ((games != 0 && gamesPlayed >= games) || (seconds != 0 && elapsed >= seconds)) {
+			break;
+		}
+
+		uint64_t caseSeed = GameBoard::NextRandom(state);
+		if (!FuzzGame(fuzzer, caseSeed, fuzzCase, moveCount)) {
+			printf("FAIL in game %llu (%s %dx%d, %d bombs): %s\n", static_cast<unsigned long long>(gamesPlayed),
+				engineNames[static_cast<int>(fuzzCase.engine)], fuzzCase.nCols, fuzzCase.nRows, fuzzCase.numberOfBombs, fuzzer.difference.c_str());
+
+			size_t originalMoves = fuzzCase.moves.size();
+			FuzzCase shrunk = Shrink(fuzzer, fuzzCase);
+			std::string replay = FormatReplay(shrunk);
+			printf("shrunk from %zu to %zu moves: %s\n%s", originalMoves, shrunk.moves.size(), fuzzer.difference.c_str(), replay.c_str());
+
+			std::ofstream out(outPath);
+			out << replay;
+			printf("replay saved to %s (run with --replay %s)\n", outPath, outPath);
+			return 1;
+		}
+		gamesPlayed++;
+	}
+
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+	double gamesPerMinute = gamesPlayed * 60.0 / elapsed;
+	printf("%llu games (%llu won, %llu lost), %llu moves in %.2f s: %.0f games/min, %.0f moves/s, no differences\n",
+		static_cast<unsigned long long>(gamesPlayed), static_cast<unsigned long long>(fuzzer.gamesWon), static_cast<unsigned long long>(fuzzer.gamesLost),
+		static_cast<unsigned long long>(moveCount), elapsed, gamesPerMinute, moveCount / elapsed);
+
+	if (gamesPerMinute < minGamesPerMinute) {
+		printf("FAIL: below the target of %.0f games/min\n", minGamesPerMinute);
+		return 1;
+	}
+	return 0;
+}
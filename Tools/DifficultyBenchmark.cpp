@@ -0,0 +1,188 @@
+// Benchmark and check for the difficulty profiler (MinesweeperGUI/DifficultyProfiler.h): profiles seeded boards of
+// the preset sizes on every shape on the profiler's pool, and reports their 3BV, openings, forced guesses and longest
+// chains, and the boards that need no guess (the boards a generator would keep when guessing isn't wanted) and the
+// hardest ones. Then times the profile of one board of growing sizes, which has to be done before a second click, and
+// the boards profiled per second by the pool against one thread. It checks that:
+//   - the solver clears every board (a wrong move proven by the solver would lose it, or leave no safe cell to guess)
+//   - the pool gives the same profiles as one thread
+//   - the 3BV is the one of the board the game places (GameBoard::Count3BV after the same first reveal)
+//   - a toroidal board smaller than 3 x 3 gets the profile of the same board set up as standard (it is played as one)
+// It fails if any of them doesn't hold.
+//
+// usage: difficultybench [boards] [threads]
+
+#include "../MinesweeperGUI/DifficultyProfiler.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const topologyNames[] = { "standard", "toroidal", "hexagonal", "knight" };
+static const TopologyType topologies[] = { TopologyType::Standard, TopologyType::Toroidal, TopologyType::Hexagonal, TopologyType::Knight };
+
+// Define the presets of the main menu, and the sizes the single profiles are timed on
+struct ProfiledBoard {
+	const char* name;
+	int nCols;
+	int nRows;
+	int numberOfBombs;
+};
+static const ProfiledBoard presets[] = { { "9x9", 9, 9, 15 }, { "16x16", 16, 16, 50 }, { "30x16", 30, 16, 100 } };
+static const ProfiledBoard timedBoards[] = { { "30x16", 30, 16, 100 }, { "100x100", 100, 100, 2000 }, { "300x300", 300, 300, 18000 },
+	{ "512x512", 512, 512, 512 * 512 / 5 } };
+
+// Define the time a player takes to make a second click (after the first reveal has been drawn)
+static const double secondClickMilliseconds = 300;
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+static BoardSetup MakeSetup(const ProfiledBoard& board, TopologyType topology, uint64_t seed) {
+	BoardSetup setup;
+	setup.nCols = board.nCols;
+	setup.nRows = board.nRows;
+	setup.numberOfBombs = board.numberOfBombs;
+	setup.topology = topology;
+	setup.seed = seed;
+	setup.firstX = board.nCols / 2;
+	setup.firstY = board.nRows / 2;
+	return setup;
+}
+
+static bool IsSameProfile(const BoardProfile& first, const BoardProfile& second) {
+	return first.bbbv == second.bbbv && first.openings == second.openings && first.forcedGuesses == second.forcedGuesses &&
+		first.longestChain == second.longestChain && first.IsProfiled == second.IsProfiled;
+}
+
+// Profiles the boards of a preset on one shape and prints what they are like, returns the # of failed checks
+static int ProfilePreset(DifficultyProfiler& profiler, const ProfiledBoard& preset, TopologyType topology, int boardCount) {
+
+	BoardSetup setup = MakeSetup(preset, topology, 1);
+	std::vector<BoardProfile> profiles;
+	profiler.ProfileSeeds(setup, boardCount, profiles);
+
+	int failures = 0;
+	long long bbbv = 0;
+	long long openings = 0;
+	long long guesses = 0;
+	int longestChain = 0;
+	int noGuessBoards = 0;
+	for (int i = 0; i < boardCount; i++) {
+		const BoardProfile& profile = profiles[i];
+		if (!profile.IsProfiled) {
+			if (failures++ == 0) {
+				printf("%s %s seed %d: the solver didn't clear the board\n", preset.name, topologyNames[static_cast<int>(topology)], i + 1);
+			}
+			continue;
+		}
+		bbbv += profile.bbbv;
+		openings += profile.openings;
+		guesses += profile.forcedGuesses;
+		longestChain = std::max(longestChain, profile.longestChain);
+		noGuessBoards += profile.forcedGuesses == 0;
+	}
+
+	// The first boards are profiled again on this thread, and placed by a game to check their 3BV
+	for (int i = 0; i < std::min(boardCount, 200); i++) {
+		BoardSetup seedSetup = setup;
+		seedSetup.seed = setup.seed + i;
+		if (!IsSameProfile(DifficultyProfiler::Profile(seedSetup), profiles[i])) {
+			if (failures++ == 0) {
+				printf("%s %s seed %d: the pool and one thread give different profiles\n", preset.name, topologyNames[static_cast<int>(topology)], i + 1);
+			}
+		}
+		GameBoard board(preset.nCols, preset.nRows, preset.numberOfBombs);
+		board.SetTopology(topology);
+		board.NewGame(seedSetup.seed);
+		board.Reveal(seedSetup.firstX, seedSetup.firstY);
+		if (board.Count3BV() != profiles[i].bbbv) {
+			if (failures++ == 0) {
+				printf("%s %s seed %d: 3BV %d, the game's board has %d\n", preset.name, topologyNames[static_cast<int>(topology)], i + 1, profiles[i].bbbv, board.Count3BV());
+			}
+		}
+	}
+
+	// Sorted by difficulty, the boards a generator would pick from
+	std::vector<int> order(boardCount);
+	for (int i = 0; i < boardCount; i++) {
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](int first, int second) {
+		if (profiles[first].forcedGuesses != profiles[second].forcedGuesses) {
+			return profiles[first].forcedGuesses > profiles[second].forcedGuesses;
+		}
+		return profiles[first].longestChain > profiles[second].longestChain;
+	});
+	const BoardProfile& hardest = profiles[order.front()];
+
+	double count = std::max(boardCount, 1);
+	printf("%-6s %-10s 3BV %6.1f  openings %5.2f  guesses %5.2f  longest chain %3d  no guess %5.1f%%  hardest seed %d (%d guesses)\n",
+		preset.name, topologyNames[static_cast<int>(topology)], bbbv / count, openings / count, guesses / count, longestChain,
+		noGuessBoards * 100.0 / count, order.front() + 1, hardest.forcedGuesses);
+	return failures;
+}
+
+int main(int argc, char** argv) {
+
+	int boardCount = argc > 1 ? atoi(argv[1]) : 20000;
+	int threadCount = argc > 2 ? atoi(argv[2]) : 0;
+	DifficultyProfiler profiler(threadCount);
+	printf("%d boards per preset and shape, %d profiler threads\n", boardCount, profiler.GetThreadCount());
+
+	int failures = 0;
+	for (const ProfiledBoard& preset : presets) {
+		for (TopologyType topology : topologies) {
+			failures += ProfilePreset(profiler, preset, topology, boardCount);
+		}
+	}
+
+	// A narrow toroidal board is played, and has to be solved, as a standard one
+	ProfiledBoard narrowBoard = { "2x9", 2, 9, 4 };
+	int narrowDifferences = 0;
+	for (int i = 0; i < boardCount; i++) {
+		BoardProfile toroidal = DifficultyProfiler::Profile(MakeSetup(narrowBoard, TopologyType::Toroidal, 1 + i));
+		BoardProfile standard = DifficultyProfiler::Profile(MakeSetup(narrowBoard, TopologyType::Standard, 1 + i));
+		narrowDifferences += !IsSameProfile(toroidal, standard);
+	}
+	printf("\n2x9 toroidal boards: %d of %d profiles differ from the same boards set up as standard\n", narrowDifferences, boardCount);
+	failures += narrowDifferences;
+
+	// One board at a time, the way the window profiles a game
+	printf("\nprofile of one board (it must be done %.0f ms after the first reveal):\n", secondClickMilliseconds);
+	for (const ProfiledBoard& board : timedBoards) {
+		std::vector<double> times;
+		BoardProfile profile;
+		for (int i = 0; i < 5; i++) {
+			Clock::time_point start = Clock::now();
+			profile = DifficultyProfiler::Profile(MakeSetup(board, TopologyType::Standard, 1 + i));
+			times.push_back(MillisecondsSince(start));
+			failures += !profile.IsProfiled;
+		}
+		std::sort(times.begin(), times.end());
+		printf("%-10s %9.2f ms (median of 5)  %s  3BV %d, %d openings, %d guesses, longest chain %d\n", board.name, times[2],
+			times[2] < secondClickMilliseconds ? "in time" : "too slow", profile.bbbv, profile.openings, profile.forcedGuesses, profile.longestChain);
+	}
+
+	// The boards profiled per second when a generator picks from many seeds
+	BoardSetup setup = MakeSetup(presets[2], TopologyType::Standard, 1);
+	std::vector<BoardProfile> profiles;
+	Clock::time_point start = Clock::now();
+	for (int i = 0; i < boardCount; i++) {
+		setup.seed = 1 + i;
+		DifficultyProfiler::Profile(setup);
+	}
+	double singleMilliseconds = MillisecondsSince(start);
+	setup.seed = 1;
+	start = Clock::now();
+	profiler.ProfileSeeds(setup, boardCount, profiles);
+	double poolMilliseconds = MillisecondsSince(start);
+	printf("\n30x16 boards per second: %.0f on one thread, %.0f on the pool (%.1fx)\n", boardCount * 1000.0 / singleMilliseconds,
+		boardCount * 1000.0 / poolMilliseconds, singleMilliseconds / poolMilliseconds);
+
+	printf(failures == 0 ? "all checks passed\n" : "%d CHECKS FAILED\n", failures);
+	return failures == 0 ? 0 : 1;
+}
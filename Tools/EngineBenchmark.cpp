@@ -0,0 +1,97 @@
+// Benchmark comparing the generic GameBoard with the compile-time specialized PresetBoard
+// engines on the three preset grid sizes. Both engines play exactly the same seeded games
+// (same bombs, same moves), and the final boards are compared so the speedup is not a shortcut.
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include "../MinesweeperGUI/PresetBoard.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the results of playing a series of games on one engine
+struct BenchmarkResult {
+	uint64_t moves = 0;
+	uint64_t checksum = 0;
+	double seconds = 0;
+};
+
+// Plays games with a seeded random agent (reveals, and a flag every 8th move) until each one ends
+template <class Engine>
+static BenchmarkResult PlayGames(Engine& engine, int nCols, int nRows, int games, uint64_t seed) {
+
+	BenchmarkResult result;
+	uint64_t agentState = seed;
+	int cellCount = nCols * nRows;
+	Clock::time_point start = Clock::now();
+
+	for (int game = 0; game < games; game++) {
+		engine.NewGame(seed + game);
+		const uint8_t* visible = engine.GetVisibleState();
+
+		while (engine.GetStatus() != GameBoard::Status::Won && engine.GetStatus() != GameBoard::Status::Lost) {
+
+			// Probe for a covered cell, fall back to a scan
+			int index = static_cast<int>(GameBoard::RandomBelow(agentState, cellCount));
+			for (int i = 0; i < cellCount && visible[index] != GameBoard::Covered; i++) {
+				index = (index + 1) % cellCount;
+			}
+			if (visible[index] != GameBoard::Covered) {
+				break; // only flags are left
+			}
+
+			if (GameBoard::RandomBelow(agentState, 8) == 0) {
+				engine.ToggleFlag(index % nCols, index / nCols);
+			}
+			else {
+				engine.Reveal(index % nCols, index / nCols);
+			}
+			result.moves++;
+		}
+
+		// Hash the final board
+		for (int i = 0; i < cellCount; i++) {
+			result.checksum = result.checksum * 31 + visible[i];
+		}
+	}
+
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return result;
+}
+
+// Runs the generic and the specialized engine on the same games and prints the comparison
+template <class Preset>
+static bool ComparePreset(const char* name, int games) {
+
+	GameBoard generic(Preset::Cols, Preset::Rows, Preset::Bombs);
+	std::unique_ptr<Preset> specialized(new Preset());
+
+	BenchmarkResult genericResult = PlayGames(generic, Preset::Cols, Preset::Rows, games, 12345);
+	BenchmarkResult specializedResult = PlayGames(*specialized, Preset::Cols, Preset::Rows, games, 12345);
+
+	bool IsSame = genericResult.checksum == specializedResult.checksum && genericResult.moves == specializedResult.moves;
+	printf("%-8s generic: %9.0f games/s %11.0f moves/s | specialized: %9.0f games/s %11.0f moves/s | speedup %.2fx %s\n",
+		name,
+		games / genericResult.seconds, genericResult.moves / genericResult.seconds,
+		games / specializedResult.seconds, specializedResult.moves / specializedResult.seconds,
+		genericResult.seconds / specializedResult.seconds,
+		IsSame ? "(same boards)" : "(BOARDS DIFFER)");
+
+	return IsSame;
+}
+
+int main(int argc, char** argv) {
+
+	int games = argc > 1 ? atoi(argv[1]) : 200000;
+
+	printf("sizeof engine: 9x9 %zu bytes, 16x16 %zu bytes, 30x16 %zu bytes\n",
+		sizeof(PresetBoard9x9), sizeof(PresetBoard16x16), sizeof(PresetBoard30x16));
+
+	bool IsSame = ComparePreset<PresetBoard9x9>("9x9", games);
+	IsSame &= ComparePreset<PresetBoard16x16>("16x16", games);
+	IsSame &= ComparePreset<PresetBoard30x16>("30x16", games);
+
+	return IsSame ? 0 : 1;
+}
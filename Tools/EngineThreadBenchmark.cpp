@@ -0,0 +1,203 @@
+// Benchmark and check for the engine thread (MinesweeperGUI/EngineThread.h): sends the moves of seeded games to the
+// engine thread and checks every result against a GameBoard playing the same moves on this thread (the cells changed,
+// the state of the game and the # of flags), and that the results come back in the order the moves were sent.
+// Then measures the latency of a single move from the moment it is sent to the moment its result is received
+// (what the GUI waits for before drawing), and the # of moves per second when they are sent in bursts
+//
+// usage: enginethreadbench [cols] [rows] [bombs] [games]
+
+#include "../MinesweeperGUI/EngineThread.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Creates the moves of seeded games: a new game, then reveals, flags and undos on random cells (the script does not
+// look at the board, so the moves after a game is over test that they are ignored the same way on both sides)
+static std::vector<EngineThread::Command> CreateScript(int nCols, int nRows, int games, int movesPerGame) {
+
+	std::vector<EngineThread::Command> script;
+	uint64_t state = 11;
+	for (int game = 0; game < games; game++) {
+		EngineThread::Command command;
+		command.type = EngineThread::CommandType::NewGame;
+		command.seed = game;
+		script.push_back(command);
+
+		for (int move = 0; move < movesPerGame; move++) {
+			int kind = static_cast<int>(GameBoard::RandomBelow(state, 10));
+			command.type = kind < 7 ? EngineThread::CommandType::Reveal : kind < 9 ? EngineThread::CommandType::Flag : EngineThread::CommandType::Undo;
+			command.xPos = static_cast<int>(GameBoard::RandomBelow(state, nCols));
+			command.yPos = static_cast<int>(GameBoard::RandomBelow(state, nRows));
+			script.push_back(command);
+		}
+		command.type = EngineThread::CommandType::FindHint;
+		script.push_back(command);
+	}
+	return script;
+}
+
+// Applies a command on this thread the way the engine thread does, returns true if the result matches
+static bool CheckResult(GameBoard& board, const EngineThread::Result& result) {
+
+	const EngineThread::Command& command = result.command;
+	bool IsChanged = false;
+	switch (command.type) {
+	case EngineThread::CommandType::Reveal:
+		IsChanged = board.Reveal(command.xPos, command.yPos);
+		break;
+	case EngineThread::CommandType::Flag:
+		IsChanged = board.ToggleFlag(command.xPos, command.yPos);
+		break;
+	case EngineThread::CommandType::Undo:
+		IsChanged = board.Undo();
+		break;
+	case EngineThread::CommandType::Redo:
+		IsChanged = board.Redo();
+		break;
+	case EngineThread::CommandType::NewGame:
+		board.NewGame(command.seed);
+		IsChanged = true;
+		break;
+	case EngineThread::CommandType::Resize:
+		board.Resize(command.width, command.height, command.numberOfBombs);
+		board.NewGame(command.seed);
+		IsChanged = true;
+		break;
+	case EngineThread::CommandType::FindHint:
+		return result.mines.empty() || board.IsUnflaggedBomb(result.mines[0] % board.GetCols(), result.mines[0] / board.GetCols());
+	case EngineThread::CommandType::CountRegion:
+		return true;
+	}
+
+	if (IsChanged != result.IsChanged || board.GetStatus() != result.status || board.GetFlagsPlaced() != result.flagsPlaced) {
+		return false;
+	}
+	if (result.bbbv != 0 && result.bbbv != board.Count3BV()) {
+		return false;
+	}
+	if (!IsChanged || command.type == EngineThread::CommandType::NewGame || command.type == EngineThread::CommandType::Resize) {
+		return true;
+	}
+	const GameBoard::ChangeList& changes = board.GetChanges();
+	if (changes.size() != result.changes.size()) {
+		return false;
+	}
+	for (size_t i = 0; i < changes.size(); i++) {
+		if (changes[i].index != result.changes[i].index || changes[i].visible != result.changes[i].visible) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// Sends the script as fast as the command queue takes it, checks each result as it comes back (this thread gives
+// its core away while it has nothing to send or receive, as the window does while it waits for events).
+// Returns the time from the first move sent to the last result received
+static double RunScript(GameBoard& engineBoard, GameBoard& checkBoard, const std::vector<EngineThread::Command>& script, bool IsChecked) {
+
+	EngineThread engine;
+	engine.Start(engineBoard, []() {});
+	size_t sent = 0;
+	size_t received = 0;
+
+	Clock::time_point start = Clock::now();
+	while (received < script.size()) {
+		size_t sentBefore = sent;
+		size_t receivedBefore = received;
+		while (sent < script.size() && engine.Submit(script[sent])) {
+			sent++;
+		}
+		engine.DrainResults([&](const EngineThread::Result& result) {
+			if (result.command.sequence != received) {
+				printf("result %llu came back in place of %llu\n", static_cast<unsigned long long>(result.command.sequence), static_cast<unsigned long long>(received));
+				exit(1);
+			}
+			if (IsChecked && !CheckResult(checkBoard, result)) {
+				printf("move %llu gave a different result on the engine thread\n", static_cast<unsigned long long>(received));
+				exit(1);
+			}
+			received++;
+		});
+		if (sent == sentBefore && received == receivedBefore) {
+			std::this_thread::yield();
+		}
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	engine.Stop();
+	return seconds;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 30;
+	int nRows = argc > 2 ? atoi(argv[2]) : 16;
+	int numberOfBombs = argc > 3 ? atoi(argv[3]) : 99;
+	int games = argc > 4 ? atoi(argv[4]) : 20000;
+	const int movesPerGame = 40;
+	const int latencyMoves = 20000;
+	printf("%dx%d board, %d bombs, %d games of %d moves\n", nCols, nRows, numberOfBombs, games, movesPerGame);
+
+	GameBoard engineBoard;
+	GameBoard checkBoard;
+	for (GameBoard* board : { &engineBoard, &checkBoard }) {
+		board->SetTrainingMode(true);
+		board->Resize(nCols, nRows, numberOfBombs);
+	}
+	std::vector<EngineThread::Command> script = CreateScript(nCols, nRows, games, movesPerGame);
+
+	// Every result must match the board played on this thread, in the order the moves were sent
+	RunScript(engineBoard, checkBoard, script, true);
+	printf("%zu results checked against the same moves played on one thread\n", script.size());
+
+	// Moves sent in bursts (the command queue is kept full), the fastest of a few runs
+	double seconds = 0;
+	for (int run = 0; run < 3; run++) {
+		double runSeconds = RunScript(engineBoard, checkBoard, script, false);
+		seconds = run == 0 ? runSeconds : std::min(seconds, runSeconds);
+	}
+	printf("bursts:      %9.0f moves/s (%.0f ns per move)\n", script.size() / seconds, seconds * 1e9 / script.size());
+
+	// One move at a time: the time from sending a move to receiving its result, split into the time spent waiting for
+	// the engine thread to wake up, in the engine, and on the way back
+	EngineThread engine;
+	engine.Start(engineBoard, []() {});
+	std::vector<double> total;
+	std::vector<double> waiting;
+	std::vector<double> delivery;
+	for (int i = 0; i < latencyMoves; i++) {
+		EngineThread::Command command = script[i % script.size()];
+		command.submitTime = 0;
+		engine.Submit(command);
+
+		// The wait yields, so a woken engine thread gets a core at once (as when the UI thread goes back to its event
+		// loop) rather than when this thread's time slice is used up
+		bool IsReceived = false;
+		while (!IsReceived) {
+			std::this_thread::yield();
+			engine.DrainResults([&](const EngineThread::Result& result) {
+				int64_t receiveTime = EngineThread::Now();
+				total.push_back((receiveTime - result.command.submitTime) / 1e3);
+				waiting.push_back((result.startTime - result.command.submitTime) / 1e3);
+				delivery.push_back((receiveTime - result.endTime) / 1e3);
+				IsReceived = true;
+			});
+		}
+	}
+	engine.Stop();
+
+	for (std::vector<double>* times : { &total, &waiting, &delivery }) {
+		std::sort(times->begin(), times->end());
+	}
+	const char* const names[] = { "sent to received", "waiting for the engine", "engine to received" };
+	const std::vector<double>* lists[] = { &total, &waiting, &delivery };
+	printf("single moves (us):         p50      p90      p99      max\n");
+	for (int i = 0; i < 3; i++) {
+		const std::vector<double>& times = *lists[i];
+		printf("%-22s %8.1f %8.1f %8.1f %8.1f\n", names[i], times[times.size() / 2], times[times.size() * 9 / 10], times[times.size() * 99 / 100], times.back());
+	}
+	return 0;
+}
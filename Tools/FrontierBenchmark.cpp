@@ -0,0 +1,213 @@
+// Benchmark for the frontier and constraint index (MinesweeperGUI/FrontierIndex.h): plays games on a large board in
+// training mode, taking the forced moves the index finds (and undoing some moves), checks the index against a scan of
+// the whole board every few moves and times its queries against the scan. Then plays the same moves again with the
+// index off, to show what keeping it up to date costs per move.
+//
+// usage: frontierbench [cols] [rows] [bombPercent] [moves]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const int dx[] = { -1, 0, 1, 0, -1, -1, 1, 1 };
+static const int dy[] = { 0, -1, 0, 1, -1, 1, -1, 1 };
+
+// Define the moves recorded to be played again with the index off
+enum MoveType : uint8_t {
+	RevealMove,
+	FlagMove,
+	UndoMove,
+	NewGameMove
+};
+
+struct Move {
+	MoveType type;
+	int x;
+	int y;
+};
+
+static double MicrosecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Finds the frontier, the trivially safe cells and the trivially certain mines by scanning every cell of the board
+static void ScanBoard(const GameBoard& board, std::vector<uint32_t>& frontier, std::vector<uint32_t>& safe, std::vector<uint32_t>& mines) {
+
+	frontier.clear();
+	safe.clear();
+	mines.clear();
+	const uint8_t* visible = board.GetVisibleState();
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			int index = board.GetIndex(x, y);
+			int unknown = 0;
+			int flagged = 0;
+			int revealed = 0;
+			for (int i = 0; i < 8; i++) {
+				if (board.IsInGridIndex(x + dx[i], y + dy[i])) {
+					uint8_t value = visible[board.GetIndex(x + dx[i], y + dy[i])];
+					unknown += value == GameBoard::Covered;
+					flagged += value == GameBoard::Flagged;
+					revealed += value < GameBoard::Covered;
+				}
+			}
+
+			if (visible[index] == GameBoard::Covered) {
+				if (revealed > 0) {
+					frontier.push_back(index);
+				}
+			}
+			else if (visible[index] < GameBoard::Covered && unknown > 0) {
+				int remaining = visible[index] - flagged;
+				std::vector<uint32_t>* found = (remaining == 0) ? &safe : (remaining == unknown) ? &mines : nullptr;
+				for (int i = 0; found != nullptr && i < 8; i++) {
+					if (board.IsInGridIndex(x + dx[i], y + dy[i]) && visible[board.GetIndex(x + dx[i], y + dy[i])] == GameBoard::Covered) {
+						found->push_back(board.GetIndex(x + dx[i], y + dy[i]));
+					}
+				}
+			}
+		}
+	}
+
+	std::sort(safe.begin(), safe.end());
+	safe.erase(std::unique(safe.begin(), safe.end()), safe.end());
+	std::sort(mines.begin(), mines.end());
+	mines.erase(std::unique(mines.begin(), mines.end()), mines.end());
+}
+
+static bool IsSameSet(std::vector<uint32_t> cells, const std::vector<uint32_t>& sorted) {
+	std::sort(cells.begin(), cells.end());
+	return cells == sorted;
+}
+
+// Plays the recorded moves on a board, returns the time spent in the moves
+static double PlayMoves(GameBoard& board, const std::vector<Move>& moves) {
+
+	Clock::time_point start = Clock::now();
+	for (const Move& move : moves) {
+		if (move.type == RevealMove) {
+			board.Reveal(move.x, move.y);
+		}
+		else if (move.type == FlagMove) {
+			board.ToggleFlag(move.x, move.y);
+		}
+		else if (move.type == UndoMove) {
+			board.Undo();
+		}
+		else {
+			board.NewGame(static_cast<uint64_t>(move.x));
+		}
+	}
+	return MicrosecondsSince(start);
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 1000;
+	int nRows = argc > 2 ? atoi(argv[2]) : 1000;
+	double bombPercent = argc > 3 ? atof(argv[3]) : 15;
+	int moveCount = argc > 4 ? atoi(argv[4]) : 50000;
+	int numberOfBombs = static_cast<int>(static_cast<double>(nCols) * nRows * bombPercent / 100.0);
+	const int checkInterval = 1000;
+
+	GameBoard board;
+	board.SetTrainingMode(true);
+	board.Resize(nCols, nRows, numberOfBombs);
+	board.SetFrontierTracking(true);
+	board.NewGame(1);
+	printf("%dx%d board, %d bombs, %d moves\n", nCols, nRows, numberOfBombs, moveCount);
+
+	// Play forced moves when the index finds some, otherwise a safe guess (the bombs are known here)
+	std::vector<Move> moves;
+	std::vector<uint32_t> safe, mines, scanFrontier, scanSafe, scanMines;
+	uint64_t state = 5;
+	uint64_t seed = 1;
+	int forcedMoves = 0;
+	int checks = 0;
+	int games = 1;
+	double indexMicroseconds = 0;
+	double cellsFound = 0;
+	double scanMicroseconds = 0;
+
+	for (int i = 0; i < moveCount; i++) {
+
+		Clock::time_point start = Clock::now();
+		board.GetFrontier().FindSafeCells(safe);
+		board.GetFrontier().FindCertainMines(mines);
+		indexMicroseconds += MicrosecondsSince(start);
+		cellsFound += static_cast<double>(safe.size() + mines.size());
+
+		Move move = { RevealMove, nCols / 2, nRows / 2 };
+		if (board.GetStatus() == GameBoard::Status::Won || board.GetStatus() == GameBoard::Status::Lost) {
+			move = { NewGameMove, static_cast<int>(++seed), 0 };
+			games++;
+		}
+		else if (board.GetStatus() == GameBoard::Status::NotStarted) {
+			move = { RevealMove, nCols / 2, nRows / 2 };
+		}
+		else if (GameBoard::RandomBelow(state, 100) < 3) {
+			move = { UndoMove, 0, 0 };
+		}
+		else if (!safe.empty() || !mines.empty()) {
+			bool IsFlag = safe.empty() || (!mines.empty() && GameBoard::RandomBelow(state, 2) == 0);
+			const std::vector<uint32_t>& cells = IsFlag ? mines : safe;
+			uint32_t index = cells[GameBoard::RandomBelow(state, cells.size())];
+			move = { IsFlag ? FlagMove : RevealMove, static_cast<int>(index % nCols), static_cast<int>(index / nCols) };
+			forcedMoves++;
+		}
+		else {
+			int x, y;
+			do {
+				x = static_cast<int>(GameBoard::RandomBelow(state, nCols));
+				y = static_cast<int>(GameBoard::RandomBelow(state, nRows));
+			} while (board.IsCleared(x, y) || board.IsFlagged(x, y) || board.IsBomb(x, y));
+			move = { RevealMove, x, y };
+		}
+		moves.push_back(move);
+		std::vector<Move> single(1, move);
+		PlayMoves(board, single);
+
+		// The index must match a scan of the board
+		if (i % checkInterval == 0 || i == moveCount - 1) {
+			start = Clock::now();
+			ScanBoard(board, scanFrontier, scanSafe, scanMines);
+			scanMicroseconds += MicrosecondsSince(start);
+			checks++;
+
+			board.GetFrontier().FindSafeCells(safe);
+			board.GetFrontier().FindCertainMines(mines);
+			if (!IsSameSet(board.GetFrontier().GetFrontierCells(), scanFrontier) || !IsSameSet(safe, scanSafe) || !IsSameSet(mines, scanMines)) {
+				printf("the index differs from a scan of the board after move %d\n", i);
+				return 1;
+			}
+		}
+	}
+	printf("%d games, %d forced moves found by the index, %d checks: the index matches a scan of the board\n", games, forcedMoves, checks);
+	printf("safe cell and mine queries: %.2f us with the index (%.0f cells found on average), %.1f us scanning the board\n",
+		indexMicroseconds / moveCount, cellsFound / moveCount, scanMicroseconds / checks);
+
+	// Play the same moves with and without the index
+	GameBoard tracked;
+	tracked.SetTrainingMode(true);
+	tracked.Resize(nCols, nRows, numberOfBombs);
+	tracked.SetFrontierTracking(true);
+	tracked.NewGame(1);
+	double trackedMicroseconds = PlayMoves(tracked, moves);
+
+	GameBoard untracked;
+	untracked.SetTrainingMode(true);
+	untracked.Resize(nCols, nRows, numberOfBombs);
+	untracked.NewGame(1);
+	double untrackedMicroseconds = PlayMoves(untracked, moves);
+
+	printf("moves: %.2f us each with the index, %.2f us without it\n", trackedMicroseconds / moves.size(), untrackedMicroseconds / moves.size());
+	return 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstdint>
+
+// Binary protocol used between GameServer and its clients over a Unix domain socket.
+// Every request is a fixed size Request, every reply is a ReplyHeader followed by payloadBytes bytes.
+// Values are in host byte order since both ends always run on the same machine
+
+// Define the default path of the server's socket
+#define GAME_SERVER_SOCKET_PATH "/tmp/minesweeper.sock"
+
+// Define the requests that a client can send
+enum class Opcode : uint8_t {
+	NewGame = 1,          // sessionId 0 creates a session, an existing sessionId restarts it
+	Reveal = 2,
+	Flag = 3,
+	Chord = 4,
+	GetVisibleState = 5,  // payload is one visible byte per cell (see GameBoard::VisibleCell)
+	CloseGame = 6
+};
+
+// Define the result of a request
+enum class ReplyResult : uint8_t {
+	Ok = 0,
+	Unchanged = 1,
+	UnknownSession = 2,
+	InvalidRequest = 3
+};
+
+// Define a request (32 bytes, the layout must not change)
+struct Request {
+	uint64_t seed;
+	uint32_t sessionId;
+	uint32_t numberOfBombs;
+	uint16_t xPos;
+	uint16_t yPos;
+	uint16_t nCols;
+	uint16_t nRows;
+	uint8_t opcode;
+	uint8_t reserved[7];
+};
+
+// Define the header of a reply (16 bytes, the layout must not change).
+// Moves are followed by changeCount packed changes: (cell index << 4) | visible value
+struct ReplyHeader {
+	uint32_t sessionId;
+	uint32_t payloadBytes;
+	uint32_t changeCount;
+	uint8_t opcode;
+	uint8_t result;
+	uint8_t status;       // GameBoard::Status of the session after the request
+	uint8_t reserved;
+};
+
+static_assert(sizeof(Request) == 32, "Request layout changed");
+static_assert(sizeof(ReplyHeader) == 16, "ReplyHeader layout changed");
+
+// Define the largest board that can be described by a packed change (28 bit cell index)
+const uint32_t MaxProtocolCells = 1u << 28;
+
+// Packs a changed cell into the 4 bytes sent in a reply
+inline uint32_t PackChange(uint32_t index, uint8_t visible) {
+	return (index << 4) | visible;
+}
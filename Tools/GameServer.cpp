@@ -0,0 +1,470 @@
+// Headless game server: hosts many independent game sessions behind a Unix domain socket
+// so automated players can be tested without creating a MainFrame for each of them.
+//
+// The main thread accepts connections and hands each one to a worker (round robin).
+// Every worker runs its own epoll event loop, and owns the connections (and the sessions
+// created on them) it was given, so no locks are needed while handling requests.
+// Sessions of the preset sizes are played on the specialized engines (MinesweeperGUI/RulesEngine.h).
+
+#include "GameProtocol.h"
+#include "../MinesweeperGUI/RulesEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Define the largest board of a session: 1024x1024 cells, about 28 MB, so thousands of sessions fit in memory
+// (a packed change could describe boards of up to MaxProtocolCells, about 7 GB each)
+static const uint32_t maxSessionCells = 1u << 20;
+
+// Define the most reply bytes a connection can have waiting to be sent: past it, the connection's requests are not
+// read or handled until its client has read the replies (so a client that only sends can't grow either buffer)
+static const size_t maxPendingReplyBytes = 1 << 20;
+
+// Define how long accepting pauses when the server is out of file descriptors (or memory) for a new connection
+static const int acceptPauseMilliseconds = 100;
+
+// Define the flag used to stop all event loops (set by SIGINT / SIGTERM)
+static std::atomic<bool> IsStopping(false);
+
+static void OnStopSignal(int) {
+	IsStopping = true;
+}
+
+// Define the state of a single client connection
+struct Connection {
+	int fd;
+	std::vector<uint8_t> inBuffer;
+	std::vector<uint8_t> outBuffer;
+	size_t outOffset = 0;
+	uint32_t watchedEvents = EPOLLIN;
+
+	// Sessions are indexed by sessionId - 1, closed sessions are reused
+	std::vector<std::unique_ptr<RulesEngine>> sessions;
+	std::vector<uint32_t> freeSessions;
+};
+
+// Define a worker thread with its own epoll instance
+struct Worker {
+	int epollFd;
+	std::thread thread;
+	std::atomic<uint64_t> requestsHandled{ 0 };
+};
+
+// Sets a file descriptor to non-blocking mode
+static bool SetNonBlocking(int fd) {
+	int flags = fcntl(fd, F_GETFL, 0);
+	return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// Finds the session a request refers to (nullptr if it doesn't exist)
+static RulesEngine* FindSession(Connection& connection, uint32_t sessionId) {
+	if (sessionId == 0 || sessionId > connection.sessions.size()) {
+		return nullptr;
+	}
+	return connection.sessions[sessionId - 1].get();
+}
+
+// Appends a reply header and its payload to the connection's output buffer
+static void AppendReply(Connection& connection, const ReplyHeader& header, const void* payload) {
+	const uint8_t* headerBytes = reinterpret_cast<const uint8_t*>(&header);
+	connection.outBuffer.insert(connection.outBuffer.end(), headerBytes, headerBytes + sizeof(header));
+	if (header.payloadBytes > 0) {
+		const uint8_t* payloadBytes = static_cast<const uint8_t*>(payload);
+		connection.outBuffer.insert(connection.outBuffer.end(), payloadBytes, payloadBytes + header.payloadBytes);
+	}
+}
+
+// Appends a reply holding only the cells changed by the last move of the session
+static void AppendChanges(Connection& connection, ReplyHeader& header, const RulesEngine& board) {
+
+	const GameBoard::CellChange* changes = board.GetChanges();
+	header.changeCount = static_cast<uint32_t>(board.GetChangeCount());
+	header.payloadBytes = header.changeCount * sizeof(uint32_t);
+
+	// Copy the header, then pack the changes directly into the output buffer
+	size_t offset = connection.outBuffer.size();
+	connection.outBuffer.resize(offset + sizeof(header) + header.payloadBytes);
+	std::memcpy(&connection.outBuffer[offset], &header, sizeof(header));
+	offset += sizeof(header);
+	for (uint32_t i = 0; i < header.changeCount; i++) {
+		uint32_t packed = PackChange(changes[i].index, changes[i].visible);
+		std::memcpy(&connection.outBuffer[offset], &packed, sizeof(packed));
+		offset += sizeof(packed);
+	}
+}
+
+// Handles a NewGame request: creates a session (sessionId 0) or restarts an existing one
+static void HandleNewGame(Connection& connection, const Request& request, ReplyHeader& header) {
+
+	uint32_t cellCount = static_cast<uint32_t>(request.nCols) * request.nRows;
+	if (request.nCols == 0 || request.nRows == 0 || cellCount > maxSessionCells || request.numberOfBombs >= cellCount) {
+		header.result = static_cast<uint8_t>(ReplyResult::InvalidRequest);
+		AppendReply(connection, header, nullptr);
+		return;
+	}
+
+	if (request.sessionId == 0) {
+
+		// Reuse a closed session if there is one, otherwise add a new one
+		if (!connection.freeSessions.empty()) {
+			header.sessionId = connection.freeSessions.back();
+			connection.freeSessions.pop_back();
+		}
+		else {
+			connection.sessions.emplace_back();
+			header.sessionId = static_cast<uint32_t>(connection.sessions.size());
+		}
+	}
+	else if (FindSession(connection, request.sessionId) == nullptr) {
+		header.result = static_cast<uint8_t>(ReplyResult::UnknownSession);
+		AppendReply(connection, header, nullptr);
+		return;
+	}
+
+	// A board the server has no memory for is refused, and its session is closed (a board that failed to
+	// resize holds no game)
+	// Only create the engine again if the grid size or # of bombs changed. A session places its bombs on the worker
+	// that serves it (a 1024x1024 board is big enough to start the threads of a parallel placement, which would be
+	// one set of threads per session on top of the workers)
+	std::unique_ptr<RulesEngine>& session = connection.sessions[header.sessionId - 1];
+	try {
+		if (request.sessionId == 0 || session->GetCols() != request.nCols || session->GetRows() != request.nRows ||
+			session->GetNumberOfBombs() != static_cast<int>(request.numberOfBombs)) {
+			session.reset();
+			session = RulesEngine::Create(request.nCols, request.nRows, request.numberOfBombs, 1);
+		}
+	}
+	catch (const std::bad_alloc&) {
+		session.reset();
+		connection.freeSessions.push_back(header.sessionId);
+		header.result = static_cast<uint8_t>(ReplyResult::InvalidRequest);
+		AppendReply(connection, header, nullptr);
+		return;
+	}
+
+	RulesEngine* board = session.get();
+	board->NewGame(request.seed);
+	header.status = static_cast<uint8_t>(board->GetStatus());
+	AppendReply(connection, header, nullptr);
+}
+
+// Handles a single request and appends its reply to the connection's output buffer
+static void HandleRequest(Connection& connection, const Request& request) {
+
+	ReplyHeader header = {};
+	header.sessionId = request.sessionId;
+	header.opcode = request.opcode;
+	header.result = static_cast<uint8_t>(ReplyResult::Ok);
+
+	Opcode opcode = static_cast<Opcode>(request.opcode);
+	if (opcode == Opcode::NewGame) {
+		HandleNewGame(connection, request, header);
+		return;
+	}
+
+	RulesEngine* board = FindSession(connection, request.sessionId);
+	if (board == nullptr) {
+		header.result = static_cast<uint8_t>(ReplyResult::UnknownSession);
+		AppendReply(connection, header, nullptr);
+		return;
+	}
+
+	bool HasChanged = false;
+	switch (opcode) {
+		case Opcode::Reveal:
+			HasChanged = board->Reveal(request.xPos, request.yPos);
+			break;
+		case Opcode::Flag:
+			HasChanged = board->ToggleFlag(request.xPos, request.yPos);
+			break;
+		case Opcode::Chord:
+			HasChanged = board->Chord(request.xPos, request.yPos);
+			break;
+		case Opcode::GetVisibleState:
+			header.status = static_cast<uint8_t>(board->GetStatus());
+			header.payloadBytes = board->GetCellCount();
+			AppendReply(connection, header, board->GetVisibleState());
+			return;
+		case Opcode::CloseGame:
+			connection.sessions[request.sessionId - 1].reset();
+			connection.freeSessions.push_back(request.sessionId);
+			AppendReply(connection, header, nullptr);
+			return;
+		default:
+			header.result = static_cast<uint8_t>(ReplyResult::InvalidRequest);
+			AppendReply(connection, header, nullptr);
+			return;
+	}
+
+	header.status = static_cast<uint8_t>(board->GetStatus());
+	if (!HasChanged) {
+		header.result = static_cast<uint8_t>(ReplyResult::Unchanged);
+		AppendReply(connection, header, nullptr);
+		return;
+	}
+
+	AppendChanges(connection, header, *board);
+}
+
+// Writes as much of the output buffer as the socket accepts, returns false if the connection failed
+static bool FlushOutput(Connection& connection) {
+
+	while (connection.outOffset < connection.outBuffer.size()) {
+		ssize_t written = send(connection.fd, connection.outBuffer.data() + connection.outOffset,
+			connection.outBuffer.size() - connection.outOffset, MSG_NOSIGNAL);
+		if (written < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+
+				// Drop the bytes sent once they are most of the buffer, so it doesn't grow while the client reads slowly
+				if (connection.outOffset > connection.outBuffer.size() / 2) {
+					connection.outBuffer.erase(connection.outBuffer.begin(), connection.outBuffer.begin() + connection.outOffset);
+					connection.outOffset = 0;
+				}
+				return true;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		connection.outOffset += written;
+	}
+
+	// Everything was sent, reuse the buffer's memory for the next replies
+	connection.outBuffer.clear();
+	connection.outOffset = 0;
+	return true;
+}
+
+// Returns true if the connection has too many replies waiting to be sent to take more requests
+static bool HasTooManyReplies(const Connection& connection) {
+	return connection.outBuffer.size() - connection.outOffset > maxPendingReplyBytes;
+}
+
+// Handles the complete requests read from the connection (until it has too many replies waiting), keeps the rest
+static void HandleRequests(Connection& connection, Worker& worker) {
+
+	size_t offset = 0;
+	while (connection.inBuffer.size() - offset >= sizeof(Request) && !HasTooManyReplies(connection)) {
+		Request request;
+		std::memcpy(&request, &connection.inBuffer[offset], sizeof(request));
+		HandleRequest(connection, request);
+		offset += sizeof(Request);
+		worker.requestsHandled.fetch_add(1, std::memory_order_relaxed);
+	}
+	connection.inBuffer.erase(connection.inBuffer.begin(), connection.inBuffer.begin() + offset);
+}
+
+// Reads the available requests from the connection, handles them and sends their replies, returns false if the
+// connection closed. Reading stops while the replies waiting to be sent are over their limit, the requests left are
+// handled once the client has read them
+static bool HandleReadable(Connection& connection, Worker& worker) {
+
+	uint8_t readBuffer[64 * 1024];
+	for (;;) {
+		HandleRequests(connection, worker);
+		if (!FlushOutput(connection)) {
+			return false;
+		}
+		if (HasTooManyReplies(connection)) {
+			return true;
+		}
+
+		// The replies sent made room for the requests already read
+		if (connection.inBuffer.size() >= sizeof(Request)) {
+			continue;
+		}
+
+		ssize_t received = recv(connection.fd, readBuffer, sizeof(readBuffer), 0);
+		if (received == 0) {
+			return false;
+		}
+		if (received < 0) {
+			if (errno == EAGAIN || errno == EWOULDBLOCK) {
+				return true;
+			}
+			if (errno == EINTR) {
+				continue;
+			}
+			return false;
+		}
+		connection.inBuffer.insert(connection.inBuffer.end(), readBuffer, readBuffer + received);
+	}
+}
+
+// Closes a connection and frees all of its sessions
+static void CloseConnection(Worker& worker, Connection* connection) {
+	epoll_ctl(worker.epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+	close(connection->fd);
+	delete connection;
+}
+
+// Runs a worker's event loop until the server stops
+static void RunWorker(Worker& worker) {
+
+	epoll_event events[256];
+	while (!IsStopping) {
+
+		int eventCount = epoll_wait(worker.epollFd, events, 256, 200);
+		for (int i = 0; i < eventCount; i++) {
+			Connection* connection = static_cast<Connection*>(events[i].data.ptr);
+
+			bool IsOpen = (events[i].events & (EPOLLERR | EPOLLHUP)) == 0 || (events[i].events & EPOLLIN);
+			if (IsOpen && (events[i].events & EPOLLIN)) {
+				IsOpen = HandleReadable(*connection, worker);
+			}
+			if (IsOpen && (events[i].events & EPOLLOUT)) {
+				IsOpen = FlushOutput(*connection);
+
+				// The requests left while the replies were over their limit are handled once they have been sent
+				if (IsOpen && connection->inBuffer.size() >= sizeof(Request) && !HasTooManyReplies(*connection)) {
+					IsOpen = HandleReadable(*connection, worker);
+				}
+			}
+			if (!IsOpen) {
+				CloseConnection(worker, connection);
+				continue;
+			}
+
+			// Only wait for the socket to be writable while replies are pending, and stop reading requests while
+			// there are too many of them
+			uint32_t watchedEvents = 0;
+			if (!HasTooManyReplies(*connection)) {
+				watchedEvents |= EPOLLIN;
+			}
+			if (!connection->outBuffer.empty()) {
+				watchedEvents |= EPOLLOUT;
+			}
+			if (watchedEvents != connection->watchedEvents) {
+				epoll_event event = {};
+				event.events = watchedEvents;
+				event.data.ptr = connection;
+				epoll_ctl(worker.epollFd, EPOLL_CTL_MOD, connection->fd, &event);
+				connection->watchedEvents = watchedEvents;
+			}
+		}
+	}
+}
+
+// Creates the listening socket at the given path
+static int CreateListenSocket(const std::string& socketPath) {
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd < 0) {
+		perror("socket");
+		return -1;
+	}
+
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	if (socketPath.size() >= sizeof(address.sun_path)) {
+		fprintf(stderr, "Socket path is too long: %s\n", socketPath.c_str());
+		close(listenFd);
+		return -1;
+	}
+	std::strcpy(address.sun_path, socketPath.c_str());
+	unlink(socketPath.c_str());
+
+	if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listenFd, SOMAXCONN) < 0) {
+		perror("bind/listen");
+		close(listenFd);
+		return -1;
+	}
+
+	return listenFd;
+}
+
+int main(int argc, char** argv) {
+
+	std::string socketPath = GAME_SERVER_SOCKET_PATH;
+	int workerCount = std::max(2u, std::thread::hardware_concurrency());
+
+	// Read command line options
+	for (int i = 1; i < argc; i++) {
+		std::string arg = argv[i];
+		if (arg == "--socket" && i + 1 < argc) {
+			socketPath = argv[++i];
+		}
+		else if (arg == "--workers" && i + 1 < argc) {
+			workerCount = std::max(1, atoi(argv[++i]));
+		}
+		else {
+			fprintf(stderr, "Usage: %s [--socket path] [--workers n]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// Stop on SIGINT / SIGTERM (without SA_RESTART, so accept is interrupted)
+	struct sigaction stopAction = {};
+	stopAction.sa_handler = OnStopSignal;
+	sigaction(SIGINT, &stopAction, nullptr);
+	sigaction(SIGTERM, &stopAction, nullptr);
+	signal(SIGPIPE, SIG_IGN);
+
+	int listenFd = CreateListenSocket(socketPath);
+	if (listenFd < 0) {
+		return 1;
+	}
+
+	// Start the worker pool
+	std::vector<std::unique_ptr<Worker>> workers;
+	for (int i = 0; i < workerCount; i++) {
+		workers.emplace_back(new Worker());
+		workers.back()->epollFd = epoll_create1(0);
+		workers.back()->thread = std::thread(RunWorker, std::ref(*workers.back()));
+	}
+	printf("Game server listening on %s with %d workers\n", socketPath.c_str(), workerCount);
+	fflush(stdout);
+
+	// Accept connections and hand them to the workers (round robin)
+	int nextWorker = 0;
+	while (!IsStopping) {
+		int clientFd = accept(listenFd, nullptr, nullptr);
+		if (clientFd < 0) {
+
+			// The connection stays in the listen queue, it is accepted once other connections have closed
+			if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(acceptPauseMilliseconds));
+			}
+			continue; // interrupted by a signal, or the client gave up
+		}
+		SetNonBlocking(clientFd);
+
+		Connection* connection = new Connection();
+		connection->fd = clientFd;
+
+		epoll_event event = {};
+		event.events = EPOLLIN;
+		event.data.ptr = connection;
+		epoll_ctl(workers[nextWorker]->epollFd, EPOLL_CTL_ADD, clientFd, &event);
+		nextWorker = (nextWorker + 1) % workerCount;
+	}
+
+	// Stop the workers and report how many requests were handled
+	uint64_t totalRequests = 0;
+	for (std::unique_ptr<Worker>& worker : workers) {
+		worker->thread.join();
+		close(worker->epollFd);
+		totalRequests += worker->requestsHandled;
+	}
+	close(listenFd);
+	unlink(socketPath.c_str());
+	printf("Game server stopped after %llu requests\n", static_cast<unsigned long long>(totalRequests));
+
+	return 0;
+}
@@ -0,0 +1,140 @@
+// Benchmark for placing the bombs of large boards on several threads: times the first reveal (which places the
+// bombs) with 1, 2, 4, ... threads, checks that every # of threads places the same bombs with the right counts,
+// and checks that a first reveal cancelled from another thread leaves the board as it was.
+//
+// usage: generationbench [cols] [rows] [bombPercent] [maxThreads]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+typedef std::chrono::steady_clock Clock;
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Hashes the bombs of the board, and checks the bomb count and the # of bombs surrounding every cell
+static bool CheckBoard(const GameBoard& board, uint64_t& hash) {
+
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	int bombs = 0;
+	hash = 0;
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			if (board.IsBomb(x, y)) {
+				bombs++;
+				uint64_t state = hash ^ static_cast<uint64_t>(board.GetIndex(x, y));
+				hash = GameBoard::NextRandom(state);
+			}
+
+			int count = 0;
+			for (int j = y - 1; j <= y + 1; j++) {
+				for (int i = x - 1; i <= x + 1; i++) {
+					if ((i != x || j != y) && board.IsInGridIndex(i, j) && board.IsBomb(i, j)) {
+						count++;
+					}
+				}
+			}
+			if (count != board.CountBombsSurrounding(x, y)) {
+				printf("wrong count at %d,%d: %d instead of %d\n", x, y, board.CountBombsSurrounding(x, y), count);
+				return false;
+			}
+		}
+	}
+
+	if (bombs != board.GetNumberOfBombs()) {
+		printf("%d bombs placed instead of %d\n", bombs, board.GetNumberOfBombs());
+		return false;
+	}
+	return true;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 10000;
+	int nRows = argc > 2 ? atoi(argv[2]) : 10000;
+	double bombPercent = argc > 3 ? atof(argv[3]) : 20;
+	int maxThreads = argc > 4 ? atoi(argv[4]) : 8;
+	int numberOfBombs = static_cast<int>(static_cast<double>(nCols) * nRows * bombPercent / 100.0);
+	const uint64_t seed = 12345;
+
+	printf("%dx%d board (%.1fM cells), %d bombs, %u cores\n", nCols, nRows, nCols * static_cast<double>(nRows) / 1e6,
+		numberOfBombs, std::thread::hardware_concurrency());
+
+	GameBoard board(nCols, nRows, numberOfBombs);
+	if (!board.IsLargeBoard()) {
+		printf("boards below %d cells place their bombs on one thread\n", GameBoard::ParallelGenerationCells);
+	}
+
+	// Time the first reveal with more and more threads, every one must place the same bombs
+	uint64_t firstHash = 0;
+	for (int threads = 1; threads <= maxThreads; threads *= 2) {
+		board.SetGenerationThreads(threads);
+		board.NewGame(seed);
+
+		Clock::time_point start = Clock::now();
+		board.Reveal(nCols / 2, nRows / 2);
+		double milliseconds = MillisecondsSince(start);
+
+		uint64_t hash = 0;
+		if (!CheckBoard(board, hash)) {
+			return 1;
+		}
+		if (threads == 1) {
+			firstHash = hash;
+		}
+		printf("%2d threads: first reveal in %8.1f ms, %6zu cells revealed, bombs %016llx\n", threads, milliseconds,
+			board.GetChanges().size(), static_cast<unsigned long long>(hash));
+		if (hash != firstHash) {
+			printf("different bombs than with 1 thread\n");
+			return 1;
+		}
+	}
+
+	// Cancel a first reveal from another thread, once it is partly done, with a flag placed before it
+	board.SetGenerationThreads(0);
+	board.NewGame(seed);
+	board.ToggleFlag(0, 0);
+
+	bool IsRevealed = true;
+	Clock::time_point start = Clock::now();
+	std::thread revealThread([&]() { IsRevealed = board.Reveal(nCols / 2, nRows / 2); });
+	double progress = 0;
+	while ((progress = board.GetGenerationProgress()) < 0.3 && MillisecondsSince(start) < 10000) {
+		std::this_thread::yield();
+	}
+	board.CancelGeneration();
+	revealThread.join();
+	printf("cancelled at %.0f%% after %.1f ms: ", progress * 100, MillisecondsSince(start));
+
+	if (board.IsLargeBoard()) {
+		bool HasBombs = false;
+		for (int y = 0; y < nRows && !HasBombs; y++) {
+			for (int x = 0; x < nCols && !HasBombs; x++) {
+				HasBombs = board.IsBomb(x, y) || board.CountBombsSurrounding(x, y) != 0;
+			}
+		}
+		if (IsRevealed || board.GetStatus() != GameBoard::Status::NotStarted || HasBombs || !board.IsFlagged(0, 0)) {
+			printf("the board was changed\n");
+			return 1;
+		}
+		printf("the board is unchanged\n");
+
+		// The same game can still be started, with the same bombs
+		uint64_t hash = 0;
+		board.Reveal(nCols / 2, nRows / 2);
+		if (!CheckBoard(board, hash) || hash != firstHash) {
+			printf("different bombs after a cancelled first reveal\n");
+			return 1;
+		}
+	}
+	else {
+		printf("(small boards can't be cancelled)\n");
+	}
+
+	return 0;
+}
@@ -0,0 +1,251 @@
+// Writes and loads mine layouts (MinesweeperGUI/LayoutImporter.h). --write plays the first reveal of a seeded game
+// and saves its mines and opening: a .txt file as a text grid, any other name as a raw PBM of the mines with the
+// opening in a .revealed layer next to it. Loading a file imports it (with the layers found next to it, or the ones
+// given) and reports how fast it was read. --check writes boards in every format, loads them back and compares them
+// with the boards they came from, and checks that broken files are refused, it fails if any of it doesn't hold.
+//
+// usage: layouttool --write file [cols] [rows] [bombs] [seed]
+//        layouttool file [--revealed layer] [--flagged layer]
+//        layouttool --check [cols] [rows] [bombs]
+
+#include "../MinesweeperGUI/LayoutImporter.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static bool IsTextPath(const std::string& path) {
+	return path.size() > 4 && path.compare(path.size() - 4, 4, ".txt") == 0;
+}
+
+// Returns the path of a layer next to a layout file (the name LayoutImporter::FindLayerPath looks for)
+static std::string LayerPath(const std::string& path, const std::string& layerName) {
+	size_t dot = path.find_last_of('.');
+	return dot == std::string::npos ? path + "." + layerName : path.substr(0, dot) + "." + layerName + path.substr(dot);
+}
+
+// Writes a raw PBM with a pixel set for every cell where IsSet(x, y) is true
+template <class Function>
+static bool WritePbm(const std::string& path, int nCols, int nRows, Function IsSet) {
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+	fprintf(file, "P4\n%d %d\n", nCols, nRows);
+	std::vector<uint8_t> packedRow((nCols + 7) / 8);
+	for (int y = 0; y < nRows; y++) {
+		std::fill(packedRow.begin(), packedRow.end(), 0);
+		for (int x = 0; x < nCols; x++) {
+			packedRow[x >> 3] |= static_cast<uint8_t>(IsSet(x, y)) << (7 - (x & 7));
+		}
+		fwrite(packedRow.data(), 1, packedRow.size(), file);
+	}
+	return fclose(file) == 0;
+}
+
+// Writes the board as a text grid (its mines, revealed numbers and flags)
+static bool WriteText(const std::string& path, const GameBoard& board) {
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (file == nullptr) {
+		return false;
+	}
+	std::string line(board.GetCols() + 1, '\n');
+	for (int y = 0; y < board.GetRows(); y++) {
+		for (int x = 0; x < board.GetCols(); x++) {
+			if (board.IsCleared(x, y)) {
+				line[x] = static_cast<char>('0' + board.CountBombsSurrounding(x, y));
+			}
+			else if (board.IsFlagged(x, y)) {
+				line[x] = board.IsBomb(x, y) ? 'F' : 'f';
+			}
+			else {
+				line[x] = board.IsBomb(x, y) ? '*' : '.';
+			}
+		}
+		fwrite(line.data(), 1, line.size(), file);
+	}
+	return fclose(file) == 0;
+}
+
+// Writes the board in the format of the path's extension (a PBM gets its revealed and flagged cells as layers)
+static bool WriteBoard(const std::string& path, const GameBoard& board) {
+
+	if (IsTextPath(path)) {
+		return WriteText(path, board);
+	}
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	return WritePbm(path, nCols, nRows, [&](int x, int y) { return board.IsBomb(x, y); })
+		&& WritePbm(LayerPath(path, "revealed"), nCols, nRows, [&](int x, int y) { return board.IsCleared(x, y); })
+		&& WritePbm(LayerPath(path, "flagged"), nCols, nRows, [&](int x, int y) { return board.IsFlagged(x, y); });
+}
+
+// Plays the first reveal of a seeded game in the center, and flags some of the mines
+static void CreateBoard(GameBoard& board, int nCols, int nRows, int numberOfBombs, uint64_t seed) {
+
+	board.Resize(nCols, nRows, numberOfBombs);
+	board.NewGame(seed);
+	board.Reveal(nCols / 2, nRows / 2);
+	uint64_t state = seed;
+	for (int i = 0; i < 20; i++) {
+		int x = static_cast<int>(GameBoard::RandomBelow(state, nCols));
+		int y = static_cast<int>(GameBoard::RandomBelow(state, nRows));
+		if (board.IsBomb(x, y) && !board.IsFlagged(x, y)) {
+			board.ToggleFlag(x, y);
+		}
+	}
+}
+
+// Returns true if the loaded board has the mines and visible cells of the board it was written from
+static bool IsSameBoard(const GameBoard& loaded, const GameBoard& board) {
+
+	if (loaded.GetCols() != board.GetCols() || loaded.GetRows() != board.GetRows() || loaded.GetNumberOfBombs() != board.GetNumberOfBombs()
+		|| loaded.GetFlagsPlaced() != board.GetFlagsPlaced() || loaded.GetStatus() != board.GetStatus()) {
+		return false;
+	}
+	for (int y = 0; y < board.GetRows(); y++) {
+		for (int x = 0; x < board.GetCols(); x++) {
+			int index = board.GetIndex(x, y);
+			if (loaded.IsBomb(x, y) != board.IsBomb(x, y) || loaded.GetVisibleState()[index] != board.GetVisibleState()[index]) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Writes a file of the given contents
+static void WriteFile(const std::string& path, const std::string& contents) {
+	FILE* file = fopen(path.c_str(), "wb");
+	fwrite(contents.data(), 1, contents.size(), file);
+	fclose(file);
+}
+
+static int Check(int nCols, int nRows, int numberOfBombs) {
+
+	GameBoard board;
+	CreateBoard(board, nCols, nRows, numberOfBombs, 3);
+	LayoutImporter importer;
+	bool IsPassed = true;
+
+	// Every format loads back as the board it was written from, and plays on the same way
+	for (const char* path : { "layout-check.txt", "layout-check.pbm" }) {
+		WriteBoard(path, board);
+		GameBoard loaded;
+		std::string revealedPath = LayoutImporter::FindLayerPath(path, "revealed");
+		std::string flaggedPath = LayoutImporter::FindLayerPath(path, "flagged");
+		bool IsLoaded = importer.Import(loaded, path, revealedPath, flaggedPath);
+		bool IsSame = IsLoaded && IsSameBoard(loaded, board);
+		printf("%-20s %s\n", path, IsSame ? "loads back the same board" : IsLoaded ? "loads a different board" : importer.GetError().c_str());
+		IsPassed &= IsSame;
+
+		// A new game on the layout starts from the same cells
+		if (IsSame) {
+			loaded.NewGame(1);
+			IsSame = IsSameBoard(loaded, board);
+			printf("%-20s %s\n", path, IsSame ? "starts again the same after a new game" : "starts again differently after a new game");
+			IsPassed &= IsSame;
+		}
+	}
+
+	// Broken files are refused with a message, and leave the board without bombs
+	const char* const brokenNames[] = { "wrong number", "short line", "unknown character", "truncated PBM", "layer size", "mine revealed", "huge header" };
+	const std::string brokenContents[] = { "*2.\n...\n", "*1.\n..\n", "*1.\n.x.\n", "P4\n16 4\n\xff", "P1\n2 2\n1 0 0 0\n", "*1.\n...\n", "P1\n9999999999 1\n" };
+	for (int i = 0; i < 7; i++) {
+		WriteFile("layout-broken.txt", brokenContents[i]);
+		std::string revealedPath;
+		if (i == 4 || i == 5) {
+			WriteFile("layout-broken.txt", "*1.\n...\n");
+			WriteFile("layout-broken.revealed.txt", i == 4 ? brokenContents[i] : "o..\n...\n");
+			revealedPath = "layout-broken.revealed.txt";
+		}
+		GameBoard loaded;
+		bool IsRefused = !importer.Import(loaded, "layout-broken.txt", revealedPath) && loaded.GetNumberOfBombs() == 0 && !loaded.HasLayout();
+		printf("%-20s %s\n", brokenNames[i], IsRefused ? importer.GetError().c_str() : "was loaded");
+		IsPassed &= IsRefused;
+	}
+
+	// A layout bigger than the caller can play is refused from its header, before the board is sized for it
+	WriteFile("layout-broken.pbm", "P4 20000 20000\n");
+	GameBoard small;
+	LayoutImporter limitedImporter;
+	limitedImporter.SetMaxSize(4000, 4000);
+	bool IsRefused = !limitedImporter.Import(small, "layout-broken.pbm") && small.GetCellCount() == 0 && small.GetArenaCapacity() == 0;
+	printf("%-20s %s\n", "too big to play", IsRefused ? limitedImporter.GetError().c_str() : "was sized");
+	IsPassed &= IsRefused;
+
+	for (const char* path : { "layout-check.txt", "layout-check.pbm", "layout-check.revealed.pbm", "layout-check.flagged.pbm", "layout-broken.txt", "layout-broken.revealed.txt", "layout-broken.pbm" }) {
+		remove(path);
+	}
+	printf(IsPassed ? "every check passed\n" : "a check failed\n");
+	return IsPassed ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+
+	if (argc > 1 && strcmp(argv[1], "--check") == 0) {
+		return Check(argc > 2 ? atoi(argv[2]) : 300, argc > 3 ? atoi(argv[3]) : 200, argc > 4 ? atoi(argv[4]) : 9000);
+	}
+
+	if (argc > 2 && strcmp(argv[1], "--write") == 0) {
+		int nCols = argc > 3 ? atoi(argv[3]) : 10000;
+		int nRows = argc > 4 ? atoi(argv[4]) : 10000;
+		int numberOfBombs = argc > 5 ? atoi(argv[5]) : nCols * nRows / 6;
+		uint64_t seed = argc > 6 ? strtoull(argv[6], nullptr, 10) : 1;
+		GameBoard board;
+		CreateBoard(board, nCols, nRows, numberOfBombs, seed);
+		if (!WriteBoard(argv[2], board)) {
+			printf("%s can't be written\n", argv[2]);
+			return 1;
+		}
+		printf("%dx%d board with %d bombs written to %s\n", nCols, nRows, board.GetNumberOfBombs(), argv[2]);
+		return 0;
+	}
+
+	if (argc < 2) {
+		printf("usage: layouttool --write file [cols] [rows] [bombs] [seed]\n");
+		printf("       layouttool file [--revealed layer] [--flagged layer]\n");
+		printf("       layouttool --check [cols] [rows] [bombs]\n");
+		return 1;
+	}
+
+	// The layers are the ones given, or the ones next to the file
+	std::string path = argv[1];
+	std::string revealedPath = LayoutImporter::FindLayerPath(path, "revealed");
+	std::string flaggedPath = LayoutImporter::FindLayerPath(path, "flagged");
+	for (int i = 2; i + 1 < argc; i += 2) {
+		if (strcmp(argv[i], "--revealed") == 0) {
+			revealedPath = argv[i + 1];
+		}
+		else if (strcmp(argv[i], "--flagged") == 0) {
+			flaggedPath = argv[i + 1];
+		}
+	}
+
+	GameBoard board;
+	LayoutImporter importer;
+	Clock::time_point start = Clock::now();
+	if (!importer.Import(board, path, revealedPath, flaggedPath)) {
+		printf("%s\n", importer.GetError().c_str());
+		return 1;
+	}
+	double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	const char* const statusNames[] = { "not started", "playing", "won", "lost" };
+	int cellCount = board.GetCellCount();
+	int revealed = 0;
+	for (int index = 0; index < cellCount; index++) {
+		revealed += board.GetVisibleState()[index] < GameBoard::Covered;
+	}
+	printf("%dx%d layout, %d bombs, %d revealed, %d flags, %s\n", board.GetCols(), board.GetRows(), board.GetNumberOfBombs(), revealed,
+		board.GetFlagsPlaced(), statusNames[static_cast<int>(board.GetStatus())]);
+	printf("loaded in %.3f s (%.1f M cells/s)%s%s\n", seconds, cellCount / seconds / 1e6,
+		revealedPath.empty() ? "" : (", revealed from " + revealedPath).c_str(), flaggedPath.empty() ? "" : (", flagged from " + flaggedPath).c_str());
+	return 0;
+}
@@ -0,0 +1,290 @@
+// Load test client for GameServer: every connection thread plays random moves on many sessions
+// (one pipelined request per session per round) and measures the latency of every request.
+// Reports the number of sessions, moves per second and tail latency at saturation.
+
+#include "GameProtocol.h"
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the options of a load test
+struct LoadTestOptions {
+	std::string socketPath = GAME_SERVER_SOCKET_PATH;
+	int connections = 8;
+	int sessionsPerConnection = 128;
+	int seconds = 10;
+	int nCols = 30;
+	int nRows = 16;
+	int numberOfBombs = 99;
+};
+
+// Define the client side copy of a session (visible state rebuilt from the replies)
+struct ClientSession {
+	uint32_t sessionId = 0;
+	std::vector<uint8_t> visible;
+	uint8_t status = 0;
+};
+
+// Define the results measured by a single connection thread
+struct ConnectionResult {
+	uint64_t moves = 0;
+	uint64_t gamesFinished = 0;
+	std::vector<uint32_t> latenciesMicro;
+	bool IsFailed = false;
+};
+
+// Reads exactly size bytes from the socket
+static bool ReadFull(int fd, void* buffer, size_t size) {
+	uint8_t* bytes = static_cast<uint8_t*>(buffer);
+	while (size > 0) {
+		ssize_t received = recv(fd, bytes, size, 0);
+		if (received <= 0) {
+			return false;
+		}
+		bytes += received;
+		size -= received;
+	}
+	return true;
+}
+
+// Writes exactly size bytes to the socket
+static bool WriteFull(int fd, const void* buffer, size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(buffer);
+	while (size > 0) {
+		ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+		if (written <= 0) {
+			return false;
+		}
+		bytes += written;
+		size -= written;
+	}
+	return true;
+}
+
+// Connects to the server's socket
+static int Connect(const std::string& socketPath) {
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un address = {};
+	address.sun_family = AF_UNIX;
+	std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+	if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+// Creates a NewGame request for a session (sessionId 0 creates a new session)
+static Request CreateNewGameRequest(const LoadTestOptions& options, uint32_t sessionId, std::mt19937_64& gen) {
+	Request request = {};
+	request.opcode = static_cast<uint8_t>(Opcode::NewGame);
+	request.sessionId = sessionId;
+	request.seed = gen();
+	request.nCols = options.nCols;
+	request.nRows = options.nRows;
+	request.numberOfBombs = options.numberOfBombs;
+	return request;
+}
+
+// Chooses a random move on a covered cell: mostly reveals, sometimes a flag
+static Request CreateMoveRequest(const LoadTestOptions& options, const ClientSession& session, std::mt19937_64& gen) {
+
+	Request request = {};
+	request.sessionId = session.sessionId;
+
+	// Probe random cells for a covered one, fall back to a scan
+	int cellCount = options.nCols * options.nRows;
+	int index = gen() % cellCount;
+	for (int tries = 0; tries < 64 && session.visible[index] != GameBoard::Covered; tries++) {
+		index = gen() % cellCount;
+	}
+	for (int i = 0; i < cellCount && session.visible[index] != GameBoard::Covered; i++) {
+		index = (index + 1) % cellCount;
+	}
+
+	request.xPos = index % options.nCols;
+	request.yPos = index / options.nCols;
+	request.opcode = static_cast<uint8_t>((gen() % 10 == 0) ? Opcode::Flag : Opcode::Reveal);
+	return request;
+}
+
+// Reads a reply and applies its changes to the client side copy of the session
+static bool ReadReply(int fd, ClientSession& session, std::vector<uint8_t>& payload) {
+
+	ReplyHeader header;
+	if (!ReadFull(fd, &header, sizeof(header))) {
+		return false;
+	}
+	payload.resize(header.payloadBytes);
+	if (header.payloadBytes > 0 && !ReadFull(fd, payload.data(), header.payloadBytes)) {
+		return false;
+	}
+	if (header.result == static_cast<uint8_t>(ReplyResult::InvalidRequest) || header.result == static_cast<uint8_t>(ReplyResult::UnknownSession)) {
+		return false;
+	}
+
+	session.status = header.status;
+	if (header.opcode == static_cast<uint8_t>(Opcode::NewGame)) {
+		session.sessionId = header.sessionId;
+		std::fill(session.visible.begin(), session.visible.end(), static_cast<uint8_t>(GameBoard::Covered));
+		return true;
+	}
+
+	for (uint32_t i = 0; i < header.changeCount; i++) {
+		uint32_t packed;
+		std::memcpy(&packed, &payload[i * sizeof(packed)], sizeof(packed));
+		session.visible[packed >> 4] = packed & 0xF;
+	}
+	return true;
+}
+
+// Plays random moves on all of the connection's sessions until the deadline
+static void RunConnection(const LoadTestOptions& options, int connectionIndex, Clock::time_point deadline,
+	std::atomic<bool>& IsStarted, ConnectionResult& result) {
+
+	std::mt19937_64 gen(connectionIndex + 1);
+	std::vector<uint8_t> payload;
+	std::vector<Request> requests(options.sessionsPerConnection);
+	std::vector<ClientSession> sessions(options.sessionsPerConnection);
+	for (ClientSession& session : sessions) {
+		session.visible.assign(options.nCols * options.nRows, GameBoard::Covered);
+	}
+
+	int fd = Connect(options.socketPath);
+	if (fd < 0) {
+		result.IsFailed = true;
+		return;
+	}
+
+	// Create all sessions
+	for (int i = 0; i < options.sessionsPerConnection; i++) {
+		requests[i] = CreateNewGameRequest(options, 0, gen);
+	}
+	if (!WriteFull(fd, requests.data(), requests.size() * sizeof(Request))) {
+		result.IsFailed = true;
+	}
+	for (int i = 0; i < options.sessionsPerConnection && !result.IsFailed; i++) {
+		result.IsFailed = !ReadReply(fd, sessions[i], payload);
+	}
+
+	// Wait until every connection has created its sessions
+	while (!IsStarted && !result.IsFailed) {
+		std::this_thread::yield();
+	}
+
+	// Send one request per session, then read all of the replies
+	result.latenciesMicro.reserve(1 << 22);
+	while (!result.IsFailed && Clock::now() < deadline) {
+
+		for (int i = 0; i < options.sessionsPerConnection; i++) {
+			bool IsGameOver = sessions[i].status == static_cast<uint8_t>(GameBoard::Status::Won)
+				|| sessions[i].status == static_cast<uint8_t>(GameBoard::Status::Lost);
+			requests[i] = IsGameOver ? CreateNewGameRequest(options, sessions[i].sessionId, gen) : CreateMoveRequest(options, sessions[i], gen);
+			result.gamesFinished += IsGameOver;
+		}
+
+		Clock::time_point sent = Clock::now();
+		if (!WriteFull(fd, requests.data(), requests.size() * sizeof(Request))) {
+			result.IsFailed = true;
+			break;
+		}
+
+		for (int i = 0; i < options.sessionsPerConnection; i++) {
+			if (!ReadReply(fd, sessions[i], payload)) {
+				result.IsFailed = true;
+				break;
+			}
+			Clock::time_point received = Clock::now();
+			result.latenciesMicro.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(received - sent).count()));
+			result.moves++;
+		}
+	}
+
+	close(fd);
+}
+
+// Returns the value at the given quantile of sorted latencies
+static uint32_t Percentile(const std::vector<uint32_t>& sorted, double quantile) {
+	if (sorted.empty()) {
+		return 0;
+	}
+	size_t index = static_cast<size_t>(quantile * (sorted.size() - 1));
+	return sorted[index];
+}
+
+int main(int argc, char** argv) {
+
+	LoadTestOptions options;
+
+	// Read command line options
+	for (int i = 1; i + 1 < argc; i += 2) {
+		std::string arg = argv[i];
+		if (arg == "--socket") { options.socketPath = argv[i + 1]; }
+		else if (arg == "--connections") { options.connections = atoi(argv[i + 1]); }
+		else if (arg == "--sessions") { options.sessionsPerConnection = atoi(argv[i + 1]); }
+		else if (arg == "--seconds") { options.seconds = atoi(argv[i + 1]); }
+		else if (arg == "--cols") { options.nCols = atoi(argv[i + 1]); }
+		else if (arg == "--rows") { options.nRows = atoi(argv[i + 1]); }
+		else if (arg == "--bombs") { options.numberOfBombs = atoi(argv[i + 1]); }
+		else {
+			fprintf(stderr, "Usage: %s [--socket path] [--connections n] [--sessions n] [--seconds n] [--cols n] [--rows n] [--bombs n]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	// Start every connection, the clock starts once all sessions have been created
+	std::atomic<bool> IsStarted(false);
+	std::vector<ConnectionResult> results(options.connections);
+	std::vector<std::thread> threads;
+	Clock::time_point deadline = Clock::now() + std::chrono::seconds(options.seconds + 1);
+	for (int i = 0; i < options.connections; i++) {
+		threads.emplace_back(RunConnection, std::cref(options), i, deadline, std::ref(IsStarted), std::ref(results[i]));
+	}
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+	Clock::time_point start = Clock::now();
+	IsStarted = true;
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+	// Merge the results of all connections
+	uint64_t moves = 0;
+	uint64_t gamesFinished = 0;
+	std::vector<uint32_t> latencies;
+	for (ConnectionResult& result : results) {
+		if (result.IsFailed) {
+			fprintf(stderr, "A connection failed (is the server running on %s?)\n", options.socketPath.c_str());
+			return 1;
+		}
+		moves += result.moves;
+		gamesFinished += result.gamesFinished;
+		latencies.insert(latencies.end(), result.latenciesMicro.begin(), result.latenciesMicro.end());
+	}
+	std::sort(latencies.begin(), latencies.end());
+
+	printf("sessions:        %d (%d connections x %d)\n", options.connections * options.sessionsPerConnection, options.connections, options.sessionsPerConnection);
+	printf("board:           %dx%d, %d bombs\n", options.nCols, options.nRows, options.numberOfBombs);
+	printf("moves:           %llu in %.2f s\n", static_cast<unsigned long long>(moves), elapsed);
+	printf("moves/s:         %.0f\n", moves / elapsed);
+	printf("games finished:  %llu\n", static_cast<unsigned long long>(gamesFinished));
+	printf("latency (us):    p50 %u  p90 %u  p99 %u  p99.9 %u  max %u\n",
+		Percentile(latencies, 0.50), Percentile(latencies, 0.90), Percentile(latencies, 0.99),
+		Percentile(latencies, 0.999), latencies.empty() ? 0 : latencies.back());
+
+	return 0;
+}
@@ -0,0 +1,128 @@
+// Benchmark for the minimap pyramid (MinesweeperGUI/MipPyramid.h) on a large board: plays a game while updating
+// the pyramid from the cells each move changed, checks it against a pyramid built from the board at the end,
+// then times drawing a window of pixels at random pan positions for every zoomed out level and the minimap.
+//
+// usage: minimapbench [cols] [rows] [bombPercent] [viewWidth] [viewHeight]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include "../MinesweeperGUI/MipPyramid.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const MipPyramid::Palette palette = { { 255, 255, 255 }, { 230, 230, 230 }, { 220, 0, 0 } };
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Times drawing a view of the given size at random positions on a level, returns the slowest frame
+static double TimeFrames(MipPyramid& pyramid, int level, int scale, int viewWidth, int viewHeight, double& average) {
+
+	int cols = std::min(pyramid.GetLevelCols(level), viewWidth / scale + 1);
+	int rows = std::min(pyramid.GetLevelRows(level), viewHeight / scale + 1);
+	std::vector<uint8_t> rgb(static_cast<size_t>(cols) * rows * scale * scale * 3);
+
+	const int frames = 100;
+	uint64_t state = 99;
+	double slowest = 0;
+	double total = 0;
+	for (int i = 0; i < frames; i++) {
+		int firstCol = static_cast<int>(GameBoard::RandomBelow(state, pyramid.GetLevelCols(level) - cols + 1));
+		int firstRow = static_cast<int>(GameBoard::RandomBelow(state, pyramid.GetLevelRows(level) - rows + 1));
+		Clock::time_point start = Clock::now();
+		pyramid.Render(level, firstCol, firstRow, cols, rows, scale, rgb.data());
+		double milliseconds = MillisecondsSince(start);
+		slowest = std::max(slowest, milliseconds);
+		total += milliseconds;
+	}
+	average = total / frames;
+	return slowest;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 4000;
+	int nRows = argc > 2 ? atoi(argv[2]) : 4000;
+	double bombPercent = argc > 3 ? atof(argv[3]) : 15;
+	int viewWidth = argc > 4 ? atoi(argv[4]) : 1280;
+	int viewHeight = argc > 5 ? atoi(argv[5]) : 800;
+	int numberOfBombs = static_cast<int>(static_cast<double>(nCols) * nRows * bombPercent / 100.0);
+
+	GameBoard board(nCols, nRows, numberOfBombs);
+	board.NewGame(2024);
+	MipPyramid pyramid;
+	pyramid.Reset(nCols, nRows, palette);
+	printf("%dx%d board, %d bombs, %d pyramid levels\n", nCols, nRows, numberOfBombs, pyramid.GetLevelCount());
+
+	// Play safe reveals and correct flags on random cells, updating the pyramid from each move's changes
+	uint64_t state = 7;
+	size_t cellsUpdated = 0;
+	double updateMilliseconds = 0;
+	for (int move = 0; move < 200000 && board.GetStatus() != GameBoard::Status::Won; move++) {
+		int x = static_cast<int>(GameBoard::RandomBelow(state, nCols));
+		int y = static_cast<int>(GameBoard::RandomBelow(state, nRows));
+		if (board.IsCleared(x, y) || board.IsFlagged(x, y)) {
+			continue;
+		}
+		if (move == 0) {
+			board.Reveal(nCols / 2, nRows / 2);
+		}
+		else if (board.IsBomb(x, y)) {
+			board.ToggleFlag(x, y);
+		}
+		else {
+			board.Reveal(x, y);
+		}
+
+		Clock::time_point start = Clock::now();
+		for (const GameBoard::CellChange& change : board.GetChanges()) {
+			pyramid.Update(change.index, change.visible);
+		}
+		updateMilliseconds += MillisecondsSince(start);
+		cellsUpdated += board.GetChanges().size();
+	}
+	printf("updated %zu cells in %.1f ms (%.1f ns per cell)\n", cellsUpdated, updateMilliseconds, updateMilliseconds * 1e6 / std::max<size_t>(cellsUpdated, 1));
+
+	// The incrementally updated pyramid must match one built from the board
+	MipPyramid rebuilt;
+	rebuilt.Reset(nCols, nRows, palette);
+	for (int index = 0; index < board.GetCellCount(); index++) {
+		rebuilt.Update(index, board.GetVisibleState()[index]);
+	}
+	for (int level = 0; level < pyramid.GetLevelCount(); level++) {
+		for (int y = 0; y < pyramid.GetLevelRows(level); y++) {
+			for (int x = 0; x < pyramid.GetLevelCols(level); x++) {
+				if (pyramid.GetRevealed(level, x, y) != rebuilt.GetRevealed(level, x, y) || pyramid.GetFlagged(level, x, y) != rebuilt.GetFlagged(level, x, y)) {
+					printf("level %d pixel %d,%d differs from the rebuilt pyramid\n", level, x, y);
+					return 1;
+				}
+			}
+		}
+	}
+	printf("pyramid matches the board\n");
+
+	// Time a view of the window size on each zoomed out level (level 0 drawn at 8, 4, 2 and 1 pixels per cell)
+	for (int scale = 8; scale >= 1; scale /= 2) {
+		double average = 0;
+		double slowest = TimeFrames(pyramid, 0, scale, viewWidth, viewHeight, average);
+		printf("level 0 at %d px per cell: %6.2f ms per frame (slowest %6.2f ms)\n", scale, average, slowest);
+	}
+	for (int level = 1; level < pyramid.GetLevelCount(); level++) {
+		double average = 0;
+		double slowest = TimeFrames(pyramid, level, 1, viewWidth, viewHeight, average);
+		printf("level %d (%dx%d): %6.2f ms per frame (slowest %6.2f ms)\n", level, pyramid.GetLevelCols(level), pyramid.GetLevelRows(level), average, slowest);
+	}
+
+	// The minimap draws the whole board from the level that fits in it
+	int minimapLevel = pyramid.GetLevelToFit(200, 200);
+	double average = 0;
+	double slowest = TimeFrames(pyramid, minimapLevel, 1, 200, 200, average);
+	printf("minimap (level %d): %6.2f ms per frame (slowest %6.2f ms)\n", minimapLevel, average, slowest);
+
+	return 0;
+}
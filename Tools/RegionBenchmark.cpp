@@ -0,0 +1,217 @@
+// Benchmark for the region index (MinesweeperGUI/RegionIndex.h): plays games on a large board in training mode with
+// the index kept up to date (reveals, flags on mines, undos), and checks it every few moves against a scan of the
+// board: the counts of random rectangles of each layer, and that the nearest cell found for a random view is at the
+// smallest distance there is. Times the queries against the scans, then plays the same moves with the index off
+// to measure what keeping it up to date costs.
+//
+// usage: regionbench [cols] [rows] [bombPercent] [moves]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const layerNames[] = { "unflagged mines", "flags", "covered cells" };
+
+// Define the moves recorded to be played again with the index off
+enum MoveType : uint8_t {
+	RevealMove,
+	FlagMove,
+	UndoMove,
+	NewGameMove
+};
+
+struct Move {
+	MoveType type;
+	int x;
+	int y;
+};
+
+static double MicrosecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+// Determines if a cell is in a layer of the index, from the board
+static bool IsInLayer(const GameBoard& board, RegionIndex::Layer layer, int x, int y) {
+	if (layer == RegionIndex::UnflaggedMines) {
+		return board.IsUnflaggedBomb(x, y);
+	}
+	if (layer == RegionIndex::Flags) {
+		return board.IsFlagged(x, y);
+	}
+	return !board.IsCleared(x, y) && !board.IsFlagged(x, y);
+}
+
+static int ScanCount(const GameBoard& board, RegionIndex::Layer layer, int left, int top, int right, int bottom) {
+	int count = 0;
+	for (int y = top; y < bottom; y++) {
+		for (int x = left; x < right; x++) {
+			count += IsInLayer(board, layer, x, y);
+		}
+	}
+	return count;
+}
+
+// Returns the distance (in rows or columns) of a cell from a rectangle, 0 inside it
+static int DistanceFrom(int x, int y, int left, int top, int right, int bottom) {
+	int distanceX = x < left ? left - x : x >= right ? x - right + 1 : 0;
+	int distanceY = y < top ? top - y : y >= bottom ? y - bottom + 1 : 0;
+	return std::max(distanceX, distanceY);
+}
+
+// Returns the smallest distance of a cell of a layer from a rectangle by scanning the board, -1 if there is none
+static int ScanNearestDistance(const GameBoard& board, RegionIndex::Layer layer, int left, int top, int right, int bottom) {
+	int nearest = -1;
+	for (int y = 0; y < board.GetRows(); y++) {
+		for (int x = 0; x < board.GetCols(); x++) {
+			if (IsInLayer(board, layer, x, y)) {
+				int distance = DistanceFrom(x, y, left, top, right, bottom);
+				nearest = nearest < 0 ? distance : std::min(nearest, distance);
+			}
+		}
+	}
+	return nearest;
+}
+
+// Plays the recorded moves on a board, returns the time spent in the moves
+static double PlayMoves(GameBoard& board, const std::vector<Move>& moves) {
+
+	Clock::time_point start = Clock::now();
+	for (const Move& move : moves) {
+		if (move.type == RevealMove) {
+			board.Reveal(move.x, move.y);
+		}
+		else if (move.type == FlagMove) {
+			board.ToggleFlag(move.x, move.y);
+		}
+		else if (move.type == UndoMove) {
+			board.Undo();
+		}
+		else {
+			board.NewGame(static_cast<uint64_t>(move.x));
+		}
+	}
+	return MicrosecondsSince(start);
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 2000;
+	int nRows = argc > 2 ? atoi(argv[2]) : 2000;
+	double bombPercent = argc > 3 ? atof(argv[3]) : 15;
+	int moveCount = argc > 4 ? atoi(argv[4]) : 20000;
+	int numberOfBombs = static_cast<int>(static_cast<double>(nCols) * nRows * bombPercent / 100.0);
+	const int checkInterval = 2000;
+	const int rectanglesPerCheck = 20;
+
+	GameBoard board;
+	board.SetTrainingMode(true);
+	board.Resize(nCols, nRows, numberOfBombs);
+	board.SetRegionTracking(true);
+	board.NewGame(1);
+	printf("%dx%d board, %d bombs, %d moves\n", nCols, nRows, numberOfBombs, moveCount);
+
+	// Reveal random safe cells and flag random mines (the bombs are known here), with some undos
+	std::vector<Move> moves;
+	uint64_t state = 5;
+	uint64_t seed = 1;
+	int checks = 0;
+	int games = 1;
+	int queries = 0;
+	double countMicroseconds = 0;
+	double nearestMicroseconds = 0;
+	double scanCountMicroseconds = 0;
+	double scanNearestMicroseconds = 0;
+
+	for (int i = 0; i < moveCount; i++) {
+
+		// A game in progress always has a covered safe cell, so a covered cell that is not flagged is found
+		Move move = { RevealMove, nCols / 2, nRows / 2 };
+		if (board.GetStatus() == GameBoard::Status::Won || board.GetStatus() == GameBoard::Status::Lost) {
+			move = { NewGameMove, static_cast<int>(++seed), 0 };
+			games++;
+		}
+		else if (board.GetStatus() == GameBoard::Status::Playing && GameBoard::RandomBelow(state, 100) < 3) {
+			move = { UndoMove, 0, 0 };
+		}
+		else if (board.GetStatus() == GameBoard::Status::Playing) {
+			int x, y;
+			do {
+				x = static_cast<int>(GameBoard::RandomBelow(state, nCols));
+				y = static_cast<int>(GameBoard::RandomBelow(state, nRows));
+			} while (board.IsCleared(x, y) || board.IsFlagged(x, y));
+			move = { board.IsBomb(x, y) ? FlagMove : RevealMove, x, y };
+		}
+		moves.push_back(move);
+		std::vector<Move> single(1, move);
+		PlayMoves(board, single);
+
+		if (i % checkInterval != 0 && i != moveCount - 1) {
+			continue;
+		}
+		checks++;
+
+		// Random views (of the size of a window, or of any size) counted and searched with the index and by a scan
+		const RegionIndex& regions = board.GetRegions();
+		for (int r = 0; r < rectanglesPerCheck; r++) {
+			int width = r % 2 == 0 ? 40 : 1 + static_cast<int>(GameBoard::RandomBelow(state, nCols));
+			int height = r % 2 == 0 ? 25 : 1 + static_cast<int>(GameBoard::RandomBelow(state, nRows));
+			int left = static_cast<int>(GameBoard::RandomBelow(state, nCols - std::min(width, nCols) + 1));
+			int top = static_cast<int>(GameBoard::RandomBelow(state, nRows - std::min(height, nRows) + 1));
+			int right = std::min(left + width, nCols);
+			int bottom = std::min(top + height, nRows);
+
+			for (int layer = 0; layer < RegionIndex::LayerCount; layer++) {
+				RegionIndex::Layer regionLayer = static_cast<RegionIndex::Layer>(layer);
+				Clock::time_point start = Clock::now();
+				int count = regions.Count(regionLayer, left, top, width, height);
+				countMicroseconds += MicrosecondsSince(start);
+
+				start = Clock::now();
+				int nearest = regions.FindNearest(regionLayer, left, top, width, height);
+				nearestMicroseconds += MicrosecondsSince(start);
+				queries++;
+
+				start = Clock::now();
+				int scanned = ScanCount(board, regionLayer, left, top, right, bottom);
+				scanCountMicroseconds += MicrosecondsSince(start);
+
+				start = Clock::now();
+				int scannedDistance = ScanNearestDistance(board, regionLayer, left, top, right, bottom);
+				scanNearestMicroseconds += MicrosecondsSince(start);
+
+				int distance = nearest < 0 ? -1 : DistanceFrom(nearest % nCols, nearest / nCols, left, top, right, bottom);
+				bool IsInLayerCell = nearest < 0 || IsInLayer(board, regionLayer, nearest % nCols, nearest / nCols);
+				if (count != scanned || distance != scannedDistance || !IsInLayerCell) {
+					printf("%s after move %d: %d counted (scan %d), nearest at distance %d (scan %d)\n",
+						layerNames[layer], i, count, scanned, distance, scannedDistance);
+					return 1;
+				}
+			}
+		}
+	}
+	printf("%d games, %d checks of %d views: the index matches a scan of the board\n", games, checks, rectanglesPerCheck);
+	printf("counts: %.2f us with the index, %.1f us scanning the view\n", countMicroseconds / queries, scanCountMicroseconds / queries);
+	printf("nearest cell to a view: %.2f us with the index, %.1f us scanning the board\n", nearestMicroseconds / queries, scanNearestMicroseconds / queries);
+
+	// Play the same moves with and without the index
+	GameBoard tracked;
+	tracked.SetTrainingMode(true);
+	tracked.Resize(nCols, nRows, numberOfBombs);
+	tracked.SetRegionTracking(true);
+	tracked.NewGame(1);
+	double trackedMicroseconds = PlayMoves(tracked, moves);
+
+	GameBoard untracked;
+	untracked.SetTrainingMode(true);
+	untracked.Resize(nCols, nRows, numberOfBombs);
+	untracked.NewGame(1);
+	double untrackedMicroseconds = PlayMoves(untracked, moves);
+
+	printf("moves: %.2f us each with the index, %.2f us without it\n", trackedMicroseconds / moves.size(), untrackedMicroseconds / moves.size());
+	return 0;
+}
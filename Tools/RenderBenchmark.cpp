@@ -0,0 +1,435 @@
+// Headless benchmark for drawing the grid (MinesweeperGUI/GridRenderCache.h and TileCache.h): plays scripted sessions
+// on boards of several sizes and paints a window sized view of the grid into a bitmap (a wxMemoryDC) after every step,
+// the way MainFrame paints the grid, timing every frame and counting the cells drawn for it. The sessions are:
+//   - opening: the first reveal of a board with few mines, shown outward from the clicked cell a slice at a time
+//     (as the reveal animation shows it)
+//   - flag mode: flag mode turned on and off, which changes the tile of every covered cell
+//   - scroll: the view swept over the grid in rows, a few cells at a time
+//   - game over: games lost on a mine, with the mines and the false flags shown (as MainFrame::ShowMinesAndFalseFlags)
+// Every board and move comes from a seed, so a build draws the same frames on any machine. Nothing is shown, but the
+// toolkit still needs a display: on a machine without one run it under a virtual X server (xvfb-run ./renderbench).
+// With --cells it compares the paint time per 1,000 cells of the ways the grid has drawn its cells instead: labels on
+// a window of buttons (before the cell images), the cell images on the buttons, and the render cache
+//
+// usage: renderbench [viewWidth] [viewHeight]
+//        renderbench --cells
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include "../MinesweeperGUI/GridRenderCache.h"
+#include "../MinesweeperGUI/TileCache.h"
+#include <wx/wx.h>
+#include <wx/dcmemory.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the boards the sessions are played on (columns, rows, and the % of mines of the game over session)
+static const int boardSizes[][3] = { { 30, 16, 20 }, { 500, 500, 15 }, { 2000, 2000, 15 } };
+
+// Define the % of mines of the opening session's board (few mines make big openings), the cells shown in a slice
+// of the opening, the frames of the scroll sweep and the games of the game over session
+static const int openingBombPercent = 3;
+static const size_t openingSliceCells = 4096;
+static const int scrollStep = 40;
+static const int maxScrollFrames = 1500;
+static const int gameOverGames = 10;
+
+// Define the cell size and colors used by MainFrame
+static const int cellSize = 60;
+static const wxColour gridLineColour(160, 160, 160);
+static const wxColour backgroundColour(230, 230, 230);
+
+// Define the grid the cell paths are compared on (--cells, the expert preset) and its rounds of updates, and the
+// colors of the numbers of the labels the buttons of the grid had before the cell images
+static const int buttonCols = 30;
+static const int buttonRows = 16;
+static const int cellRounds = 40;
+static const wxColour numberColours[] = { wxColour(0, 0, 0), wxColour(0, 0, 255), wxColour(0, 128, 0), wxColour(255, 0, 0), wxColour(0, 0, 139),
+	wxColour(139, 0, 0), wxColour(95, 158, 160), wxColour(0, 0, 0), wxColour(128, 128, 128) };
+
+// Define a painted frame: the time it took and the cells drawn into render tiles for it
+struct Frame {
+	double milliseconds;
+	uint64_t cellsDrawn;
+};
+
+// Draws the grid of a board the way the game screen does: a tile for every cell, drawn into the render tiles of
+// the render cache and painted into a view of the window's size
+class GridView
+{
+public:
+
+	GridView(int viewWidth, int viewHeight)
+		: tileCache(wxUniChar(0x0001F6A9), wxUniChar(0x0001F3F3), wxUniChar(0x0001F4A3), wxUniChar(0x00002716), wxColour(*wxWHITE), backgroundColour),
+		renderCache(gridLineColour, backgroundColour), viewBitmap(viewWidth, viewHeight), viewWidth(viewWidth), viewHeight(viewHeight) {
+		tileCache.Build(wxSize(cellSize - 1, cellSize - 1), 1.0);
+		viewDC.SelectObject(viewBitmap);
+	}
+
+	// Covers every cell of a board of the given size (no render tile is drawn yet), with the view at its top left
+	void Reset(int nCols, int nRows) {
+		this->nCols = nCols;
+		this->nRows = nRows;
+		cellTiles.assign(static_cast<size_t>(nCols) * nRows, TileCache::Covered);
+		renderCache.Reset(nCols, nRows);
+		renderCache.SetCellSize(cellSize, 1.0);
+		renderCache.SetViewSize(wxSize(viewWidth, viewHeight));
+		viewOrigin = wxPoint(0, 0);
+	}
+
+	// Sets the tile of a cell, its render tile draws it again the next time it is painted
+	void SetTile(int index, TileCache::Tile tile) {
+		if (cellTiles[index] != tile) {
+			cellTiles[index] = tile;
+			renderCache.InvalidateCell(index % nCols, index / nCols);
+		}
+	}
+
+	// Sets the tile of a cell from its visible value on the board
+	void ShowCell(int index, uint8_t visible) {
+		SetTile(index, visible == GameBoard::Flagged ? TileCache::Flag : static_cast<TileCache::Tile>(visible));
+	}
+
+	// Moves the view (in pixels of the grid), it stays inside the grid
+	void ScrollTo(int x, int y) {
+		wxSize gridSize = renderCache.GetGridSize();
+		viewOrigin.x = std::max(0, std::min(x, gridSize.GetWidth() - viewWidth));
+		viewOrigin.y = std::max(0, std::min(y, gridSize.GetHeight() - viewHeight));
+	}
+
+	// Moves the view to put a cell in its center
+	void CenterOn(int index) {
+		ScrollTo((index % nCols) * cellSize - viewWidth / 2, (index / nCols) * cellSize - viewHeight / 2);
+	}
+
+	// Paints the whole view, and adds the frame to the frames
+	void Paint(std::vector<Frame>& frames) {
+		uint64_t cellsBefore = renderCache.GetStats().cellsDrawn;
+		Clock::time_point start = Clock::now();
+		renderCache.Draw(viewDC, wxRect(0, 0, viewWidth, viewHeight), viewOrigin, cellTiles, tileCache);
+		double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		frames.push_back({ milliseconds, renderCache.GetStats().cellsDrawn - cellsBefore });
+	}
+
+	wxSize GetGridSize() const { return renderCache.GetGridSize(); }
+	int GetViewWidth() const { return viewWidth; }
+	int GetViewHeight() const { return viewHeight; }
+
+private:
+
+	TileCache tileCache;
+	GridRenderCache renderCache;
+	std::vector<TileCache::Tile> cellTiles;
+	wxBitmap viewBitmap;
+	wxMemoryDC viewDC;
+	wxPoint viewOrigin;
+	int viewWidth;
+	int viewHeight;
+	int nCols = 0;
+	int nRows = 0;
+};
+
+// Shows the cells changed by a board's last move
+static void ShowChanges(GridView& view, const GameBoard& board) {
+	for (const GameBoard::CellChange& change : board.GetChanges()) {
+		view.ShowCell(change.index, change.visible);
+	}
+}
+
+// Reveals the center of a board with few mines, and shows the opening a slice at a time from the nearest cells
+// to the farthest, painting a frame after each slice
+static std::vector<Frame> PlayOpening(GridView& view, GameBoard& board) {
+
+	std::vector<Frame> frames;
+	int nCols = board.GetCols();
+	int center = board.GetIndex(nCols / 2, board.GetRows() / 2);
+	view.CenterOn(center);
+	view.Paint(frames);
+
+	board.Reveal(nCols / 2, board.GetRows() / 2);
+	std::vector<GameBoard::CellChange> changes(board.GetChanges().begin(), board.GetChanges().end());
+	auto Distance = [&](const GameBoard::CellChange& change) {
+		return std::max(std::abs(static_cast<int>(change.index % nCols) - nCols / 2), std::abs(static_cast<int>(change.index / nCols) - board.GetRows() / 2));
+	};
+	std::stable_sort(changes.begin(), changes.end(), [&](const GameBoard::CellChange& a, const GameBoard::CellChange& b) { return Distance(a) < Distance(b); });
+
+	for (size_t first = 0; first < changes.size(); first += openingSliceCells) {
+		size_t last = std::min(changes.size(), first + openingSliceCells);
+		for (size_t i = first; i < last; i++) {
+			view.ShowCell(changes[i].index, changes[i].visible);
+		}
+		view.Paint(frames);
+	}
+	return frames;
+}
+
+// Turns flag mode on and off a few times (every covered cell shows the flag indicator while it is on)
+static std::vector<Frame> PlayFlagMode(GridView& view, const GameBoard& board) {
+
+	std::vector<Frame> frames;
+	const uint8_t* visible = board.GetVisibleState();
+	for (int toggle = 0; toggle < 10; toggle++) {
+		TileCache::Tile tile = toggle % 2 == 0 ? TileCache::FlagIndicator : TileCache::Covered;
+		for (int index = 0; index < board.GetCellCount(); index++) {
+			if (visible[index] == GameBoard::Covered) {
+				view.SetTile(index, tile);
+			}
+		}
+		view.Paint(frames);
+	}
+	return frames;
+}
+
+// Sweeps the view over the grid in rows of the view's height, left to right then right to left
+static std::vector<Frame> PlayScroll(GridView& view) {
+
+	std::vector<Frame> frames;
+	wxSize gridSize = view.GetGridSize();
+	int maxX = std::max(0, gridSize.GetWidth() - view.GetViewWidth());
+	int maxY = std::max(0, gridSize.GetHeight() - view.GetViewHeight());
+	bool IsMovingRight = true;
+
+	for (int y = 0; static_cast<int>(frames.size()) < maxScrollFrames; y += view.GetViewHeight()) {
+		for (int step = 0; step <= maxX / scrollStep && static_cast<int>(frames.size()) < maxScrollFrames; step++) {
+			view.ScrollTo(IsMovingRight ? step * scrollStep : maxX - step * scrollStep, std::min(y, maxY));
+			view.Paint(frames);
+		}
+		IsMovingRight = !IsMovingRight;
+		if (y >= maxY) {
+			break;
+		}
+	}
+	return frames;
+}
+
+// Plays games that are lost: the first reveal, some flags (on mines and on safe cells), then a reveal of a mine.
+// The frame that shows the mines and the false flags is timed
+static std::vector<Frame> PlayGameOver(GridView& view, GameBoard& board) {
+
+	std::vector<Frame> frames;
+	std::vector<Frame> setupFrames;
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	uint64_t state = 7;
+
+	for (int game = 0; game < gameOverGames; game++) {
+		view.Reset(nCols, nRows);
+		board.NewGame(static_cast<uint64_t>(game) + 1);
+		board.Reveal(nCols / 2, nRows / 2);
+		ShowChanges(view, board);
+
+		// Flag random covered cells near the center, then lose on the nearest unflagged mine
+		int spread = std::min(std::min(nCols, nRows), 40);
+		for (int flag = 0; flag < 60; flag++) {
+			int x = nCols / 2 - spread / 2 + static_cast<int>(GameBoard::RandomBelow(state, spread));
+			int y = nRows / 2 - spread / 2 + static_cast<int>(GameBoard::RandomBelow(state, spread));
+			if (!board.IsCleared(x, y) && !board.IsFlagged(x, y) && board.ToggleFlag(x, y)) {
+				ShowChanges(view, board);
+			}
+		}
+		int mine = -1;
+		for (int distance = 0; mine < 0 && distance < std::max(nCols, nRows); distance++) {
+			for (int y = std::max(0, nRows / 2 - distance); mine < 0 && y <= std::min(nRows - 1, nRows / 2 + distance); y++) {
+				for (int x = std::max(0, nCols / 2 - distance); mine < 0 && x <= std::min(nCols - 1, nCols / 2 + distance); x++) {
+					mine = board.IsUnflaggedBomb(x, y) ? board.GetIndex(x, y) : -1;
+				}
+			}
+		}
+		if (mine < 0) {
+			continue;
+		}
+
+		// The view is painted before the mine is revealed, so the game over frame only draws what changed
+		view.CenterOn(mine);
+		view.Paint(setupFrames);
+		board.Reveal(mine % nCols, mine / nCols);
+		ShowChanges(view, board);
+
+		// The engine lists the unflagged mines and the false flags of a lost game, the window shows them
+		for (int y = 0; y < nRows; y++) {
+			for (int x = 0; x < nCols; x++) {
+				if (board.IsUnflaggedBomb(x, y)) {
+					view.SetTile(board.GetIndex(x, y), TileCache::Bomb);
+				}
+				else if (board.IsFlagged(x, y) && !board.IsBomb(x, y)) {
+					view.SetTile(board.GetIndex(x, y), TileCache::FalseFlag);
+				}
+			}
+		}
+		view.Paint(frames);
+	}
+	return frames;
+}
+
+// Prints the distribution of the frame times of a session and the cells drawn per frame
+static void Report(const char* board, const char* session, const std::vector<Frame>& frames) {
+
+	if (frames.empty()) {
+		printf("%-10s %-10s no frames\n", board, session);
+		return;
+	}
+	std::vector<double> times;
+	uint64_t cellsDrawn = 0;
+	uint64_t maxCells = 0;
+	for (const Frame& frame : frames) {
+		times.push_back(frame.milliseconds);
+		cellsDrawn += frame.cellsDrawn;
+		maxCells = std::max(maxCells, frame.cellsDrawn);
+	}
+	std::sort(times.begin(), times.end());
+	auto Percentile = [&](double share) { return times[std::min(times.size() - 1, static_cast<size_t>(share * times.size()))]; };
+
+	printf("%-10s %-10s %7d %8.2f %8.2f %8.2f %8.2f %12.0f %10llu\n", board, session, static_cast<int>(frames.size()),
+		Percentile(0.5), Percentile(0.9), Percentile(0.99), times.back(), static_cast<double>(cellsDrawn) / frames.size(),
+		static_cast<unsigned long long>(maxCells));
+}
+
+// Gives the tile a cell shows in a round of the cell path comparison, every round changes the tile of every cell
+static TileCache::Tile GetRoundTile(size_t index, int round) {
+	static const TileCache::Tile cycle[] = { TileCache::Covered, static_cast<TileCache::Tile>(1), TileCache::Flag, static_cast<TileCache::Tile>(3),
+		TileCache::FlagIndicator, static_cast<TileCache::Tile>(2), TileCache::Bomb, static_cast<TileCache::Tile>(5) };
+	return cycle[(index + round) % (sizeof(cycle) / sizeof(cycle[0]))];
+}
+
+// Shows a tile on a button the way the grid did before the cell images: a label (the emoji go through font
+// fallback), and the color of the number
+static void SetCellLabel(wxButton* button, TileCache::Tile tile) {
+	switch (tile) {
+	case TileCache::Covered:
+		button->SetLabel("");
+		break;
+	case TileCache::Flag:
+		button->SetLabel(wxString(wxUniChar(0x0001F6A9)));
+		break;
+	case TileCache::FlagIndicator:
+		button->SetLabel(wxString(wxUniChar(0x0001F3F3)));
+		break;
+	case TileCache::Bomb:
+		button->SetLabel(wxString(wxUniChar(0x0001F4A3)));
+		break;
+	default:
+		button->SetLabel(wxString::Format("%d", static_cast<int>(tile)));
+		button->SetForegroundColour(numberColours[tile]);
+		button->Refresh();
+		break;
+	}
+}
+
+// Times the rounds of updates of every cell of a grid of buttons, each round is painted before the next one,
+// returns the time per 1,000 cells (the first round isn't timed, it loads the fonts and draws the buttons once)
+template <class Function>
+static double TimeButtonRounds(wxWindow* grid, const std::vector<wxButton*>& buttons, Function setCell) {
+
+	Clock::time_point start = Clock::now();
+	for (int round = -1; round < cellRounds; round++) {
+		if (round == 0) {
+			start = Clock::now();
+		}
+		for (size_t i = 0; i < buttons.size(); i++) {
+			setCell(buttons[i], GetRoundTile(i, round + 1));
+		}
+		grid->Update();
+	}
+	double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+	return milliseconds * 1000.0 / (static_cast<double>(buttons.size()) * cellRounds);
+}
+
+// Compares the paint time per 1,000 cells of the ways the grid has drawn its cells: labels on buttons, cell images
+// on buttons (TileCache.h), and the render cache of the game screen, on a shown window of buttonCols x buttonRows
+static void CompareCellPaths() {
+
+	wxFrame* window = new wxFrame(nullptr, wxID_ANY, "renderbench");
+	wxPanel* grid = new wxPanel(window);
+	grid->SetFont(wxFont(wxFontInfo(wxSize(0, 24)).Bold()));
+	wxGridSizer* gridSizer = new wxGridSizer(buttonRows, buttonCols, 0, 0);
+	std::vector<wxButton*> buttons;
+	for (int i = 0; i < buttonCols * buttonRows; i++) {
+		buttons.push_back(new wxButton(grid, wxID_ANY));
+		buttons.back()->SetMinSize(wxSize(cellSize, cellSize));
+		gridSizer->Add(buttons.back(), 1, wxEXPAND | wxALL);
+	}
+	grid->SetSizer(gridSizer);
+	window->SetClientSize(buttonCols * cellSize, buttonRows * cellSize);
+	window->Show();
+	window->Update();
+
+	double labelMilliseconds = TimeButtonRounds(grid, buttons, SetCellLabel);
+	for (wxButton* button : buttons) {
+		button->SetLabel("");
+	}
+	TileCache tileCache(wxUniChar(0x0001F6A9), wxUniChar(0x0001F3F3), wxUniChar(0x0001F4A3), wxUniChar(0x00002716), wxColour(*wxWHITE), backgroundColour);
+	tileCache.Build(wxSize(cellSize - 1, cellSize - 1), grid->GetContentScaleFactor());
+	double tileMilliseconds = TimeButtonRounds(grid, buttons, [&](wxButton* button, TileCache::Tile tile) { button->SetBitmap(tileCache.Get(tile)); });
+	window->Destroy();
+
+	// The same rounds drawn by the render cache into a view of the window's size
+	GridView view(buttonCols * cellSize, buttonRows * cellSize);
+	std::vector<Frame> frames;
+	view.Reset(buttonCols, buttonRows);
+	view.Paint(frames);
+	frames.clear();
+	for (int round = 0; round < cellRounds; round++) {
+		for (int i = 0; i < buttonCols * buttonRows; i++) {
+			view.SetTile(i, GetRoundTile(i, round + 1));
+		}
+		view.Paint(frames);
+	}
+	double cacheMilliseconds = 0;
+	for (const Frame& painted : frames) {
+		cacheMilliseconds += painted.milliseconds;
+	}
+	cacheMilliseconds = cacheMilliseconds * 1000.0 / (buttonCols * buttonRows * cellRounds);
+
+	printf("%dx%d cells, %d rounds that change every cell, each painted before the next\n", buttonCols, buttonRows, cellRounds);
+	printf("labels on buttons (before the cell images) %8.2f ms per 1,000 cells\n", labelMilliseconds);
+	printf("cell images on buttons                     %8.2f ms per 1,000 cells (%.1fx)\n", tileMilliseconds, labelMilliseconds / tileMilliseconds);
+	printf("render cache (the game screen)             %8.2f ms per 1,000 cells (%.1fx)\n", cacheMilliseconds, labelMilliseconds / cacheMilliseconds);
+}
+
+// Runs the benchmark once the toolkit is set up (no window is created)
+class RenderBenchmarkApp : public wxApp
+{
+public:
+
+	bool OnInit() override {
+		return true;
+	}
+
+	int OnRun() override {
+
+		if (argc > 1 && wxString(argv[1]) == "--cells") {
+			CompareCellPaths();
+			return 0;
+		}
+		int viewWidth = argc > 1 ? wxAtoi(argv[1]) : 840;
+		int viewHeight = argc > 2 ? wxAtoi(argv[2]) : 600;
+		GridView view(viewWidth, viewHeight);
+		printf("%dx%d view, %d pixel cells, frame times in ms\n", viewWidth, viewHeight, cellSize);
+		printf("%-10s %-10s %7s %8s %8s %8s %8s %12s %10s\n", "board", "session", "frames", "p50", "p90", "p99", "max", "cells/frame", "max cells");
+
+		for (const int* size : boardSizes) {
+			int nCols = size[0];
+			int nRows = size[1];
+			char name[32];
+			snprintf(name, sizeof(name), "%dx%d", nCols, nRows);
+
+			GameBoard board;
+			board.Resize(nCols, nRows, std::max(1, nCols * nRows * openingBombPercent / 100));
+			board.NewGame(1);
+			view.Reset(nCols, nRows);
+			Report(name, "opening", PlayOpening(view, board));
+			Report(name, "flag mode", PlayFlagMode(view, board));
+			Report(name, "scroll", PlayScroll(view));
+
+			board.Resize(nCols, nRows, nCols * nRows * size[2] / 100);
+			Report(name, "game over", PlayGameOver(view, board));
+		}
+		return 0;
+	}
+};
+
+wxIMPLEMENT_APP(RenderBenchmarkApp);
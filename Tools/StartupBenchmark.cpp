@@ -0,0 +1,198 @@
+// Benchmark for the time from the Start click to the first frame of the grid (MainFrame::ShowGame), for every grid
+// size up to the largest custom grid. Does the work the game screen does for the grid before its first frame (the
+// buffers of the cells shown, the tile images and the render cache as MainFrame::CreateMatrix sets them up, the board
+// handed to the engine thread with a Resize command) and paints the first view of the grid into a bitmap of the
+// window's size (a wxMemoryDC) while the engine sizes the board. Then waits for the engine and sets up the minimap
+// pyramid, as the window does after the first frame. The same work done the way it was before (the board sized and
+// the pyramid set up before the first frame) is timed next to it. The widgets of the game screen are not included,
+// the window shows the whole time in its status bar. Fails if the first frame of any grid size takes longer than the
+// budget. Nothing is shown, but the toolkit still needs a display: on a machine without one run it under a virtual
+// X server (xvfb-run ./startupbench)
+//
+// usage: startupbench [budgetMilliseconds] [runs] [viewWidth] [viewHeight]
+
+#include "../MinesweeperGUI/EngineThread.h"
+#include "../MinesweeperGUI/GridRenderCache.h"
+#include "../MinesweeperGUI/MipPyramid.h"
+#include "../MinesweeperGUI/TileCache.h"
+#include <wx/wx.h>
+#include <wx/dcmemory.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the grid sizes timed (the presets, then custom grids up to the largest one)
+static const int gridSizes[][2] = { { 9, 9 }, { 16, 16 }, { 16, 30 }, { 500, 500 }, { 1000, 1000 }, { 2000, 2000 }, { 4000, 4000 } };
+
+// Define the colors of the minimap (as in MainFrame)
+static const MipPyramid::Palette minimapPalette = { { 160, 160, 160 }, { 235, 235, 235 }, { 220, 0, 0 } };
+
+// Define the cell size and colors used by MainFrame
+static const int cellSize = 60;
+static const wxColour gridLineColour(160, 160, 160);
+static const wxColour backgroundColour(230, 230, 230);
+
+// Define the times of one run, in milliseconds from the Start click
+struct StartupTimes {
+	double firstFrame = 0;
+	double boardReady = 0;
+	double minimapReady = 0;
+};
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// The grid of the game screen: the tile images, the render cache and the view the first frame is painted into
+class GameScreen
+{
+public:
+
+	GameScreen(int viewWidth, int viewHeight)
+		: tileCache(wxUniChar(0x0001F6A9), wxUniChar(0x0001F3F3), wxUniChar(0x0001F4A3), wxUniChar(0x00002716), wxColour(*wxWHITE), backgroundColour),
+		renderCache(gridLineColour, backgroundColour), viewBitmap(viewWidth, viewHeight), viewWidth(viewWidth), viewHeight(viewHeight) {
+		viewDC.SelectObject(viewBitmap);
+	}
+
+	// Sets up the grid as MainFrame::CreateMatrix does: the cell images, every cell covered, no render tile drawn yet
+	void CreateMatrix(int nCols, int nRows) {
+		tileCache.Build(wxSize(cellSize - 1, cellSize - 1), 1.0);
+		cellTiles.assign(static_cast<size_t>(nCols) * nRows, TileCache::Covered);
+		renderCache.Reset(nCols, nRows);
+		renderCache.SetCellSize(cellSize, 1.0);
+		renderCache.SetViewSize(wxSize(viewWidth, viewHeight));
+	}
+
+	// Paints the view at the top left of the grid, as the first paint event of the scrolled window does
+	void PaintFirstFrame() {
+		renderCache.Draw(viewDC, wxRect(0, 0, viewWidth, viewHeight), wxPoint(0, 0), cellTiles, tileCache);
+	}
+
+private:
+
+	TileCache tileCache;
+	GridRenderCache renderCache;
+	std::vector<TileCache::Tile> cellTiles;
+	wxBitmap viewBitmap;
+	wxMemoryDC viewDC;
+	int viewWidth;
+	int viewHeight;
+};
+
+// Sets up a game the way the game screen does: the cell buffers and the grid before the first frame, painted while
+// the engine sizes the board, then the pyramid once the engine is done
+static StartupTimes TimeStartup(int nCols, int nRows, int numberOfBombs, int viewWidth, int viewHeight) {
+
+	StartupTimes times;
+	Clock::time_point start = Clock::now();
+	GameBoard board;
+	EngineThread engine;
+	MipPyramid pyramid;
+	GameScreen screen(viewWidth, viewHeight);
+	std::atomic<bool> IsResultReady{ false };
+
+	board.SetRegionTracking(true);
+	screen.CreateMatrix(nCols, nRows);
+	std::vector<uint8_t> visibleCells(static_cast<size_t>(nCols) * nRows, GameBoard::Covered);
+	engine.Start(board, [&]() { IsResultReady = true; });
+
+	EngineThread::Command command;
+	command.type = EngineThread::CommandType::Resize;
+	command.width = nCols;
+	command.height = nRows;
+	command.numberOfBombs = numberOfBombs;
+	command.seed = 1;
+	engine.Submit(command);
+	screen.PaintFirstFrame();
+	times.firstFrame = MillisecondsSince(start);
+
+	// The window gets the result from its event loop
+	bool IsBoardReady = false;
+	while (!IsBoardReady) {
+		while (!IsResultReady) {
+			std::this_thread::yield();
+		}
+		IsResultReady = false;
+		engine.DrainResults([&](const EngineThread::Result& result) { IsBoardReady |= result.command.type == EngineThread::CommandType::Resize; });
+	}
+	times.boardReady = MillisecondsSince(start);
+
+	pyramid.Reset(nCols, nRows, minimapPalette);
+	times.minimapReady = MillisecondsSince(start);
+	engine.Stop();
+	return times;
+}
+
+// Sets up a game the way it was before, everything before the first frame on the UI thread
+static double TimeUpfrontStartup(int nCols, int nRows, int numberOfBombs, int viewWidth, int viewHeight) {
+
+	Clock::time_point start = Clock::now();
+	GameBoard board;
+	MipPyramid pyramid;
+	GameScreen screen(viewWidth, viewHeight);
+	board.Resize(nCols, nRows, numberOfBombs);
+	board.NewGame(1);
+	board.SetRegionTracking(true);
+	pyramid.Reset(nCols, nRows, minimapPalette);
+	std::vector<uint8_t> visibleCells(static_cast<size_t>(nCols) * nRows, GameBoard::Covered);
+	screen.CreateMatrix(nCols, nRows);
+	screen.PaintFirstFrame();
+	return MillisecondsSince(start);
+}
+
+// Runs the benchmark once the toolkit is set up (no window is created)
+class StartupBenchmarkApp : public wxApp
+{
+public:
+
+	bool OnInit() override {
+		return true;
+	}
+
+	int OnRun() override;
+};
+
+int StartupBenchmarkApp::OnRun() {
+
+	double budget = argc > 1 ? wxAtof(argv[1]) : 100;
+	int runs = argc > 2 ? std::max(1, wxAtoi(argv[2])) : 3;
+	int viewWidth = argc > 3 ? wxAtoi(argv[3]) : 840;
+	int viewHeight = argc > 4 ? wxAtoi(argv[4]) : 600;
+	bool IsWithinBudget = true;
+	printf("%dx%d view, %d pixel cells\n", viewWidth, viewHeight, cellSize);
+
+	// The best of the runs is shown for each time, the other programs running are not part of the startup
+	printf("%-11s %12s %12s %14s %14s\n", "grid", "first frame", "board ready", "minimap ready", "all up front");
+	for (const int* size : gridSizes) {
+		int nCols = size[0];
+		int nRows = size[1];
+		int numberOfBombs = static_cast<int>(static_cast<int64_t>(nCols) * nRows * 15 / 100);
+		StartupTimes best;
+		double bestUpfront = 0;
+		for (int run = 0; run < runs; run++) {
+			StartupTimes times = TimeStartup(nCols, nRows, numberOfBombs, viewWidth, viewHeight);
+			double upfront = TimeUpfrontStartup(nCols, nRows, numberOfBombs, viewWidth, viewHeight);
+			best.firstFrame = run == 0 ? times.firstFrame : std::min(best.firstFrame, times.firstFrame);
+			best.boardReady = run == 0 ? times.boardReady : std::min(best.boardReady, times.boardReady);
+			best.minimapReady = run == 0 ? times.minimapReady : std::min(best.minimapReady, times.minimapReady);
+			bestUpfront = run == 0 ? upfront : std::min(bestUpfront, upfront);
+		}
+
+		char grid[32];
+		snprintf(grid, sizeof(grid), "%dx%d", nCols, nRows);
+		printf("%-11s %9.2f ms %9.2f ms %11.2f ms %11.2f ms%s\n", grid, best.firstFrame, best.boardReady, best.minimapReady, bestUpfront,
+			best.firstFrame > budget ? "  over budget" : "");
+		IsWithinBudget &= best.firstFrame <= budget;
+	}
+
+	printf(IsWithinBudget ? "every first frame is within the %.0f ms budget\n" : "a first frame is over the %.0f ms budget\n", budget);
+	return IsWithinBudget ? 0 : 1;
+}
+
+wxIMPLEMENT_APP(StartupBenchmarkApp);
@@ -0,0 +1,273 @@
+// Benchmark and check for the game statistics (MinesweeperGUI/StatsStore.h): adds seeded games to a new log the way
+// the window does when games end, and times it. Then reopens the log to time opening it from its summary against
+// reading the whole log, and checks:
+//   - the summary opened, and the summaries caught up from an old summary and from a record cut short by a crash,
+//     are the same as the summary rebuilt from every record of the log
+//   - the median, 90% and 99% clear times of each board (and of every board, from the merged sketches) are within
+//     2% of the exact times of the games
+//   - GameBoard::Count3BV gives the same 3BV as a count done another way, on seeded boards of every shape
+// It fails if any of them doesn't hold. The files are written in the current folder and removed at the end.
+//
+// usage: statsbench [games]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include "../MinesweeperGUI/StatsStore.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <string>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the boards the games are played on (each is played on every shape), and the time a game usually takes
+struct BenchmarkBoard {
+	int nCols;
+	int nRows;
+	int numberOfBombs;
+	double typicalSeconds;
+};
+static const BenchmarkBoard benchmarkBoards[] = { { 9, 9, 15, 20 }, { 16, 16, 50, 90 }, { 30, 16, 100, 240 }, { 200, 200, 6000, 4000 } };
+
+// Define the files written (and removed at the end)
+static const std::string logPath = "statsbench.log";
+static const std::string summaryPath = "statsbench.summary";
+
+// Define the quantiles checked, and how far from the exact time they may be (the sketch's 2%, and the rounding of
+// the exact time to whole milliseconds)
+static const double checkedQuantiles[] = { 0.5, 0.9, 0.99 };
+static const double quantileTolerance = 0.02;
+
+static double MillisecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// Creates the record of a seeded game: a random board and shape, a tenth of them in training mode, about 40% won
+static GameRecord CreateGame(uint64_t game) {
+
+	uint64_t state = game;
+	const BenchmarkBoard& board = benchmarkBoards[GameBoard::RandomBelow(state, sizeof(benchmarkBoards) / sizeof(benchmarkBoards[0]))];
+	GameRecord record = {};
+	record.finishTime = 1700000000 + static_cast<int64_t>(game) * 60;
+	record.seed = GameBoard::NextRandom(state);
+	record.nCols = static_cast<uint16_t>(board.nCols);
+	record.nRows = static_cast<uint16_t>(board.nRows);
+	record.numberOfBombs = board.numberOfBombs;
+	record.topology = static_cast<uint8_t>(GameBoard::RandomBelow(state, 4));
+	record.options = GameBoard::RandomBelow(state, 10) == 0 ? TrainingModeGame : 0;
+	record.IsWon = GameBoard::RandomBelow(state, 100) < 40;
+
+	// The times spread from a quarter to 4 times the typical time (a log-uniform spread)
+	double spread = std::pow(16.0, GameBoard::RandomBelow(state, 1 << 20) / static_cast<double>(1 << 20)) / 4;
+	record.milliseconds = static_cast<uint32_t>(board.typicalSeconds * 1000 * spread * (record.IsWon ? 1 : 0.3));
+	record.bbbv = static_cast<uint32_t>(board.nCols * board.nRows / 5 + GameBoard::RandomBelow(state, 50));
+	return record;
+}
+
+// Rebuilds the summary from every record of the log
+static StatsSummary RebuildSummary() {
+	StatsSummary summary;
+	StatsStore::ReadLog(logPath, 0, UINT64_MAX, [&](const GameRecord& record) { summary.Add(record); });
+	return summary;
+}
+
+// Compares two summaries byte for byte (a board's statistics are plain values)
+static bool IsSameSummary(const StatsSummary& summary, const StatsSummary& expected, const char* when) {
+
+	const std::vector<BoardStats>& boards = summary.GetBoards();
+	const std::vector<BoardStats>& expectedBoards = expected.GetBoards();
+	bool IsSame = summary.GetRecordCount() == expected.GetRecordCount() && boards.size() == expectedBoards.size() &&
+		(boards.empty() || memcmp(boards.data(), expectedBoards.data(), boards.size() * sizeof(BoardStats)) == 0);
+	if (!IsSame) {
+		printf("%s: the summary (%llu records, %zu boards) isn't the one rebuilt from the log (%llu records, %zu boards)\n", when,
+			static_cast<unsigned long long>(summary.GetRecordCount()), boards.size(),
+			static_cast<unsigned long long>(expected.GetRecordCount()), expectedBoards.size());
+	}
+	return IsSame;
+}
+
+// Checks the quantiles of a sketch against the exact clear times, returns the largest difference (relative)
+static double CheckQuantiles(const QuantileSketch& sketch, std::vector<uint32_t>& times, bool& IsWithinTolerance) {
+
+	std::sort(times.begin(), times.end());
+	double largestDifference = 0;
+	for (double quantile : checkedQuantiles) {
+		size_t rank = std::min(times.size(), std::max<size_t>(1, static_cast<size_t>(std::ceil(quantile * times.size()))));
+		double exact = times[rank - 1];
+		double difference = std::fabs(sketch.GetQuantile(quantile) - exact) / exact;
+		largestDifference = std::max(largestDifference, difference);
+		IsWithinTolerance &= difference <= quantileTolerance + 1 / exact;
+	}
+	return largestDifference;
+}
+
+// Counts the 3BV of a board another way than GameBoard: the empty cells are joined into openings with union find,
+// and each number with no empty cell around it is a click of its own
+static int Reference3BV(const GameBoard& board) {
+
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	std::vector<int> parent(board.GetCellCount());
+	std::iota(parent.begin(), parent.end(), 0);
+	auto FindRoot = [&](int index) {
+		while (parent[index] != index) {
+			index = parent[index] = parent[parent[index]];
+		}
+		return index;
+	};
+	auto IsEmpty = [&](int index) { return !board.IsBomb(index % nCols, index / nCols) && board.CountBombsSurrounding(index % nCols, index / nCols) == 0; };
+
+	int count = 0;
+	WithTopology(board.GetTopology(), [&](auto policy) {
+		typedef decltype(policy) Topology;
+		for (int index = 0; index < board.GetCellCount(); index++) {
+			if (IsEmpty(index)) {
+				Topology::ForEachNeighbor(index % nCols, index / nCols, nCols, nRows, [&](int neighbor) {
+					if (IsEmpty(neighbor)) {
+						parent[FindRoot(neighbor)] = FindRoot(index);
+					}
+				});
+			}
+		}
+		for (int index = 0; index < board.GetCellCount(); index++) {
+			if (board.IsBomb(index % nCols, index / nCols)) {
+				continue;
+			}
+			if (IsEmpty(index)) {
+				count += FindRoot(index) == index;
+				continue;
+			}
+			bool IsNextToOpening = false;
+			Topology::ForEachNeighbor(index % nCols, index / nCols, nCols, nRows, [&](int neighbor) { IsNextToOpening |= IsEmpty(neighbor); });
+			count += !IsNextToOpening;
+		}
+	});
+	return count;
+}
+
+// Checks Count3BV on seeded boards of every size and shape, returns the # of boards that differ
+static int Check3BV(int boardsPerShape) {
+
+	int failures = 0;
+	for (const BenchmarkBoard& size : benchmarkBoards) {
+		for (int topology = 0; topology < 4; topology++) {
+			GameBoard board(size.nCols, size.nRows, size.numberOfBombs);
+			board.SetTopology(static_cast<TopologyType>(topology));
+			for (int game = 0; game < boardsPerShape; game++) {
+				board.NewGame(1000 + game);
+				board.Reveal(size.nCols / 2, size.nRows / 2);
+				int bbbv = board.Count3BV();
+				int expected = Reference3BV(board);
+				if (bbbv != expected) {
+					printf("%dx%d board of shape %d, seed %d: Count3BV gives %d, the reference count %d\n", size.nCols, size.nRows, topology, 1000 + game, bbbv, expected);
+					failures++;
+				}
+			}
+		}
+	}
+	return failures;
+}
+
+int main(int argc, char** argv) {
+
+	int games = argc > 1 ? std::max(1, atoi(argv[1])) : 500000;
+	bool IsPassing = true;
+	std::remove(logPath.c_str());
+	std::remove(summaryPath.c_str());
+
+	// The games are added the way the window adds them, the thread writes them as they come
+	StatsStore store;
+	if (!store.Open(logPath, summaryPath)) {
+		printf("can't create %s\n", logPath.c_str());
+		return 1;
+	}
+	std::vector<GameRecord> records(games);
+	Clock::time_point start = Clock::now();
+	for (int game = 0; game < games; game++) {
+		records[game] = CreateGame(game);
+		store.Add(records[game]);
+	}
+	double addMilliseconds = MillisecondsSince(start);
+	start = Clock::now();
+	store.Close();
+	double closeMilliseconds = MillisecondsSince(start);
+	printf("%d games added in %.1f ms (%.2f us per game on the window's thread), written %.1f ms later\n", games, addMilliseconds,
+		addMilliseconds * 1000 / games, closeMilliseconds);
+
+	// Opening reads the summary, not the log
+	start = Clock::now();
+	IsPassing &= store.Open(logPath, summaryPath);
+	double openMilliseconds = MillisecondsSince(start);
+	store.Close();
+	start = Clock::now();
+	StatsSummary rebuilt = RebuildSummary();
+	double rebuildMilliseconds = MillisecondsSince(start);
+	printf("opened from the summary in %.2f ms, reading all %llu records of the log takes %.1f ms\n", openMilliseconds,
+		static_cast<unsigned long long>(rebuilt.GetRecordCount()), rebuildMilliseconds);
+	IsPassing &= rebuilt.GetRecordCount() == static_cast<uint64_t>(games) && IsSameSummary(store.GetSummary(), rebuilt, "open");
+
+	// A summary that fell behind the log catches up with the records after it
+	StatsSummary oldSummary;
+	oldSummary.Read(summaryPath);
+	IsPassing &= store.Open(logPath, summaryPath);
+	for (int game = games; game < games + 1000; game++) {
+		store.Add(CreateGame(game));
+	}
+	store.Close();
+	oldSummary.Write(summaryPath);
+	start = Clock::now();
+	IsPassing &= store.Open(logPath, summaryPath);
+	double catchUpMilliseconds = MillisecondsSince(start);
+	store.Close();
+	printf("opened from a summary 1000 records behind in %.2f ms\n", catchUpMilliseconds);
+	IsPassing &= IsSameSummary(store.GetSummary(), RebuildSummary(), "summary behind the log");
+
+	// A record cut short (the app closed while it was written) is written over by the next record
+	FILE* file = fopen(logPath.c_str(), "ab");
+	fwrite("cut short", 1, 9, file);
+	fclose(file);
+	IsPassing &= store.Open(logPath, summaryPath);
+	store.Add(CreateGame(games + 1000));
+	store.Close();
+	IsPassing &= StatsStore::CountLogRecords(logPath) == games + 1001;
+	IsPassing &= store.Open(logPath, summaryPath);
+	store.Close();
+	IsPassing &= IsSameSummary(store.GetSummary(), RebuildSummary(), "record cut short");
+
+	// The quantiles of each board's sketch and of the merged sketch are checked against the exact times of the first
+	// games (the ones the summary has from the start, as the later games were added too)
+	StatsSummary firstGames;
+	for (const GameRecord& record : records) {
+		firstGames.Add(record);
+	}
+	bool IsWithinTolerance = true;
+	double largestDifference = 0;
+	std::vector<uint32_t> allTimes;
+	for (const BoardStats& board : firstGames.GetBoards()) {
+		std::vector<uint32_t> times;
+		for (const GameRecord& record : records) {
+			if (board.IsSameBoard(record) && record.IsWon && record.options == 0) {
+				times.push_back(record.milliseconds);
+			}
+		}
+		allTimes.insert(allTimes.end(), times.begin(), times.end());
+		largestDifference = std::max(largestDifference, CheckQuantiles(board.winTimes, times, IsWithinTolerance));
+	}
+	double mergedDifference = CheckQuantiles(firstGames.GetTotal().winTimes, allTimes, IsWithinTolerance);
+	printf("quantiles of %zu boards within %.2f%% of the exact times (%.2f%% for the merged sketch)\n", firstGames.GetBoards().size(),
+		largestDifference * 100, mergedDifference * 100);
+	IsPassing &= IsWithinTolerance;
+
+	int failures3BV = Check3BV(50);
+	printf("3BV of %d boards checked, %d differ\n", 50 * 4 * static_cast<int>(sizeof(benchmarkBoards) / sizeof(benchmarkBoards[0])), failures3BV);
+	IsPassing &= failures3BV == 0;
+
+	std::remove(logPath.c_str());
+	std::remove(summaryPath.c_str());
+	printf(IsPassing ? "every check passed\n" : "a check failed\n");
+	return IsPassing ? 0 : 1;
+}
@@ -0,0 +1,237 @@
+// Benchmark and check for the board topologies (MinesweeperGUI/Topology.h): plays the same seeded games on every
+// topology, and checks each final board against neighbors found from the geometry of the topology (not from its
+// policy): the numbers, the cells kept free of bombs around the first reveal, and that empty areas were cleared
+// to their edges. Toroidal boards smaller than 3 x 3 must be played as standard ones (a wrapped neighbor would be the
+// cell itself or another neighbor), and their frontier index must count the neighbors of a standard board too. A
+// large board is also generated on every topology to check the parallel placement.
+// The standard topology's games/s can be compared with the previous engine (the loops are compiled per topology)
+//
+// usage: topologybench [cols] [rows] [bombs] [games]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const topologyNames[] = { "standard", "toroidal", "hexagonal", "knight" };
+static const TopologyType topologies[] = { TopologyType::Standard, TopologyType::Toroidal, TopologyType::Hexagonal, TopologyType::Knight };
+
+// Determines if two different cells are neighbors from the geometry of the topology
+static bool IsNeighbor(TopologyType topology, int x1, int y1, int x2, int y2, int nCols, int nRows) {
+
+	int distanceX = std::abs(x1 - x2);
+	int distanceY = std::abs(y1 - y2);
+	if (distanceX == 0 && distanceY == 0) {
+		return false;
+	}
+
+	if (topology == TopologyType::Toroidal) {
+		return std::min(distanceX, nCols - distanceX) <= 1 && std::min(distanceY, nRows - distanceY) <= 1;
+	}
+	if (topology == TopologyType::Hexagonal) {
+		// Cube coordinates of the shifted rows, neighbors are at a distance of 1
+		int cubeX1 = x1 - (y1 - (y1 & 1)) / 2;
+		int cubeX2 = x2 - (y2 - (y2 & 1)) / 2;
+		int cubeY1 = -cubeX1 - y1;
+		int cubeY2 = -cubeX2 - y2;
+		return std::max({ std::abs(cubeX1 - cubeX2), std::abs(cubeY1 - cubeY2), distanceY }) == 1;
+	}
+	if (topology == TopologyType::Knight) {
+		return (distanceX == 1 && distanceY == 2) || (distanceX == 2 && distanceY == 1);
+	}
+	return distanceX <= 1 && distanceY <= 1;
+}
+
+// Checks a board against the geometry of its topology, returns false (and prints why) if it is wrong
+static bool CheckBoard(const GameBoard& board, int firstX, int firstY) {
+
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	TopologyType topology = board.GetTopology();
+	const uint8_t* visible = board.GetVisibleState();
+	int reach = topology == TopologyType::Knight ? 2 : 1;
+
+	for (int y = 0; y < nRows; y++) {
+		for (int x = 0; x < nCols; x++) {
+			if ((x == firstX && y == firstY) || IsNeighbor(topology, x, y, firstX, firstY, nCols, nRows)) {
+				if (board.IsBomb(x, y)) {
+					printf("bomb at %d,%d next to the first reveal\n", x, y);
+					return false;
+				}
+			}
+			if (!board.IsCleared(x, y)) {
+				continue;
+			}
+
+			// Visit the cells close enough to be neighbors (every cell on a wrapping board)
+			int bombs = 0;
+			int coveredNeighbors = 0;
+			for (int j = 0; j < nRows; j++) {
+				if (topology != TopologyType::Toroidal && std::abs(j - y) > reach) {
+					continue;
+				}
+				for (int i = 0; i < nCols; i++) {
+					if ((topology == TopologyType::Toroidal || std::abs(i - x) <= reach) && IsNeighbor(topology, x, y, i, j, nCols, nRows)) {
+						bombs += board.IsBomb(i, j);
+						coveredNeighbors += !board.IsCleared(i, j) && !board.IsBomb(i, j);
+					}
+				}
+			}
+			if (visible[board.GetIndex(x, y)] != bombs) {
+				printf("cell %d,%d shows %d, it has %d bombs around it\n", x, y, visible[board.GetIndex(x, y)], bombs);
+				return false;
+			}
+			if (bombs == 0 && coveredNeighbors > 0) {
+				printf("empty cell %d,%d has covered safe neighbors\n", x, y);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+// Checks the frontier index of a board (if it is tracked) against the geometry of its topology: each revealed number
+// must count its covered neighbors. Returns false (and prints why) if it is wrong
+static bool CheckFrontier(const GameBoard& board) {
+
+	if (!board.GetFrontier().IsAllocated()) {
+		return true;
+	}
+	int nCols = board.GetCols();
+	int nRows = board.GetRows();
+	const uint8_t* visible = board.GetVisibleState();
+	for (int index = 0; index < board.GetCellCount(); index++) {
+		if (visible[index] == 0 || visible[index] >= GameBoard::Covered) {
+			continue;
+		}
+		int unknowns = 0;
+		for (int other = 0; other < board.GetCellCount(); other++) {
+			unknowns += visible[other] == GameBoard::Covered &&
+				IsNeighbor(board.GetTopology(), index % nCols, index / nCols, other % nCols, other / nCols, nCols, nRows);
+		}
+		if (board.GetFrontier().GetUnknownCount(index) != unknowns) {
+			printf("the frontier counts %d unknowns around cell %d,%d, it has %d\n", board.GetFrontier().GetUnknownCount(index),
+				index % nCols, index / nCols, unknowns);
+			return false;
+		}
+	}
+	return true;
+}
+
+// Plays seeded games with a random agent (reveals, and a chord every 4th move) and checks every final board.
+// Returns the time spent in the moves
+static double PlayGames(GameBoard& board, int games, bool IsChecked, int& wins) {
+
+	double seconds = 0;
+	uint64_t agentState = 7;
+	int cellCount = board.GetCellCount();
+	wins = 0;
+
+	for (int game = 0; game < games; game++) {
+		board.NewGame(game);
+		int firstX = -1;
+		int firstY = -1;
+		Clock::time_point start = Clock::now();
+
+		for (int move = 0; board.GetStatus() != GameBoard::Status::Won && board.GetStatus() != GameBoard::Status::Lost; move++) {
+			int index = static_cast<int>(GameBoard::RandomBelow(agentState, cellCount));
+			int x = index % board.GetCols();
+			int y = index / board.GetCols();
+			if (firstX < 0) {
+				firstX = x;
+				firstY = y;
+			}
+			if (move % 4 == 3 || !board.IsCleared(x, y)) {
+				board.Reveal(x, y);
+			}
+		}
+		seconds += std::chrono::duration<double>(Clock::now() - start).count();
+		wins += board.GetStatus() == GameBoard::Status::Won;
+
+		if (IsChecked && (!CheckBoard(board, firstX, firstY) || !CheckFrontier(board))) {
+			printf("game %d is wrong\n", game);
+			exit(1);
+		}
+	}
+	return seconds;
+}
+
+int main(int argc, char** argv) {
+
+	int nCols = argc > 1 ? atoi(argv[1]) : 30;
+	int nRows = argc > 2 ? atoi(argv[2]) : 16;
+	int numberOfBombs = argc > 3 ? atoi(argv[3]) : 40;
+	int games = argc > 4 ? atoi(argv[4]) : 100000;
+	const int checkedGames = 2000;
+	const int runs = 5;
+	printf("%dx%d board, %d bombs, %d games on each topology\n", nCols, nRows, numberOfBombs, games);
+
+	for (int i = 0; i < 4; i++) {
+		GameBoard board;
+		board.Resize(nCols, nRows, numberOfBombs);
+		board.SetTopology(topologies[i]);
+
+		int wins = 0;
+		PlayGames(board, checkedGames, true, wins);
+
+		// Keep the fastest of a few runs
+		double seconds = 0;
+		for (int run = 0; run < runs; run++) {
+			double runSeconds = PlayGames(board, games, false, wins);
+			seconds = run == 0 ? runSeconds : std::min(seconds, runSeconds);
+		}
+		printf("%-9s %9.0f games/s, %5.1f%% won, %d boards checked\n", topologyNames[i], games / seconds, 100.0 * wins / games, checkedGames);
+	}
+
+	// Narrow toroidal boards are played as standard ones (whether the topology is set before or after the size, and
+	// with the frontier index tracked), and are toroidal again once they are resized
+	const int narrowSizes[][2] = { { 2, 2 }, { 1, 5 }, { 2, 9 }, { 9, 2 }, { 3, 3 } };
+	for (const int* size : narrowSizes) {
+		GameBoard board;
+		board.SetTopology(TopologyType::Toroidal);
+		board.Resize(size[0], size[1], 1);
+		GameBoard trackedBoard;
+		trackedBoard.Resize(size[0], size[1], 1);
+		trackedBoard.SetFrontierTracking(true);
+		trackedBoard.SetTopology(TopologyType::Toroidal);
+		TopologyType expected = size[0] < 3 || size[1] < 3 ? TopologyType::Standard : TopologyType::Toroidal;
+		int wins = 0;
+		for (const GameBoard* playedBoard : { &board, &trackedBoard }) {
+			if (playedBoard->GetTopology() != expected) {
+				printf("the toroidal %dx%d board is played as %s\n", size[0], size[1], topologyNames[static_cast<int>(playedBoard->GetTopology())]);
+				return 1;
+			}
+		}
+		PlayGames(board, checkedGames, true, wins);
+		PlayGames(trackedBoard, checkedGames, true, wins);
+		board.Resize(9, 9, 10);
+		if (board.GetTopology() != TopologyType::Toroidal) {
+			printf("the toroidal %dx%d board isn't toroidal once resized to 9x9\n", size[0], size[1]);
+			return 1;
+		}
+	}
+	printf("toroidal boards smaller than 3x3 are played as standard boards, %d boards checked per size\n", checkedGames);
+
+	// Generate a large board on every topology (bombs placed on several threads) and check it
+	int largeCols = 1200;
+	int largeRows = 1000;
+	for (int i = 0; i < 4; i++) {
+		GameBoard board;
+		board.Resize(largeCols, largeRows, largeCols * largeRows / 5);
+		board.SetTopology(topologies[i]);
+		board.NewGame(3);
+
+		Clock::time_point start = Clock::now();
+		board.Reveal(0, 0);
+		double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+		if (!CheckBoard(board, 0, 0)) {
+			printf("the %s large board is wrong\n", topologyNames[i]);
+			return 1;
+		}
+		printf("%-9s %dx%d board generated in %.1f ms and checked\n", topologyNames[i], largeCols, largeRows, milliseconds);
+	}
+	return 0;
+}
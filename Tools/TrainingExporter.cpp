@@ -0,0 +1,424 @@
+// Exporter of training data for solvers: plays seeded games on several generator threads and writes every position
+// with the move made from it (Tools/TrainingFormat.h). The player takes the moves forced by a single number
+// (found by the frontier index, MinesweeperGUI/FrontierIndex.h) and otherwise guesses a covered cell, so the records
+// hold both forced moves and guesses, labeled with where the mines really are.
+//
+// Each generator thread fills chunks of records and hands them to a writer thread, which is the only one that touches
+// the file. Every generator has two chunk buffers: it fills one while the other is being written, and only waits if
+// the writer is still busy with its other buffer when it fills the next one (the time waited is reported).
+// The sustained records/s is measured from the start to the file being closed.
+//
+// --check maps a written file and checks its header, its index and a sample of records (the visible numbers must match
+// the labels, forced reveals must be safe and forced flags must be mines).
+//
+// usage: trainingexport output [records] [cols] [rows] [bombs] [threads]
+//        trainingexport --check file [samples]
+
+#include "../MinesweeperGUI/GameBoard.h"
+#include "TrainingFormat.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+typedef std::chrono::steady_clock Clock;
+
+// Define the # of records in a chunk (about 2 MB), the unit handed from the generators to the writer
+const uint32_t RecordsPerChunk = 4096;
+
+// Define a chunk buffer and the thread that owns it
+struct Chunk {
+	std::vector<Record> records;
+	uint64_t firstGameSeed = 0;
+	uint32_t thread = 0;
+	bool IsFree = true;
+};
+
+// Define what the generator threads and the writer thread share, every field is guarded by the mutex
+struct Pipeline {
+	std::mutex mutex;
+	std::condition_variable chunkFull;
+	std::condition_variable chunkFree;
+	std::deque<Chunk*> fullChunks;
+	int runningGenerators = 0;
+};
+
+// Define a generator's game and player
+struct Player {
+	GameBoard board;
+	uint64_t gameSeed = 0;
+	uint64_t randomState = 0;
+	uint32_t moveNumber = 0;
+	std::vector<uint32_t> cells;
+};
+
+static double SecondsSince(Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Copies the window around a cell into a record: what the player sees, and the labels
+static void FillWindow(const GameBoard& board, int xPos, int yPos, Record& record) {
+
+	const uint8_t* visible = board.GetVisibleState();
+	int half = WindowSide / 2;
+	int position = 0;
+	for (int j = 0; j < WindowSide; j++) {
+		int y = yPos + j - half;
+		for (int i = 0; i < WindowSide; i++, position++) {
+			int x = xPos + i - half;
+			if (!board.IsInGridIndex(x, y)) {
+				record.visible[position] = OutsideCell;
+				record.labels[position] = OutsideLabel;
+			}
+			else {
+				record.visible[position] = visible[board.GetIndex(x, y)];
+				record.labels[position] = board.IsBomb(x, y) ? MineLabel : SafeLabel;
+			}
+		}
+	}
+}
+
+// Starts the next game (the game # is the seed), the first reveal is made without a record since the bombs are
+// only placed by it (a game won by its first reveal is skipped)
+static void StartGame(Player& player, std::atomic<uint64_t>& nextGame) {
+
+	GameBoard& board = player.board;
+	do {
+		player.gameSeed = nextGame++;
+		player.randomState = player.gameSeed * 0x9E3779B97F4A7C15ull + 1;
+		player.moveNumber = 0;
+		board.NewGame(player.gameSeed);
+		int index = static_cast<int>(GameBoard::RandomBelow(player.randomState, board.GetCellCount()));
+		board.Reveal(index % board.GetCols(), index / board.GetCols());
+	} while (board.GetStatus() != GameBoard::Status::Playing);
+}
+
+// Chooses the next move of a game in progress, writes the position and the move into the record, then makes it
+static void PlayMove(Player& player, Record& record) {
+
+	GameBoard& board = player.board;
+	const FrontierIndex& frontier = board.GetFrontier();
+	const uint8_t* visible = board.GetVisibleState();
+	std::vector<uint32_t>& cells = player.cells;
+	TrainingMove move = TrainingMove::Reveal;
+	bool IsForced = true;
+
+	// A safe cell next to a number with all of its mines flagged, a mine next to a number with no other cell left,
+	// or else a guess on the frontier (or anywhere covered if the frontier is empty)
+	frontier.FindSafeCells(cells);
+	if (cells.empty()) {
+		frontier.FindCertainMines(cells);
+		move = TrainingMove::Flag;
+	}
+	if (cells.empty()) {
+		move = TrainingMove::Reveal;
+		IsForced = false;
+		cells = frontier.GetFrontierCells();
+	}
+
+	int index;
+	if (!cells.empty()) {
+		index = cells[IsForced ? 0 : GameBoard::RandomBelow(player.randomState, cells.size())];
+	}
+	else {
+		do {
+			index = static_cast<int>(GameBoard::RandomBelow(player.randomState, board.GetCellCount()));
+		} while (visible[index] != GameBoard::Covered);
+	}
+	int xPos = index % board.GetCols();
+	int yPos = index / board.GetCols();
+
+	record.gameSeed = player.gameSeed;
+	record.moveNumber = player.moveNumber++;
+	record.moveX = static_cast<uint16_t>(xPos);
+	record.moveY = static_cast<uint16_t>(yPos);
+	record.move = static_cast<uint8_t>(move);
+	record.IsForced = IsForced;
+	record.IsMoveOnMine = board.IsBomb(xPos, yPos);
+	FillWindow(board, xPos, yPos, record);
+
+	if (move == TrainingMove::Flag) {
+		board.ToggleFlag(xPos, yPos);
+	}
+	else {
+		board.Reveal(xPos, yPos);
+	}
+}
+
+// Fills chunks with the records of games until every chunk has been claimed, then tells the writer it is done.
+// Returns (in stallSeconds) the time spent waiting for the writer to give a buffer back
+static void RunGenerator(Pipeline& pipeline, Chunk* buffers, int nCols, int nRows, int numberOfBombs,
+	std::atomic<uint64_t>& nextGame, std::atomic<uint32_t>& nextChunk, uint32_t chunkCount, double& stallSeconds) {
+
+	Player player;
+	player.board.Resize(nCols, nRows, numberOfBombs);
+	player.board.SetFrontierTracking(true);
+	StartGame(player, nextGame);
+	stallSeconds = 0;
+
+	for (int buffer = 0; nextChunk++ < chunkCount; buffer ^= 1) {
+		Chunk& chunk = buffers[buffer];
+		{
+			Clock::time_point start = Clock::now();
+			std::unique_lock<std::mutex> lock(pipeline.mutex);
+			pipeline.chunkFree.wait(lock, [&]() { return chunk.IsFree; });
+			chunk.IsFree = false;
+			stallSeconds += SecondsSince(start);
+		}
+
+		chunk.firstGameSeed = player.gameSeed;
+		for (Record& record : chunk.records) {
+			PlayMove(player, record);
+			GameBoard::Status status = player.board.GetStatus();
+			if (status == GameBoard::Status::Won || status == GameBoard::Status::Lost) {
+				StartGame(player, nextGame);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(pipeline.mutex);
+		pipeline.fullChunks.push_back(&chunk);
+		pipeline.chunkFull.notify_one();
+	}
+
+	std::lock_guard<std::mutex> lock(pipeline.mutex);
+	pipeline.runningGenerators--;
+	pipeline.chunkFull.notify_one();
+}
+
+// Writes the full chunks in the order they come, and gives each buffer back to its generator once it is written.
+// Returns false if the file could not be written
+static bool RunWriter(Pipeline& pipeline, FILE* file, std::vector<ChunkEntry>& index, double& writeSeconds) {
+
+	uint64_t offset = sizeof(FileHeader);
+	writeSeconds = 0;
+	bool IsWritten = true;
+	while (true) {
+		Chunk* chunk;
+		{
+			std::unique_lock<std::mutex> lock(pipeline.mutex);
+			pipeline.chunkFull.wait(lock, [&]() { return !pipeline.fullChunks.empty() || pipeline.runningGenerators == 0; });
+			if (pipeline.fullChunks.empty()) {
+				return IsWritten;
+			}
+			chunk = pipeline.fullChunks.front();
+			pipeline.fullChunks.pop_front();
+		}
+
+		Clock::time_point start = Clock::now();
+		size_t bytes = chunk->records.size() * sizeof(Record);
+		IsWritten &= fwrite(chunk->records.data(), 1, bytes, file) == bytes;
+		writeSeconds += SecondsSince(start);
+
+		ChunkEntry entry;
+		entry.offset = offset;
+		entry.firstGameSeed = chunk->firstGameSeed;
+		entry.thread = chunk->thread;
+		entry.recordCount = static_cast<uint32_t>(chunk->records.size());
+		index.push_back(entry);
+		offset += bytes;
+
+		std::lock_guard<std::mutex> lock(pipeline.mutex);
+		chunk->IsFree = true;
+		pipeline.chunkFree.notify_all();
+	}
+}
+
+static int Export(const char* path, uint64_t records, int nCols, int nRows, int numberOfBombs, int threadCount) {
+
+	uint32_t chunkCount = static_cast<uint32_t>((records + RecordsPerChunk - 1) / RecordsPerChunk);
+	printf("%dx%d board, %d bombs, %u chunks of %u records (%.1f MB), %d generator threads\n", nCols, nRows, numberOfBombs,
+		chunkCount, RecordsPerChunk, chunkCount * static_cast<double>(RecordsPerChunk) * sizeof(Record) / 1e6, threadCount);
+
+	FILE* file = fopen(path, "wb");
+	if (file == nullptr) {
+		printf("can't open %s\n", path);
+		return 1;
+	}
+
+	// The header is written again once the index is written
+	FileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRAINING_FILE_MAGIC, sizeof(header.magic));
+	header.version = TrainingFileVersion;
+	header.recordSize = sizeof(Record);
+	header.windowSide = WindowSide;
+	header.recordsPerChunk = RecordsPerChunk;
+	header.chunkCount = chunkCount;
+	header.nCols = nCols;
+	header.nRows = nRows;
+	header.numberOfBombs = numberOfBombs;
+	header.recordCount = static_cast<uint64_t>(chunkCount) * RecordsPerChunk;
+	fwrite(&header, sizeof(header), 1, file);
+
+	Pipeline pipeline;
+	pipeline.runningGenerators = threadCount;
+	std::vector<Chunk> buffers(threadCount * 2);
+	for (size_t i = 0; i < buffers.size(); i++) {
+		buffers[i].records.resize(RecordsPerChunk);
+		memset(buffers[i].records.data(), 0, RecordsPerChunk * sizeof(Record));
+		buffers[i].thread = static_cast<uint32_t>(i / 2);
+	}
+
+	std::atomic<uint64_t> nextGame{ 0 };
+	std::atomic<uint32_t> nextChunk{ 0 };
+	std::vector<double> stallSeconds(threadCount);
+	std::vector<ChunkEntry> index;
+	double writeSeconds = 0;
+
+	Clock::time_point start = Clock::now();
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; i++) {
+		threads.emplace_back(RunGenerator, std::ref(pipeline), &buffers[i * 2], nCols, nRows, numberOfBombs,
+			std::ref(nextGame), std::ref(nextChunk), chunkCount, std::ref(stallSeconds[i]));
+	}
+	bool IsWritten = RunWriter(pipeline, file, index, writeSeconds);
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+
+	header.indexOffset = sizeof(FileHeader) + header.recordCount * sizeof(Record);
+	IsWritten &= fwrite(index.data(), sizeof(ChunkEntry), index.size(), file) == index.size();
+	IsWritten &= fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+	IsWritten &= fclose(file) == 0;
+	double seconds = SecondsSince(start);
+	if (!IsWritten) {
+		printf("writing %s failed\n", path);
+		return 1;
+	}
+
+	double totalStall = 0;
+	for (double stall : stallSeconds) {
+		totalStall += stall;
+	}
+	printf("%llu records from %llu games in %.2f s: %.0f records/s, %.1f MB/s\n", static_cast<unsigned long long>(header.recordCount),
+		static_cast<unsigned long long>(nextGame.load()), seconds, header.recordCount / seconds, header.recordCount * sizeof(Record) / seconds / 1e6);
+	printf("writer busy %.0f%% of the time, generators waited for the writer %.1f%% of the time\n",
+		100 * writeSeconds / seconds, 100 * totalStall / (seconds * threadCount));
+	return 0;
+}
+
+// Determines if a record is consistent: every revealed number whose neighbors are all in the window matches the
+// mine labels around it, and the move is on a covered cell (forced moves must be right)
+static bool CheckRecord(const Record& record) {
+
+	int half = WindowSide / 2;
+	int center = half + half * WindowSide;
+	if (record.visible[center] != GameBoard::Covered || record.labels[center] != record.IsMoveOnMine) {
+		return false;
+	}
+	if (record.IsForced && record.IsMoveOnMine != (record.move == static_cast<uint8_t>(TrainingMove::Flag))) {
+		return false;
+	}
+
+	for (int y = 1; y < WindowSide - 1; y++) {
+		for (int x = 1; x < WindowSide - 1; x++) {
+			uint8_t value = record.visible[x + y * WindowSide];
+			if (value >= GameBoard::Covered || value == OutsideCell) {
+				continue;
+			}
+			int mines = 0;
+			for (int j = y - 1; j <= y + 1; j++) {
+				for (int i = x - 1; i <= x + 1; i++) {
+					mines += record.labels[i + j * WindowSide] == MineLabel;
+				}
+			}
+			if (record.labels[x + y * WindowSide] != SafeLabel || mines != value) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static int Check(const char* path, int samples) {
+
+	int descriptor = open(path, O_RDONLY);
+	struct stat fileStat;
+	if (descriptor < 0 || fstat(descriptor, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+		printf("can't read %s\n", path);
+		return 1;
+	}
+	size_t size = static_cast<size_t>(fileStat.st_size);
+	void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	close(descriptor);
+	if (mapping == MAP_FAILED) {
+		printf("can't map %s\n", path);
+		return 1;
+	}
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(mapping);
+	const FileHeader& header = *reinterpret_cast<const FileHeader*>(bytes);
+	bool IsValid = memcmp(header.magic, TRAINING_FILE_MAGIC, sizeof(header.magic)) == 0 && header.version == TrainingFileVersion &&
+		header.recordSize == sizeof(Record) && header.windowSide == WindowSide && header.indexOffset != 0 &&
+		header.recordCount == static_cast<uint64_t>(header.chunkCount) * header.recordsPerChunk &&
+		header.indexOffset == sizeof(FileHeader) + header.recordCount * sizeof(Record) &&
+		size == header.indexOffset + header.chunkCount * sizeof(ChunkEntry);
+	if (!IsValid) {
+		printf("%s is not a finished training file of this version\n", path);
+		munmap(mapping, size);
+		return 1;
+	}
+
+	// Every chunk is full and in place
+	const ChunkEntry* index = reinterpret_cast<const ChunkEntry*>(bytes + header.indexOffset);
+	for (uint32_t i = 0; i < header.chunkCount; i++) {
+		if (index[i].offset != sizeof(FileHeader) + static_cast<uint64_t>(i) * header.recordsPerChunk * sizeof(Record) ||
+			index[i].recordCount != header.recordsPerChunk) {
+			printf("index entry %u is wrong\n", i);
+			munmap(mapping, size);
+			return 1;
+		}
+	}
+
+	// Sample records at random, the way a training reader would
+	const Record* records = reinterpret_cast<const Record*>(bytes + sizeof(FileHeader));
+	uint64_t state = 5;
+	int forced = 0;
+	for (int i = 0; i < samples; i++) {
+		uint64_t recordIndex = GameBoard::RandomBelow(state, header.recordCount);
+		if (!CheckRecord(records[recordIndex])) {
+			printf("record %llu is wrong\n", static_cast<unsigned long long>(recordIndex));
+			munmap(mapping, size);
+			return 1;
+		}
+		forced += records[recordIndex].IsForced;
+	}
+	printf("%s: %llu records in %u chunks, %d sampled records checked (%.1f%% forced moves)\n", path,
+		static_cast<unsigned long long>(header.recordCount), header.chunkCount, samples, 100.0 * forced / samples);
+	munmap(mapping, size);
+	return 0;
+}
+
+int main(int argc, char** argv) {
+
+	if (argc > 2 && strcmp(argv[1], "--check") == 0) {
+		return Check(argv[2], argc > 3 ? atoi(argv[3]) : 100000);
+	}
+	if (argc < 2) {
+		printf("usage: trainingexport output [records] [cols] [rows] [bombs] [threads]\n");
+		printf("       trainingexport --check file [samples]\n");
+		return 1;
+	}
+
+	uint64_t records = argc > 2 ? strtoull(argv[2], nullptr, 10) : 1000000;
+	int nCols = argc > 3 ? atoi(argv[3]) : 30;
+	int nRows = argc > 4 ? atoi(argv[4]) : 16;
+	int numberOfBombs = argc > 5 ? atoi(argv[5]) : 99;
+	int threadCount = argc > 6 ? atoi(argv[6]) : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+	if (nCols > 65535 || nRows > 65535 || threadCount < 1) {
+		printf("the board can be 65535 x 65535 at most, and there must be a generator thread\n");
+		return 1;
+	}
+	return Export(argv[1], records, nCols, nRows, numberOfBombs, threadCount);
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+
+// File format written by TrainingExporter: positions from seeded games, for training and evaluating solvers.
+// The file is a FileHeader, then chunkCount chunks of recordsPerChunk fixed size Records, then the index
+// (chunkCount ChunkEntries at indexOffset). Every chunk is full, so record i is at
+// sizeof(FileHeader) + i * sizeof(Record) and a reader can map the file and sample records at random.
+// The index tells which thread wrote each chunk and the seed of its first game (chunks are in the order they
+// were written, not by seed). Values are in host byte order
+
+// Define the magic and version at the start of the file
+#define TRAINING_FILE_MAGIC "MSTRAIN1"
+const uint32_t TrainingFileVersion = 1;
+
+// Define the window of cells around the move kept in each record (the move is at the center)
+const int WindowSide = 15;
+const int WindowCells = WindowSide * WindowSide;
+
+// Define the visible value of window cells outside of the board (0 - 10 are GameBoard visible values)
+const uint8_t OutsideCell = 11;
+
+// Define the label of each window cell: the truth the player can't see
+enum CellLabel : uint8_t {
+	SafeLabel = 0,
+	MineLabel = 1,
+	OutsideLabel = 2
+};
+
+// Define the moves the exporter's player makes
+enum class TrainingMove : uint8_t {
+	Reveal = 0,
+	Flag = 1
+};
+
+// Define the header at the start of the file (64 bytes, the layout must not change).
+// indexOffset is 0 in a file that was not finished
+struct FileHeader {
+	char magic[8];
+	uint32_t version;
+	uint32_t recordSize;
+	uint32_t windowSide;
+	uint32_t recordsPerChunk;
+	uint32_t chunkCount;
+	uint32_t nCols;
+	uint32_t nRows;
+	uint32_t numberOfBombs;
+	uint64_t recordCount;
+	uint64_t indexOffset;
+	uint8_t reserved[8];
+};
+
+// Define a position and the move made from it (480 bytes, the layout must not change).
+// IsForced is set when the move follows from a single number (the rest are guesses),
+// visible and labels are the window around the move, row by row
+struct Record {
+	uint64_t gameSeed;
+	uint32_t moveNumber;
+	uint16_t moveX;
+	uint16_t moveY;
+	uint8_t move;
+	uint8_t IsForced;
+	uint8_t IsMoveOnMine;
+	uint8_t reserved[5];
+	uint8_t visible[WindowCells];
+	uint8_t labels[WindowCells];
+	uint8_t padding[6];
+};
+
+// Define an entry of the index (24 bytes, the layout must not change)
+struct ChunkEntry {
+	uint64_t offset;
+	uint64_t firstGameSeed;
+	uint32_t thread;
+	uint32_t recordCount;
+};
+
+static_assert(sizeof(FileHeader) == 64, "FileHeader layout changed");
+static_assert(sizeof(Record) == 480, "Record layout changed");
+static_assert(sizeof(ChunkEntry) == 24, "ChunkEntry layout changed");